@@ -47,6 +47,21 @@
 #include <assert.h>
 #include "half.h"
 
+#if defined (__SSE2__) || defined (_M_X64) || \
+    (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define HALF_HAVE_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+#if defined (HALF_HAVE_SSE2) && \
+    (defined (__clang__) || \
+     (defined (__GNUC__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+    #define HALF_HAVE_F16C 1
+    #include <immintrin.h>
+    #include <cpuid.h>
+#endif
+
 using namespace std;
 
 //-------------------------------------------------------------
@@ -308,3 +323,314 @@ printBits (char c[35], float f)
 
     c[34] = 0;
 }
+
+
+//---------------------------------------------------------
+// Array conversion -- SSE2 and F16C kernels, which process
+// blocks of eight values and return the number of values
+// converted; the remaining values are converted one by one.
+//---------------------------------------------------------
+
+namespace {
+
+#ifdef HALF_HAVE_SSE2
+
+//
+// Converts four halfs, zero-extended to 32 bits, into four floats.
+//
+
+inline __m128i
+halfToFloatSse2 (__m128i h)
+{
+    const __m128i sign = _mm_slli_epi32 (_mm_and_si128 (h, _mm_set1_epi32 (0x8000)), 16);
+    const __m128i em   = _mm_and_si128 (h, _mm_set1_epi32 (0x7fff));
+
+    //
+    // Normalized numbers, infinities and NANs: move the exponent
+    // and significand into place and adjust the exponent bias;
+    // infinities and NANs get the maximum float exponent.
+    //
+
+    const __m128i bias = _mm_set1_epi32 ((127 - 15) << 23);
+    const __m128i isInfNan = _mm_cmpgt_epi32 (em, _mm_set1_epi32 (0x7bff));
+
+    __m128i normal = _mm_add_epi32 (_mm_slli_epi32 (em, 13), bias);
+    normal = _mm_add_epi32 (normal, _mm_and_si128 (isInfNan, bias));
+
+    //
+    // Zeroes and denormalized numbers: the value is the
+    // significand times 2^-24, which a float holds exactly.
+    //
+
+    const __m128i isDenorm = _mm_cmplt_epi32 (em, _mm_set1_epi32 (0x0400));
+
+    const __m128 denorm = _mm_mul_ps (_mm_cvtepi32_ps (em),
+                                      _mm_set1_ps (5.9604644775390625e-8f));
+
+    __m128i bits = _mm_or_si128 (_mm_and_si128 (isDenorm, _mm_castps_si128 (denorm)),
+                                 _mm_andnot_si128 (isDenorm, normal));
+
+    return _mm_or_si128 (bits, sign);
+}
+
+
+//
+// Converts four floats into four halfs, zero-extended to 32 bits,
+// rounding the same way as half::half(float).  Rounding of values
+// that become denormalized halfs relies on the floating-point unit
+// being in its default round-to-nearest mode.
+//
+
+inline __m128i
+floatToHalfSse2 (__m128i f)
+{
+    const __m128i sign = _mm_and_si128 (f, _mm_set1_epi32 (0x80000000));
+    const __m128i a    = _mm_xor_si128 (f, sign);
+
+    //
+    // Normalized halfs: adjust the exponent bias and round the
+    // significand to the nearest half, ties to even.
+    //
+
+    const __m128i odd = _mm_and_si128 (_mm_srli_epi32 (a, 13), _mm_set1_epi32 (1));
+
+    __m128i normal = _mm_add_epi32 (a, _mm_set1_epi32 (((15 - 127) << 23) + 0xfff));
+    normal = _mm_srli_epi32 (_mm_add_epi32 (normal, odd), 13);
+
+    //
+    // Zeroes and denormalized halfs: adding 0.5 shifts the value
+    // into the significand of the sum, rounded to a multiple of
+    // 2^-24, the spacing of the denormalized halfs.
+    //
+
+    const __m128 magic = _mm_castsi128_ps (_mm_set1_epi32 (126 << 23));
+
+    const __m128i denorm =
+        _mm_sub_epi32 (_mm_castps_si128 (_mm_add_ps (_mm_castsi128_ps (a), magic)),
+                       _mm_castps_si128 (magic));
+
+    //
+    // NANs keep the upper bits of the significand (at least one
+    // of which must be set); everything else that is too large
+    // becomes an infinity.
+    //
+
+    const __m128i m = _mm_and_si128 (_mm_srli_epi32 (a, 13), _mm_set1_epi32 (0x3ff));
+
+    const __m128i nan =
+        _mm_or_si128 (_mm_or_si128 (_mm_set1_epi32 (0x7c00), m),
+                      _mm_and_si128 (_mm_cmpeq_epi32 (m, _mm_setzero_si128 ()),
+                                     _mm_set1_epi32 (1)));
+
+    const __m128i isDenorm = _mm_cmplt_epi32 (a, _mm_set1_epi32 (113 << 23));
+    const __m128i isInf    = _mm_cmpgt_epi32 (a, _mm_set1_epi32 ((143 << 23) - 1));
+    const __m128i isNan    = _mm_cmpgt_epi32 (a, _mm_set1_epi32 (0x7f800000));
+
+    __m128i bits = _mm_or_si128 (_mm_and_si128 (isDenorm, denorm),
+                                 _mm_andnot_si128 (isDenorm, normal));
+
+    bits = _mm_or_si128 (_mm_and_si128 (isInf, _mm_set1_epi32 (0x7c00)),
+                         _mm_andnot_si128 (isInf, bits));
+
+    bits = _mm_or_si128 (_mm_and_si128 (isNan, nan),
+                         _mm_andnot_si128 (isNan, bits));
+
+    return _mm_or_si128 (bits, _mm_srli_epi32 (sign, 16));
+}
+
+
+//
+// Packs eight halfs, zero-extended to 32 bits, into 16 bits each.
+//
+
+inline __m128i
+packHalfs (__m128i lo, __m128i hi)
+{
+    lo = _mm_srai_epi32 (_mm_slli_epi32 (lo, 16), 16);
+    hi = _mm_srai_epi32 (_mm_slli_epi32 (hi, 16), 16);
+    return _mm_packs_epi32 (lo, hi);
+}
+
+
+size_t
+halfToFloatBlocksSse2 (const half src[], float dst[], size_t n)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i h = _mm_loadu_si128 ((const __m128i *) (src + i));
+
+        _mm_storeu_si128 ((__m128i *) (dst + i),
+                          halfToFloatSse2 (_mm_unpacklo_epi16 (h, zero)));
+
+        _mm_storeu_si128 ((__m128i *) (dst + i + 4),
+                          halfToFloatSse2 (_mm_unpackhi_epi16 (h, zero)));
+    }
+
+    return i;
+}
+
+
+size_t
+floatToHalfBlocksSse2 (const float src[], half dst[], size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i lo = _mm_loadu_si128 ((const __m128i *) (src + i));
+        __m128i hi = _mm_loadu_si128 ((const __m128i *) (src + i + 4));
+
+        _mm_storeu_si128 ((__m128i *) (dst + i),
+                          packHalfs (floatToHalfSse2 (lo), floatToHalfSse2 (hi)));
+    }
+
+    return i;
+}
+
+#endif // HALF_HAVE_SSE2
+
+
+#ifdef HALF_HAVE_F16C
+
+bool
+cpuHasF16c ()
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid (1, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    //
+    // The F16C instructions are VEX-encoded, so the operating
+    // system must also save the AVX state (OSXSAVE and XCR0).
+    //
+
+    if (!(ecx & (1 << 29)) || !(ecx & (1 << 27)))
+        return false;
+
+    unsigned int xcr0, xcr0High;
+
+    __asm__ ("xgetbv" : "=a" (xcr0), "=d" (xcr0High) : "c" (0));
+
+    return (xcr0 & 6) == 6;
+}
+
+
+const bool haveF16c = cpuHasF16c ();
+
+
+//
+// The F16C instructions quiet signaling NANs and, for float-to-half
+// conversion, treat NAN significands differently from the scalar
+// code.  Blocks that contain infinities or NANs are therefore
+// converted with the SSE2 code.
+//
+
+__attribute__((target("avx,f16c")))
+size_t
+halfToFloatBlocksF16c (const half src[], float dst[], size_t n)
+{
+    const __m128i expMask = _mm_set1_epi16 (0x7c00);
+    const __m128i zero = _mm_setzero_si128 ();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i h = _mm_loadu_si128 ((const __m128i *) (src + i));
+        __m128i e = _mm_and_si128 (h, expMask);
+
+        if (_mm_movemask_epi8 (_mm_cmpeq_epi16 (e, expMask)))
+        {
+            _mm_storeu_si128 ((__m128i *) (dst + i),
+                              halfToFloatSse2 (_mm_unpacklo_epi16 (h, zero)));
+
+            _mm_storeu_si128 ((__m128i *) (dst + i + 4),
+                              halfToFloatSse2 (_mm_unpackhi_epi16 (h, zero)));
+        }
+        else
+        {
+            _mm256_storeu_ps (dst + i, _mm256_cvtph_ps (h));
+        }
+    }
+
+    _mm256_zeroupper ();
+    return i;
+}
+
+
+__attribute__((target("avx,f16c")))
+size_t
+floatToHalfBlocksF16c (const float src[], half dst[], size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128 lo = _mm_loadu_ps (src + i);
+        __m128 hi = _mm_loadu_ps (src + i + 4);
+
+        __m128i h;
+
+        if (_mm_movemask_ps (_mm_or_ps (_mm_cmpunord_ps (lo, lo),
+                                        _mm_cmpunord_ps (hi, hi))))
+        {
+            h = packHalfs (floatToHalfSse2 (_mm_castps_si128 (lo)),
+                           floatToHalfSse2 (_mm_castps_si128 (hi)));
+        }
+        else
+        {
+            __m256 f = _mm256_insertf128_ps (_mm256_castps128_ps256 (lo), hi, 1);
+            h = _mm256_cvtps_ph (f, _MM_FROUND_TO_NEAREST_INT);
+        }
+
+        _mm_storeu_si128 ((__m128i *) (dst + i), h);
+    }
+
+    _mm256_zeroupper ();
+    return i;
+}
+
+#endif // HALF_HAVE_F16C
+
+} // namespace
+
+
+HALF_EXPORT void
+halfToFloatArray (const half src[], float dst[], size_t n)
+{
+    size_t i = 0;
+
+#if defined (HALF_HAVE_F16C)
+    if (haveF16c)
+        i = halfToFloatBlocksF16c (src, dst, n);
+    else
+        i = halfToFloatBlocksSse2 (src, dst, n);
+#elif defined (HALF_HAVE_SSE2)
+    i = halfToFloatBlocksSse2 (src, dst, n);
+#endif
+
+    for (; i < n; ++i)
+        dst[i] = src[i];
+}
+
+
+HALF_EXPORT void
+floatToHalfArray (const float src[], half dst[], size_t n)
+{
+    size_t i = 0;
+
+#if defined (HALF_HAVE_F16C)
+    if (haveF16c)
+        i = floatToHalfBlocksF16c (src, dst, n);
+    else
+        i = floatToHalfBlocksSse2 (src, dst, n);
+#elif defined (HALF_HAVE_SSE2)
+    i = floatToHalfBlocksSse2 (src, dst, n);
+#endif
+
+    for (; i < n; ++i)
+        dst[i] = src[i];
+}
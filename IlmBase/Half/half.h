@@ -87,6 +87,7 @@
 
 #include "halfExport.h"    // for definition of HALF_EXPORT
 #include <iostream>
+#include <stddef.h>
 
 class half
 {
@@ -240,6 +241,30 @@ HALF_EXPORT void        printBits   (char  c[19], half  h);
 HALF_EXPORT void        printBits   (char  c[35], float f);
 
 
+//-------------------------------------------------------------------------
+// Array conversion
+//
+// halfToFloatArray(src,dst,n) converts n halfs into floats, and
+// floatToHalfArray(src,dst,n) converts n floats into halfs.  The
+// results are bit-for-bit identical to converting the values one at
+// a time with half::operator float() and half::half(float), but
+// floatToHalfArray() does not necessarily generate floating-point
+// overflows for floats that are too large to be represented as halfs.
+//
+// On x86 processors the conversions use the F16C instructions if the
+// processor supports them, and branch-free SSE2 code otherwise.
+// Neither the source nor the destination needs to be aligned.
+//-------------------------------------------------------------------------
+
+HALF_EXPORT void        halfToFloatArray (const half src[],
+                                          float dst[],
+                                          size_t n);
+
+HALF_EXPORT void        floatToHalfArray (const float src[],
+                                          half dst[],
+                                          size_t n);
+
+
 //-------------------------------------------------------------------------
 // Limits
 //
@@ -5,6 +5,7 @@
 #include <testClassification.h>
 #include <testLimits.h>
 #include <testFunction.h>
+#include <testArrayConversion.h>
 
 #include <iostream>
 #include <string.h>
@@ -27,6 +28,7 @@ main (int argc, char *argv[])
     TEST (testClassification);
     TEST (testLimits);
     TEST (testFunction);
+    TEST (testArrayConversion);
 
     return 0;
 }
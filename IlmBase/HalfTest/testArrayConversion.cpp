@@ -0,0 +1,178 @@
+#include <testArrayConversion.h>
+#include "half.h"
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+using namespace std;
+
+namespace {
+
+
+unsigned int
+floatBits (float f)
+{
+    unsigned int i;
+    memcpy (&i, &f, sizeof (i));
+    return i;
+}
+
+
+float
+bitsToFloat (unsigned int i)
+{
+    float f;
+    memcpy (&f, &i, sizeof (f));
+    return f;
+}
+
+
+void
+checkHalfToFloat (const vector<half> &h, size_t first, size_t n)
+{
+    vector<float> f (n + 1, 42.0f);
+
+    halfToFloatArray (&h[first], &f[0], n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+	if (floatBits (f[i]) != floatBits (float (h[first + i])))
+	{
+	    cout << "error: half " << h[first + i].bits() <<
+		    " converted to float bits " << floatBits (f[i]) <<
+		    ", expected " << floatBits (float (h[first + i])) << endl;
+	    assert (false);
+	}
+    }
+
+    assert (f[n] == 42.0f);
+}
+
+
+void
+checkFloatToHalf (const vector<float> &f, size_t first, size_t n)
+{
+    vector<half> h (n + 1, half (42.0f));
+
+    floatToHalfArray (&f[first], &h[0], n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+	if (h[i].bits() != half (f[first + i]).bits())
+	{
+	    cout << "error: float bits " << floatBits (f[first + i]) <<
+		    " converted to half " << h[i].bits() <<
+		    ", expected " << half (f[first + i]).bits() << endl;
+	    assert (false);
+	}
+    }
+
+    assert (h[n] == half (42.0f));
+}
+
+
+//
+// Puts a NAN into every block of eight values, at a position that
+// changes from block to block, so that the conversion functions'
+// special handling for blocks with NANs gets exercised as well.
+//
+
+void
+sprinkleNans (vector<float> &f)
+{
+    for (size_t i = 0; i < f.size(); ++i)
+	if (i % 8 == (i / 8) % 8)
+	    f[i] = bitsToFloat ((rand() & 0x807fffff) | 0x7f800001);
+}
+
+
+} // namespace
+
+
+void
+testArrayConversion ()
+{
+    cout << "array conversion\n";
+
+    //
+    // Every half, with different lengths and start offsets
+    //
+
+    vector<half> h (1 << 16);
+
+    for (size_t i = 0; i < h.size(); ++i)
+	h[i].setBits ((unsigned short) i);
+
+    checkHalfToFloat (h, 0, h.size());
+
+    for (size_t n = 0; n < 40; ++n)
+	for (size_t first = 0; first < 3; ++first)
+	    checkHalfToFloat (h, 0x7bf0 + first, n);
+
+    //
+    // For every half, the float with the same value, its neighbors,
+    // and the floats around the midpoint to the next larger half;
+    // this covers all rounding cases, including overflows to
+    // infinity and the boundary between normalized and
+    // denormalized halfs.
+    //
+
+    vector<float> f;
+
+    for (size_t i = 0; i < h.size(); ++i)
+    {
+	if (h[i].isNan() || h[i].isInfinity())
+	    continue;
+
+	unsigned int b = floatBits (float (h[i]));
+	unsigned int next = floatBits (float (h[i]) * 2.0f);
+
+	if ((i & 0x7fff) < 0x7bff)
+	{
+	    half hn;
+	    hn.setBits ((unsigned short) (i + 1));
+	    next = floatBits (float (hn));
+	}
+
+	unsigned int mid = b + (next - b) / 2;
+
+	f.push_back (bitsToFloat (b));
+	f.push_back (bitsToFloat (b + 1));
+	f.push_back (bitsToFloat (b - 1));
+	f.push_back (bitsToFloat (mid - 1));
+	f.push_back (bitsToFloat (mid));
+	f.push_back (bitsToFloat (mid + 1));
+    }
+
+    //
+    // Special values and random bit patterns
+    //
+
+    f.push_back (bitsToFloat (0x7f800000));	// +infinity
+    f.push_back (bitsToFloat (0xff800000));	// -infinity
+    f.push_back (bitsToFloat (0x7fc00000));	// quiet NAN
+    f.push_back (bitsToFloat (0x7f800001));	// signaling NANs
+    f.push_back (bitsToFloat (0xff801fff));
+    f.push_back (bitsToFloat (0x00000001));	// float denormals
+    f.push_back (bitsToFloat (0x807fffff));
+    f.push_back (bitsToFloat (0x7f7fffff));	// largest float
+
+    srand (1);
+
+    for (int i = 0; i < 1000000; ++i)
+	f.push_back (bitsToFloat (((unsigned int) rand() << 16) ^ rand()));
+
+    checkFloatToHalf (f, 0, f.size());
+
+    for (size_t n = 0; n < 40; ++n)
+	for (size_t first = 0; first < 3; ++first)
+	    checkFloatToHalf (f, first, n);
+
+    sprinkleNans (f);
+    checkFloatToHalf (f, 0, f.size());
+
+    cout << "ok\n\n" << flush;
+}
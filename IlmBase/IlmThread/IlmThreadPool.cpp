@@ -44,10 +44,13 @@
 #include "IlmThreadPool.h"
 #include "Iex.h"
 #include <vector>
+#include <algorithm>
 #ifndef ILMBASE_FORCE_CXX03
 # include <memory>
 # include <atomic>
 # include <thread>
+# include <deque>
+# include <cstdint>
 #endif
 
 using namespace std;
@@ -65,10 +68,13 @@ struct TaskGroup::Data
     
     void    addTask () ;
     void    removeTask ();
+    int     pending ();
 #ifndef ILMBASE_FORCE_CXX03
     std::atomic<int> numPending;
+    std::atomic<ThreadPool::Data *> pool;
 #else
     int              numPending;     // number of pending tasks to still execute
+    ThreadPool::Data *pool;          // the pool the tasks were added to
 #endif
     Semaphore        isEmpty;        // used to signal that the taskgroup is empty
 #if defined(ENABLE_SEM_DTOR_WORKAROUND) || defined(ILMBASE_FORCE_CXX03)
@@ -159,12 +165,32 @@ struct ThreadPool::Data
     std::atomic<ThreadPoolProvider *> provider;
     std::atomic<int> provUsers;
 #endif
+
+    ProviderType type;              // provider to create for threads > 0
 };
 
 
 
 namespace {
 
+//
+// Execute a task, then mark it as finished in its task group.
+// This is how worker threads, and threads that help while they
+// wait for a task group, run tasks.
+//
+
+void
+runTask (Task *task)
+{
+    TaskGroup* taskGroup = task->group();
+    task->execute();
+
+    delete task;
+
+    taskGroup->_data->removeTask ();
+}
+
+
 class DefaultWorkerThread;
 
 struct DefaultWorkData
@@ -258,12 +284,7 @@ DefaultWorkerThread::run ()
                 _data->tasks.pop_back();
                 taskLock.release();
 
-                TaskGroup* taskGroup = task->group();
-                task->execute();
-
-                delete task;
-
-                taskGroup->_data->removeTask ();
+                runTask (task);
             }
             else if (_data->stopped())
             {
@@ -286,6 +307,7 @@ class DefaultThreadPoolProvider : public ThreadPoolProvider
     virtual int numThreads() const;
     virtual void setNumThreads(int count);
     virtual void addTask(Task *task);
+    virtual bool runPendingTask();
 
     virtual void finish();
 
@@ -295,6 +317,10 @@ class DefaultThreadPoolProvider : public ThreadPoolProvider
 
 DefaultThreadPoolProvider::DefaultThreadPoolProvider (int count)
 {
+#ifndef ILMBASE_FORCE_CXX03
+    _data.hasThreads = false;
+#endif
+    _data.stopping = false;
     setNumThreads(count);
 }
 
@@ -387,14 +413,46 @@ DefaultThreadPoolProvider::addTask (Task *task)
     }
     else
     {
-        // this path shouldn't normally happen since we have the
-        // NullThreadPoolProvider, but just in case...
-        task->execute ();
-        task->group()->_data->removeTask ();
-        delete task;
+        //
+        // Without worker threads, the calling thread runs the task
+        //
+
+        runTask (task);
     }
 }
 
+bool
+DefaultThreadPoolProvider::runPendingTask ()
+{
+    //
+    // Claim one of the semaphore's posts, so that the worker
+    // threads and the caller agree on the number of queued tasks.
+    //
+
+    if (!_data.taskSemaphore.tryWait())
+        return false;
+
+    Lock taskLock (_data.taskMutex);
+
+    if (_data.tasks.empty())
+    {
+        //
+        // The post was meant to stop a worker thread; give it back.
+        //
+
+        taskLock.release();
+        _data.taskSemaphore.post();
+        return false;
+    }
+
+    Task* task = _data.tasks.back();
+    _data.tasks.pop_back();
+    taskLock.release();
+
+    runTask (task);
+    return true;
+}
+
 void
 DefaultThreadPoolProvider::finish ()
 {
@@ -436,21 +494,541 @@ DefaultThreadPoolProvider::finish ()
 }
 
 
-class NullThreadPoolProvider : public ThreadPoolProvider
+
+#ifndef ILMBASE_FORCE_CXX03
+
+//
+// class TaskDeque -- a work-stealing deque, as described in
+// "Dynamic Circular Work-Stealing Deque" (Chase and Lev, 2005),
+// with the memory orderings from "Correct and Efficient Work-
+// Stealing for Weak Memory Models" (Le et al., 2013).
+//
+// Only the thread that owns the deque may call push() and pop(),
+// which operate on the bottom end.  Any thread may call steal(),
+// which takes the oldest task from the top end without locking.
+// Rings that are outgrown are kept until the deque is destroyed,
+// because a concurrent steal() may still be reading from them.
+//
+
+class TaskDeque
 {
-    virtual ~NullThreadPoolProvider() {}
-    virtual int numThreads () const { return 0; }
-    virtual void setNumThreads (int count)
+  public:
+
+     TaskDeque ();
+    ~TaskDeque ();
+
+    void	push (Task *task);
+    Task *	pop ();
+    Task *	steal ();
+
+  private:
+
+    struct Ring
     {
+        Ring (int64_t n): mask (n - 1), slots (new std::atomic<Task *>[n]) {}
+        ~Ring () {delete [] slots;}
+
+        int64_t size () const {return mask + 1;}
+
+        Task *get (int64_t i) const
+        {
+            return slots[i & mask].load (std::memory_order_relaxed);
+        }
+
+        void put (int64_t i, Task *task)
+        {
+            slots[i & mask].store (task, std::memory_order_relaxed);
+        }
+
+        int64_t			mask;
+        std::atomic<Task *> *	slots;
+    };
+
+    std::atomic<int64_t>	_top;
+    std::atomic<int64_t>	_bottom;
+    std::atomic<Ring *>		_ring;
+    vector<Ring *>		_retired;
+};
+
+
+TaskDeque::TaskDeque (): _top (0), _bottom (0), _ring (new Ring (64))
+{
+    // empty
+}
+
+
+TaskDeque::~TaskDeque ()
+{
+    delete _ring.load (std::memory_order_relaxed);
+
+    for (size_t i = 0; i < _retired.size(); ++i)
+        delete _retired[i];
+}
+
+
+void
+TaskDeque::push (Task *task)
+{
+    int64_t b = _bottom.load (std::memory_order_relaxed);
+    int64_t t = _top.load (std::memory_order_acquire);
+    Ring *r = _ring.load (std::memory_order_relaxed);
+
+    if (b - t > r->size() - 1)
+    {
+        //
+        // The ring is full; copy the live range into one
+        // that is twice as large.
+        //
+
+        Ring *bigger = new Ring (2 * r->size());
+
+        for (int64_t i = t; i < b; ++i)
+            bigger->put (i, r->get (i));
+
+        _retired.push_back (r);
+        _ring.store (bigger, std::memory_order_release);
+        r = bigger;
+    }
+
+    r->put (b, task);
+    std::atomic_thread_fence (std::memory_order_release);
+    _bottom.store (b + 1, std::memory_order_relaxed);
+}
+
+
+Task *
+TaskDeque::pop ()
+{
+    int64_t b = _bottom.load (std::memory_order_relaxed) - 1;
+    Ring *r = _ring.load (std::memory_order_relaxed);
+    _bottom.store (b, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+    int64_t t = _top.load (std::memory_order_relaxed);
+
+    Task *task = 0;
+
+    if (t <= b)
+    {
+        task = r->get (b);
+
+        if (t == b)
+        {
+            //
+            // This is the last task in the deque; race
+            // against the thieves for it.
+            //
+
+            if (!_top.compare_exchange_strong (t, t + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed))
+            {
+                task = 0;
+            }
+
+            _bottom.store (b + 1, std::memory_order_relaxed);
+        }
     }
-    virtual void addTask (Task *t)
+    else
     {
-        t->execute ();
-        t->group()->_data->removeTask ();
-        delete t;
+        _bottom.store (b + 1, std::memory_order_relaxed);
     }
-    virtual void finish () {}
-}; 
+
+    return task;
+}
+
+
+Task *
+TaskDeque::steal ()
+{
+    int64_t t = _top.load (std::memory_order_acquire);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+    int64_t b = _bottom.load (std::memory_order_acquire);
+
+    if (t >= b)
+        return 0;
+
+    Ring *r = _ring.load (std::memory_order_acquire);
+    Task *task = r->get (t);
+
+    if (!_top.compare_exchange_strong (t, t + 1,
+                                       std::memory_order_seq_cst,
+                                       std::memory_order_relaxed))
+    {
+        //
+        // Another thread took the task first.
+        //
+
+        return 0;
+    }
+
+    return task;
+}
+
+
+class StealingWorkerThread;
+
+struct StealingWorkData
+{
+    Semaphore taskSemaphore;        // posted once for every task added
+    Mutex queueMutex;               // mutual exclusion for the queue
+    std::deque<Task*> queue;        // tasks not yet taken by a worker
+
+    Semaphore threadSemaphore;      // signaled when a thread starts executing
+    mutable Mutex threadMutex;      // mutual exclusion for threads list
+    vector<StealingWorkerThread*> threads;  // the list of all threads
+    vector<TaskDeque*> deques;      // one deque per thread
+
+    std::atomic<bool> hasThreads;
+    std::atomic<bool> stopping;
+
+    //
+    // Find a task for worker thread number self; a thread
+    // that is not one of the workers passes deques.size().
+    //
+
+    Task *	findTask (size_t self);
+
+    inline bool stopped () const
+    {
+        return stopping.load( std::memory_order_relaxed );
+    }
+
+    inline void stop ()
+    {
+        stopping = true;
+    }
+};
+
+
+Task *
+StealingWorkData::findTask (size_t self)
+{
+    //
+    // Look for a task in our own deque first, then in the queue
+    // of newly added tasks, and finally in the other workers'
+    // deques.
+    //
+
+    TaskDeque *own = self < deques.size() ? deques[self] : 0;
+
+    if (own)
+    {
+        if (Task *task = own->pop())
+            return task;
+    }
+
+    {
+        Lock queueLock (queueMutex);
+
+        if (!queue.empty())
+        {
+            //
+            // Take the oldest task, plus our share of the ones
+            // behind it so that the other workers can steal them
+            // from us instead of contending for the queue lock.
+            // The batch is pushed in reverse so that we pop it
+            // in the order in which it was added.
+            //
+
+            Task *task = queue.front();
+            queue.pop_front();
+
+            size_t batch = 0;
+
+            if (own)
+                batch = min (queue.size() / deques.size(), size_t (16));
+
+            for (size_t i = batch; i > 0; --i)
+                own->push (queue[i - 1]);
+
+            queue.erase (queue.begin(), queue.begin() + batch);
+            return task;
+        }
+    }
+
+    for (size_t i = 0; i < deques.size(); ++i)
+    {
+        size_t victim = (self + 1 + i) % deques.size();
+
+        if (victim == self)
+            continue;
+
+        if (Task *task = deques[victim]->steal())
+            return task;
+    }
+
+    return 0;
+}
+
+
+//
+// class StealingWorkerThread
+//
+class StealingWorkerThread: public Thread
+{
+  public:
+
+    StealingWorkerThread (StealingWorkData* data, size_t index);
+
+    virtual void    run ();
+    
+  private:
+
+    StealingWorkData *  _data;
+    size_t              _index;
+};
+
+
+StealingWorkerThread::StealingWorkerThread (StealingWorkData* data,
+                                            size_t index):
+    _data (data),
+    _index (index)
+{
+    start();
+}
+
+
+void
+StealingWorkerThread::run ()
+{
+    //
+    // Signal that the thread has started executing
+    //
+
+    _data->threadSemaphore.post();
+
+    while (true)
+    {
+        //
+        // Wait for a task to become available
+        //
+
+        _data->taskSemaphore.wait();
+
+        //
+        // The semaphore is posted once per task, so a task is
+        // reserved for us.  It may not be visible yet, though,
+        // if another worker is moving it into its deque or if
+        // we lost a race to steal it; in that case, retry.
+        //
+
+        Task *task;
+
+        while ((task = _data->findTask (_index)) == 0)
+        {
+            if (_data->stopped())
+                return;
+
+            std::this_thread::yield();
+        }
+
+        runTask (task);
+    }
+}
+
+
+//
+// class WorkStealingThreadPoolProvider
+//
+class WorkStealingThreadPoolProvider : public ThreadPoolProvider
+{
+  public:
+    WorkStealingThreadPoolProvider(int count);
+    virtual ~WorkStealingThreadPoolProvider();
+
+    virtual int numThreads() const;
+    virtual void setNumThreads(int count);
+    virtual void addTask(Task *task);
+    virtual void addTasks(Task* const tasks[], int numTasks);
+    virtual bool runPendingTask();
+
+    virtual void finish();
+
+  private:
+    StealingWorkData _data;
+};
+
+WorkStealingThreadPoolProvider::WorkStealingThreadPoolProvider (int count)
+{
+    _data.hasThreads = false;
+    _data.stopping = false;
+    setNumThreads(count);
+}
+
+WorkStealingThreadPoolProvider::~WorkStealingThreadPoolProvider ()
+{
+    finish();
+}
+
+int
+WorkStealingThreadPoolProvider::numThreads () const
+{
+    Lock lock (_data.threadMutex);
+    return static_cast<int> (_data.threads.size());
+}
+
+void
+WorkStealingThreadPoolProvider::setNumThreads (int count)
+{
+    //
+    // Lock access to thread list and size
+    //
+
+    Lock lock (_data.threadMutex);
+
+    size_t desired = static_cast<size_t>(count);
+    if (desired == _data.threads.size())
+        return;
+
+    //
+    // The workers look at each other's deques, so the set
+    // of threads cannot change while they are running.  Wait
+    // until all existing threads are finished processing,
+    // then start the new set of threads.
+    //
+
+    finish ();
+
+    for (size_t i = 0; i < desired; ++i)
+        _data.deques.push_back (new TaskDeque);
+
+    for (size_t i = 0; i < desired; ++i)
+        _data.threads.push_back (new StealingWorkerThread (&_data, i));
+
+    _data.hasThreads = !(_data.threads.empty());
+}
+
+void
+WorkStealingThreadPoolProvider::addTask (Task *task)
+{
+    addTasks (&task, 1);
+}
+
+void
+WorkStealingThreadPoolProvider::addTasks (Task* const tasks[], int numTasks)
+{
+    if (_data.hasThreads.load( std::memory_order_relaxed ))
+    {
+        //
+        // Queue all the tasks under a single lock, then wake
+        // up a worker for each of them.
+        //
+
+        {
+            Lock queueLock (_data.queueMutex);
+            _data.queue.insert (_data.queue.end(), tasks, tasks + numTasks);
+        }
+
+        for (int i = 0; i < numTasks; ++i)
+            _data.taskSemaphore.post ();
+    }
+    else
+    {
+        //
+        // Without worker threads, the calling thread runs the tasks
+        //
+
+        for (int i = 0; i < numTasks; ++i)
+            runTask (tasks[i]);
+    }
+}
+
+bool
+WorkStealingThreadPoolProvider::runPendingTask ()
+{
+    //
+    // As in the worker threads, claim a post before taking a task.
+    // If none is visible (it may be on its way into a worker's
+    // deque), give the post back rather than spinning.
+    //
+
+    if (!_data.taskSemaphore.tryWait())
+        return false;
+
+    Task *task = _data.findTask (_data.deques.size());
+
+    if (task == 0)
+    {
+        _data.taskSemaphore.post();
+        return false;
+    }
+
+    runTask (task);
+    return true;
+}
+
+void
+WorkStealingThreadPoolProvider::finish ()
+{
+    _data.stop();
+
+    //
+    // Signal enough times to allow all threads to stop.  A worker
+    // only stops when it cannot find any task, so the tasks that
+    // are still queued are executed first.
+    //
+    // Wait until all threads have started their run functions
+    // (see DefaultThreadPoolProvider::finish()).
+    //
+
+    size_t curT = _data.threads.size();
+    for (size_t i = 0; i != curT; ++i)
+    {
+        _data.taskSemaphore.post();
+        _data.threadSemaphore.wait();
+    }
+
+    //
+    // Join all the threads
+    //
+    for (size_t i = 0; i != curT; ++i)
+        delete _data.threads[i];
+
+    for (size_t i = 0; i != curT; ++i)
+        delete _data.deques[i];
+
+    //
+    // Drain the posts that were not consumed because
+    // a worker stopped while other tasks were running.
+    //
+
+    while (_data.taskSemaphore.tryWait())
+        ;
+
+    Lock queueLock (_data.queueMutex);
+    _data.threads.clear();
+    _data.deques.clear();
+    _data.queue.clear();
+
+    _data.hasThreads = false;
+    _data.stopping = false;
+}
+
+#endif
+
+
+ThreadPoolProvider *
+newThreadPoolProvider (ThreadPool::ProviderType type, int count)
+{
+#ifndef ILMBASE_FORCE_CXX03
+    if (type == ThreadPool::WORK_STEALING_PROVIDER)
+        return new WorkStealingThreadPoolProvider (count);
+#endif
+
+    return new DefaultThreadPoolProvider (count);
+}
+
+
+bool
+isBuiltInProvider (ThreadPoolProvider *p, ThreadPool::ProviderType type)
+{
+#ifndef ILMBASE_FORCE_CXX03
+    if (type == ThreadPool::WORK_STEALING_PROVIDER)
+        return dynamic_cast<WorkStealingThreadPoolProvider *> (p) != 0;
+#endif
+
+    return dynamic_cast<DefaultThreadPoolProvider *> (p) != 0;
+}
 
 } //namespace
 
@@ -459,7 +1037,7 @@ class NullThreadPoolProvider : public ThreadPoolProvider
 // struct TaskGroup::Data
 //
 
-TaskGroup::Data::Data (): isEmpty (1), numPending (0)
+TaskGroup::Data::Data (): isEmpty (1), numPending (0), pool (0)
 {
     // empty
 }
@@ -472,6 +1050,23 @@ TaskGroup::Data::~Data ()
     // is above 0 then waiting on the taskgroup will block.  This
     // destructor waits until the taskgroup is empty before returning.
     //
+    // Rather than block right away, run the tasks that are still
+    // queued in the thread pool; only when there are none left
+    // (the remaining tasks of this group are being executed by
+    // worker threads) wait for the group to become empty.
+    //
+
+#ifdef ILMBASE_FORCE_CXX03
+    ThreadPool::Data *p = pool;
+#else
+    ThreadPool::Data *p = pool.load (std::memory_order_relaxed);
+#endif
+
+    if (p)
+    {
+        while (pending() > 0 && p->getProvider()->runPendingTask())
+            ;
+    }
 
     isEmpty.wait ();
 
@@ -509,6 +1104,16 @@ TaskGroup::Data::addTask ()
 }
 
 
+int
+TaskGroup::Data::pending ()
+{
+#ifdef ILMBASE_FORCE_CXX03
+    Lock lock (dtorMutex);
+#endif
+    return numPending;
+}
+
+
 void
 TaskGroup::Data::removeTask ()
 {
@@ -557,6 +1162,7 @@ ThreadPool::Data::Data ():
     , oldprovider (NULL)
 #else
 #endif
+    , type (DEFAULT_PROVIDER)
 {
     // empty
 }
@@ -747,6 +1353,21 @@ ThreadPoolProvider::~ThreadPoolProvider()
 }
 
 
+void
+ThreadPoolProvider::addTasks (Task* const tasks[], int numTasks)
+{
+    for (int i = 0; i < numTasks; ++i)
+        addTask (tasks[i]);
+}
+
+
+bool
+ThreadPoolProvider::runPendingTask ()
+{
+    return false;
+}
+
+
 //
 // class ThreadPool
 //
@@ -754,10 +1375,7 @@ ThreadPoolProvider::~ThreadPoolProvider()
 ThreadPool::ThreadPool (unsigned nthreads):
     _data (new Data)
 {
-    if ( nthreads == 0 )
-        _data->setProvider( new NullThreadPoolProvider );
-    else
-        _data->setProvider( new DefaultThreadPoolProvider( int(nthreads) ) );
+    _data->setProvider( newThreadPoolProvider( _data->type, int(nthreads) ) );
 }
 
 
@@ -781,36 +1399,15 @@ ThreadPool::setNumThreads (int count)
         throw IEX_INTERNAL_NAMESPACE::ArgExc ("Attempt to set the number of threads "
                "in a thread pool to a negative value.");
 
-    bool doReset = false;
-    {
-        Data::SafeProvider sp = _data->getProvider ();
-        int curT = sp->numThreads ();
-        if ( curT == count )
-            return;
+    //
+    // Both built-in providers handle a thread count of zero by
+    // running tasks in the thread that adds them.
+    //
 
-        if ( curT == 0 )
-        {
-            NullThreadPoolProvider *npp = dynamic_cast<NullThreadPoolProvider *>( sp.get() );
-            if ( npp )
-                doReset = true;
-        }
-        else if ( count == 0 )
-        {
-            DefaultThreadPoolProvider *dpp = dynamic_cast<DefaultThreadPoolProvider *>( sp.get() );
-            if ( dpp )
-                doReset = true;
-        }
-        if ( ! doReset )
-            sp->setNumThreads( count );
-    }
+    Data::SafeProvider sp = _data->getProvider ();
 
-    if ( doReset )
-    {
-        if ( count == 0 )
-            _data->setProvider( new NullThreadPoolProvider );
-        else
-            _data->setProvider( new DefaultThreadPoolProvider( count ) );
-    }
+    if ( sp->numThreads () != count )
+        sp->setNumThreads( count );
 }
 
 
@@ -821,13 +1418,59 @@ ThreadPool::setThreadProvider (ThreadPoolProvider *provider)
 }
 
 
+void
+ThreadPool::setProviderType (ProviderType type)
+{
+    _data->type = type;
+
+    int count;
+    {
+        Data::SafeProvider sp = _data->getProvider ();
+        count = sp->numThreads ();
+
+        if ( isBuiltInProvider( sp.get(), type ) )
+            return;
+    }
+
+    _data->setProvider( newThreadPoolProvider( type, count ) );
+}
+
+
+ThreadPool::ProviderType
+ThreadPool::providerType () const
+{
+    return _data->type;
+}
+
+
 void
 ThreadPool::addTask (Task* task) 
 {
+    //
+    // Remember the pool in the task's group, so that a thread
+    // waiting for the group can help run the pool's tasks.
+    //
+
+    if (task->group())
+        task->group()->_data->pool = _data;
+
     _data->getProvider ()->addTask (task);
 }
 
 
+void
+ThreadPool::addTasks (Task* const tasks[], int numTasks)
+{
+    for (int i = 0; i < numTasks; ++i)
+    {
+        if (tasks[i]->group())
+            tasks[i]->group()->_data->pool = _data;
+    }
+
+    _data->getProvider ()->addTasks (tasks, numTasks);
+}
+
+
 ThreadPool&
 ThreadPool::globalThreadPool ()
 {
@@ -848,4 +1491,11 @@ ThreadPool::addGlobalTask (Task* task)
 }
 
 
+void
+ThreadPool::addGlobalTasks (Task* const tasks[], int numTasks)
+{
+    globalThreadPool().addTasks (tasks, numTasks);
+}
+
+
 ILMTHREAD_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -51,7 +51,9 @@
 //	Class TaskGroup allows synchronization on the completion of a set
 //	of tasks.  Every task that is added to a ThreadPool belongs to a
 //	single TaskGroup.  The destructor of the TaskGroup waits for all
-//	tasks in the group to finish.
+//	tasks in the group to finish.  While it waits, the destructor
+//	runs tasks that are still queued in the thread pool, so the
+//	waiting thread helps the worker threads instead of sitting idle.
 //
 //	Note: if you plan to use the ThreadPool interface in your own
 //	applications note that the implementation of the ThreadPool calls
@@ -87,6 +89,16 @@ class ILMTHREAD_EXPORT ThreadPoolProvider
     virtual void setNumThreads (int count) = 0;
     // as in ThreadPool below
     virtual void addTask (Task* task) = 0;
+    // as in ThreadPool below; the default implementation
+    // calls addTask() for each task in turn
+    virtual void addTasks (Task* const tasks[], int numTasks);
+
+    // Run one queued task in the calling thread and return
+    // true, or return false if no task is waiting to be
+    // run.  TaskGroup calls this while it waits for its
+    // tasks to finish.  The default implementation returns
+    // false, in which case TaskGroup simply blocks.
+    virtual bool runPendingTask ();
 
     // Ensure that all tasks in this set are finished
     // and threads shutdown
@@ -151,6 +163,40 @@ class ILMTHREAD_EXPORT ThreadPool
     //--------------------------------------------------------
     void    setThreadProvider (ThreadPoolProvider *provider);
 
+    //--------------------------------------------------------
+    // Select one of the thread pool providers that come with
+    // IlmThread.
+    //
+    // DEFAULT_PROVIDER: all worker threads take their tasks
+    // from a single queue that is protected by a mutex.
+    //
+    // WORK_STEALING_PROVIDER: every worker thread owns a
+    // double-ended queue of tasks.  Idle workers take a batch
+    // of newly added tasks into their own queue, and steal
+    // tasks from the other workers' queues without locking
+    // once the shared queue is empty.  This reduces lock
+    // contention when many small tasks are added at once.
+    // (If IlmBase was built with ILMBASE_FORCE_CXX03, the
+    // default provider is used instead.)
+    //
+    // The selection replaces the current provider, including
+    // one that was installed with setThreadProvider().
+    //
+    // Warning: never call setProviderType from within a worker
+    // thread as this will almost certainly cause a deadlock
+    // or crash.
+    //--------------------------------------------------------
+
+    enum ProviderType
+    {
+	DEFAULT_PROVIDER,
+	WORK_STEALING_PROVIDER
+    };
+
+    void		setProviderType (ProviderType type);
+    ProviderType	providerType () const;
+
+
     //------------------------------------------------------------
     // Add a task for processing.  The ThreadPool can handle any
     // number of tasks regardless of the number of worker threads.
@@ -159,6 +205,16 @@ class ILMTHREAD_EXPORT ThreadPool
     //------------------------------------------------------------
 
     void addTask (Task* task);
+
+
+    //------------------------------------------------------------
+    // Add several tasks for processing in one operation.  This
+    // is equivalent to calling addTask() for each of the tasks,
+    // in order, but providers can queue the whole range at once
+    // instead of synchronizing once per task.
+    //------------------------------------------------------------
+
+    void addTasks (Task* const tasks[], int numTasks);
     
 
     //-------------------------------------------
@@ -167,6 +223,7 @@ class ILMTHREAD_EXPORT ThreadPool
     
     static ThreadPool&	globalThreadPool ();
     static void		addGlobalTask (Task* task);
+    static void		addGlobalTasks (Task* const tasks[], int numTasks);
 
     struct Data;
 
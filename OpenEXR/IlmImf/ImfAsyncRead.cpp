@@ -0,0 +1,232 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------
+//
+//	class AsyncRead
+//
+//-----------------------------------------------------------------------------
+
+#include "ImfAsyncReadData.h"
+#include "IlmThreadPool.h"
+#include "Iex.h"
+#include "ImfNamespace.h"
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+using ILMTHREAD_NAMESPACE::Mutex;
+using ILMTHREAD_NAMESPACE::Lock;
+using ILMTHREAD_NAMESPACE::TaskGroup;
+using std::string;
+
+
+AsyncRead::Data::Data (const string &fileName,
+                       AsyncRead::Callback callback,
+                       void *userData)
+:
+    taskGroup (new TaskGroup),
+    fileName (fileName),
+    callback (callback),
+    userData (userData),
+    refCount (0),
+    numPending (1),
+    complete (false),
+    hasException (false),
+    exception ()
+{
+    // empty
+}
+
+
+AsyncRead::Data::~Data ()
+{
+    waitForTasks();
+}
+
+
+void
+AsyncRead::Data::addTask ()
+{
+    Lock lock (mutex);
+    ++numPending;
+}
+
+
+void
+AsyncRead::Data::finishTask ()
+{
+    {
+        Lock lock (mutex);
+
+        if (--numPending > 0)
+            return;
+    }
+
+    //
+    // This was the last task for the read; call the completion
+    // callback without holding the mutex, so that the callback
+    // can look at the state of the read.
+    //
+
+    if (callback)
+        callback (userData);
+
+    Lock lock (mutex);
+    complete = true;
+}
+
+
+void
+AsyncRead::Data::setException (const string &what)
+{
+    Lock lock (mutex);
+
+    if (!hasException)
+    {
+        exception = what;
+        hasException = true;
+    }
+}
+
+
+void
+AsyncRead::Data::waitForTasks ()
+{
+    //
+    // The TaskGroup destructor waits for the tasks in the group.
+    //
+
+    Lock lock (waitMutex);
+    delete taskGroup;
+    taskGroup = 0;
+}
+
+
+AsyncRead::AsyncRead (): _data (0)
+{
+    // empty
+}
+
+
+AsyncRead::AsyncRead (Data *data): _data (data)
+{
+    Lock lock (_data->mutex);
+    ++_data->refCount;
+}
+
+
+AsyncRead::AsyncRead (const AsyncRead &other): _data (other._data)
+{
+    if (_data)
+    {
+        Lock lock (_data->mutex);
+        ++_data->refCount;
+    }
+}
+
+
+AsyncRead &
+AsyncRead::operator = (const AsyncRead &other)
+{
+    //
+    // Take a reference to the other read, and let the destructor
+    // of the copy release our reference to the current one.
+    //
+
+    AsyncRead copy (other);
+
+    Data *tmp = _data;
+    _data = copy._data;
+    copy._data = tmp;
+
+    return *this;
+}
+
+
+AsyncRead::~AsyncRead ()
+{
+    if (!_data)
+        return;
+
+    bool last;
+
+    {
+        Lock lock (_data->mutex);
+        last = (--_data->refCount == 0);
+    }
+
+    if (last)
+        delete _data;
+}
+
+
+bool
+AsyncRead::isComplete () const
+{
+    if (!_data)
+        return true;
+
+    Lock lock (_data->mutex);
+    return _data->complete;
+}
+
+
+void
+AsyncRead::wait ()
+{
+    if (!_data)
+        return;
+
+    _data->waitForTasks();
+
+    Lock lock (_data->mutex);
+
+    if (_data->hasException)
+    {
+        THROW (IEX_NAMESPACE::IoExc, "Error reading pixel data from image "
+                                     "file \"" << _data->fileName << "\". " <<
+                                     _data->exception);
+    }
+}
+
+
+AsyncRead::Data *
+AsyncRead::data () const
+{
+    return _data;
+}
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef INCLUDED_IMF_ASYNC_READ_H
+#define INCLUDED_IMF_ASYNC_READ_H
+
+//-----------------------------------------------------------------------------
+//
+//	class AsyncRead -- a handle for a pixel or tile read that
+//	runs in the background.
+//
+//	ScanLineInputFile::readPixelsAsync(), InputFile::readPixelsAsync()
+//	and TiledInputFile::readTilesAsync() hand the line or tile buffer
+//	tasks for a read to the file's thread pool and return immediately
+//	with an AsyncRead handle, instead of waiting until all tasks are
+//	done.  This way a single thread can keep many reads in flight,
+//	in one or in several files.
+//
+//	The handle can be used to wait for the read, to check whether
+//	the read is complete, and to be notified when the read completes:
+//
+//	    AsyncRead r = file.readPixelsAsync (y1, y2, callback, userData);
+//	    ...
+//	    if (!r.isComplete())
+//		...
+//	    r.wait();	// throws if the read failed
+//
+//	Copies of an AsyncRead refer to the same read.  When the last
+//	copy is destroyed, its destructor waits for the read to complete
+//	(without throwing).
+//
+//	While an asynchronous read is in flight, the memory that the
+//	file's frame buffer points to must not be modified by the
+//	application.  setFrameBuffer() and the file's destructor first
+//	wait until all earlier reads have written their data into the
+//	frame buffer, so it is safe to switch to a new frame buffer, or
+//	to destroy the file, while reads are in flight.
+//
+//-----------------------------------------------------------------------------
+
+#include "ImfNamespace.h"
+#include "ImfExport.h"
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
+
+
+class AsyncRead
+{
+  public:
+
+    //-----------------------------------------------------------------
+    // A completion callback is called exactly once per read, when all
+    // the data for the read have been written into the frame buffer,
+    // or when the read has failed.  The callback runs in the thread
+    // that finishes the read, usually a thread pool worker thread; if
+    // the file's thread pool has no worker threads, the callback runs
+    // before readPixelsAsync() or readTilesAsync() returns.
+    //
+    // The callback must not call wait() for the read that it reports,
+    // and it must not destroy the last AsyncRead that refers to that
+    // read.  Either would wait for the callback itself to return.
+    // Threads that wait for tasks run queued tasks in the meantime,
+    // so the callback may also run in a thread that is inside a
+    // read function of a file that uses the same thread pool; keep
+    // the callback short, and do not read from files in it.
+    //-----------------------------------------------------------------
+
+    typedef void (*Callback) (void *userData);
+
+
+    //-----------------------------------------------------------------
+    // Constructor -- the default constructor creates a handle for a
+    // read that has already completed successfully.
+    //-----------------------------------------------------------------
+
+    IMF_EXPORT
+    AsyncRead ();
+
+    IMF_EXPORT
+    AsyncRead (const AsyncRead &other);
+
+    IMF_EXPORT
+    AsyncRead &		operator = (const AsyncRead &other);
+
+
+    //-----------------------------------------------------------------
+    // Destructor -- if this is the last handle for the read, waits
+    // until the read is complete.  Errors are not reported.
+    //-----------------------------------------------------------------
+
+    IMF_EXPORT
+    ~AsyncRead ();
+
+
+    //-----------------------------------------------------------------
+    // isComplete() returns true if all the data for the read have
+    // been written into the frame buffer (or the read has failed),
+    // and the completion callback, if any, has returned.
+    //-----------------------------------------------------------------
+
+    IMF_EXPORT
+    bool		isComplete () const;
+
+
+    //-----------------------------------------------------------------
+    // wait() blocks until the read is complete.  While it waits, the
+    // calling thread runs queued tasks from the file's thread pool.
+    // If the read failed, wait() throws an IEX_NAMESPACE::IoExc that
+    // describes the first error that occurred.
+    //-----------------------------------------------------------------
+
+    IMF_EXPORT
+    void		wait ();
+
+
+    struct Data;
+
+    IMF_EXPORT
+    explicit AsyncRead (Data *data);
+
+    IMF_EXPORT
+    Data *		data () const;
+
+  private:
+
+    Data *		_data;
+};
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif
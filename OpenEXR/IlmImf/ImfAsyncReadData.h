@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef INCLUDED_IMF_ASYNC_READ_DATA_H
+#define INCLUDED_IMF_ASYNC_READ_DATA_H
+
+//-----------------------------------------------------------------------------
+//
+//	struct AsyncRead::Data -- the state of an asynchronous read,
+//	shared by the AsyncRead handles for the read and by the line
+//	or tile buffer tasks that carry it out.
+//
+//	The file that starts the read creates one Data object, calls
+//	addTask() for every task it creates, and calls finishTask()
+//	once when all tasks have been handed to the thread pool.  Every
+//	task calls finishTask() when it is destroyed.  The completion
+//	callback is called when the last of those calls has returned.
+//
+//-----------------------------------------------------------------------------
+
+#include "ImfAsyncRead.h"
+#include "ImfNamespace.h"
+#include "IlmThreadMutex.h"
+#include "IlmThreadForward.h"
+#include <string>
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
+
+
+struct AsyncRead::Data
+{
+    Data (const std::string &fileName,
+          AsyncRead::Callback callback,
+          void *userData);
+
+    ~Data ();
+
+    ILMTHREAD_NAMESPACE::TaskGroup *	taskGroup;
+    std::string				fileName;
+    AsyncRead::Callback			callback;
+    void *				userData;
+
+    mutable ILMTHREAD_NAMESPACE::Mutex	mutex;
+    int					refCount;
+    int					numPending;
+    bool				complete;
+    bool				hasException;
+    std::string				exception;
+
+    ILMTHREAD_NAMESPACE::Mutex		waitMutex;
+
+
+    //-------------------------------------------------------------
+    // addTask() must be called before a task for this read is
+    // handed to the thread pool; finishTask() is called by the
+    // task's destructor, after the task has released its line
+    // or tile buffer.
+    //-------------------------------------------------------------
+
+    void		addTask ();
+    void		finishTask ();
+
+
+    //-------------------------------------------------------------
+    // setException() records an error; only the first error
+    // for the read is kept.
+    //-------------------------------------------------------------
+
+    void		setException (const std::string &what);
+
+
+    //-------------------------------------------------------------
+    // waitForTasks() blocks until all tasks for the read have
+    // finished.  It does not report errors.
+    //-------------------------------------------------------------
+
+    void		waitForTasks ();
+};
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif
@@ -102,6 +102,9 @@
 #include "ImfChannelList.h"
 #include "ImfMisc.h"
 #include "ImfCheckedArithmetic.h"
+#include "ImfPixelCopySimd.h"
+#include "ImfSimd.h"
+#include "OpenEXRConfig.h"
 #include <ImathFun.h>
 #include <ImathBox.h>
 #include <Iex.h>
@@ -112,6 +115,19 @@
 #include <algorithm>
 #include "ImfNamespace.h"
 
+//
+// The AVX2 block packing and unpacking kernels are compiled with
+// GCC style target attributes, like the kernels in ImfPixelCopySimd.cpp,
+// and selected at run time according to simdLevel().
+//
+
+#if defined (IMF_HAVE_SSE2) && \
+    defined (OPENEXR_IMF_HAVE_GCC_INLINE_ASM_AVX) && \
+    defined (OPENEXR_IMF_HAVE_GCC_TARGET_AVX512)
+    #define IMF_HAVE_B44_WIDE_KERNELS 1
+    #include <immintrin.h>
+#endif
+
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
 
@@ -172,6 +188,49 @@ shiftAndRound (int x, int shift)
 }
 
 
+void
+runningDifferences (const int d[16], int r[15])
+{
+    //
+    // Running differences between the shifted absolute
+    // differences, d[0] ... d[15], biased so that they end
+    // up between 0 and 63 if the shift value is large enough.
+    //
+
+    const int bias = 0x20;
+
+    r[ 0] = d[ 0] - d[ 4] + bias;
+    r[ 1] = d[ 4] - d[ 8] + bias;
+    r[ 2] = d[ 8] - d[12] + bias;
+
+    r[ 3] = d[ 0] - d[ 1] + bias;
+    r[ 4] = d[ 4] - d[ 5] + bias;
+    r[ 5] = d[ 8] - d[ 9] + bias;
+    r[ 6] = d[12] - d[13] + bias;
+
+    r[ 7] = d[ 1] - d[ 2] + bias;
+    r[ 8] = d[ 5] - d[ 6] + bias;
+    r[ 9] = d[ 9] - d[10] + bias;
+    r[10] = d[13] - d[14] + bias;
+
+    r[11] = d[ 2] - d[ 3] + bias;
+    r[12] = d[ 6] - d[ 7] + bias;
+    r[13] = d[10] - d[11] + bias;
+    r[14] = d[14] - d[15] + bias;
+}
+
+
+int
+packDifferences (unsigned short t0,
+                 unsigned short tMax,
+                 int shift,
+                 const int d[16],
+                 const int r[15],
+                 unsigned char b[14],
+                 bool optFlatFields,
+                 bool exactMax);
+
+
 int
 pack (const unsigned short s[16],
       unsigned char b[14],
@@ -280,24 +339,7 @@ pack (const unsigned short s[16],
         // Convert d[0] .. d[15] into running differences
         //
 
-        r[ 0] = d[ 0] - d[ 4] + bias;
-        r[ 1] = d[ 4] - d[ 8] + bias;
-        r[ 2] = d[ 8] - d[12] + bias;
-
-        r[ 3] = d[ 0] - d[ 1] + bias;
-        r[ 4] = d[ 4] - d[ 5] + bias;
-        r[ 5] = d[ 8] - d[ 9] + bias;
-        r[ 6] = d[12] - d[13] + bias;
-
-        r[ 7] = d[ 1] - d[ 2] + bias;
-        r[ 8] = d[ 5] - d[ 6] + bias;
-        r[ 9] = d[ 9] - d[10] + bias;
-        r[10] = d[13] - d[14] + bias;
-
-        r[11] = d[ 2] - d[ 3] + bias;
-        r[12] = d[ 6] - d[ 7] + bias;
-        r[13] = d[10] - d[11] + bias;
-        r[14] = d[14] - d[15] + bias;
+        runningDifferences (d, r);
 
         rMin = r[0];
         rMax = r[0];
@@ -313,7 +355,34 @@ pack (const unsigned short s[16],
     }
     while (rMin < 0 || rMax > 0x3f);
 
-    if (rMin == bias && rMax == bias && optFlatFields)
+    return packDifferences (t[0], tMax, shift, d, r,
+                            b, optFlatFields, exactMax);
+}
+
+
+int
+packDifferences (unsigned short t0,
+                 unsigned short tMax,
+                 int shift,
+                 const int d[16],
+                 const int r[15],
+                 unsigned char b[14],
+                 bool optFlatFields,
+                 bool exactMax)
+{
+    //
+    // Store a block, given the shift value, the shifted absolute
+    // differences, d[0] ... d[15], and the biased running differences,
+    // r[0] ... r[14], that pack() has computed.
+    //
+
+    bool flat = true;
+
+    for (int i = 0; i < 15; ++i)
+        if (r[i] != 0x20)
+            flat = false;
+
+    if (flat && optFlatFields)
     {
         //
         // Special case - all pixels have the same value.
@@ -322,8 +391,8 @@ pack (const unsigned short s[16],
         // which cannot occur in the 14-byte encoding.
         //
 
-        b[0] = (t[0] >> 8);
-        b[1] = (unsigned char) t[0];
+        b[0] = (t0 >> 8);
+        b[1] = (unsigned char) t0;
         b[2] = 0xfc;
 
         return 3;
@@ -336,15 +405,15 @@ pack (const unsigned short s[16],
         // to tMax gets represented as accurately as possible.
         //
 
-        t[0] = tMax - (d[0] << shift);
+        t0 = tMax - (d[0] << shift);
     }
 
     //
     // Pack t[0], shift and r[0] ... r[14] into 14 bytes:
     //
 
-    b[ 0] = (t[0] >> 8);
-    b[ 1] = (unsigned char) t[0];
+    b[ 0] = (t0 >> 8);
+    b[ 1] = (unsigned char) t0;
 
     b[ 2] = (unsigned char) ((shift << 2) | (r[ 0] >> 4));
     b[ 3] = (unsigned char) ((r[ 0] << 4) | (r[ 1] >> 2));
@@ -436,6 +505,238 @@ unpack3 (const unsigned char b[3], unsigned short s[16])
 }
 
 
+typedef int (*PackFunc) (const unsigned short s[16],
+                         unsigned char b[14],
+                         bool optFlatFields,
+                         bool exactMax);
+
+
+#ifdef IMF_HAVE_B44_WIDE_KERNELS
+
+__attribute__((target("avx2")))
+int
+packAvx2 (const unsigned short s[16],
+          unsigned char b[14],
+          bool optFlatFields,
+          bool exactMax)
+{
+    //
+    // Same as pack(), above, but with all 16 pixels of the block
+    // held in vector registers: the absolute differences for each
+    // shift value are computed with one row of the block in each
+    // 128-bit lane, and all 15 running differences are range-checked
+    // at once.  The block is stored by packDifferences(), so that
+    // the output is identical to that of pack().
+    //
+
+    __m256i sv = _mm256_loadu_si256 ((const __m256i *) s);
+
+    //
+    // Convert s[i] to t[i] and replace NaNs and infinities with zeroes.
+    //
+
+    __m256i sign = _mm256_set1_epi16 ((short) 0x8000);
+    __m256i expMask = _mm256_set1_epi16 (0x7c00);
+    __m256i special = _mm256_cmpeq_epi16 (_mm256_and_si256 (sv, expMask),
+                                          expMask);
+    __m256i neg = _mm256_srai_epi16 (sv, 15);
+
+    __m256i t = _mm256_or_si256 (_mm256_xor_si256 (sv, neg),
+                                 _mm256_andnot_si256 (neg, sign));
+
+    t = _mm256_or_si256 (_mm256_andnot_si256 (special, t),
+                         _mm256_and_si256 (special, sign));
+
+    //
+    // Find tMax; _mm_minpos_epu16() on the complement of t
+    // finds the maximum.
+    //
+
+    __m128i m = _mm_max_epu16 (_mm256_castsi256_si128 (t),
+                               _mm256_extracti128_si256 (t, 1));
+
+    m = _mm_minpos_epu16 (_mm_xor_si128 (m, _mm_set1_epi16 (-1)));
+
+    unsigned short tMax = (unsigned short) ~_mm_cvtsi128_si32 (m);
+    unsigned short t0 = (unsigned short) _mm256_extract_epi16 (t, 0);
+
+    //
+    // 2 * (tMax - t[i]) as 32-bit integers, rows 0 and 1
+    // of the block in x01, rows 2 and 3 in x23.
+    //
+
+    __m256i tMaxv = _mm256_set1_epi32 (tMax);
+
+    __m256i x01 = _mm256_slli_epi32
+        (_mm256_sub_epi32 (tMaxv, _mm256_cvtepu16_epi32
+                                    (_mm256_castsi256_si128 (t))), 1);
+
+    __m256i x23 = _mm256_slli_epi32
+        (_mm256_sub_epi32 (tMaxv, _mm256_cvtepu16_epi32
+                                    (_mm256_extracti128_si256 (t, 1))), 1);
+
+    //
+    // Out-of-range masks: horizontal differences are checked in
+    // columns 0 to 2 of every row, vertical differences only in
+    // column 0 and only between rows 0-1, 1-2 and 2-3.
+    //
+
+    const __m256i hMask = _mm256_setr_epi32 (~0x3f, ~0x3f, ~0x3f, 0,
+                                             ~0x3f, ~0x3f, ~0x3f, 0);
+
+    const __m256i v01Mask = _mm256_setr_epi32 (~0x3f, 0, 0, 0,
+                                               ~0x3f, 0, 0, 0);
+
+    const __m256i v23Mask = _mm256_setr_epi32 (~0x3f, 0, 0, 0,
+                                               0, 0, 0, 0);
+
+    const __m256i bias = _mm256_set1_epi32 (0x20);
+    const __m256i one = _mm256_set1_epi32 (1);
+
+    __m256i d01;
+    __m256i d23;
+    int shift = -1;
+
+    while (true)
+    {
+        shift += 1;
+
+        //
+        // Shift and round, as in shiftAndRound().
+        //
+
+        __m128i count = _mm_cvtsi32_si128 (shift + 1);
+        __m256i a = _mm256_set1_epi32 ((1 << shift) - 1);
+
+        __m256i b01 = _mm256_and_si256 (_mm256_srl_epi32 (x01, count), one);
+        __m256i b23 = _mm256_and_si256 (_mm256_srl_epi32 (x23, count), one);
+
+        d01 = _mm256_srl_epi32 (_mm256_add_epi32 (_mm256_add_epi32 (x01, a),
+                                                  b01), count);
+
+        d23 = _mm256_srl_epi32 (_mm256_add_epi32 (_mm256_add_epi32 (x23, a),
+                                                  b23), count);
+
+        //
+        // Biased running differences.
+        //
+
+        __m256i h01 = _mm256_sub_epi32 (d01, _mm256_srli_si256 (d01, 4));
+        __m256i h23 = _mm256_sub_epi32 (d23, _mm256_srli_si256 (d23, 4));
+
+        __m256i v01 = _mm256_sub_epi32
+            (d01, _mm256_permute2x128_si256 (d01, d23, 0x21));
+
+        __m256i v23 = _mm256_sub_epi32
+            (d23, _mm256_permute2x128_si256 (d23, d23, 0x01));
+
+        __m256i out = _mm256_or_si256
+            (_mm256_or_si256
+                (_mm256_and_si256 (_mm256_add_epi32 (h01, bias), hMask),
+                 _mm256_and_si256 (_mm256_add_epi32 (h23, bias), hMask)),
+             _mm256_or_si256
+                (_mm256_and_si256 (_mm256_add_epi32 (v01, bias), v01Mask),
+                 _mm256_and_si256 (_mm256_add_epi32 (v23, bias), v23Mask)));
+
+        if (_mm256_testz_si256 (out, out))
+            break;
+    }
+
+    int d[16];
+    int r[15];
+
+    _mm256_storeu_si256 ((__m256i *) &d[0], d01);
+    _mm256_storeu_si256 ((__m256i *) &d[8], d23);
+
+    runningDifferences (d, r);
+
+    return packDifferences (t0, tMax, shift, d, r,
+                            b, optFlatFields, exactMax);
+}
+
+
+__attribute__((target("avx2")))
+void
+unpack14Avx2 (const unsigned char b[16], unsigned short s[16])
+{
+    //
+    // Same as unpack14(), above, for blocks whose shift value is
+    // less than 16.  The caller must guarantee that 16 bytes can
+    // be read from b.
+    //
+    // The 6-bit differences are gathered into 16-bit lanes with
+    // one byte shuffle and isolated with a multiply and a shift;
+    // the pixel values are then prefix sums of the differences,
+    // first along the rows of the block, then down column 0.
+    //
+
+    __m256i in = _mm256_broadcastsi128_si256
+                    (_mm_loadu_si128 ((const __m128i *) b));
+
+    //
+    // Lanes 0 to 7 hold s[0] ... s[7], lanes 8 to 15 hold s[8] ... s[15];
+    // each lane receives the big-endian 16-bit word that contains the
+    // lane's difference.  Lane 0 is replaced by s[0] below.
+    //
+
+    const __m256i shuffle = _mm256_setr_epi8
+        (-1, -1,  6,  5,  9,  8, 12, 11,  3,  2,  6,  5,  9,  8, 12, 11,
+          4,  3,  7,  6, 10,  9, 13, 12,  4,  3,  7,  6, 10,  9, 13, 12);
+
+    const __m256i align = _mm256_setr_epi16
+        (   1,    1,    1,    1,   64,   64,   64,   64,
+           16,   16,   16,   16, 1024, 1024, 1024, 1024);
+
+    __m256i r = _mm256_srli_epi16
+        (_mm256_mullo_epi16 (_mm256_shuffle_epi8 (in, shuffle), align), 10);
+
+    int shift = b[2] >> 2;
+    unsigned short s0 = (b[0] << 8) | b[1];
+
+    __m256i scale = _mm256_and_si256
+        (_mm256_set1_epi16 ((short) (1 << shift)),
+         _mm256_setr_epi16 (0, -1, -1, -1, -1, -1, -1, -1,
+                            -1, -1, -1, -1, -1, -1, -1, -1));
+
+    __m256i d = _mm256_or_si256
+        (_mm256_mullo_epi16 (_mm256_sub_epi16 (r, _mm256_set1_epi16 (0x20)),
+                             scale),
+         _mm256_castsi128_si256 (_mm_cvtsi32_si128 (s0)));
+
+    //
+    // Prefix sums along each row (one row per 64 bits) ...
+    //
+
+    __m256i v = _mm256_add_epi16 (d, _mm256_slli_epi64 (d, 16));
+    v = _mm256_add_epi16 (v, _mm256_slli_epi64 (v, 32));
+
+    //
+    // ... and down column 0: add the sum of the column 0
+    // differences of all previous rows to every row.
+    //
+
+    __m256i c = _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (d, 0), 0);
+    __m256i c01 = _mm256_add_epi16 (c, _mm256_shuffle_epi32 (c, 0x4e));
+
+    v = _mm256_add_epi16 (v, _mm256_slli_si256 (c, 8));
+    v = _mm256_add_epi16 (v, _mm256_permute2x128_si256 (c01, c01, 0x08));
+
+    //
+    // Convert back to the sign-magnitude format.
+    //
+
+    __m256i neg = _mm256_srai_epi16 (v, 15);
+
+    v = _mm256_andnot_si256
+        (_mm256_and_si256 (neg, _mm256_set1_epi16 ((short) 0x8000)),
+         _mm256_xor_si256 (v, _mm256_xor_si256 (neg, _mm256_set1_epi16 (-1))));
+
+    _mm256_storeu_si256 ((__m256i *) s, v);
+}
+
+#endif
+
+
 void
 notEnoughData ()
 {
@@ -767,6 +1068,13 @@ B44Compressor::compress (const char *inPtr,
 
     char *outEnd = _outBuffer;
 
+    PackFunc packBlock = pack;
+
+    #ifdef IMF_HAVE_B44_WIDE_KERNELS
+	if (simdLevel() >= SIMD_AVX2)
+	    packBlock = packAvx2;
+    #endif
+
     for (int i = 0; i < _numChans; ++i)
     {
 	ChannelData &cd = _channelData[i];
@@ -853,8 +1161,8 @@ B44Compressor::compress (const char *inPtr,
 		if (cd.pLinear)
 		    convertFromLinear (s);
 
-		outEnd += pack (s, (unsigned char *) outEnd,
-				_optFlatFields, !cd.pLinear);
+		outEnd += packBlock (s, (unsigned char *) outEnd,
+				     _optFlatFields, !cd.pLinear);
 	    }
 	}
     }
@@ -909,6 +1217,10 @@ B44Compressor::uncompress (const char *inPtr,
 	tmpBufferEnd += cd.nx * cd.ny * cd.size;
     }
 
+    #ifdef IMF_HAVE_B44_WIDE_KERNELS
+	bool wide = (simdLevel() >= SIMD_AVX2);
+    #endif
+
     for (int i = 0; i < _numChans; ++i)
     {
 	ChannelData &cd = _channelData[i];
@@ -960,7 +1272,27 @@ B44Compressor::uncompress (const char *inPtr,
 		    if (inSize < 14)
 			notEnoughData();
 
-		    unpack14 ((const unsigned char *)inPtr, s);
+		    const unsigned char *b = (const unsigned char *) inPtr;
+
+		    #ifdef IMF_HAVE_B44_WIDE_KERNELS
+
+			//
+			// unpack14Avx2() reads 16 bytes and handles
+			// only shift values below 16; other blocks
+			// fall back to unpack14().
+			//
+
+			if (wide && inSize >= 16 && b[2] < 0x40)
+			    unpack14Avx2 (b, s);
+			else
+			    unpack14 (b, s);
+
+		    #else
+
+			unpack14 (b, s);
+
+		    #endif
+
 		    inPtr += 14;
 		    inSize -= 14;
 		}
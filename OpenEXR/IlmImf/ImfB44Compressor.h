@@ -42,6 +42,7 @@
 //
 //-----------------------------------------------------------------------------
 
+#include "ImfChannelList.h"
 #include "ImfCompressor.h"
 #include "ImfNamespace.h"
 #include "ImfExport.h"
@@ -113,7 +114,7 @@ class B44Compressor: public Compressor
     unsigned short *	_tmpBuffer;
     char *		_outBuffer;
     int			_numChans;
-    const ChannelList &	_channels;
+    ChannelList		_channels;
     ChannelData *	_channelData;
     int			_minX;
     int			_maxX;
@@ -75,6 +75,11 @@ enum Compression
                                 // wise and faster to decode full frames
                                 // than DWAA_COMPRESSION.
 
+    ZSTD_COMPRESSION = 10,      // Zstandard compression, in blocks of 32
+                                // scan lines, with the same preprocessing
+                                // as ZIP_COMPRESSION.  Compresses about as
+                                // well as zlib, and decompresses faster.
+
     NUM_COMPRESSION_METHODS	// number of different compression methods
 };
 
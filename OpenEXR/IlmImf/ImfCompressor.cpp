@@ -43,19 +43,34 @@
 #include "ImfCompressor.h"
 #include "ImfRleCompressor.h"
 #include "ImfZipCompressor.h"
+#include "ImfZstdCompressor.h"
 #include "ImfPizCompressor.h"
 #include "ImfPxr24Compressor.h"
 #include "ImfB44Compressor.h"
 #include "ImfDwaCompressor.h"
 #include "ImfCheckedArithmetic.h"
+#include "ImfStandardAttributes.h"
+#include "ImfHeader.h"
 #include "ImfNamespace.h"
+#include "OpenEXRConfig.h"
+#include "IlmThreadMutex.h"
+#include "Iex.h"
+
+#include <list>
+#include <map>
+#include <vector>
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
 
 using IMATH_NAMESPACE::Box2i;
+using ILMTHREAD_NAMESPACE::Mutex;
+using ILMTHREAD_NAMESPACE::Lock;
+using std::list;
+using std::map;
+using std::vector;
 
 
-Compressor::Compressor (const Header &hdr): _header (hdr) {}
+Compressor::Compressor (const Header &hdr): _header (&hdr) {}
 
 
 Compressor::~Compressor () {}
@@ -88,6 +103,13 @@ Compressor::uncompressTile (const char *inPtr,
 }
 
 
+bool
+Compressor::setChannelsToDecode (const ChannelList &)
+{
+    return false;
+}
+
+
 bool	
 isValidCompression (Compression c)
 {
@@ -103,6 +125,7 @@ isValidCompression (Compression c)
       case B44A_COMPRESSION:
       case DWAA_COMPRESSION:
       case DWAB_COMPRESSION:
+      case ZSTD_COMPRESSION:
 
 	return true;
 
@@ -119,6 +142,7 @@ bool isValidDeepCompression(Compression c)
       case NO_COMPRESSION:
       case RLE_COMPRESSION:
       case ZIPS_COMPRESSION:
+      case ZSTD_COMPRESSION:
           return true;
       default :
           return false;
@@ -126,6 +150,18 @@ bool isValidDeepCompression(Compression c)
 }
 
 
+bool
+isSupportedCompression (Compression c)
+{
+#ifndef OPENEXR_IMF_HAVE_ZSTD
+    if (c == ZSTD_COMPRESSION)
+	return false;
+#endif
+
+    return isValidCompression (c);
+}
+
+
 Compressor *
 newCompressor (Compression c, size_t maxScanLineSize, const Header &hdr)
 {
@@ -169,6 +205,15 @@ newCompressor (Compression c, size_t maxScanLineSize, const Header &hdr)
 	return new DwaCompressor (hdr, maxScanLineSize, 256, 
                                DwaCompressor::STATIC_HUFFMAN);
 
+      case ZSTD_COMPRESSION:
+
+#ifdef OPENEXR_IMF_HAVE_ZSTD
+	return new ZstdCompressor (hdr, maxScanLineSize, 32);
+#else
+	throw IEX_NAMESPACE::ArgExc ("ZSTD compression is not supported "
+				     "by this build of the library.");
+#endif
+
       default:
 
 	return 0;
@@ -215,6 +260,15 @@ newTileCompressor (Compression c,
 	return new DwaCompressor (hdr, tileLineSize, numTileLines, 
                                DwaCompressor::DEFLATE);
 
+      case ZSTD_COMPRESSION:
+
+#ifdef OPENEXR_IMF_HAVE_ZSTD
+	return new ZstdCompressor (hdr, tileLineSize, numTileLines);
+#else
+	throw IEX_NAMESPACE::ArgExc ("ZSTD compression is not supported "
+				     "by this build of the library.");
+#endif
+
       default:
 
 	return 0;
@@ -222,5 +276,367 @@ newTileCompressor (Compression c,
 }
 
 
+//
+// The compressor pool
+//
+
+class CompressorPool
+{
+  public:
+
+    CompressorPool ();
+    ~CompressorPool ();
+
+    Compressor *	borrow (Compression c,
+				bool tiled,
+				size_t lineSize,
+				size_t numLines,
+				const Header &hdr);
+
+    void		giveBack (Compressor *compressor);
+
+    int			size ();
+    void		setSize (int size);
+
+  private:
+
+    //
+    // For every compressor that the pool has constructed, an Entry
+    // records the arguments that were passed to newCompressor() or
+    // newTileCompressor().  The entry's header is a copy of the parts
+    // of the original header that the compressors depend on; while
+    // the compressor is idle, its header() refers to this copy.
+    //
+
+    struct Entry
+    {
+	Compression	compression;
+	bool		tiled;
+	size_t		lineSize;
+	size_t		numLines;
+	Header		header;
+	Compressor *	compressor;
+    };
+
+    static bool		matches (const Entry &entry,
+				 Compression c,
+				 bool tiled,
+				 size_t lineSize,
+				 size_t numLines,
+				 const Header &hdr);
+
+    void		trim (vector<Entry *> &victims);
+
+    Mutex			_mutex;
+    int				_size;
+    list<Entry *>		_idle;		// most recently returned first
+    map<Compressor *, Entry *>	_borrowed;
+};
+
+
+namespace {
+
+//
+// Files may still return compressors while static objects are being
+// destroyed at program exit, possibly after the pool itself.
+//
+
+bool poolDestroyed = false;
+
+
+CompressorPool &
+pool ()
+{
+    static CompressorPool thePool;
+    return thePool;
+}
+
+
+template <class T>
+bool
+sameAttribute (const Header &a, const Header &b, const char name[])
+{
+    const T *x = a.findTypedAttribute<T> (name);
+    const T *y = b.findTypedAttribute<T> (name);
+
+    if (x == 0 || y == 0)
+	return x == y;
+
+    return x->value() == y->value();
+}
+
+} // namespace
+
+
+CompressorPool::CompressorPool (): _size (32)
+{
+    // empty
+}
+
+
+CompressorPool::~CompressorPool ()
+{
+    Lock lock (_mutex);
+
+    for (list<Entry *>::iterator i = _idle.begin(); i != _idle.end(); ++i)
+    {
+	delete (*i)->compressor;
+	delete *i;
+    }
+
+    //
+    // Borrowed compressors are deleted when they are returned.
+    //
+
+    for (map<Compressor *, Entry *>::iterator i = _borrowed.begin();
+	 i != _borrowed.end();
+	 ++i)
+    {
+	delete i->second;
+    }
+
+    _idle.clear();
+    _borrowed.clear();
+    poolDestroyed = true;
+}
+
+
+bool
+CompressorPool::matches (const Entry &entry,
+			 Compression c,
+			 bool tiled,
+			 size_t lineSize,
+			 size_t numLines,
+			 const Header &hdr)
+{
+    //
+    // The compressors depend on the header's data window and
+    // channel list, and on the compression level attributes.
+    //
+
+    return entry.compression == c &&
+	   entry.tiled == tiled &&
+	   entry.lineSize == lineSize &&
+	   entry.numLines == numLines &&
+	   entry.header.dataWindow() == hdr.dataWindow() &&
+	   entry.header.channels() == hdr.channels() &&
+	   sameAttribute<FloatAttribute>
+		(entry.header, hdr, "dwaCompressionLevel") &&
+	   sameAttribute<IntAttribute>
+		(entry.header, hdr, "zipCompressionLevel") &&
+	   sameAttribute<IntAttribute>
+		(entry.header, hdr, "zstdCompressionLevel");
+}
+
+
+Compressor *
+CompressorPool::borrow (Compression c,
+			bool tiled,
+			size_t lineSize,
+			size_t numLines,
+			const Header &hdr)
+{
+    bool pooling;
+
+    {
+	Lock lock (_mutex);
+
+	for (list<Entry *>::iterator i = _idle.begin(); i != _idle.end(); ++i)
+	{
+	    if (matches (**i, c, tiled, lineSize, numLines, hdr))
+	    {
+		Entry *entry = *i;
+		_idle.erase (i);
+		_borrowed[entry->compressor] = entry;
+
+		entry->compressor->_header = &hdr;
+		entry->compressor->setChannelsToDecode (hdr.channels());
+		return entry->compressor;
+	    }
+	}
+
+	pooling = (_size > 0);
+    }
+
+    Compressor *compressor =
+	tiled? newTileCompressor (c, lineSize, numLines, hdr):
+	       newCompressor (c, lineSize, hdr);
+
+    if (compressor == 0 || !pooling)
+	return compressor;
+
+    Entry *entry = new Entry;
+
+    entry->compression = c;
+    entry->tiled = tiled;
+    entry->lineSize = lineSize;
+    entry->numLines = numLines;
+    entry->header.dataWindow() = hdr.dataWindow();
+    entry->header.displayWindow() = hdr.displayWindow();
+    entry->header.channels() = hdr.channels();
+    entry->header.compression() = c;
+    entry->compressor = compressor;
+
+    const char *levels[] =
+    {
+	"dwaCompressionLevel",
+	"zipCompressionLevel",
+	"zstdCompressionLevel"
+    };
+
+    for (int i = 0; i < int (sizeof (levels) / sizeof (levels[0])); ++i)
+    {
+	Header::ConstIterator a = hdr.find (levels[i]);
+
+	if (a != hdr.end())
+	    entry->header.insert (levels[i], a.attribute());
+    }
+
+    Lock lock (_mutex);
+    _borrowed[compressor] = entry;
+    return compressor;
+}
+
+
+void
+CompressorPool::giveBack (Compressor *compressor)
+{
+    vector<Entry *> victims;
+
+    {
+	Lock lock (_mutex);
+
+	map<Compressor *, Entry *>::iterator i = _borrowed.find (compressor);
+
+	if (i == _borrowed.end())
+	{
+	    //
+	    // Not borrowed from the pool (or borrowed while
+	    // pooling was disabled).
+	    //
+
+	    lock.release();
+	    delete compressor;
+	    return;
+	}
+
+	Entry *entry = i->second;
+	_borrowed.erase (i);
+
+	compressor->_header = &entry->header;
+	_idle.push_front (entry);
+
+	trim (victims);
+    }
+
+    for (size_t i = 0; i < victims.size(); ++i)
+    {
+	delete victims[i]->compressor;
+	delete victims[i];
+    }
+}
+
+
+void
+CompressorPool::trim (vector<Entry *> &victims)
+{
+    //
+    // Remove the least recently returned idle compressors
+    // that exceed the pool size.  The caller deletes them
+    // after releasing the mutex.
+    //
+
+    while (int (_idle.size()) > _size)
+    {
+	victims.push_back (_idle.back());
+	_idle.pop_back();
+    }
+}
+
+
+int
+CompressorPool::size ()
+{
+    Lock lock (_mutex);
+    return _size;
+}
+
+
+void
+CompressorPool::setSize (int size)
+{
+    vector<Entry *> victims;
+
+    {
+	Lock lock (_mutex);
+	_size = (size < 0)? 0: size;
+	trim (victims);
+    }
+
+    for (size_t i = 0; i < victims.size(); ++i)
+    {
+	delete victims[i]->compressor;
+	delete victims[i];
+    }
+}
+
+
+Compressor *
+borrowCompressor (Compression c, size_t maxScanLineSize, const Header &hdr)
+{
+    if (poolDestroyed)
+	return newCompressor (c, maxScanLineSize, hdr);
+
+    return pool().borrow (c, false, maxScanLineSize, 0, hdr);
+}
+
+
+Compressor *
+borrowTileCompressor (Compression c,
+		      size_t tileLineSize,
+		      size_t numTileLines,
+		      const Header &hdr)
+{
+    if (poolDestroyed)
+	return newTileCompressor (c, tileLineSize, numTileLines, hdr);
+
+    return pool().borrow (c, true, tileLineSize, numTileLines, hdr);
+}
+
+
+void
+returnCompressor (Compressor *compressor)
+{
+    if (compressor == 0)
+	return;
+
+    if (poolDestroyed)
+    {
+	delete compressor;
+	return;
+    }
+
+    pool().giveBack (compressor);
+}
+
+
+int
+compressorPoolSize ()
+{
+    if (poolDestroyed)
+	return 0;
+
+    return pool().size();
+}
+
+
+void
+setCompressorPoolSize (int size)
+{
+    if (!poolDestroyed)
+	pool().setSize (size);
+}
+
+
 OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_EXIT
 
@@ -106,7 +106,7 @@ class Compressor
     // Access to the file's header
     //----------------------------
 
-    const Header &	header () const		{return _header;}
+    const Header &	header () const		{return *_header;}
 
 
     //-------------------------------------------------------------------------
@@ -202,9 +202,30 @@ class Compressor
 					IMATH_NAMESPACE::Box2i range,
 					const char *&outPtr);
 
+
+    //-------------------------------------------------------------
+    // Partial decoding:
+    //
+    // setChannelsToDecode(c) tells the compressor that the caller
+    // only needs the channels in c from the data returned by
+    // uncompress() and uncompressTile().  The layout of the
+    // uncompressed data does not change, but a compressor that
+    // can skip the work for the other channels leaves their data
+    // undefined, and returns true.  Initially, all channels are
+    // decoded.
+    //
+    // The default implementation ignores the call, and returns
+    // false.
+    //-------------------------------------------------------------
+
+    IMF_EXPORT
+    virtual bool	setChannelsToDecode (const ChannelList &channels);
+
   private:
 
-    const Header &	_header;
+    friend class CompressorPool;
+
+    const Header *	_header;
 };
 
 
@@ -222,6 +243,15 @@ bool isValidCompression (Compression c);
 IMF_EXPORT
 bool            isValidDeepCompression (Compression c);
 
+//--------------------------------------------------------------
+// Test if this build of the library can read and write files
+// with compression type c (ZSTD_COMPRESSION is only available
+// if the library was built with the Zstandard library)
+//--------------------------------------------------------------
+
+IMF_EXPORT
+bool            isSupportedCompression (Compression c);
+
 
 //-----------------------------------------------------------------
 // Construct a Compressor for compression type c:
@@ -235,6 +265,8 @@ bool            isValidDeepCompression (Compression c);
 //  return value	A pointer to a new Compressor object (it
 //			is the caller's responsibility to delete
 //			the object), or 0 (if c is NO_COMPRESSION).
+//			Throws an IEX_NAMESPACE::ArgExc if c is not
+//			supported by this build of the library.
 //
 //-----------------------------------------------------------------
 
@@ -258,6 +290,8 @@ Compressor *	newCompressor (Compression c,
 //  return value	A pointer to a new Compressor object (it
 //			is the caller's responsibility to delete
 //			the object), or 0 (if c is NO_COMPRESSION).
+//			Throws an IEX_NAMESPACE::ArgExc if c is not
+//			supported by this build of the library.
 //
 //-----------------------------------------------------------------
 
@@ -268,6 +302,58 @@ Compressor *    newTileCompressor (Compression c,
 				   const Header &hdr);
 
 
+//-----------------------------------------------------------------
+// Compressor pooling:
+//
+// Some compressors allocate large internal buffers when they are
+// constructed.  Applications that open many short-lived files can
+// avoid the cost of constructing a new compressor for every file
+// by borrowing compressors from a process-wide pool instead.
+//
+// borrowCompressor() and borrowTileCompressor() take the same
+// arguments as newCompressor() and newTileCompressor().  They
+// return an idle compressor from the pool if there is one that
+// was created for the same compression type, the same buffer
+// sizes, and a header with the same data window, channel list
+// and compression level attributes; otherwise they construct
+// a new compressor.  The compressor's header() is the header
+// passed to borrowCompressor(), and its setChannelsToDecode()
+// is reset to all channels.
+//
+// returnCompressor() gives a borrowed compressor back to the pool.
+// If the pool is full, the least recently returned compressor is
+// deleted.  Compressors that were not borrowed from the pool are
+// deleted immediately.  returnCompressor(0) does nothing.
+//
+// setCompressorPoolSize() sets the maximum number of idle compressors
+// that the pool keeps, and deletes any that exceed the new limit.
+// A size of 0 disables pooling.  The default size is 32.
+//
+// All of these functions are thread-safe.
+//
+//-----------------------------------------------------------------
+
+IMF_EXPORT
+Compressor *	borrowCompressor (Compression c,
+				  size_t maxScanLineSize,
+				  const Header &hdr);
+
+IMF_EXPORT
+Compressor *	borrowTileCompressor (Compression c,
+				      size_t tileLineSize,
+				      size_t numTileLines,
+				      const Header &hdr);
+
+IMF_EXPORT
+void		returnCompressor (Compressor *compressor);
+
+IMF_EXPORT
+int		compressorPoolSize ();
+
+IMF_EXPORT
+void		setCompressorPoolSize (int size);
+
+
 OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif
@@ -257,6 +257,7 @@ struct DeepScanLineInputFile::Data: public Mutex
                                                     // sample count table
     InputStreamMutex*   _streamData;
     bool                _deleteStream;
+    ThreadPool *        threadPool;         // runs the line buffer tasks
                                                     
 
     Data (int numThreads);
@@ -276,7 +277,8 @@ DeepScanLineInputFile::Data::Data (int numThreads):
         memoryMapped(false),
         frameBufferValid(false),
         _streamData(NULL),
-        _deleteStream(false)
+        _deleteStream(false),
+        threadPool(&globalThreadPool())
 {
     //
     // We need at least one lineBuffer, but if threading is used,
@@ -929,6 +931,7 @@ DeepScanLineInputFile::DeepScanLineInputFile(InputPartData* part)
     _data = new Data(part->numThreads);
     _data->_deleteStream=false;
     _data->_streamData = part->mutex;
+    _data->threadPool = part->threadPool;
     _data->memoryMapped = _data->_streamData->is->isMemoryMapped();
     _data->version = part->version;
 
@@ -941,10 +944,11 @@ DeepScanLineInputFile::DeepScanLineInputFile(InputPartData* part)
 
 
 DeepScanLineInputFile::DeepScanLineInputFile
-    (const char fileName[], int numThreads)
+    (const char fileName[], int numThreads, ThreadPool &threadPool)
 :
      _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_streamData = new InputStreamMutex();
     _data->_deleteStream = true;
     OPENEXR_IMF_INTERNAL_NAMESPACE::IStream* is = 0;
@@ -998,10 +1002,12 @@ DeepScanLineInputFile::DeepScanLineInputFile
     (const Header &header,
      OPENEXR_IMF_INTERNAL_NAMESPACE::IStream *is,
      int version,
-     int numThreads)
+     int numThreads,
+     ThreadPool &threadPool)
 :
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_streamData=new InputStreamMutex();
     _data->_deleteStream=false;
     _data->_streamData->is = is;
@@ -1058,7 +1064,8 @@ DeepScanLineInputFile::compatibilityInitialize(OPENEXR_IMF_INTERNAL_NAMESPACE::I
     // (TODO) maybe change the third parameter of the constructor of MultiPartInputFile later.
     //
     _data->multiPartBackwardSupport = true;
-    _data->multiPartFile = new MultiPartInputFile(is, _data->numThreads);
+    _data->multiPartFile = new MultiPartInputFile(is, _data->numThreads, true,
+                                                  *_data->threadPool);
     InputPartData* part = _data->multiPartFile->getPart(0);
     
     multiPartInitialize(part);
@@ -1068,6 +1075,7 @@ void DeepScanLineInputFile::multiPartInitialize(InputPartData* part)
 {
     
     _data->_streamData = part->mutex;
+    _data->threadPool = part->threadPool;
     _data->memoryMapped = _data->_streamData->is->isMemoryMapped();
     _data->version = part->version;
     
@@ -1322,10 +1330,10 @@ DeepScanLineInputFile::readPixels (int scanLine1, int scanLine2)
 
             for (int l = start; l != stop; l += dl)
             {
-                ThreadPool::addGlobalTask (newLineBufferTask (&taskGroup,
-                                                              _data, l,
-                                                              scanLineMin,
-                                                              scanLineMax));
+                _data->threadPool->addTask (newLineBufferTask (&taskGroup,
+                                                               _data, l,
+                                                               scanLineMin,
+                                                               scanLineMax));
             }
 
             //
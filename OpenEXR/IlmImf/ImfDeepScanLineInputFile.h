@@ -56,18 +56,23 @@ class DeepScanLineInputFile : public GenericInputFile
 {
   public:
 
-    //------------
-    // Constructor
-    //------------
+    //------------------------------------------------------
+    // Constructors -- pixel data are decompressed by tasks
+    // in threadPool
+    //------------------------------------------------------
 
     IMF_EXPORT
     DeepScanLineInputFile (const char fileName[],
-                           int numThreads = globalThreadCount());
+                           int numThreads = globalThreadCount(),
+                           ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                               globalThreadPool());
 
     IMF_EXPORT
     DeepScanLineInputFile (const Header &header, OPENEXR_IMF_INTERNAL_NAMESPACE::IStream *is,
                            int version, /*version field from file*/
-                           int numThreads = globalThreadCount());
+                           int numThreads = globalThreadCount(),
+                           ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                               globalThreadPool());
 
 
     //-----------------------------------------
@@ -231,6 +231,7 @@ struct DeepScanLineOutputFile::Data
                                                        // sample count table
     OutputStreamMutex*  _streamData;
     bool                _deleteStream;
+    ThreadPool *        threadPool;         // runs the line buffer tasks
 
     Data (int numThreads);
     ~Data ();
@@ -249,7 +250,8 @@ DeepScanLineOutputFile::Data::Data (int numThreads):
     lineOffsetsPosition (0),
     partNumber (-1) ,
     _streamData(NULL),
-    _deleteStream(false)
+    _deleteStream(false),
+    threadPool(&globalThreadPool())
 {
     //
     // We need at least one lineBuffer, but if threading is used,
@@ -813,10 +815,12 @@ LineBufferTask::execute ()
 DeepScanLineOutputFile::DeepScanLineOutputFile
     (const char fileName[],
      const Header &header,
-     int numThreads)
+     int numThreads,
+     ThreadPool &threadPool)
 :
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_streamData=new OutputStreamMutex ();
     _data->_deleteStream=true;
     try
@@ -855,11 +859,13 @@ DeepScanLineOutputFile::DeepScanLineOutputFile
 DeepScanLineOutputFile::DeepScanLineOutputFile
     (OPENEXR_IMF_INTERNAL_NAMESPACE::OStream &os,
      const Header &header,
-     int numThreads)
+     int numThreads,
+     ThreadPool &threadPool)
 :
     _data (new Data (numThreads))
     
 {
+    _data->threadPool    = &threadPool;
     _data->_streamData   = new OutputStreamMutex ();
     _data->_deleteStream = false;
     try
@@ -903,6 +909,7 @@ DeepScanLineOutputFile::DeepScanLineOutputFile(const OutputPartData* part)
 
         _data = new Data (part->numThreads);
         _data->_streamData = part->mutex;
+        _data->threadPool = part->threadPool;
         _data->_deleteStream=false;
         initialize (part->header);
         _data->partNumber = part->partNumber;
@@ -1224,7 +1231,7 @@ DeepScanLineOutputFile::writePixels (int numScanLines)
 
                 for (int i = 0; i < numTasks; i++)
                 {
-                    ThreadPool::addGlobalTask
+                    _data->threadPool->addTask
                         (new LineBufferTask (&taskGroup, _data, first + i,
                                              scanLineMin, scanLineMax));
                 }
@@ -1247,7 +1254,7 @@ DeepScanLineOutputFile::writePixels (int numScanLines)
 
                 for (int i = 0; i < numTasks; i++)
                 {
-                    ThreadPool::addGlobalTask
+                    _data->threadPool->addTask
                         (new LineBufferTask (&taskGroup, _data, first - i,
                                              scanLineMin, scanLineMax));
                 }
@@ -1337,7 +1344,7 @@ DeepScanLineOutputFile::writePixels (int numScanLines)
                 // Add nextCompressBuffer as a compression task
                 //
 
-                ThreadPool::addGlobalTask
+                _data->threadPool->addTask
                     (new LineBufferTask (&taskGroup, _data, nextCompressBuffer,
                                          scanLineMin, scanLineMax));
 
@@ -68,12 +68,15 @@ class DeepScanLineOutputFile : public GenericOutputFile
     // the file.
     //
     // numThreads determines the number of threads that will be
-    // used to write the file (see ImfThreading.h).
+    // used to write the file, and threadPool the pool that these
+    // threads belong to (see ImfThreading.h).
     //-----------------------------------------------------------
 
     IMF_EXPORT
     DeepScanLineOutputFile (const char fileName[], const Header &header,
-                int numThreads = globalThreadCount());
+                int numThreads = globalThreadCount(),
+                ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                    globalThreadPool());
 
 
     //------------------------------------------------------------
@@ -85,12 +88,15 @@ class DeepScanLineOutputFile : public GenericOutputFile
     // close the file.
     //
     // numThreads determines the number of threads that will be
-    // used to write the file (see ImfThreading.h).
+    // used to write the file, and threadPool the pool that these
+    // threads belong to (see ImfThreading.h).
     //------------------------------------------------------------
 
     IMF_EXPORT
     DeepScanLineOutputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::OStream &os, const Header &header,
-                int numThreads = globalThreadCount());
+                int numThreads = globalThreadCount(),
+                ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                    globalThreadPool());
 
 
     //-------------------------------------------------
@@ -263,6 +263,7 @@ struct DeepTiledInputFile::Data: public Mutex
                                                     
     InputStreamMutex *  _streamData;
     bool                _deleteStream; // should we delete the stream
+    ThreadPool *        threadPool;    // runs the tile buffer tasks
      Data (int numThreads);
     ~Data ();
 
@@ -284,7 +285,8 @@ DeepTiledInputFile::Data::Data (int numThreads):
     numThreads(numThreads),
     memoryMapped(false),
     _streamData(NULL),
-    _deleteStream(false)
+    _deleteStream(false),
+    threadPool(&globalThreadPool())
 {
     //
     // We need at least one tileBuffer, but if threading is used,
@@ -790,9 +792,12 @@ newTileBufferTask
 } // namespace
 
 
-DeepTiledInputFile::DeepTiledInputFile (const char fileName[], int numThreads):
+DeepTiledInputFile::DeepTiledInputFile (const char fileName[],
+                                        int numThreads,
+                                        ThreadPool &threadPool):
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_deleteStream=true;
     //
     // This constructor is called when a user
@@ -843,9 +848,12 @@ DeepTiledInputFile::DeepTiledInputFile (const char fileName[], int numThreads):
 }
 
 
-DeepTiledInputFile::DeepTiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int numThreads):
+DeepTiledInputFile::DeepTiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is,
+                                        int numThreads,
+                                        ThreadPool &threadPool):
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_streamData=0;
     _data->_deleteStream=false;
     
@@ -899,10 +907,12 @@ DeepTiledInputFile::DeepTiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream
 DeepTiledInputFile::DeepTiledInputFile (const Header &header,
                                         OPENEXR_IMF_INTERNAL_NAMESPACE::IStream *is,
                                         int version,
-                                        int numThreads) :
+                                        int numThreads,
+                                        ThreadPool &threadPool) :
     _data (new Data (numThreads))
     
 {
+    _data->threadPool = &threadPool;
     _data->_streamData->is = is;
     _data->_deleteStream=false;
     
@@ -940,7 +950,8 @@ DeepTiledInputFile::compatibilityInitialize(OPENEXR_IMF_INTERNAL_NAMESPACE::IStr
     // with the part 0 data.
     // (TODO) maybe change the third parameter of the constructor of MultiPartInputFile later.
     //
-    _data->multiPartFile = new MultiPartInputFile(is, _data->numThreads);
+    _data->multiPartFile = new MultiPartInputFile(is, _data->numThreads, true,
+                                                  *_data->threadPool);
     _data->multiPartBackwardSupport = true;
     InputPartData* part = _data->multiPartFile->getPart(0);
 
@@ -958,6 +969,7 @@ DeepTiledInputFile::multiPartInitialize(InputPartData* part)
     _data->header = part->header;
     _data->version = part->version;
     _data->partNumber = part->partNumber;
+    _data->threadPool = part->threadPool;
     _data->memoryMapped = _data->_streamData->is->isMemoryMapped();
     initialize();
     _data->tileOffsets.readFrom(part->chunkOffsets , _data->fileIsComplete);
@@ -1317,11 +1329,11 @@ DeepTiledInputFile::readTiles (int dx1, int dx2, int dy1, int dy2, int lx, int l
                                "Tile (" << dx << ", " << dy << ", " <<
                                lx << "," << ly << ") is not a valid tile.");
 
-                    ThreadPool::addGlobalTask (newTileBufferTask (&taskGroup,
-                                                                  _data,
-                                                                  tileNumber++,
-                                                                  dx, dy,
-                                                                  lx, ly));
+                    _data->threadPool->addTask (newTileBufferTask (&taskGroup,
+                                                                   _data,
+                                                                   tileNumber++,
+                                                                   dx, dy,
+                                                                   lx, ly));
                 }
             }
 
@@ -65,14 +65,17 @@ class DeepTiledInputFile : public GenericInputFile
     // reads the file header.  The constructor throws an IEX_NAMESPACE::ArgExc
     // exception if the file is not tiled.
     // The numThreads parameter specifies how many worker threads this
-    // file will try to keep busy when decompressing individual tiles.
+    // file will try to keep busy when decompressing individual tiles;
+    // the tiles are decompressed by tasks in threadPool.
     // Destroying TiledInputFile objects constructed with this constructor
     // automatically closes the corresponding files.
     //--------------------------------------------------------------------
 
     IMF_EXPORT
     DeepTiledInputFile (const char fileName[],
-                    int numThreads = globalThreadCount ());
+                    int numThreads = globalThreadCount (),
+                    ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                        globalThreadPool ());
 
 
     // ----------------------------------------------------------
@@ -84,7 +87,9 @@ class DeepTiledInputFile : public GenericInputFile
     // ----------------------------------------------------------
 
     IMF_EXPORT
-    DeepTiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int numThreads = globalThreadCount ());
+    DeepTiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int numThreads = globalThreadCount (),
+                    ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                        globalThreadPool ());
 
 
     //-----------
@@ -444,7 +449,7 @@ class DeepTiledInputFile : public GenericInputFile
     DeepTiledInputFile & operator = (const DeepTiledInputFile &); // not implemented
 
     DeepTiledInputFile (const Header &header, OPENEXR_IMF_INTERNAL_NAMESPACE::IStream *is, int version,
-                    int numThreads);
+                    int numThreads, ILMTHREAD_NAMESPACE::ThreadPool &threadPool);
 
     void                initialize ();
     void                multiPartInitialize(InputPartData* part);
@@ -308,6 +308,7 @@ struct DeepTiledOutputFile::Data
                                                 // sample count table
     OutputStreamMutex*  _streamData;
     bool                _deleteStream;
+    ThreadPool *        threadPool;             // runs the tile buffer tasks
                                                 
      Data (int numThreads);
     ~Data ();
@@ -331,7 +332,8 @@ DeepTiledOutputFile::Data::Data (int numThreads):
     tileOffsetsPosition (0),
     partNumber(-1),
     _streamData(NULL),
-    _deleteStream(true)
+    _deleteStream(true),
+    threadPool(&globalThreadPool())
 {
     //
     // We need at least one tileBuffer, but if threading is used,
@@ -1052,11 +1054,13 @@ TileBufferTask::execute ()
 DeepTiledOutputFile::DeepTiledOutputFile
     (const char fileName[],
      const Header &header,
-     int numThreads)
+     int numThreads,
+     ThreadPool &threadPool)
 :
     _data (new Data (numThreads))
 
 {
+    _data->threadPool = &threadPool;
     _data->_streamData=new OutputStreamMutex();
     _data->_deleteStream =true;
     try
@@ -1096,10 +1100,12 @@ DeepTiledOutputFile::DeepTiledOutputFile
 DeepTiledOutputFile::DeepTiledOutputFile
     (OPENEXR_IMF_INTERNAL_NAMESPACE::OStream &os,
      const Header &header,
-     int numThreads)
+     int numThreads,
+     ThreadPool &threadPool)
 :
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_streamData=new OutputStreamMutex();
     _data->_deleteStream=false;
     
@@ -1145,6 +1151,7 @@ DeepTiledOutputFile::DeepTiledOutputFile(const OutputPartData* part)
 
         _data = new Data (part->numThreads);
         _data->_streamData=part->mutex;
+        _data->threadPool = part->threadPool;
         _data->_deleteStream=false;
         initialize(part->header);
         _data->partNumber = part->partNumber;
@@ -1497,11 +1504,11 @@ DeepTiledOutputFile::writeTiles (int dx1, int dx2, int dy1, int dy2,
 
             while (nextCompBuffer < numTasks)
             {
-                ThreadPool::addGlobalTask (new TileBufferTask (&taskGroup,
-                                                               _data,
-                                                               nextCompBuffer++,
-                                                               dxComp, dyComp,
-                                                               lx, ly));
+                _data->threadPool->addTask (new TileBufferTask (&taskGroup,
+                                                                _data,
+                                                                nextCompBuffer++,
+                                                                dxComp, dyComp,
+                                                                lx, ly));
                 dxComp++;
 
                 if (dxComp > dx2)
@@ -1560,7 +1567,7 @@ DeepTiledOutputFile::writeTiles (int dx1, int dx2, int dy1, int dy2,
                     // add nextCompBuffer as a compression Task
                     //
 
-                    ThreadPool::addGlobalTask
+                    _data->threadPool->addTask
                         (new TileBufferTask (&taskGroup,
                                              _data,
                                              nextCompBuffer,
@@ -78,12 +78,16 @@ class DeepTiledOutputFile : public GenericOutputFile
     // same order as they are in the file tends to be significantly
     // faster than reading the tiles in random order (see writeTile,
     // below).
+    //
+    // The tiles are compressed by tasks in threadPool.
     //-------------------------------------------------------------------
 
     IMF_EXPORT
     DeepTiledOutputFile (const char fileName[],
                          const Header &header,
-                         int numThreads = globalThreadCount ());
+                         int numThreads = globalThreadCount (),
+                         ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                             globalThreadPool ());
 
 
     // ----------------------------------------------------------------
@@ -96,7 +100,9 @@ class DeepTiledOutputFile : public GenericOutputFile
     IMF_EXPORT
     DeepTiledOutputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::OStream &os,
                          const Header &header,
-                         int numThreads = globalThreadCount ());
+                         int numThreads = globalThreadCount (),
+                         ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                             globalThreadPool ());
 
 
     //-----------------------------------------------------
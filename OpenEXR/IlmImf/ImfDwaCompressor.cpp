@@ -202,6 +202,15 @@ namespace {
     void (*dctInverse8x8_5)(float*) = dctInverse8x8_scalar<5>;
     void (*dctInverse8x8_6)(float*) = dctInverse8x8_scalar<6>;
     void (*dctInverse8x8_7)(float*) = dctInverse8x8_scalar<7>;
+
+    //
+    // Dispatch the forward DCT and the color space conversions
+    //
+
+    void (*dctForward8x8Func)(float*) = dctForward8x8;
+
+    void (*csc709Forward64Func)(float*, float*, float*) = csc709Forward64;
+    void (*csc709Inverse64Func)(float*, float*, float*) = csc709Inverse64;
     
 } // namespace
 
@@ -214,6 +223,7 @@ struct DwaCompressor::ChannelData
     int                 ySampling;
     PixelType           type;
     bool                pLinear;
+    bool                decode;
 
     int                 width;
     int                 height;
@@ -366,6 +376,23 @@ class DwaCompressor::LossyDctDecoderBase
 
     void execute();
 
+    //
+    // Decode only the DC component of each block, and store one
+    // pixel per block in the rows of _rowPtrs[]: the rows hold
+    // the image at 1/8 resolution.
+    //
+
+    void executeDcOnly();
+
+    //
+    // Advance past the DC and AC components of the channels
+    // without decoding them, so that numAcValuesEncoded() and
+    // numDcValuesEncoded() return the same values as after
+    // execute().
+    //
+
+    void skip();
+
     //
     // These return number of items, not bytes. Each item
     // is an unsigned short
@@ -393,6 +420,14 @@ class DwaCompressor::LossyDctDecoderBase
                  unsigned short  *halfZigBlock); 
 
 
+    //
+    // Convert the rows of the channels of type FLOAT
+    // from HALF XDR back to FLOAT XDR.
+    //
+
+    void halfXdrToFloatXdr (int width, int height);
+
+
     //
     // if NATIVE and XDR are really the same values, we can
     // skip some processing and speed things along
@@ -920,9 +955,9 @@ DwaCompressor::LossyDctDecoderBase::execute ()
             {
                 if (!blockIsConstant)
                 {
-                    csc709Inverse64 (_dctData[0]._buffer, 
-                                     _dctData[1]._buffer, 
-                                     _dctData[2]._buffer);
+                    csc709Inverse64Func (_dctData[0]._buffer, 
+                                         _dctData[1]._buffer, 
+                                         _dctData[2]._buffer);
 
                 }
                 else
@@ -1137,23 +1172,142 @@ DwaCompressor::LossyDctDecoderBase::execute ()
     // Convert from HALF XDR back to FLOAT XDR.
     //
 
-    for (unsigned int chan = 0; chan < numComp; ++chan)
+    halfXdrToFloatXdr (_width, _height);
+
+    delete[] rowBlockHandle;
+}
+
+
+void
+DwaCompressor::LossyDctDecoderBase::executeDcOnly ()
+{
+    int numComp    = _rowPtrs.size();
+    int numBlocksX = (int) ceil ((float)_width  / 8.0f);
+    int numBlocksY = (int) ceil ((float)_height / 8.0f);
+
+    if (_type.size() != _rowPtrs.size())
+        throw Iex::BaseExc ("Row pointers and types mismatch in count");
+
+    if ((_rowPtrs.size() != 3) && (_rowPtrs.size() != 1))
+        throw Iex::NoImplExc ("Only 1 and 3 channel encoding is supported");
+
+    //
+    // The DC components are packed by plane, as in execute()
+    //
+
+    std::vector<unsigned short *> currDcComp (numComp);
+
+    currDcComp[0] = (unsigned short *)_packedDc;
+
+    for (int comp = 1; comp < numComp; ++comp)
+        currDcComp[comp] = currDcComp[comp - 1] + numBlocksX * numBlocksY;
+
+    for (int blocky = 0; blocky < numBlocksY; ++blocky)
+    {
+        for (int blockx = 0; blockx < numBlocksX; ++blockx)
+        {
+            float dc[3];
+
+            for (int comp = 0; comp < numComp; ++comp)
+            {
+                unsigned short bits = *currDcComp[comp]++;
+
+                if (!_isNativeXdr)
+                {
+                    const char *tmpConstCharPtr = (const char *)&bits;
+                    unsigned short tmpShortNative;
+
+                    Xdr::read<CharPtrIO> (tmpConstCharPtr, tmpShortNative);
+                    bits = tmpShortNative;
+                }
+
+                _packedDcCount++;
+
+                //
+                // This is the value that dctInverse8x8DcOnly()
+                // fills the whole block with.
+                //
+
+                half h;
+                h.setBits (bits);
+
+                dc[comp] = (float)h * 3.535536e-01f * 3.535536e-01f;
+            }
+
+            if (numComp == 3)
+                csc709Inverse (dc[0], dc[1], dc[2]);
+
+            for (int comp = 0; comp < numComp; ++comp)
+            {
+                unsigned short *dst = (unsigned short *)_rowPtrs[comp][blocky];
+
+                dst[blockx] = _toLinear[((half)dc[comp]).bits()];
+            }
+        }
+    }
+
+    halfXdrToFloatXdr (numBlocksX, numBlocksY);
+}
+
+
+void
+DwaCompressor::LossyDctDecoderBase::skip ()
+{
+    int numComp    = _rowPtrs.size();
+    int numBlocksX = (int) ceil ((float)_width  / 8.0f);
+    int numBlocksY = (int) ceil ((float)_height / 8.0f);
+    int numBlocks  = numComp * numBlocksX * numBlocksY;
+
+    //
+    // There is one DC component per block.  The AC components
+    // of each block are scanned as in unRleAc(), up to the end
+    // of the block.
+    //
+
+    const unsigned short *currAcComp = (const unsigned short *)_packedAc;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        int dctComp = 1;
+
+        while (dctComp < 64)
+        {
+            if (*currAcComp == 0xff00)
+                dctComp = 64;
+            else if ((*currAcComp) >> 8 == 0xff)
+                dctComp += (*currAcComp) & 0xff;
+            else
+                dctComp++;
+
+            _packedAcCount++;
+            currAcComp++;
+        }
+    }
+
+    _packedDcCount += numBlocks;
+}
+
+
+void
+DwaCompressor::LossyDctDecoderBase::halfXdrToFloatXdr (int width, int height)
+{
+    for (unsigned int chan = 0; chan < _rowPtrs.size(); ++chan)
     {
 
         if (_type[chan] != FLOAT)
             continue;
 
-        std::vector<unsigned short> halfXdr (_width);
+        std::vector<unsigned short> halfXdr (width);
 
-        for (int y=0; y<_height; ++y)
+        for (int y=0; y<height; ++y)
         {
             char *floatXdrPtr = _rowPtrs[chan][y];
 
-            memcpy(&halfXdr[0], floatXdrPtr, _width*sizeof(unsigned short));
+            memcpy(&halfXdr[0], floatXdrPtr, width*sizeof(unsigned short));
 
             const char *halfXdrPtr = (const char *)(&halfXdr[0]);
 
-            for (int x=0; x<_width; ++x)
+            for (int x=0; x<width; ++x)
             {
                 half tmpHalf;
 
@@ -1166,8 +1320,6 @@ DwaCompressor::LossyDctDecoderBase::execute ()
             }
         }
     }
-
-    delete[] rowBlockHandle;
 }
 
 
@@ -1510,9 +1662,9 @@ DwaCompressor::LossyDctEncoderBase::execute ()
 
             if (_rowPtrs.size() == 3)
             {
-                csc709Forward64 (_dctData[0]._buffer, 
-                                 _dctData[1]._buffer, 
-                                 _dctData[2]._buffer);
+                csc709Forward64Func (_dctData[0]._buffer, 
+                                     _dctData[1]._buffer, 
+                                     _dctData[2]._buffer);
             }
 
             for (unsigned int chan = 0; chan < _rowPtrs.size(); ++chan)
@@ -1521,7 +1673,7 @@ DwaCompressor::LossyDctEncoderBase::execute ()
                 // Forward DCT
                 //
 
-                dctForward8x8(_dctData[chan]._buffer);
+                dctForward8x8Func(_dctData[chan]._buffer);
 
                 //
                 // Quantize to half, and zigzag
@@ -1804,6 +1956,7 @@ DwaCompressor::DwaCompressor
     _maxScanLineSize(maxScanLineSize),
     _numScanLines(numScanLines),
     _channels(hdr.channels()),
+    _channelsToDecode(hdr.channels()),
     _packedAcBuffer(0),
     _packedAcBufferSize(0),
     _packedDcBuffer(0),
@@ -2328,18 +2481,32 @@ DwaCompressor::uncompressTile
 }
 
 
-int 
-DwaCompressor::uncompress
+bool
+DwaCompressor::setChannelsToDecode (const ChannelList &channels)
+{
+    _channelsToDecode = channels;
+    return true;
+}
+
+
+//
+// Parse the header of a compressed block, set up the channel data
+// for the pixels in [minX, maxX] x [minY, maxY], and uncompress the
+// UNKNOWN, AC, DC and RLE data that the channels to decode need
+// into their buffers.  If dcOnly is true, all channels are decoded,
+// but the AC data are not uncompressed.
+//
+
+void
+DwaCompressor::uncompressStreams
     (const char *inPtr,
      int inSize,
-     Imath::Box2i range,
-     const char *&outPtr)
+     int minX,
+     int minY,
+     int maxX,
+     int maxY,
+     bool dcOnly)
 {
-    int minX = range.min.x;
-    int maxX = std::min (range.max.x, _max[0]);
-    int minY = range.min.y;
-    int maxY = std::min (range.max.y, _max[1]);
-
     int headerSize = NUM_SIZES_SINGLE*sizeof(Int64);
     if (inSize < headerSize) 
     {
@@ -2348,22 +2515,21 @@ DwaCompressor::uncompress
     }
 
     // 
-    // Flip the counters from XDR to NATIVE
+    // Read the counters from XDR to NATIVE.  The input block is
+    // left untouched, so that it can be uncompressed again.
     //
 
-    for (int i = 0; i < NUM_SIZES_SINGLE; ++i)
-    {
-        Int64      *dst =  (((Int64 *)inPtr) + i);
-        const char *src = (char *)(((Int64 *)inPtr) + i);
+    Int64 counters[NUM_SIZES_SINGLE];
+    const char *counterPtr = inPtr;
 
-        Xdr::read<CharPtrIO> (src, *dst);
-    }
+    for (int i = 0; i < NUM_SIZES_SINGLE; ++i)
+        Xdr::read<CharPtrIO> (counterPtr, counters[i]);
 
     //
     // Unwind all the counter info
     //
 
-    const Int64 *inPtr64 = (const Int64*) inPtr;
+    const Int64 *inPtr64 = counters;
 
     Int64 version                  = *(inPtr64 + VERSION);
     Int64 unknownUncompressedSize  = *(inPtr64 + UNKNOWN_UNCOMPRESSED_SIZE);
@@ -2441,38 +2607,7 @@ DwaCompressor::uncompress
 
     size_t outBufferSize = 0;
     initializeBuffers(outBufferSize);
-
-    //
-    // Allocate _outBuffer, if we haven't done so already
-    //
-
-    if (_maxScanLineSize * numScanLines() > _outBufferSize) 
-    {
-        _outBufferSize = _maxScanLineSize * numScanLines();
-        if (_outBuffer != 0)
-            delete[] _outBuffer;
-        _outBuffer = new char[_maxScanLineSize * numScanLines()];
-    }
-
-
-    char *outBufferEnd = _outBuffer;
-
-       
-    //
-    // Find the start of the RLE packed AC components and
-    // the DC components for each channel. This will be handy   
-    // if you want to decode the channels in parallel later on.
-    //
-
-    char *packedAcBufferEnd = 0; 
-
-    if (_packedAcBuffer)
-        packedAcBufferEnd = _packedAcBuffer;
-
-    char *packedDcBufferEnd = 0;
-
-    if (_packedDcBuffer)
-        packedDcBufferEnd = _packedDcBuffer;
+    initializeOutBuffer();
 
     //
     // UNKNOWN data is packed first, followed by the 
@@ -2501,11 +2636,45 @@ DwaCompressor::uncompress
 
     setupChannelData(minX, minY, maxX, maxY);
 
+    //
+    // Find the channels to decode, and the data they need.  The
+    // channels of a color space converted set are decoded together.
+    //
+
+    bool decodeScheme[NUM_COMPRESSOR_SCHEMES];
+
+    for (int i = 0; i < NUM_COMPRESSOR_SCHEMES; ++i)
+        decodeScheme[i] = false;
+
+    for (unsigned int chan = 0; chan < _channelData.size(); ++chan)
+    {
+        _channelData[chan].decode =
+            dcOnly ||
+            _channelsToDecode.findChannel (_channelData[chan].name) != 0;
+    }
+
+    for (unsigned int csc = 0; csc < _cscSets.size(); ++csc)
+    {
+        bool decode = false;
+
+        for (int comp = 0; comp < 3; ++comp)
+            decode = decode || _channelData[_cscSets[csc].idx[comp]].decode;
+
+        for (int comp = 0; comp < 3; ++comp)
+            _channelData[_cscSets[csc].idx[comp]].decode = decode;
+    }
+
+    for (unsigned int chan = 0; chan < _channelData.size(); ++chan)
+    {
+        if (_channelData[chan].decode)
+            decodeScheme[_channelData[chan].compression] = true;
+    }
+
     // 
     // Uncompress the UNKNOWN data into _planarUncBuffer[UNKNOWN]
     //
 
-    if (unknownCompressedSize > 0)
+    if (decodeScheme[UNKNOWN] && unknownCompressedSize > 0)
     {
         if (unknownUncompressedSize > _planarUncBufferSize[UNKNOWN]) 
         {
@@ -2529,7 +2698,7 @@ DwaCompressor::uncompress
     // Uncompress the AC data into _packedAcBuffer
     //
 
-    if (acCompressedSize > 0)
+    if (decodeScheme[LOSSY_DCT] && !dcOnly && acCompressedSize > 0)
     {
         if (totalAcUncompressedCount*sizeof(unsigned short) > _packedAcBufferSize)
         {
@@ -2586,7 +2755,7 @@ DwaCompressor::uncompress
     // Uncompress the DC data into _packedDcBuffer
     //
 
-    if (dcCompressedSize > 0)
+    if (decodeScheme[LOSSY_DCT] && dcCompressedSize > 0)
     {
         if (totalDcUncompressedCount*sizeof(unsigned short) > _packedDcBufferSize)
         {
@@ -2607,7 +2776,7 @@ DwaCompressor::uncompress
     // into _planarUncBuffer[RLE]
     //
 
-    if (rleRawSize > 0)
+    if (decodeScheme[RLE] && rleRawSize > 0)
     {
         if (rleUncompressedSize > _rleBufferSize ||
             rleRawSize > _planarUncBufferSize[RLE])
@@ -2639,6 +2808,32 @@ DwaCompressor::uncompress
             throw Iex::BaseExc("RLE data corrupted");
         }
     }
+}
+
+
+int 
+DwaCompressor::uncompress
+    (const char *inPtr,
+     int inSize,
+     Imath::Box2i range,
+     const char *&outPtr)
+{
+    int minX = range.min.x;
+    int maxX = std::min (range.max.x, _max[0]);
+    int minY = range.min.y;
+    int maxY = std::min (range.max.y, _max[1]);
+
+    uncompressStreams (inPtr, inSize, minX, minY, maxX, maxY, false);
+
+    //
+    // Find the start of the RLE packed AC components and
+    // the DC components for each channel. This will be handy   
+    // if you want to decode the channels in parallel later on.
+    //
+
+    char *packedAcBufferEnd = _packedAcBuffer;
+    char *packedDcBufferEnd = _packedDcBuffer;
+    char *outBufferEnd      = _outBuffer;
 
     //
     // Determine the start of each row in the output buffer
@@ -2650,8 +2845,6 @@ DwaCompressor::uncompress
     for (unsigned int chan = 0; chan < _channelData.size(); ++chan)
         decodedChannels[chan] = false;
 
-    outBufferEnd = _outBuffer;
-
     for (int y = minY; y <= maxY; ++y)
     {
         for (unsigned int chan = 0; chan < _channelData.size(); ++chan)
@@ -2666,6 +2859,23 @@ DwaCompressor::uncompress
         }
     }
 
+    //
+    // The AC and DC data have only been uncompressed if some lossy
+    // DCT channels are decoded.  In that case, the channels that
+    // are not decoded must still be skipped.
+    //
+
+    bool decodeDct = false;
+
+    for (unsigned int chan = 0; chan < _channelData.size(); ++chan)
+    {
+        if (_channelData[chan].compression == LOSSY_DCT &&
+            _channelData[chan].decode)
+        {
+            decodeDct = true;
+        }
+    }
+
     //
     // Setup to decode each block of 3 channels that need to
     // be handled together
@@ -2691,7 +2901,10 @@ DwaCompressor::uncompress
              _channelData[gChan].type,
              _channelData[bChan].type);
 
-        decoder.execute();
+        if (_channelData[rChan].decode)
+            decoder.execute();
+        else if (decodeDct)
+            decoder.skip();
 
         packedAcBufferEnd +=
             decoder.numAcValuesEncoded() * sizeof (unsigned short);
@@ -2740,7 +2953,10 @@ DwaCompressor::uncompress
                      cd->height,
                      cd->type);
 
-                decoder.execute();   
+                if (cd->decode)
+                    decoder.execute();
+                else if (decodeDct)
+                    decoder.skip();
 
                 packedAcBufferEnd += 
                     decoder.numAcValuesEncoded() * sizeof (unsigned short);
@@ -2760,6 +2976,7 @@ DwaCompressor::uncompress
             // order in the output buffer;
             //
 
+            if (cd->decode)
             {
                 int row = 0;
 
@@ -2804,6 +3021,7 @@ DwaCompressor::uncompress
             // and just needs to copied over to the output buffer
             //
 
+            if (cd->decode)
             {
                 int row             = 0;
                 int dstScanlineSize = cd->width * Imf::pixelTypeSize (cd->type);
@@ -2842,6 +3060,284 @@ DwaCompressor::uncompress
 }
 
 
+namespace {
+
+//
+// Add one scan line of a channel to a reduced-resolution scan line:
+// row points to the y-th of height scan lines of width samples, in
+// XDR format, and reducedRow to the scan line at 1/8 resolution that
+// row y contributes to.  HALF and FLOAT samples are averaged over
+// each 8x8 block; sums holds the running sums for the current row
+// of blocks.  For UINT samples, the block's top-left sample is kept.
+//
+
+void
+reduceRow (const char *row,
+           PixelType type,
+           int width,
+           int y,
+           int height,
+           std::vector<float> &sums,
+           char *reducedRow)
+{
+    int numBlocksX = (width + 7) / 8;
+
+    if (type == UINT)
+    {
+        if (y % 8 == 0)
+        {
+            for (int blockx = 0; blockx < numBlocksX; ++blockx)
+                memcpy (reducedRow + blockx * sizeof (unsigned int),
+                        row + blockx * 8 * sizeof (unsigned int),
+                        sizeof (unsigned int));
+        }
+
+        return;
+    }
+
+    if (y % 8 == 0)
+        sums.assign (numBlocksX, 0.0f);
+
+    for (int x = 0; x < width; ++x)
+    {
+        if (type == HALF)
+        {
+            half h;
+            Xdr::read<CharPtrIO> (row, h);
+            sums[x / 8] += (float)h;
+        }
+        else
+        {
+            float f;
+            Xdr::read<CharPtrIO> (row, f);
+            sums[x / 8] += f;
+        }
+    }
+
+    if (y % 8 != 7 && y != height - 1)
+        return;
+
+    int rowsInBlock = y % 8 + 1;
+
+    for (int blockx = 0; blockx < numBlocksX; ++blockx)
+    {
+        int pixelsInBlock = std::min (8, width - 8 * blockx) * rowsInBlock;
+        float average = sums[blockx] / pixelsInBlock;
+
+        if (type == HALF)
+            Xdr::write<CharPtrIO> (reducedRow, (half)average);
+        else
+            Xdr::write<CharPtrIO> (reducedRow, average);
+    }
+}
+
+} // namespace
+
+
+int
+DwaCompressor::uncompressDcOnly
+    (const char *inPtr,
+     int inSize,
+     int minY,
+     const char *&outPtr)
+{
+    int minX = _min[0];
+    int maxX = _max[0];
+    int maxY = std::min (minY + numScanLines() - 1, _max[1]);
+
+    uncompressStreams (inPtr, inSize, minX, minY, maxX, maxY, true);
+
+    std::vector< std::vector<char *> > rowPtrs;
+    char *outBufferEnd = reducedRowPointers (minY, maxY, rowPtrs);
+
+    char *packedDcBufferEnd = _packedDcBuffer;
+
+    std::vector<bool> decodedChannels (_channelData.size(), false);
+
+    //
+    // Decode the DC components of the color space converted sets of
+    // channels first, and then those of the remaining lossy DCT
+    // channels, in the same order as uncompress().  The AC buffer
+    // is never read.
+    //
+
+    for (unsigned int csc = 0; csc < _cscSets.size(); ++csc)
+    {
+        int rChan = _cscSets[csc].idx[0];    
+        int gChan = _cscSets[csc].idx[1];    
+        int bChan = _cscSets[csc].idx[2];    
+
+        LossyDctDecoderCsc decoder
+            (rowPtrs[rChan],
+             rowPtrs[gChan],
+             rowPtrs[bChan],
+             0,
+             packedDcBufferEnd,
+             dwaCompressorToLinear,
+             _channelData[rChan].width,
+             _channelData[rChan].height,
+             _channelData[rChan].type,
+             _channelData[gChan].type,
+             _channelData[bChan].type);
+
+        decoder.executeDcOnly();
+
+        packedDcBufferEnd +=
+            decoder.numDcValuesEncoded() * sizeof (unsigned short);
+
+        decodedChannels[rChan] = true;
+        decodedChannels[gChan] = true;
+        decodedChannels[bChan] = true;
+    }
+
+    std::vector<char>  row;
+    std::vector<float> sums;
+
+    for (unsigned int chan = 0; chan < _channelData.size(); ++chan)
+    {
+        if (decodedChannels[chan])
+            continue;
+
+        ChannelData *cd = &_channelData[chan];
+        int pixelSize = Imf::pixelTypeSize (cd->type);
+
+        switch (cd->compression)
+        {
+          case LOSSY_DCT:
+
+            {
+                const unsigned short *linearLut = 0;
+
+                if (!cd->pLinear)
+                    linearLut = dwaCompressorToLinear;
+
+                LossyDctDecoder decoder
+                    (rowPtrs[chan],
+                     0,
+                     packedDcBufferEnd,
+                     linearLut,
+                     cd->width,
+                     cd->height,
+                     cd->type);
+
+                decoder.executeDcOnly();   
+
+                packedDcBufferEnd += 
+                    decoder.numDcValuesEncoded() * sizeof (unsigned short);
+            }
+
+            break;
+
+          case RLE:
+
+            //
+            // Put the bytes of each scan line back in order,
+            // and then reduce the scan line.
+            //
+
+            row.resize (cd->width * pixelSize);
+
+            for (int y = 0; y < cd->height; ++y)
+            {
+                char *dst = &row[0];
+
+                for (int x = 0; x < cd->width; ++x)
+                {
+                    for (int byte = 0; byte < pixelSize; ++byte)
+                        *dst++ = *cd->planarUncRleEnd[byte]++;
+                }
+
+                reduceRow (&row[0], cd->type, cd->width, y, cd->height,
+                           sums, rowPtrs[chan][y / 8]);
+            }
+
+            break;
+
+          case UNKNOWN:
+
+            for (int y = 0; y < cd->height; ++y)
+            {
+                reduceRow (cd->planarUncBufferEnd, cd->type, cd->width,
+                           y, cd->height, sums, rowPtrs[chan][y / 8]);
+
+                cd->planarUncBufferEnd += cd->width * pixelSize;
+            }
+
+            break;
+
+          default:
+
+            throw Iex::NoImplExc ("Unhandled compression scheme case");
+            break;
+        }
+
+        decodedChannels[chan] = true;
+    }
+
+    outPtr = _outBuffer;
+    return (int)(outBufferEnd - _outBuffer);
+}
+
+
+int
+DwaCompressor::reduceUncompressed
+    (const char *inPtr,
+     int inSize,
+     int minY,
+     const char *&outPtr)
+{
+    int maxY = std::min (minY + numScanLines() - 1, _max[1]);
+    int width = _max[0] - _min[0] + 1;
+    int height = maxY - minY + 1;
+
+    std::vector< std::vector<char *> > rowPtrs;
+    char *outBufferEnd = reducedRowPointers (minY, maxY, rowPtrs);
+
+    int bytesPerLine = 0;
+
+    for (ChannelList::ConstIterator c = _channels.begin();
+         c != _channels.end();
+         ++c)
+    {
+        bytesPerLine += width * Imf::pixelTypeSize (c.channel().type);
+    }
+
+    if (inSize < bytesPerLine * height)
+    {
+        throw Iex::InputExc("Error reducing DWA data"
+                            " (truncated block).");
+    }
+
+    std::vector<float> sums;
+
+    //
+    // The scan lines hold the channels one after the other;
+    // reduce the channels one at a time.
+    //
+
+    int chan = 0;
+    int offset = 0;
+
+    for (ChannelList::ConstIterator c = _channels.begin();
+         c != _channels.end();
+         ++c, ++chan)
+    {
+        PixelType type = c.channel().type;
+
+        for (int y = 0; y < height; ++y)
+        {
+            reduceRow (inPtr + y * bytesPerLine + offset, type, width,
+                       y, height, sums, rowPtrs[chan][y / 8]);
+        }
+
+        offset += width * Imf::pixelTypeSize (type);
+    }
+
+    outPtr = _outBuffer;
+    return (int)(outBufferEnd - _outBuffer);
+}
+
+
 // static
 void
 DwaCompressor::initializeFuncs()
@@ -2896,6 +3392,48 @@ DwaCompressor::initializeFuncs()
         dctInverse8x8_6 = dctInverse8x8_sse2<6>;
         dctInverse8x8_7 = dctInverse8x8_sse2<7>;
     }
+
+    dctForward8x8Func   = dctForward8x8;
+    csc709Forward64Func = csc709Forward64;
+    csc709Inverse64Func = csc709Inverse64;
+
+    //
+    // Setup the AVX2 and AVX-512 implementations.  Unlike the
+    // AVX inverse DCT above, these produce the same results as
+    // the scalar inverse DCT and the baseline forward DCT and
+    // color space conversions. There is no separate AVX-512 DCT;
+    // on 8x8 blocks, the transposes limit the gain from 16-wide
+    // registers, and the AVX2 version is used.
+    //
+
+#ifdef IMF_HAVE_DWA_WIDE_KERNELS
+
+    if (cpuId.avx && cpuId.avx2 && cpuId.f16c)
+    {
+        dctInverse8x8_0 = dctInverse8x8_avx2<0>;
+        dctInverse8x8_1 = dctInverse8x8_avx2<1>;
+        dctInverse8x8_2 = dctInverse8x8_avx2<2>;
+        dctInverse8x8_3 = dctInverse8x8_avx2<3>;
+        dctInverse8x8_4 = dctInverse8x8_avx2<4>;
+        dctInverse8x8_5 = dctInverse8x8_avx2<5>;
+        dctInverse8x8_6 = dctInverse8x8_avx2<6>;
+        dctInverse8x8_7 = dctInverse8x8_avx2<7>;
+
+        dctForward8x8Func   = dctForward8x8_avx2;
+        csc709Forward64Func = csc709Forward64_avx2;
+        csc709Inverse64Func = csc709Inverse64_avx2;
+
+        if (cpuId.avx512f && cpuId.avx512bw)
+        {
+            convertFloatToHalf64 = convertFloatToHalf64_avx512;
+            fromHalfZigZag       = fromHalfZigZag_avx512;
+
+            csc709Forward64Func = csc709Forward64_avx512;
+            csc709Inverse64Func = csc709Inverse64_avx512;
+        }
+    }
+
+#endif
 }
 
 
@@ -3127,6 +3665,23 @@ DwaCompressor::initializeBuffers (size_t &outBufferSize)
 }
 
 
+//
+// Allocate _outBuffer, if we haven't done so already
+//
+
+void
+DwaCompressor::initializeOutBuffer ()
+{
+    if (_maxScanLineSize * numScanLines() > _outBufferSize) 
+    {
+        _outBufferSize = _maxScanLineSize * numScanLines();
+        if (_outBuffer != 0)
+            delete[] _outBuffer;
+        _outBuffer = new char[_maxScanLineSize * numScanLines()];
+    }
+}
+
+
 //
 // Setup channel classification rules to use when writing files
 //
@@ -3275,6 +3830,7 @@ DwaCompressor::classifyChannels
         chanData[offset].ySampling   = c.channel().ySampling;
         chanData[offset].type        = c.channel().type;
         chanData[offset].pLinear     = c.channel().pLinear;
+        chanData[offset].decode      = true;
 
         offset++;
     }
@@ -3436,4 +3992,58 @@ DwaCompressor::setupChannelData (int minX, int minY, int maxX, int maxY)
     }
 }
 
+
+char *
+DwaCompressor::reducedRowPointers
+    (int minY,
+     int maxY,
+     std::vector< std::vector<char *> > &rowPtrs)
+{
+    for (ChannelList::ConstIterator c = _channels.begin();
+         c != _channels.end();
+         ++c)
+    {
+        if (c.channel().xSampling != 1 || c.channel().ySampling != 1)
+        {
+            throw Iex::NoImplExc ("Cannot decode DWA data at reduced "
+                                  "resolution (subsampled channels "
+                                  "are not supported).");
+        }
+    }
+
+    initializeOutBuffer();
+
+    int reducedWidth  = (_max[0] - _min[0] + 8) / 8;
+    int reducedHeight = (maxY - minY + 8) / 8;
+
+    int numChan = 0;
+
+    for (ChannelList::ConstIterator c = _channels.begin();
+         c != _channels.end();
+         ++c)
+    {
+        numChan++;
+    }
+
+    rowPtrs.clear();
+    rowPtrs.resize (numChan);
+
+    char *outBufferEnd = _outBuffer;
+
+    for (int y = 0; y < reducedHeight; ++y)
+    {
+        int chan = 0;
+
+        for (ChannelList::ConstIterator c = _channels.begin();
+             c != _channels.end();
+             ++c, ++chan)
+        {
+            rowPtrs[chan].push_back (outBufferEnd);
+            outBufferEnd += reducedWidth * Imf::pixelTypeSize (c.channel().type);
+        }
+    }
+
+    return outBufferEnd;
+}
+
 OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -101,6 +101,52 @@ class DwaCompressor: public Compressor
                                 Imath::Box2i range,
                                 const char *&outPtr);
 
+    //
+    // Only the streams that hold the requested channels are
+    // uncompressed.  Lossy DCT channels that were not requested
+    // skip the inverse DCT and color space conversion; a set of
+    // color space converted channels is decoded if any one of
+    // its channels was requested.
+    //
+
+    IMF_EXPORT
+    virtual bool setChannelsToDecode (const ChannelList &channels);
+
+    //
+    // Reduced-resolution decoding:
+    //
+    // uncompressDcOnly() decodes a compressed block of scan lines at
+    // 1/8 of its full width and height.  For channels that use the
+    // lossy DCT, only the DC component of each 8x8 block is decoded;
+    // the AC components are not uncompressed, and no inverse DCT is
+    // run.  Each output pixel gets the value that uncompress() would
+    // give the pixels of its block if the block had no AC components.
+    // Other channels are uncompressed in full, and each output pixel
+    // is the average of its block (for UINT channels, the block's
+    // top-left sample).
+    //
+    // reduceUncompressed() does the same for a block that was stored
+    // without compression, in XDR format, by averaging each block.
+    //
+    // The output holds ceil(h/8) scan lines of ceil(w/8) pixels, where
+    // w is the width of the data window and h the number of scan lines
+    // in the block, laid out like the scan lines of an uncompressed
+    // block, in the format returned by format().  Files that contain
+    // subsampled channels cannot be decoded this way.
+    //
+
+    IMF_EXPORT
+    int uncompressDcOnly (const char *inPtr,
+                          int         inSize,
+                          int         minY,
+                          const char *&outPtr);
+
+    IMF_EXPORT
+    int reduceUncompressed (const char *inPtr,
+                            int         inSize,
+                            int         minY,
+                            const char *&outPtr);
+
     IMF_EXPORT
     static void initializeFuncs ();
 
@@ -160,6 +206,7 @@ class DwaCompressor: public Compressor
     int               _min[2], _max[2];
 
     ChannelList                _channels;
+    ChannelList                _channelsToDecode;
     std::vector<ChannelData>   _channelData;
     std::vector<CscChannelSet> _cscSets;
     std::vector<Classifier>    _channelRules;
@@ -188,7 +235,16 @@ class DwaCompressor: public Compressor
                     Imath::Box2i  range,
                     const char  *&outPtr);
 
+    void uncompressStreams (const char   *inPtr,
+                            int           inSize,
+                            int           minX,
+                            int           minY,
+                            int           maxX,
+                            int           maxY,
+                            bool          dcOnly);
+
     void initializeBuffers (size_t&);
+    void initializeOutBuffer ();
     void initializeDefaultChannelRules ();
     void initializeLegacyChannelRules ();
 
@@ -212,6 +268,14 @@ class DwaCompressor: public Compressor
     //
 
     void setupChannelData (int minX, int minY, int maxX, int maxY);
+
+    //
+    // Find the start of each scan line of each channel in the
+    // output of uncompressDcOnly() and reduceUncompressed()
+    //
+
+    char *reducedRowPointers (int minY, int maxY,
+                              std::vector< std::vector<char *> > &rowPtrs);
 };
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
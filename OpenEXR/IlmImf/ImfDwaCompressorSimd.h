@@ -50,9 +50,36 @@
 
 #include <half.h>
 #include <assert.h>
+#include <math.h>
 
 #include <algorithm>
 
+//
+// Test if we can compile the AVX2 and AVX-512 kernels.  Like the
+// kernels in ImfPixelCopySimd.cpp, they are compiled with GCC style
+// target attributes and selected at run time, in
+// DwaCompressor::initializeFuncs().  Contraction of multiplies and
+// adds into FMA instructions (which AVX-512 implies) is disabled,
+// so that the results are bit-for-bit identical to the baseline
+// implementations.
+//
+
+#if defined (IMF_HAVE_SSE2) && \
+    defined (OPENEXR_IMF_HAVE_GCC_INLINE_ASM_AVX) && \
+    defined (OPENEXR_IMF_HAVE_GCC_TARGET_AVX512)
+
+    #define IMF_HAVE_DWA_WIDE_KERNELS 1
+    #include <immintrin.h>
+
+    #define IMF_AVX2_KERNEL \
+        __attribute__((target("avx2,f16c"), optimize("fp-contract=off")))
+
+    #define IMF_AVX512_KERNEL \
+        __attribute__((target("avx2,f16c,avx512f,avx512bw"), \
+                       optimize("fp-contract=off")))
+
+#endif
+
 OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
 
 #define _SSE_ALIGNMENT        32
@@ -2165,6 +2192,658 @@ dctForward8x8 (float *data)
 
 #endif /* IMF_HAVE_SSE2 */
 
+#ifdef IMF_HAVE_DWA_WIDE_KERNELS
+
+//
+// AVX2 and AVX-512 kernels
+//
+// The inverse DCT and the color space conversions below perform
+// exactly the same floating point operations as dctInverse8x8_scalar(),
+// csc709Inverse() and csc709Forward64(), in the same order, but on
+// 8 or 16 values at a time.  dctForward8x8_avx2() likewise mirrors
+// the SSE2 dctForward8x8(), so the compressed data do not depend on
+// which kernel was selected.
+//
+// The kernels do not require more alignment than the SSE2 and F16C
+// versions that they replace.
+//
+
+//
+// Load and store the 8 rows of a block
+//
+
+IMF_AVX2_KERNEL inline void
+loadRows_avx2 (const float *data, __m256 r[8])
+{
+    r[0] = _mm256_load_ps (data);
+    r[1] = _mm256_load_ps (data +  8);
+    r[2] = _mm256_load_ps (data + 16);
+    r[3] = _mm256_load_ps (data + 24);
+    r[4] = _mm256_load_ps (data + 32);
+    r[5] = _mm256_load_ps (data + 40);
+    r[6] = _mm256_load_ps (data + 48);
+    r[7] = _mm256_load_ps (data + 56);
+}
+
+
+IMF_AVX2_KERNEL inline void
+storeRows_avx2 (float *data, const __m256 r[8])
+{
+    _mm256_store_ps (data,      r[0]);
+    _mm256_store_ps (data +  8, r[1]);
+    _mm256_store_ps (data + 16, r[2]);
+    _mm256_store_ps (data + 24, r[3]);
+    _mm256_store_ps (data + 32, r[4]);
+    _mm256_store_ps (data + 40, r[5]);
+    _mm256_store_ps (data + 48, r[6]);
+    _mm256_store_ps (data + 56, r[7]);
+}
+
+
+//
+// Transpose the 4x4 blocks within the 128-bit lanes of a, b, c
+// and d.  Half of the shuffles are replaced with blends, which
+// can run on more execution ports.
+//
+
+IMF_AVX2_KERNEL inline void
+transpose4x4Lanes_avx2 (__m256 &a, __m256 &b, __m256 &c, __m256 &d)
+{
+    __m256 t0 = _mm256_unpacklo_ps (a, b);
+    __m256 t1 = _mm256_unpackhi_ps (a, b);
+    __m256 t2 = _mm256_unpacklo_ps (c, d);
+    __m256 t3 = _mm256_unpackhi_ps (c, d);
+
+    __m256 u0 = _mm256_shuffle_ps (t0, t2, 0x4E);
+    __m256 u1 = _mm256_shuffle_ps (t1, t3, 0x4E);
+
+    a = _mm256_blend_ps (t0, u0, 0xCC);
+    b = _mm256_blend_ps (u0, t2, 0xCC);
+    c = _mm256_blend_ps (t1, u1, 0xCC);
+    d = _mm256_blend_ps (u1, t3, 0xCC);
+}
+
+
+//
+// Transpose an 8x8 block of floats, held in 8 rows
+//
+
+IMF_AVX2_KERNEL inline void
+transpose8x8_avx2 (__m256 r[8])
+{
+    transpose4x4Lanes_avx2 (r[0], r[1], r[2], r[3]);
+    transpose4x4Lanes_avx2 (r[4], r[5], r[6], r[7]);
+
+    __m256 s0 = r[0];
+    __m256 s1 = r[1];
+    __m256 s2 = r[2];
+    __m256 s3 = r[3];
+
+    r[0] = _mm256_permute2f128_ps (s0, r[4], 0x20);
+    r[1] = _mm256_permute2f128_ps (s1, r[5], 0x20);
+    r[2] = _mm256_permute2f128_ps (s2, r[6], 0x20);
+    r[3] = _mm256_permute2f128_ps (s3, r[7], 0x20);
+    r[4] = _mm256_permute2f128_ps (s0, r[4], 0x31);
+    r[5] = _mm256_permute2f128_ps (s1, r[5], 0x31);
+    r[6] = _mm256_permute2f128_ps (s2, r[6], 0x31);
+    r[7] = _mm256_permute2f128_ps (s3, r[7], 0x31);
+}
+
+
+//
+// Load the transpose of an 8x8 block.  Loading the halves of the
+// rows such that rows i and i+4 share a register leaves only the
+// 4x4 transposes within the lanes to do.
+//
+
+IMF_AVX2_KERNEL inline __m256
+loadHalves_avx2 (const float *lo, const float *hi)
+{
+    return _mm256_insertf128_ps (_mm256_castps128_ps256 (_mm_load_ps (lo)),
+                                 _mm_load_ps (hi), 1);
+}
+
+
+IMF_AVX2_KERNEL inline void
+loadTransposed_avx2 (const float *data, __m256 r[8])
+{
+    r[0] = loadHalves_avx2 (data,      data + 32);
+    r[1] = loadHalves_avx2 (data +  8, data + 40);
+    r[2] = loadHalves_avx2 (data + 16, data + 48);
+    r[3] = loadHalves_avx2 (data + 24, data + 56);
+    r[4] = loadHalves_avx2 (data +  4, data + 36);
+    r[5] = loadHalves_avx2 (data + 12, data + 44);
+    r[6] = loadHalves_avx2 (data + 20, data + 52);
+    r[7] = loadHalves_avx2 (data + 28, data + 60);
+
+    transpose4x4Lanes_avx2 (r[0], r[1], r[2], r[3]);
+    transpose4x4Lanes_avx2 (r[4], r[5], r[6], r[7]);
+}
+
+
+//
+// Store the transpose of an 8x8 block, the reverse of
+// loadTransposed_avx2().
+//
+
+IMF_AVX2_KERNEL inline void
+storeHalves_avx2 (float *lo, float *hi, __m256 r)
+{
+    _mm_store_ps (lo, _mm256_castps256_ps128 (r));
+    _mm_store_ps (hi, _mm256_extractf128_ps (r, 1));
+}
+
+
+IMF_AVX2_KERNEL inline void
+storeTransposed_avx2 (float *data, __m256 r[8])
+{
+    transpose4x4Lanes_avx2 (r[0], r[1], r[2], r[3]);
+    transpose4x4Lanes_avx2 (r[4], r[5], r[6], r[7]);
+
+    storeHalves_avx2 (data,      data + 32, r[0]);
+    storeHalves_avx2 (data +  8, data + 40, r[1]);
+    storeHalves_avx2 (data + 16, data + 48, r[2]);
+    storeHalves_avx2 (data + 24, data + 56, r[3]);
+    storeHalves_avx2 (data +  4, data + 36, r[4]);
+    storeHalves_avx2 (data + 12, data + 44, r[5]);
+    storeHalves_avx2 (data + 20, data + 52, r[6]);
+    storeHalves_avx2 (data + 28, data + 60, r[7]);
+}
+
+
+//
+// The constants of dctInverse8x8_scalar(), computed the same way
+//
+
+struct DctInverseCoefficients
+{
+    float a, b, c, d, e, f, g;
+
+    DctInverseCoefficients ():
+        a (.5f * cosf (3.14159f / 4.0f)),
+        b (.5f * cosf (3.14159f / 16.0f)),
+        c (.5f * cosf (3.14159f / 8.0f)),
+        d (.5f * cosf (3.f*3.14159f / 16.0f)),
+        e (.5f * cosf (5.f*3.14159f / 16.0f)),
+        f (.5f * cosf (3.f*3.14159f / 8.0f)),
+        g (.5f * cosf (7.f*3.14159f / 16.0f))
+    {}
+};
+
+
+//
+// One 1D pass of dctInverse8x8_scalar(), on 8 columns (or, after a
+// transpose, rows) at a time.  k[] holds the constants a through g.
+//
+
+IMF_AVX2_KERNEL inline void
+dctInverse1D_avx2 (__m256 y[8], const __m256 k[7])
+{
+    __m256 alpha[4], beta[4], theta[4], gamma[4];
+
+    alpha[0] = _mm256_mul_ps (k[2], y[2]);
+    alpha[1] = _mm256_mul_ps (k[5], y[2]);
+    alpha[2] = _mm256_mul_ps (k[2], y[6]);
+    alpha[3] = _mm256_mul_ps (k[5], y[6]);
+
+    beta[0] = _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (
+                  _mm256_mul_ps (k[1], y[1]), _mm256_mul_ps (k[3], y[3])),
+                  _mm256_mul_ps (k[4], y[5])), _mm256_mul_ps (k[6], y[7]));
+
+    beta[1] = _mm256_sub_ps (_mm256_sub_ps (_mm256_sub_ps (
+                  _mm256_mul_ps (k[3], y[1]), _mm256_mul_ps (k[6], y[3])),
+                  _mm256_mul_ps (k[1], y[5])), _mm256_mul_ps (k[4], y[7]));
+
+    beta[2] = _mm256_add_ps (_mm256_add_ps (_mm256_sub_ps (
+                  _mm256_mul_ps (k[4], y[1]), _mm256_mul_ps (k[1], y[3])),
+                  _mm256_mul_ps (k[6], y[5])), _mm256_mul_ps (k[3], y[7]));
+
+    beta[3] = _mm256_sub_ps (_mm256_add_ps (_mm256_sub_ps (
+                  _mm256_mul_ps (k[6], y[1]), _mm256_mul_ps (k[4], y[3])),
+                  _mm256_mul_ps (k[3], y[5])), _mm256_mul_ps (k[1], y[7]));
+
+    theta[0] = _mm256_mul_ps (k[0], _mm256_add_ps (y[0], y[4]));
+    theta[3] = _mm256_mul_ps (k[0], _mm256_sub_ps (y[0], y[4]));
+
+    theta[1] = _mm256_add_ps (alpha[0], alpha[3]);
+    theta[2] = _mm256_sub_ps (alpha[1], alpha[2]);
+
+    gamma[0] = _mm256_add_ps (theta[0], theta[1]);
+    gamma[1] = _mm256_add_ps (theta[3], theta[2]);
+    gamma[2] = _mm256_sub_ps (theta[3], theta[2]);
+    gamma[3] = _mm256_sub_ps (theta[0], theta[1]);
+
+    y[0] = _mm256_add_ps (gamma[0], beta[0]);
+    y[1] = _mm256_add_ps (gamma[1], beta[1]);
+    y[2] = _mm256_add_ps (gamma[2], beta[2]);
+    y[3] = _mm256_add_ps (gamma[3], beta[3]);
+
+    y[4] = _mm256_sub_ps (gamma[3], beta[3]);
+    y[5] = _mm256_sub_ps (gamma[2], beta[2]);
+    y[6] = _mm256_sub_ps (gamma[1], beta[1]);
+    y[7] = _mm256_sub_ps (gamma[0], beta[0]);
+}
+
+
+//
+// The row pass of dctInverse8x8_scalar() on a single row, without
+// transposing:  the elements of the row are broadcast, and each
+// lane computes one output with the constants that the scalar code
+// uses for it.  The lanes compute gamma[i] and beta[i] in the order
+//
+//     0 1 2 3 3 2 1 0
+//
+// and the output is gamma + beta in the lower half, and gamma - beta
+// in the upper half.  Subtracting a product is replaced by adding
+// the product with the negated constant, which gives the same
+// result.
+//
+
+struct DctInverseRowCoefficients
+{
+    __m256 a;           // a
+    __m256 sign4;       // sign of in[4] in theta[0] and theta[3]
+    __m256 k2, k6;      // theta[1] and theta[2]
+    __m256 k1, k3, k5, k7;  // beta[]
+
+    IMF_AVX2_KERNEL
+    DctInverseRowCoefficients (const DctInverseCoefficients &c)
+    {
+        a     = _mm256_set1_ps (c.a);
+        sign4 = _mm256_setr_ps (1, -1, -1, 1, 1, -1, -1, 1);
+        k2    = _mm256_setr_ps (c.c,  c.f,  c.f, c.c, c.c,  c.f,  c.f, c.c);
+        k6    = _mm256_setr_ps (c.f, -c.c, -c.c, c.f, c.f, -c.c, -c.c, c.f);
+        k1    = _mm256_setr_ps (c.b,  c.d,  c.e,  c.g,  c.g,  c.e,  c.d, c.b);
+        k3    = _mm256_setr_ps (c.d, -c.g, -c.b, -c.e, -c.e, -c.b, -c.g, c.d);
+        k5    = _mm256_setr_ps (c.e, -c.b,  c.g,  c.d,  c.d,  c.g, -c.b, c.e);
+        k7    = _mm256_setr_ps (c.g, -c.e,  c.d, -c.b, -c.b,  c.d, -c.e, c.g);
+    }
+};
+
+
+IMF_AVX2_KERNEL inline __m256
+dctInverseRow_avx2 (const float *row, const DctInverseRowCoefficients &k)
+{
+    __m256 theta03 = _mm256_mul_ps
+        (k.a, _mm256_add_ps (_mm256_broadcast_ss (row),
+                             _mm256_mul_ps (_mm256_broadcast_ss (row + 4),
+                                            k.sign4)));
+
+    __m256 theta12 = _mm256_add_ps
+        (_mm256_mul_ps (k.k2, _mm256_broadcast_ss (row + 2)),
+         _mm256_mul_ps (k.k6, _mm256_broadcast_ss (row + 6)));
+
+    __m256 gamma = _mm256_blend_ps (_mm256_add_ps (theta03, theta12),
+                                    _mm256_sub_ps (theta03, theta12), 0x3C);
+
+    __m256 beta = _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (
+                      _mm256_mul_ps (k.k1, _mm256_broadcast_ss (row + 1)),
+                      _mm256_mul_ps (k.k3, _mm256_broadcast_ss (row + 3))),
+                      _mm256_mul_ps (k.k5, _mm256_broadcast_ss (row + 5))),
+                      _mm256_mul_ps (k.k7, _mm256_broadcast_ss (row + 7)));
+
+    return _mm256_blend_ps (_mm256_add_ps (gamma, beta),
+                            _mm256_sub_ps (gamma, beta), 0xF0);
+}
+
+
+//
+// Inverse 8x8 DCT, AVX2.  If only a few rows are non-zero, the row
+// pass is done one row at a time, with dctInverseRow_avx2().  For
+// the other blocks, the row pass runs on all 8 rows of the transposed
+// block at once (the rows that the caller has declared to be zero
+// stay zero).
+//
+
+template <int zeroedRows>
+IMF_AVX2_KERNEL void
+dctInverse8x8_avx2 (float *data)
+{
+    const DctInverseCoefficients coef;
+
+    const __m256 k[7] =
+    {
+        _mm256_set1_ps (coef.a), _mm256_set1_ps (coef.b),
+        _mm256_set1_ps (coef.c), _mm256_set1_ps (coef.d),
+        _mm256_set1_ps (coef.e), _mm256_set1_ps (coef.f),
+        _mm256_set1_ps (coef.g)
+    };
+
+    //
+    // (The loops over the 8 rows are written out, so that
+    // the compiler keeps the rows in registers.)
+    //
+
+    __m256 v[8];
+
+    if (zeroedRows == 7)
+    {
+        //
+        // Only the first row is non-zero.  With rows 1 to 7 all +0,
+        // the column pass reduces to the expressions below (note
+        // that x + 0 is x, except for x = -0).
+        //
+
+        const __m256 zero = _mm256_setzero_ps();
+
+        __m256 y0 = dctInverseRow_avx2 (data, DctInverseRowCoefficients (coef));
+        __m256 t0 = _mm256_mul_ps (k[0], _mm256_add_ps (y0, zero));
+        __m256 t3 = _mm256_mul_ps (k[0], y0);
+        __m256 t3z = _mm256_add_ps (t3, zero);
+
+        _mm256_store_ps (data,      t0);
+        _mm256_store_ps (data +  8, t3z);
+        _mm256_store_ps (data + 16, t3z);
+        _mm256_store_ps (data + 24, t0);
+        _mm256_store_ps (data + 32, t0);
+        _mm256_store_ps (data + 40, t3);
+        _mm256_store_ps (data + 48, t3z);
+        _mm256_store_ps (data + 56, t0);
+        return;
+    }
+
+    if (zeroedRows >= 3)
+    {
+        const DctInverseRowCoefficients rk (coef);
+
+        loadRows_avx2 (data, v);
+
+        v[0] = dctInverseRow_avx2 (data, rk);
+
+        if (zeroedRows < 7)
+            v[1] = dctInverseRow_avx2 (data + 8, rk);
+
+        if (zeroedRows < 6)
+            v[2] = dctInverseRow_avx2 (data + 16, rk);
+
+        if (zeroedRows < 5)
+            v[3] = dctInverseRow_avx2 (data + 24, rk);
+
+        if (zeroedRows < 4)
+            v[4] = dctInverseRow_avx2 (data + 32, rk);
+    }
+    else
+    {
+        loadTransposed_avx2 (data, v);
+        dctInverse1D_avx2 (v, k);
+        transpose8x8_avx2 (v);
+    }
+
+    dctInverse1D_avx2 (v, k);
+    storeRows_avx2 (data, v);
+}
+
+
+//
+// One 1D pass of the SSE2 dctForward8x8(), on 8 columns at a time
+//
+
+IMF_AVX2_KERNEL inline void
+dctForward1D_avx2 (__m256 v[8])
+{
+    const __m256 c4     = _mm256_set1_ps ( .70710678f);
+    const __m256 c4Neg  = _mm256_set1_ps (-.70710678f);
+    const __m256 c1Half = _mm256_set1_ps (.490392640f);
+    const __m256 c2Half = _mm256_set1_ps (.461939770f);
+    const __m256 c3Half = _mm256_set1_ps (.415734810f);
+    const __m256 c5Half = _mm256_set1_ps (.277785120f);
+    const __m256 c6Half = _mm256_set1_ps (.191341720f);
+    const __m256 c7Half = _mm256_set1_ps (.097545161f);
+    const __m256 half   = _mm256_set1_ps (.5f);
+
+    __m256 a0 = _mm256_add_ps (v[0], v[7]);
+    __m256 a1 = _mm256_add_ps (v[1], v[2]);
+    __m256 a3 = _mm256_add_ps (v[3], v[4]);
+    __m256 a5 = _mm256_add_ps (v[5], v[6]);
+
+    __m256 a7 = _mm256_sub_ps (v[0], v[7]);
+    __m256 a2 = _mm256_sub_ps (v[1], v[2]);
+    __m256 a4 = _mm256_sub_ps (v[3], v[4]);
+    __m256 a6 = _mm256_sub_ps (v[5], v[6]);
+
+    __m256 k0 = _mm256_mul_ps (c4, _mm256_add_ps (a0, a3));
+    __m256 k1 = _mm256_mul_ps (c4, _mm256_add_ps (a1, a5));
+
+    v[0] = _mm256_mul_ps (_mm256_add_ps (k0, k1), half);
+    v[4] = _mm256_mul_ps (_mm256_sub_ps (k0, k1), half);
+
+    k0 = _mm256_sub_ps (a2, a6);
+    k1 = _mm256_sub_ps (a0, a3);
+
+    v[2] = _mm256_add_ps (_mm256_mul_ps (c6Half, k0),
+                          _mm256_mul_ps (c2Half, k1));
+
+    v[6] = _mm256_sub_ps (_mm256_mul_ps (c6Half, k1),
+                          _mm256_mul_ps (c2Half, k0));
+
+    k0 = _mm256_mul_ps (_mm256_sub_ps (a1, a5), c4);
+    k1 = _mm256_mul_ps (_mm256_add_ps (a2, a6), c4Neg);
+
+    __m256 rotX = _mm256_sub_ps (a7, k0);
+    __m256 rotY = _mm256_add_ps (a4, k1);
+
+    v[3] = _mm256_sub_ps (_mm256_mul_ps (c3Half, rotX),
+                          _mm256_mul_ps (c5Half, rotY));
+
+    v[5] = _mm256_add_ps (_mm256_mul_ps (c5Half, rotX),
+                          _mm256_mul_ps (c3Half, rotY));
+
+    rotX = _mm256_add_ps (a7, k0);
+    rotY = _mm256_sub_ps (k1, a4);
+
+    v[1] = _mm256_sub_ps (_mm256_mul_ps (c1Half, rotX),
+                          _mm256_mul_ps (c7Half, rotY));
+
+    v[7] = _mm256_add_ps (_mm256_mul_ps (c7Half, rotX),
+                          _mm256_mul_ps (c1Half, rotY));
+}
+
+
+//
+// Forward 8x8 DCT, AVX2
+//
+
+IMF_AVX2_KERNEL void
+dctForward8x8_avx2 (float *data)
+{
+    __m256 v[8];
+
+    loadRows_avx2 (data, v);
+    dctForward1D_avx2 (v);
+    transpose8x8_avx2 (v);
+    dctForward1D_avx2 (v);
+    storeTransposed_avx2 (data, v);
+}
+
+
+//
+// Color space conversion, AVX2 and AVX-512
+//
+
+IMF_AVX2_KERNEL void
+csc709Inverse64_avx2 (float *comp0, float *comp1, float *comp2)
+{
+    const __m256 c0 = _mm256_set1_ps ( 1.5747f);
+    const __m256 c1 = _mm256_set1_ps ( 1.8556f);
+    const __m256 c2 = _mm256_set1_ps (-0.1873f);
+    const __m256 c3 = _mm256_set1_ps (-0.4682f);
+
+    for (int i = 0; i < 64; i += 8)
+    {
+        __m256 src0 = _mm256_load_ps (comp0 + i);
+        __m256 src1 = _mm256_load_ps (comp1 + i);
+        __m256 src2 = _mm256_load_ps (comp2 + i);
+
+        _mm256_store_ps (comp0 + i,
+                         _mm256_add_ps (src0, _mm256_mul_ps (src2, c0)));
+
+        _mm256_store_ps (comp1 + i,
+                         _mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (src1, c2),
+                                                       src0),
+                                        _mm256_mul_ps (src2, c3)));
+
+        _mm256_store_ps (comp2 + i,
+                         _mm256_add_ps (_mm256_mul_ps (c1, src1), src0));
+    }
+}
+
+
+IMF_AVX2_KERNEL void
+csc709Forward64_avx2 (float *comp0, float *comp1, float *comp2)
+{
+    const __m256 c00 = _mm256_set1_ps ( 0.2126f);
+    const __m256 c01 = _mm256_set1_ps ( 0.7152f);
+    const __m256 c02 = _mm256_set1_ps ( 0.0722f);
+    const __m256 c10 = _mm256_set1_ps (-0.1146f);
+    const __m256 c11 = _mm256_set1_ps ( 0.3854f);
+    const __m256 c12 = _mm256_set1_ps ( 0.5000f);
+    const __m256 c20 = _mm256_set1_ps ( 0.5000f);
+    const __m256 c21 = _mm256_set1_ps ( 0.4542f);
+    const __m256 c22 = _mm256_set1_ps ( 0.0458f);
+
+    for (int i = 0; i < 64; i += 8)
+    {
+        __m256 src0 = _mm256_load_ps (comp0 + i);
+        __m256 src1 = _mm256_load_ps (comp1 + i);
+        __m256 src2 = _mm256_load_ps (comp2 + i);
+
+        _mm256_store_ps (comp0 + i,
+            _mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (c00, src0),
+                                          _mm256_mul_ps (c01, src1)),
+                           _mm256_mul_ps (c02, src2)));
+
+        _mm256_store_ps (comp1 + i,
+            _mm256_add_ps (_mm256_sub_ps (_mm256_mul_ps (c10, src0),
+                                          _mm256_mul_ps (c11, src1)),
+                           _mm256_mul_ps (c12, src2)));
+
+        _mm256_store_ps (comp2 + i,
+            _mm256_sub_ps (_mm256_sub_ps (_mm256_mul_ps (c20, src0),
+                                          _mm256_mul_ps (c21, src1)),
+                           _mm256_mul_ps (c22, src2)));
+    }
+}
+
+
+IMF_AVX512_KERNEL void
+csc709Inverse64_avx512 (float *comp0, float *comp1, float *comp2)
+{
+    const __m512 c0 = _mm512_set1_ps ( 1.5747f);
+    const __m512 c1 = _mm512_set1_ps ( 1.8556f);
+    const __m512 c2 = _mm512_set1_ps (-0.1873f);
+    const __m512 c3 = _mm512_set1_ps (-0.4682f);
+
+    for (int i = 0; i < 64; i += 16)
+    {
+        __m512 src0 = _mm512_loadu_ps (comp0 + i);
+        __m512 src1 = _mm512_loadu_ps (comp1 + i);
+        __m512 src2 = _mm512_loadu_ps (comp2 + i);
+
+        _mm512_storeu_ps (comp0 + i,
+                          _mm512_add_ps (src0, _mm512_mul_ps (src2, c0)));
+
+        _mm512_storeu_ps (comp1 + i,
+                          _mm512_add_ps (_mm512_add_ps (_mm512_mul_ps (src1, c2),
+                                                        src0),
+                                         _mm512_mul_ps (src2, c3)));
+
+        _mm512_storeu_ps (comp2 + i,
+                          _mm512_add_ps (_mm512_mul_ps (c1, src1), src0));
+    }
+}
+
+
+IMF_AVX512_KERNEL void
+csc709Forward64_avx512 (float *comp0, float *comp1, float *comp2)
+{
+    const __m512 c00 = _mm512_set1_ps ( 0.2126f);
+    const __m512 c01 = _mm512_set1_ps ( 0.7152f);
+    const __m512 c02 = _mm512_set1_ps ( 0.0722f);
+    const __m512 c10 = _mm512_set1_ps (-0.1146f);
+    const __m512 c11 = _mm512_set1_ps ( 0.3854f);
+    const __m512 c12 = _mm512_set1_ps ( 0.5000f);
+    const __m512 c20 = _mm512_set1_ps ( 0.5000f);
+    const __m512 c21 = _mm512_set1_ps ( 0.4542f);
+    const __m512 c22 = _mm512_set1_ps ( 0.0458f);
+
+    for (int i = 0; i < 64; i += 16)
+    {
+        __m512 src0 = _mm512_loadu_ps (comp0 + i);
+        __m512 src1 = _mm512_loadu_ps (comp1 + i);
+        __m512 src2 = _mm512_loadu_ps (comp2 + i);
+
+        _mm512_storeu_ps (comp0 + i,
+            _mm512_add_ps (_mm512_add_ps (_mm512_mul_ps (c00, src0),
+                                          _mm512_mul_ps (c01, src1)),
+                           _mm512_mul_ps (c02, src2)));
+
+        _mm512_storeu_ps (comp1 + i,
+            _mm512_add_ps (_mm512_sub_ps (_mm512_mul_ps (c10, src0),
+                                          _mm512_mul_ps (c11, src1)),
+                           _mm512_mul_ps (c12, src2)));
+
+        _mm512_storeu_ps (comp2 + i,
+            _mm512_sub_ps (_mm512_sub_ps (_mm512_mul_ps (c20, src0),
+                                          _mm512_mul_ps (c21, src1)),
+                           _mm512_mul_ps (c22, src2)));
+    }
+}
+
+
+//
+// Float -> half conversion, AVX-512
+//
+
+IMF_AVX512_KERNEL void
+convertFloatToHalf64_avx512 (unsigned short *dst, float *src)
+{
+    for (int i = 0; i < 64; i += 16)
+    {
+        __m256i h = _mm512_cvtps_ph (_mm512_loadu_ps (src + i),
+                                     _MM_FROUND_TO_NEAREST_INT);
+
+        _mm256_storeu_si256 ((__m256i *) (dst + i), h);
+    }
+}
+
+
+//
+// Zig-zag reordering and half -> float conversion, AVX-512.
+// Each half of the block is gathered from the two source
+// registers with a single word permute; see the table in
+// fromHalfZigZag_scalar().
+//
+
+IMF_AVX512_KERNEL void
+fromHalfZigZag_avx512 (unsigned short *src, float *dst)
+{
+    static const unsigned short zigZag[64] =
+    {
+         0,  1,  5,  6, 14, 15, 27, 28,  2,  4,  7, 13, 16, 26, 29, 42,
+         3,  8, 12, 17, 25, 30, 41, 43,  9, 11, 18, 24, 31, 40, 44, 53,
+        10, 19, 23, 32, 39, 45, 52, 54, 20, 22, 33, 38, 46, 51, 55, 60,
+        21, 34, 37, 47, 50, 56, 59, 61, 35, 36, 48, 49, 57, 58, 62, 63
+    };
+
+    __m512i lo = _mm512_loadu_si512 (src);
+    __m512i hi = _mm512_loadu_si512 (src + 32);
+
+    for (int i = 0; i < 64; i += 32)
+    {
+        __m512i h = _mm512_permutex2var_epi16
+                        (lo, _mm512_loadu_si512 (zigZag + i), hi);
+
+        _mm512_storeu_ps (dst + i,
+                          _mm512_cvtph_ps (_mm512_castsi512_si256 (h)));
+
+        _mm512_storeu_ps (dst + i + 16,
+                          _mm512_cvtph_ps (_mm512_extracti64x4_epi64 (h, 1)));
+    }
+}
+
+#endif /* IMF_HAVE_DWA_WIDE_KERNELS */
+
+
 } // anonymous namespace
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
@@ -127,7 +127,7 @@ FastHufDecoder::FastHufDecoder
 
     for (Int64 symbol = minSymbol; symbol <= maxSymbol; symbol++)
     {
-        if (currByte - table > numBytes)
+        if (currBitCount < 6 && currByte - table >= numBytes)
         {
             throw Iex::InputExc ("Error decoding Huffman table "
                                  "(Truncated table data).");
@@ -144,7 +144,7 @@ FastHufDecoder::FastHufDecoder
 
         if (codeLen == (Int64) LONG_ZEROCODE_RUN)
         {
-            if (currByte - table > numBytes)
+            if (currBitCount < 8 && currByte - table >= numBytes)
             {
                 throw Iex::InputExc ("Error decoding Huffman table "
                                      "(Truncated table data).");
@@ -248,22 +248,30 @@ FastHufDecoder::FastHufDecoder
     for (int i = _minCodeLength; i <= _maxCodeLength; ++i)
         mapping[i] = offset[i];
 
-    for (std::vector<Int64>::const_iterator i = symbols.begin(); 
-         i != symbols.end();
-         ++i)
+    try
     {
-        int codeLen = *i & 63;
-        int symbol  = *i >> 6;
-
-        if (mapping[codeLen] >= _numSymbols)
-            throw Iex::InputExc ("Huffman decode error "
-                                  "(Invalid symbol in header).");
-        
-        _idToSymbol[mapping[codeLen]] = symbol;
-        mapping[codeLen]++;
-    }
+        for (std::vector<Int64>::const_iterator i = symbols.begin(); 
+             i != symbols.end();
+             ++i)
+        {
+            int codeLen = *i & 63;
+            int symbol  = *i >> 6;
+
+            if (mapping[codeLen] >= _numSymbols)
+                throw Iex::InputExc ("Huffman decode error "
+                                      "(Invalid symbol in header).");
+            
+            _idToSymbol[mapping[codeLen]] = symbol;
+            mapping[codeLen]++;
+        }
 
-    buildTables(base, offset);
+        buildTables(base, offset);
+    }
+    catch (...)
+    {
+        delete[] _idToSymbol;
+        throw;
+    }
 }
 
 
@@ -286,9 +294,9 @@ FastHufDecoder::~FastHufDecoder()
 //
 
 #define READ64(c) \
-    ((Int64)(c)[0] << 56) | ((Int64)(c)[1] << 48) | ((Int64)(c)[2] << 40) | \
-    ((Int64)(c)[3] << 32) | ((Int64)(c)[4] << 24) | ((Int64)(c)[5] << 16) | \
-    ((Int64)(c)[6] <<  8) | ((Int64)(c)[7] ) 
+    (((Int64)(c)[0] << 56) | ((Int64)(c)[1] << 48) | ((Int64)(c)[2] << 40) | \
+     ((Int64)(c)[3] << 32) | ((Int64)(c)[4] << 24) | ((Int64)(c)[5] << 16) | \
+     ((Int64)(c)[6] <<  8) | ((Int64)(c)[7] ))
 
 #ifdef __INTEL_COMPILER // ICC built-in swap for LE hosts
     #if defined (__i386__) || defined(__x86_64__)
@@ -433,107 +441,128 @@ FastHufDecoder::buildTables (Int64 *base, Int64 *offset)
     {
         _tableMin = _ljBase[minIdx];
     }
+
+    buildMultiTable();
 }
 
 
-// 
-// For decoding, we're holding onto 2 Int64's. 
 //
-// The first (buffer), holds the next bits from the bitstream to be 
-// decoded. For certain paths in the decoder, we only need TABLE_LOOKUP_BITS
-// valid bits to decode the next symbol. For other paths, we need a full
-// 64-bits to decode a symbol. 
+// Build the multi-symbol acceleration table. For each table index,
+// decode codes from the index bits for as long as the codes fit
+// entirely into the TABLE_LOOKUP_BITS bits of the index.
 //
-// When we need to refill 'buffer', we could pull bits straight from 
-// the bitstream. But this is very slow and requires lots of book keeping
-// (what's the next bit in the next byte?). Instead, we keep another Int64
-// around that we use to refill from. While this doesn't cut down on the
-// book keeping (still need to know how many valid bits), it does cut
-// down on some of the bit shifting crazy and byte access. 
+// A code of length l is fully determined by the top l bits of the
+// buffer: if the smallest length with _ljBase[length] <= value is
+// l for the index bits followed by zeros, it is l for any bits
+// following the index. Decoding the table entry is therefore
+// equivalent to decoding its symbols one by one.
+//
+// The RLE symbol ends an entry, as its run length follows in the
+// next 8 bits of the bitstream, and so do invalid codes; both are
+// left to the single-symbol path in decode().
+//
+
+void
+FastHufDecoder::buildMultiTable ()
+{
+    for (Int64 i = 0; i < 1 << TABLE_LOOKUP_BITS; ++i)
+    {
+        Int64 value  = i << (64 - TABLE_LOOKUP_BITS);
+        int   count  = 0;
+        int   length = 0;
+
+        for (int j = 0; j < MAX_TABLE_SYMBOLS; ++j)
+            _tableMulti[i][j] = 0;
+
+        while (count < MAX_TABLE_SYMBOLS)
+        {
+            Int64 bits = value << length;
+
+            int codeLen = _minCodeLength;
+
+            while (codeLen <= _maxCodeLength && _ljBase[codeLen] > bits)
+                codeLen++;
+
+            if (codeLen > TABLE_LOOKUP_BITS - length)
+                break;
+
+            Int64 id = _ljOffset[codeLen] + (bits >> (64 - codeLen));
+
+            if (id >= _numSymbols || _idToSymbol[id] == _rleSymbol)
+                break;
+
+            _tableMulti[i][count] = _idToSymbol[id];
+            length += codeLen;
+            count++;
+        }
+
+        _tableMulti[i][MAX_TABLE_SYMBOLS] = count;
+        _tableMultiLen[i] = length;
+    }
+}
+
+
+// 
+// For decoding, we're holding onto a 64-bit buffer, whose top
+// bufferNumBits bits are the next bits from the bitstream to be
+// decoded. Decoded bits are shifted out at the top, which shifts
+// 0's in at the bottom. For certain paths in the decoder, we only
+// need TABLE_LOOKUP_BITS valid bits to decode the next symbol. For
+// other paths, we need a full 64-bits to decode a symbol.
 //
-// The refill Int64 (bufferBack) gets left-shifted after we've pulled
-// off bits. If we run out of bits in the input bit stream, we just
-// shift in 0's to bufferBack. 
+// The refill reads the next 8 bytes of the bitstream with a single
+// (unaligned) load, and ORs them in right below the valid bits. This
+// fills all 64 bits of the buffer; bufferNumBits is only advanced by
+// whole bytes, though, and currByte points to the first byte that has
+// not been counted. Its leading bits may already be in the buffer;
+// the next refill ORs them in again at the same position, which
+// does not change them. So there is no loop and only one branch,
+// instead of bit-by-bit book keeping.
 //
-// The refill act takes numBits from the top of bufferBack and sticks
-// them in the bottom of buffer. If there arn't enough bits in bufferBack,
-// it gets refilled (to 64-bits) from the input bitstream.
+// Near the end of the bitstream, where fewer than 8 bytes are left,
+// the refill falls back to reading single bytes. Past the end, the
+// bitstream is padded with 0's.
 //
 
 inline void
 FastHufDecoder::refill
     (Int64 &buffer,
-     int numBits,                       // number of bits to refill
-     Int64 &bufferBack,                 // the next 64-bits, to refill from
-     int &bufferBackNumBits,            // number of bits left in bufferBack
+     int &bufferNumBits,                // number of valid bits in buffer
      const unsigned char *&currByte,    // current byte in the bitstream
-     int &currBitsLeft)                 // number of bits left in the bitsream
+     const unsigned char *srcEnd)       // end of the bitstream
 {
-    // 
-    // Refill bits into the bottom of buffer, from the top of bufferBack.
-    // Always top up buffer to be completely full.
-    //
-
-    buffer |= bufferBack >> (64 - numBits);
-
-    if (bufferBackNumBits < numBits)
+    if (srcEnd - currByte >= (int) sizeof (Int64))
     {
-        numBits -= bufferBackNumBits;
-
-        // 
-        // Refill all of bufferBack from the bitstream. Either grab
-        // a full 64-bit chunk, or whatever bytes are left. If we
-        // don't have 64-bits left, pad with 0's.
-        //
+        buffer |= READ64 (currByte) >> bufferNumBits;
 
-        if (currBitsLeft >= 64)
+        int numBytes   = (64 - bufferNumBits) >> 3;
+        currByte      += numBytes;
+        bufferNumBits += 8 * numBytes;
+    }
+    else
+    {
+        while (bufferNumBits <= 56 && currByte < srcEnd)
         {
-            bufferBack        = READ64 (currByte); 
-            bufferBackNumBits = 64;
-            currByte         += sizeof (Int64);
-            currBitsLeft     -= 8 * sizeof (Int64);
+            buffer |= ((Int64)(*currByte)) << (56 - bufferNumBits);
 
+            currByte++;
+            bufferNumBits += 8;
         }
-        else
-        {
-            bufferBack        = 0;
-            bufferBackNumBits = 64; 
-
-            Int64 shift = 56;
-            
-            while (currBitsLeft > 0)
-            {
-                bufferBack |= ((Int64)(*currByte)) << shift;
-
-                currByte++;
-                shift        -= 8;
-                currBitsLeft -= 8;
-            }
 
+        if (currByte < srcEnd)
+        {
             //
-            // At this point, currBitsLeft might be negative, just because
-            // we're subtracting whole bytes. To keep anyone from freaking
-            // out, zero the counter.
+            // Fill the rest of the buffer with the leading bits
+            // of the next byte, as above.
             //
 
-            if (currBitsLeft < 0)
-                currBitsLeft = 0;
+            buffer |= ((Int64)(*currByte)) >> (bufferNumBits - 56);
+        }
+        else
+        {
+            bufferNumBits = 64;
         }
-
-        buffer |= bufferBack >> (64 - numBits);
     }
-    
-    bufferBack         = bufferBack << numBits;
-    bufferBackNumBits -= numBits;
-
-    // 
-    // We can have cases where the previous shift of bufferBack is << 64 - 
-    // in which case no shift occurs. The bit count math still works though,
-    // so if we don't have any bits left, zero out bufferBack.
-    //
-
-    if (bufferBackNumBits == 0)
-        bufferBack = 0;
 }
 
 //
@@ -561,13 +590,13 @@ FastHufDecoder::readBits
 
 
 //
-// Decode using a the 'One-Shift' strategy for decoding, with a 
-// small-ish table to accelerate decoding of short codes.
+// Decode using a the 'One-Shift' strategy for decoding, with small-ish
+// tables to accelerate decoding of short codes.
 //
-// If possible, try looking up codes into the acceleration table.
-// This has a few benifits - there's no search involved; We don't
-// need an additional lookup to map id to symbol; we don't need
-// a full 64-bits (so less refilling). 
+// If possible, try looking up codes into the multi-symbol table, and
+// then into the single-symbol table. This has a few benifits - there's
+// no search involved; We don't need an additional lookup to map id to
+// symbol; we don't need a full 64-bits (so less refilling). 
 //
 
 void
@@ -577,37 +606,54 @@ FastHufDecoder::decode
      unsigned short *dst, 
      int numDstElems)
 {
-    if (numSrcBits < 128)
-        throw Iex::InputExc ("Error choosing Huffman decoder implementation "
-                             "(insufficient number of bits).");
-
     //
-    // Current position (byte/bit) in the src data stream
-    // (after the first buffer fill)
+    // Current position in the src data stream, and its end
     //
 
-    const unsigned char *currByte = src + 2 * sizeof (Int64);
-
-    numSrcBits -= 8 * 2 * sizeof (Int64);
+    const unsigned char *currByte = src;
+    const unsigned char *srcEnd   = src + (numSrcBits + 7) / 8;
 
     //
     // 64-bit buffer holding the current bits in the stream
     //
 
-    Int64 buffer            = READ64 (src); 
-    int   bufferNumBits     = 64;
+    Int64 buffer        = 0;
+    int   bufferNumBits = 0;
 
-    //
-    // 64-bit buffer holding the next bits in the stream
-    //
-
-    Int64 bufferBack        = READ64 ((src + sizeof (Int64))); 
-    int   bufferBackNumBits = 64;
+    refill (buffer, bufferNumBits, currByte, srcEnd);
 
     int dstIdx = 0;
 
     while (dstIdx < numDstElems)
     {
+        //
+        // Decode as many symbols as the multi-symbol table holds
+        // for the next TABLE_LOOKUP_BITS bits. All table slots are
+        // written, so this needs room for MAX_TABLE_SYMBOLS + 1
+        // symbols in dst; near the end of dst, and for entries
+        // without any symbols, fall through to the single-symbol
+        // path below.
+        //
+
+        int tableIdx = buffer >> (64 - TABLE_LOOKUP_BITS);
+        int count    = _tableMulti[tableIdx][MAX_TABLE_SYMBOLS];
+
+        if (count > 0 && dstIdx < numDstElems - MAX_TABLE_SYMBOLS)
+        {
+            memcpy (dst + dstIdx, _tableMulti[tableIdx], sizeof (_tableMulti[0]));
+            dstIdx += count;
+
+            int length = _tableMultiLen[tableIdx];
+
+            buffer = buffer << length;
+            bufferNumBits -= length;
+
+            if (bufferNumBits < TABLE_LOOKUP_BITS)
+                refill (buffer, bufferNumBits, currByte, srcEnd);
+
+            continue;
+        }
+
         int  codeLen;
         int  symbol;
 
@@ -623,8 +669,6 @@ FastHufDecoder::decode
 
         if (_tableMin <= buffer)
         {
-            int tableIdx = buffer >> (64 - TABLE_LOOKUP_BITS);
-
             // 
             // For invalid codes, _tableCodeLen[] should return 0. This
             // will cause the decoder to get stuck in the current spot
@@ -639,16 +683,7 @@ FastHufDecoder::decode
         else
         {
             if (bufferNumBits < 64)
-            {
-                refill (buffer,
-                        64 - bufferNumBits,
-                        bufferBack,
-                        bufferBackNumBits,
-                        currByte,
-                        numSrcBits);
-
-                bufferNumBits = 64;
-            }
+                refill (buffer, bufferNumBits, currByte, srcEnd);
 
             // 
             // Brute force search: 
@@ -695,16 +730,7 @@ FastHufDecoder::decode
         if (symbol == _rleSymbol)
         {
             if (bufferNumBits < 8)
-            {
-                refill (buffer,
-                        64 - bufferNumBits,
-                        bufferBack,
-                        bufferBackNumBits,
-                        currByte,
-                        numSrcBits);
-
-                bufferNumBits = 64;
-            }
+                refill (buffer, bufferNumBits, currByte, srcEnd);
 
             int rleCount = buffer >> 56;
 
@@ -746,19 +772,10 @@ FastHufDecoder::decode
         //
 
         if (bufferNumBits < TABLE_LOOKUP_BITS)
-        {
-            refill (buffer,
-                    64 - bufferNumBits,
-                    bufferBack,
-                    bufferBackNumBits,
-                    currByte,
-                    numSrcBits);
-
-            bufferNumBits = 64;
-        }
+            refill (buffer, bufferNumBits, currByte, srcEnd);
     }
 
-    if (numSrcBits != 0)
+    if (currByte != srcEnd)
     {
         throw Iex::InputExc ("Huffman decode error (Compressed data remains "
                              "after filling expected output buffer).");
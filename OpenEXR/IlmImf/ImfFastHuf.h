@@ -60,9 +60,14 @@ OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
 // to directly look up short codes (as you might in a traditional
 // lookup-table driven decoder). 
 //
+// Short codes are frequent, and a single table lookup can often
+// decode several of them at once. A second acceleration table holds,
+// for every TABLE_LOOKUP_BITS-bit prefix of the bitstream, up to
+// MAX_TABLE_SYMBOLS consecutive symbols whose codes fit entirely
+// into the prefix.
+//
 // The decoder is meant to be compatible with the encoder (and decoder)
-// in ImfHuf.cpp, just faster. For ease of implementation, this decoder
-// should only be used on compressed bitstreams >= 128 bits long.
+// in ImfHuf.cpp, just faster.
 //
 
 class FastHufDecoder
@@ -82,6 +87,13 @@ class FastHufDecoder
 
     static const int TABLE_LOOKUP_BITS = 12;
 
+    //
+    // Maximum number of symbols in one entry of the multi-symbol
+    // acceleration table.
+    //
+
+    static const int MAX_TABLE_SYMBOLS = 3;
+
     IMF_EXPORT
     FastHufDecoder (const char*& table,
                     int numBytes,
@@ -104,7 +116,8 @@ class FastHufDecoder
   private:
 
     void  buildTables (Int64*, Int64*);
-    void  refill (Int64&, int, Int64&, int&, const unsigned char *&, int&);
+    void  buildMultiTable ();
+    void  refill (Int64&, int&, const unsigned char *&, const unsigned char *);
     Int64 readBits (int, Int64&, int&, const char *&);
 
     int             _rleSymbol;        // RLE symbol written by the encoder.
@@ -146,6 +159,18 @@ class FastHufDecoder
     int            _tableSymbol[1 << TABLE_LOOKUP_BITS];
     unsigned char  _tableCodeLen[1 << TABLE_LOOKUP_BITS];
     Int64          _tableMin;
+
+    //
+    // The multi-symbol acceleration tables. Each entry of
+    // _tableMulti holds up to MAX_TABLE_SYMBOLS symbols, followed
+    // by the number of symbols; _tableMultiLen holds the total
+    // length of their codes. Entries with a symbol count of 0 are
+    // handled by the single-symbol tables above; this is the case
+    // for long codes, invalid codes and the RLE symbol.
+    //
+
+    unsigned short _tableMulti[1 << TABLE_LOOKUP_BITS][MAX_TABLE_SYMBOLS + 1];
+    unsigned char  _tableMultiLen[1 << TABLE_LOOKUP_BITS];
 };
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
@@ -0,0 +1,229 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//
+//	Low-level file input for OpenEXR based on operating
+//	system file handles and positional reads.
+//
+//-----------------------------------------------------------------------------
+
+#include <ImfFileIO.h>
+#include "Iex.h"
+
+#if defined _WIN32 || defined _WIN64
+    #ifdef NOMINMAX
+        #undef NOMINMAX
+    #endif
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include <errno.h>
+
+#include "ImfNamespace.h"
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+
+#if defined _WIN32 || defined _WIN64
+
+FileIStream::FileIStream (const char fileName[]):
+    OPENEXR_IMF_INTERNAL_NAMESPACE::IStream (fileName),
+    _length (0),
+    _pos (0),
+    _handle (INVALID_HANDLE_VALUE)
+{
+    HANDLE file = CreateFileA (fileName,
+                               GENERIC_READ,
+                               FILE_SHARE_READ,
+                               0,
+                               OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL,
+                               0);
+
+    if (file == INVALID_HANDLE_VALUE)
+        THROW (IEX_NAMESPACE::InputExc, "Cannot open file "
+               "\"" << fileName << "\" (error " << GetLastError() << ").");
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx (file, &size))
+    {
+        CloseHandle (file);
+        THROW (IEX_NAMESPACE::InputExc, "Cannot determine the size of file "
+               "\"" << fileName << "\".");
+    }
+
+    _handle = file;
+    _length = size.QuadPart;
+}
+
+
+FileIStream::~FileIStream ()
+{
+    if (_handle != INVALID_HANDLE_VALUE)
+        CloseHandle ((HANDLE) _handle);
+}
+
+
+void
+FileIStream::readAt (char c[/*n*/], int n, Int64 pos)
+{
+    while (n > 0)
+    {
+        OVERLAPPED ov = {0};
+        ov.Offset = DWORD (pos & 0xffffffff);
+        ov.OffsetHigh = DWORD (pos >> 32);
+
+        DWORD nread = 0;
+
+        if (!ReadFile ((HANDLE) _handle, c, n, &nread, &ov))
+        {
+            THROW (IEX_NAMESPACE::InputExc, "Error reading file "
+                   "\"" << fileName() << "\" (error " << GetLastError() << ").");
+        }
+
+        if (nread == 0)
+        {
+            THROW (IEX_NAMESPACE::InputExc, "Early end of file: " << n <<
+                   " requested bytes not available.");
+        }
+
+        c += nread;
+        n -= nread;
+        pos += nread;
+    }
+}
+
+#else
+
+FileIStream::FileIStream (const char fileName[]):
+    OPENEXR_IMF_INTERNAL_NAMESPACE::IStream (fileName),
+    _length (0),
+    _pos (0),
+    _fd (-1)
+{
+    _fd = ::open (fileName, O_RDONLY);
+
+    if (_fd < 0)
+        IEX_NAMESPACE::throwErrnoExc();
+
+    struct stat st;
+
+    if (::fstat (_fd, &st) < 0)
+    {
+        int err = errno;
+        ::close (_fd);
+        IEX_NAMESPACE::throwErrnoExc ("%T.", err);
+    }
+
+    _length = st.st_size;
+}
+
+
+FileIStream::~FileIStream ()
+{
+    if (_fd >= 0)
+        ::close (_fd);
+}
+
+
+void
+FileIStream::readAt (char c[/*n*/], int n, Int64 pos)
+{
+    while (n > 0)
+    {
+        ssize_t nread = ::pread (_fd, c, n, off_t (pos));
+
+        if (nread < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            IEX_NAMESPACE::throwErrnoExc();
+        }
+
+        if (nread == 0)
+        {
+            THROW (IEX_NAMESPACE::InputExc, "Early end of file: " << n <<
+                   " requested bytes not available.");
+        }
+
+        c += nread;
+        n -= int (nread);
+        pos += nread;
+    }
+}
+
+#endif
+
+
+bool
+FileIStream::read (char c[/*n*/], int n)
+{
+    readAt (c, n, _pos);
+    _pos += n;
+
+    return _pos < _length;
+}
+
+
+bool
+FileIStream::isStatelessRead () const
+{
+    return true;
+}
+
+
+Int64
+FileIStream::tellg ()
+{
+    return _pos;
+}
+
+
+void
+FileIStream::seekg (Int64 pos)
+{
+    _pos = pos;
+}
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_EXIT
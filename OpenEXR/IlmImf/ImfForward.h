@@ -77,6 +77,7 @@ class AcesOutputFile;
 class TiledInputPart;
 class TiledInputFile;
 class TileOffsets;
+class AsyncRead;
 
 // multipart file handling
 class GenericInputFile;
@@ -53,6 +53,7 @@
 #include <cstring>
 #include <cassert>
 #include <algorithm>
+#include <vector>
 
 
 using namespace std;
@@ -206,6 +207,27 @@ getBits (int nBits, Int64 &c, int &lc, const char *&in)
 //	- see http://www.compressconsult.com/huffman/
 //
 
+void
+hufCanonicalFirstCodes (Int64 n[59])
+{
+    //
+    // n[i] contains the number of different codes
+    // of length i.  For each i from 58 through 1,
+    // compute the numerically lowest code with
+    // length i, and store that code in n[i].
+    //
+
+    Int64 c = 0;
+
+    for (int i = 58; i > 0; --i)
+    {
+	Int64 nc = ((c + n[i]) >> 1);
+	n[i] = c;
+	c = nc;
+    }
+}
+
+
 void
 hufCanonicalCodeTable (Int64 hcode[HUF_ENCSIZE])
 {
@@ -223,20 +245,7 @@ hufCanonicalCodeTable (Int64 hcode[HUF_ENCSIZE])
     for (int i = 0; i < HUF_ENCSIZE; ++i)
 	n[hcode[i]] += 1;
 
-    //
-    // For each i from 58 through 1, compute the
-    // numerically lowest code with length i, and
-    // store that code in n[i].
-    //
-
-    Int64 c = 0;
-
-    for (int i = 58; i > 0; --i)
-    {
-	Int64 nc = ((c + n[i]) >> 1);
-	n[i] = c;
-	c = nc;
-    }
+    hufCanonicalFirstCodes (n);
 
     //
     // hcode[i] contains the length, l, of the
@@ -255,6 +264,32 @@ hufCanonicalCodeTable (Int64 hcode[HUF_ENCSIZE])
 }
 
 
+//
+// Same as above, but only for the symbols listed, in increasing
+// order, in sym; hcode[i] must be 0 for all other symbols.
+//
+
+void
+hufCanonicalCodeTable (Int64 hcode[HUF_ENCSIZE], const vector <int> &sym)
+{
+    Int64 n[59];
+
+    for (int i = 0; i <= 58; ++i)
+	n[i] = 0;
+
+    for (size_t i = 0; i < sym.size(); ++i)
+	n[hcode[sym[i]]] += 1;
+
+    hufCanonicalFirstCodes (n);
+
+    for (size_t i = 0; i < sym.size(); ++i)
+    {
+	int l = hcode[sym[i]];
+	hcode[sym[i]] = l | (n[l]++ << 6);
+    }
+}
+
+
 //
 // Compute Huffman codes (based on frq input) and store them in frq:
 //	- code structure is : [63:lsb - 6:msb] | [5-0: bit length];
@@ -265,17 +300,28 @@ hufCanonicalCodeTable (Int64 hcode[HUF_ENCSIZE])
 //
 
 
+struct FHeapEntry
+{
+    Int64	frq;		// frequency
+    int		index;		// index of the frequency in hfrq
+};
+
+
 struct FHeapCompare
 {
-    bool operator () (Int64 *a, Int64 *b) {return *a > *b;}
+    bool operator () (const FHeapEntry &a, const FHeapEntry &b)
+    {
+	return a.frq > b.frq;
+    }
 };
 
 
 void
 hufBuildEncTable
-    (Int64*	frq,	// io: input frequencies [HUF_ENCSIZE], output table
-     int*	im,	//  o: min frq index
-     int*	iM)	//  o: max frq index
+    (Int64*	    frq,	// io: input frequencies [HUF_ENCSIZE], output table
+     int*	    im,		//  o: min frq index
+     int*	    iM,		//  o: max frq index
+     vector <int> & sym)	//  o: indices of non-zero frq values
 {
     //
     // This function assumes that when it is called, array frq
@@ -283,7 +329,7 @@ hufBuildEncTable
     // that are to be Huffman-encoded.  (frq[i] contains the number
     // of occurrences of symbol i in the data.)
     //
-    // The loop below does three things:
+    // The loop below does two things:
     //
     // 1) Finds the minimum and maximum indices that point
     //    to non-zero entries in frq:
@@ -291,51 +337,46 @@ hufBuildEncTable
     //     frq[im] != 0, and frq[i] == 0 for all i < im
     //     frq[iM] != 0, and frq[i] == 0 for all i > iM
     //
-    // 2) Fills array fHeap with pointers to all non-zero
-    //    entries in frq.
+    // 2) Fills array sym with the indices of all non-zero
+    //    entries in frq, in increasing order.
     //
-    // 3) Initializes array hlink such that hlink[i] == i
-    //    for all array entries.
+    // All further work is done only for the symbols in sym, not
+    // for all HUF_ENCSIZE entries in frq; image data rarely use
+    // more than a small fraction of the possible symbols.
     //
 
-    AutoArray <int, HUF_ENCSIZE> hlink;
-    AutoArray <Int64 *, HUF_ENCSIZE> fHeap;
-
     *im = 0;
 
     while (!frq[*im])
 	(*im)++;
 
-    int nf = 0;
+    sym.clear();
 
     for (int i = *im; i < HUF_ENCSIZE; i++)
     {
-	hlink[i] = i;
-
 	if (frq[i])
 	{
-	    fHeap[nf] = &frq[i];
-	    nf++;
+	    sym.push_back (i);
 	    *iM = i;
 	}
     }
 
     //
-    // Add a pseudo-symbol, with a frequency count of 1, to frq;
-    // adjust the fHeap and hlink array accordingly.  Function
-    // hufEncode() uses the pseudo-symbol for run-length encoding.
+    // Add a pseudo-symbol, with a frequency count of 1, to frq
+    // and sym.  Function hufEncode() uses the pseudo-symbol for
+    // run-length encoding.
     //
 
     (*iM)++;
     frq[*iM] = 1;
-    fHeap[nf] = &frq[*iM];
-    nf++;
+    sym.push_back (*iM);
+
+    int nf = sym.size();
 
     //
-    // Build an array, scode, such that scode[i] contains the number
-    // of bits assigned to symbol i.  Conceptually this is done by
-    // constructing a tree whose leaves are the symbols with non-zero
-    // frequency:
+    // Compute the code length for each symbol.  Conceptually this
+    // is done by constructing a tree whose leaves are the symbols
+    // with non-zero frequency:
     //
     //     Make a heap that contains all symbols with a non-zero frequency,
     //     with the least frequent symbol on top.
@@ -351,20 +392,36 @@ hufBuildEncTable
     // leaf node, the distance between the root and the leaf is the length
     // of the code for the corresponding symbol.
     //
-    // The loop below doesn't actually build the tree; instead we compute
-    // the distances of the leaves from the root on the fly.  When a new
-    // node is added to the heap, then that node's descendants are linked
-    // into a single linear list that starts at the new node, and the code
-    // lengths of the descendants (that is, their distance from the root
-    // of the tree) are incremented by one.
+    // The heap holds copies of the non-zero entries in frq, in the
+    // same order as in frq, along with their indices in sym.  The
+    // heap operations depend only on the order of the frequencies, so
+    // the tree and the code lengths are the same as for a heap of
+    // pointers into frq; the tie-breaking between equal frequencies
+    // is part of the file format.
+    //
+    // Tree nodes 0 to nf-1 are the leaves; node i corresponds to
+    // symbol sym[i].  Nodes nf to 2*nf-2 are the inner nodes, in the
+    // order in which they are created.  node[i] is the node whose
+    // frequency is currently stored in the heap entry with index i.
     //
 
-    make_heap (&fHeap[0], &fHeap[nf], FHeapCompare());
+    vector <FHeapEntry> fHeap (nf);
+    vector <int> node (nf);
+    vector <int> parent (2 * nf - 1);
+
+    for (int i = 0; i < nf; i++)
+    {
+	fHeap[i].frq = frq[sym[i]];
+	fHeap[i].index = i;
+	node[i] = i;
+    }
+
+    make_heap (&fHeap[0], &fHeap[0] + nf, FHeapCompare());
 
-    AutoArray <Int64, HUF_ENCSIZE> scode;
-    memset (scode, 0, sizeof (Int64) * HUF_ENCSIZE);
+    int nh = nf;
+    int nNodes = nf;
 
-    while (nf > 1)
+    while (nh > 1)
     {
 	//
 	// Find the indices, mm and m, of the two smallest non-zero frq
@@ -372,75 +429,52 @@ hufBuildEncTable
 	// frq, and remove the smallest frq value from fHeap.
 	//
 
-	int mm = fHeap[0] - frq;
-	pop_heap (&fHeap[0], &fHeap[nf], FHeapCompare());
-	--nf;
+	pop_heap (&fHeap[0], &fHeap[0] + nh, FHeapCompare());
+	--nh;
 
-	int m = fHeap[0] - frq;
-	pop_heap (&fHeap[0], &fHeap[nf], FHeapCompare());
+	pop_heap (&fHeap[0], &fHeap[0] + nh, FHeapCompare());
 
-	frq[m ] += frq[mm];
-	push_heap (&fHeap[0], &fHeap[nf], FHeapCompare());
+	int mm = fHeap[nh].index;
+	int m = fHeap[nh - 1].index;
+
+	fHeap[nh - 1].frq += fHeap[nh].frq;
+	push_heap (&fHeap[0], &fHeap[0] + nh, FHeapCompare());
 
 	//
-	// The entries in scode are linked into lists with the
-	// entries in hlink serving as "next" pointers and with
-	// the end of a list marked by hlink[j] == j.
-	//
-	// Traverse the lists that start at scode[m] and scode[mm].
-	// For each element visited, increment the length of the
-	// corresponding code by one bit. (If we visit scode[j]
-	// during the traversal, then the code for symbol j becomes
-	// one bit longer.)
-	//
-	// Merge the lists that start at scode[m] and scode[mm]
-	// into a single list that starts at scode[m].
-	//
-	
-	//
-	// Add a bit to all codes in the first list.
+	// The new inner node becomes the parent of the
+	// nodes for heap entries m and mm.
 	//
 
-	for (int j = m; true; j = hlink[j])
-	{
-	    scode[j]++;
-
-	    assert (scode[j] <= 58);
-
-	    if (hlink[j] == j)
-	    {
-		//
-		// Merge the two lists.
-		//
-
-		hlink[j] = mm;
-		break;
-	    }
-	}
+	parent[node[m]] = nNodes;
+	parent[node[mm]] = nNodes;
+	node[m] = nNodes;
+	nNodes++;
+    }
 
-	//
-	// Add a bit to all codes in the second list
-	//
+    //
+    // Every node is created before its parent, so walking the nodes
+    // from the root down yields the distance of each node from the
+    // root -- for the leaves, the code lengths.  Store them in frq.
+    //
 
-	for (int j = mm; true; j = hlink[j])
-	{
-	    scode[j]++;
+    vector <int> depth (nNodes);
+    depth[nNodes - 1] = 0;
 
-	    assert (scode[j] <= 58);
+    for (int i = nNodes - 2; i >= 0; i--)
+	depth[i] = depth[parent[i]] + 1;
 
-	    if (hlink[j] == j)
-		break;
-	}
+    for (int i = 0; i < nf; i++)
+    {
+	assert (depth[i] <= 58);
+	frq[sym[i]] = depth[i];
     }
 
     //
     // Build a canonical Huffman code table, replacing the code
-    // lengths in scode with (code, code length) pairs.  Copy the
-    // code table from scode into frq.
+    // lengths in frq with (code, code length) pairs.
     //
 
-    hufCanonicalCodeTable (scode);
-    memcpy (frq, scode, sizeof (Int64) * HUF_ENCSIZE);
+    hufCanonicalCodeTable (frq, sym);
 }
 
 
@@ -467,47 +501,46 @@ const int LONGEST_LONG_RUN   = 255 + SHORTEST_LONG_RUN;
 
 void
 hufPackEncTable
-    (const Int64*	hcode,		// i : encoding table [HUF_ENCSIZE]
-     int		im,		// i : min hcode index
-     int		iM,		// i : max hcode index
-     char**		pcode)		//  o: ptr to packed table (updated)
+    (const Int64*	    hcode,	// i : encoding table [HUF_ENCSIZE]
+     const vector <int> &   sym,	// i : indices of non-zero hcode values
+     char**		    pcode)	//  o: ptr to packed table (updated)
 {
     char *p = *pcode;
     Int64 c = 0;
     int lc = 0;
 
-    for (; im <= iM; im++)
+    for (size_t i = 0; i < sym.size(); i++)
     {
-	int l = hufLength (hcode[im]);
+	//
+	// Output the run of zeroes between the previous
+	// and the current symbol, in runs of at most
+	// LONGEST_LONG_RUN zeroes.
+	//
+
+	int zeroes = i? sym[i] - sym[i - 1] - 1: 0;
 
-	if (l == 0)
+	while (zeroes > 0)
 	{
-	    int zerun = 1;
+	    int zerun = min (zeroes, LONGEST_LONG_RUN);
 
-	    while ((im < iM) && (zerun < LONGEST_LONG_RUN))
+	    if (zerun >= SHORTEST_LONG_RUN)
 	    {
-		if (hufLength (hcode[im+1]) > 0 )	 
-		    break;
-		im++;
-		zerun++;
+		outputBits (6, LONG_ZEROCODE_RUN, c, lc, p);
+		outputBits (8, zerun - SHORTEST_LONG_RUN, c, lc, p);
 	    }
-
-	    if (zerun >= 2)
+	    else if (zerun >= 2)
 	    {
-		if (zerun >= SHORTEST_LONG_RUN)
-		{
-		    outputBits (6, LONG_ZEROCODE_RUN, c, lc, p);
-		    outputBits (8, zerun - SHORTEST_LONG_RUN, c, lc, p);
-		}
-		else
-		{
-		    outputBits (6, SHORT_ZEROCODE_RUN + zerun - 2, c, lc, p);
-		}
-		continue;
+		outputBits (6, SHORT_ZEROCODE_RUN + zerun - 2, c, lc, p);
+	    }
+	    else
+	    {
+		outputBits (6, 0, c, lc, p);
 	    }
+
+	    zeroes -= zerun;
 	}
 
-	outputBits (6, l, c, lc, p);
+	outputBits (6, hufLength (hcode[sym[i]]), c, lc, p);
     }
 
     if (lc > 0)
@@ -717,11 +750,51 @@ hufFreeDecTable (HufDec *hdecod)	// io: Decoding table
 //
 // ENCODING
 //
+// hufEncode() collects up to 31 bits in c before it writes them
+// to out, 32 bits at a time; outputBits() would write every byte
+// as soon as it is complete, which costs a hard-to-predict branch
+// per code.  The bitstream is the same.
+//
+
+inline void
+outputBits32 (int nBits, Int64 bits, Int64 &c, int &lc, char *&out)
+{
+    //
+    // nBits must not be greater than 32; lc is less
+    // than 32 before and after the call.
+    //
+
+    c = (c << nBits) | bits;
+    lc += nBits;
+
+    if (lc >= 32)
+    {
+	lc -= 32;
+	unsigned int w = (unsigned int) (c >> lc);
+
+	out[0] = w >> 24;
+	out[1] = w >> 16;
+	out[2] = w >> 8;
+	out[3] = w;
+	out += 4;
+    }
+}
+
 
 inline void
 outputCode (Int64 code, Int64 &c, int &lc, char *&out)
 {
-    outputBits (hufLength (code), hufCode (code), c, lc, out);
+    int l = hufLength (code);
+
+    if (l <= 32)
+    {
+	outputBits32 (l, hufCode (code), c, lc, out);
+    }
+    else
+    {
+	outputBits32 (l - 32, hufCode (code) >> 32, c, lc, out);
+	outputBits32 (32, hufCode (code) & 0xffffffff, c, lc, out);
+    }
 }
 
 
@@ -741,7 +814,7 @@ sendCode (Int64 sCode, int runCount, Int64 runCode,
     {
 	outputCode (sCode, c, lc, out);
 	outputCode (runCode, c, lc, out);
-	outputBits (8, runCount, c, lc, out);
+	outputBits32 (8, runCount, c, lc, out);
     }
     else
     {
@@ -798,6 +871,9 @@ hufEncode				// return: output size (in bits)
 
     sendCode (hcode[s], cs, hcode[rlc], c, lc, out);
 
+    while (lc >= 8)
+	*out++ = (c >> (lc -= 8));
+
     if (lc)
 	*out = (c << (8 - lc)) & 0xff;
 
@@ -975,7 +1051,35 @@ countFrequencies (Int64 freq[HUF_ENCSIZE],
     for (int i = 0; i < HUF_ENCSIZE; ++i)
 	freq[i] = 0;
 
-    for (int i = 0; i < n; ++i)
+    int i = 0;
+
+    if (n >= 4 * HUF_ENCSIZE)
+    {
+	//
+	// Long runs of equal values make consecutive increments of
+	// the same counter wait for each other.  For large inputs,
+	// count into four separate histograms and add them up at
+	// the end.
+	//
+
+	vector <unsigned int> sub (3 * HUF_ENCSIZE, 0);
+	unsigned int *f1 = &sub[0];
+	unsigned int *f2 = f1 + HUF_ENCSIZE;
+	unsigned int *f3 = f2 + HUF_ENCSIZE;
+
+	for (; i + 4 <= n; i += 4)
+	{
+	    ++freq[data[i]];
+	    ++f1[data[i + 1]];
+	    ++f2[data[i + 2]];
+	    ++f3[data[i + 3]];
+	}
+
+	for (int j = 0; j < HUF_ENCSIZE; ++j)
+	    freq[j] += (Int64) f1[j] + f2[j] + f3[j];
+    }
+
+    for (; i < n; ++i)
 	++freq[data[i]];
 }
 
@@ -1025,11 +1129,12 @@ hufCompress (const unsigned short raw[],
 
     int im = 0;
     int iM = 0;
-    hufBuildEncTable (freq, &im, &iM);
+    vector <int> sym;
+    hufBuildEncTable (freq, &im, &iM, sym);
 
     char *tableStart = compressed + 20;
     char *tableEnd   = tableStart;
-    hufPackEncTable (freq, im, iM, &tableEnd);
+    hufPackEncTable (freq, sym, &tableEnd);
     int tableLength = tableEnd - tableStart;
 
     char *dataStart = tableEnd;
@@ -1071,14 +1176,17 @@ hufUncompress (const char compressed[],
     const char *ptr = compressed + 20;
 
     // 
-    // Fast decoder needs at least 2x64-bits of compressed data, and
-    // needs to be run-able on this platform. Otherwise, fall back
-    // to the original decoder
+    // Use the fast decoder if it is run-able on this platform.
+    // Otherwise, fall back to the original decoder
     //
 
-    if (FastHufDecoder::enabled() && nBits > 128)
+    if (FastHufDecoder::enabled())
     {
         FastHufDecoder fhd (ptr, nCompressed - (ptr - compressed), im, iM, iM);
+
+        if (nBits > 8 * (nCompressed - (ptr - compressed)))
+            invalidNBits();
+
         fhd.decode ((unsigned char*)ptr, nBits, raw, nRaw);
     }
     else
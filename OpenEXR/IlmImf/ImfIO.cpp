@@ -74,6 +74,21 @@ IStream::readMemoryMapped (int n)
 }
 
 
+bool
+IStream::isStatelessRead () const
+{
+    return false;
+}
+
+
+void
+IStream::readAt (char c[/*n*/], int n, Int64 pos)
+{
+    throw IEX_NAMESPACE::InputExc ("Attempt to perform a stateless read "
+			 "on a stream that does not support it.");
+}
+
+
 void
 IStream::clear ()
 {
@@ -108,6 +108,36 @@ class IStream
     virtual char *	readMemoryMapped (int n);
 
 
+    //-----------------------------------------------------
+    // Does this input stream support stateless reads?
+    //
+    // Stateless reads do not use or change the current
+    // reading position, and they may be issued by several
+    // threads at the same time without any locking.  The
+    // scan line and tile readers use them to let each
+    // decoding task fetch its own compressed data.
+    //-----------------------------------------------------
+
+    IMF_EXPORT
+    virtual bool	isStatelessRead () const;
+
+
+    //------------------------------------------------------
+    // Read from the stream at a given position:
+    //
+    // readAt(c,n,pos) reads n bytes, starting pos bytes
+    // from the beginning of the file, and stores them in
+    // array c.  The current reading position is unaffected.
+    // If the file contains less than pos+n bytes, or if an
+    // I/O error occurs, readAt(c,n,pos) throws an exception.
+    // If the stream does not support stateless reads,
+    // readAt(c,n,pos) throws an exception.
+    //------------------------------------------------------
+
+    IMF_EXPORT
+    virtual void	readAt (char c[/*n*/], int n, Int64 pos);
+
+
     //--------------------------------------------------------
     // Get the current reading position, in bytes from the
     // beginning of the file.  If the next call to read() will
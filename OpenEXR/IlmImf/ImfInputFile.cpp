@@ -44,6 +44,7 @@
 #include "ImfChannelList.h"
 #include "ImfMisc.h"
 #include "ImfStdIO.h"
+#include "ImfMmapIO.h"
 #include "ImfVersion.h"
 #include "ImfPartType.h"
 #include "ImfInputPartData.h"
@@ -70,6 +71,7 @@ using IMATH_NAMESPACE::divp;
 using IMATH_NAMESPACE::modp;
 using ILMTHREAD_NAMESPACE::Mutex;
 using ILMTHREAD_NAMESPACE::Lock;
+using ILMTHREAD_NAMESPACE::ThreadPool;
 
 
 //
@@ -99,6 +101,7 @@ struct InputFile::Data : public Mutex
     int                 offset;
     
     int                 numThreads;
+    ThreadPool *        threadPool;
 
     int                 partNumber;
     InputPartData*      part;
@@ -124,6 +127,7 @@ InputFile::Data::Data (int numThreads):
     compositor(0),
     cachedTileY (-1),
     numThreads (numThreads),
+    threadPool (&globalThreadPool()),
     partNumber (-1),
     part(NULL),
     multiPartBackwardSupport (false),
@@ -342,16 +346,24 @@ bufferedReadPixels (InputFile::Data* ifd, int scanLine1, int scanLine2)
 
 
 
-InputFile::InputFile (const char fileName[], int numThreads):
+InputFile::InputFile (const char fileName[],
+                      int numThreads,
+                      bool memoryMapped,
+                      ThreadPool &threadPool):
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_streamData = NULL;
     _data->_deleteStream=true;
     
     OPENEXR_IMF_INTERNAL_NAMESPACE::IStream* is = 0;
     try
     {
-        is = new StdIFStream (fileName);
+        if (memoryMapped)
+            is = new MmapIStream (fileName);
+        else
+            is = new StdIFStream (fileName);
+
         readMagicNumberAndVersionField(*is, _data->version);
 
         //
@@ -413,9 +425,12 @@ InputFile::InputFile (const char fileName[], int numThreads):
 }
 
 
-InputFile::InputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int numThreads):
+InputFile::InputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is,
+                      int numThreads,
+                      ThreadPool &threadPool):
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_streamData=NULL;
     _data->_deleteStream=false;
     try
@@ -489,7 +504,8 @@ InputFile::compatibilityInitialize (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream& is)
     // (TODO) may want to have a way to set the reconstruction flag.
     //
     _data->multiPartBackwardSupport = true;
-    _data->multiPartFile = new MultiPartInputFile(is, _data->numThreads);
+    _data->multiPartFile = new MultiPartInputFile(is, _data->numThreads, true,
+                                                  *_data->threadPool);
     InputPartData* part = _data->multiPartFile->getPart(0);
 
     multiPartInitialize (part);
@@ -504,6 +520,7 @@ InputFile::multiPartInitialize (InputPartData* part)
     _data->header = part->header;
     _data->partNumber = part->partNumber;
     _data->part = part;
+    _data->threadPool = part->threadPool;
 
     initialize();
 }
@@ -524,7 +541,8 @@ InputFile::initialize ()
             _data->dsFile = new DeepScanLineInputFile (_data->header,
                                                _data->_streamData->is,
                                                _data->version,
-                                               _data->numThreads);
+                                               _data->numThreads,
+                                               *_data->threadPool);
             _data->compositor = new CompositeDeepScanLine;
             _data->compositor->addSource(_data->dsFile);
         }
@@ -545,14 +563,16 @@ InputFile::initialize ()
             _data->tFile = new TiledInputFile (_data->header,
                                                _data->_streamData->is,
                                                _data->version,
-                                               _data->numThreads);
+                                               _data->numThreads,
+                                               *_data->threadPool);
         }
         
         else if(!_data->header.hasType() || _data->header.type()==SCANLINEIMAGE)
         {
             _data->sFile = new ScanLineInputFile (_data->header,
                                                   _data->_streamData->is,
-                                                  _data->numThreads);
+                                                  _data->numThreads,
+                                                  *_data->threadPool);
         }else{
             // type set but not recognised
             
@@ -824,6 +844,32 @@ InputFile::readPixels (int scanLine)
 }
 
 
+AsyncRead
+InputFile::readPixelsAsync (int scanLine1,
+                            int scanLine2,
+                            AsyncRead::Callback callback,
+                            void *userData)
+{
+    if (_data->compositor || _data->isTiled)
+    {
+        //
+        // Deep and tiled files go through intermediate buffers
+        // that belong to this InputFile; read them synchronously.
+        //
+
+        readPixels (scanLine1, scanLine2);
+
+        if (callback)
+            callback (userData);
+
+        return AsyncRead();
+    }
+
+    return _data->sFile->readPixelsAsync (scanLine1, scanLine2,
+                                          callback, userData);
+}
+
+
 void
 InputFile::rawPixelData (int firstScanLine,
 			 const char *&pixelData,
@@ -887,6 +933,91 @@ InputFile::rawPixelDataToBuffer (int scanLine,
 
 
 
+void
+InputFile::readPixels (const char *rawPixelData,
+                       int rawPixelDataSize,
+                       const FrameBuffer &frameBuffer,
+                       int scanLine1,
+                       int scanLine2) const
+{
+    if (_data->dsFile || _data->isTiled)
+    {
+        THROW (IEX_NAMESPACE::ArgExc, "Cannot decode raw scan line data "
+               "from image file \"" << fileName() << "\". "
+               "The file is not a flat scan line file.");
+    }
+
+    _data->sFile->readPixels (rawPixelData, rawPixelDataSize,
+                              frameBuffer, scanLine1, scanLine2);
+}
+
+
+int
+InputFile::firstScanLineInChunk (int y) const
+{
+    if (_data->dsFile || _data->isTiled)
+    {
+        THROW (IEX_NAMESPACE::ArgExc, "Image file \"" << fileName() << "\" "
+               "is not a flat scan line file.");
+    }
+
+    return _data->sFile->firstScanLineInChunk (y);
+}
+
+
+int
+InputFile::lastScanLineInChunk (int y) const
+{
+    if (_data->dsFile || _data->isTiled)
+    {
+        THROW (IEX_NAMESPACE::ArgExc, "Image file \"" << fileName() << "\" "
+               "is not a flat scan line file.");
+    }
+
+    return _data->sFile->lastScanLineInChunk (y);
+}
+
+
+bool
+InputFile::dcOnlyReadsAvailable () const
+{
+    if (_data->dsFile || _data->isTiled)
+        return false;
+
+    return _data->sFile->dcOnlyReadsAvailable();
+}
+
+
+Box2i
+InputFile::dcOnlyDataWindow () const
+{
+    if (_data->dsFile || _data->isTiled)
+    {
+        THROW (IEX_NAMESPACE::ArgExc, "Image file \"" << fileName() << "\" "
+               "is not a flat scan line file.");
+    }
+
+    return _data->sFile->dcOnlyDataWindow();
+}
+
+
+void
+InputFile::readPixelsDcOnly (const FrameBuffer &frameBuffer,
+                             int scanLine1,
+                             int scanLine2)
+{
+    if (_data->dsFile || _data->isTiled)
+    {
+        THROW (IEX_NAMESPACE::ArgExc, "Cannot read image file "
+               "\"" << fileName() << "\" at reduced resolution. "
+               "The file is not a flat scan line file.");
+    }
+
+    _data->sFile->readPixelsDcOnly (frameBuffer, scanLine1, scanLine2);
+}
+
+
+
 void
 InputFile::rawTileData (int &dx, int &dy,
 			int &lx, int &ly,
@@ -48,6 +48,7 @@
 #include "ImfTiledOutputFile.h"
 #include "ImfThreading.h"
 #include "ImfGenericInputFile.h"
+#include "ImfAsyncRead.h"
 #include "ImfNamespace.h"
 #include "ImfForward.h"
 #include "ImfExport.h"
@@ -67,11 +68,21 @@ class InputFile : public GenericInputFile
     // Destroying the InputFile object will close the file.
     //
     // numThreads determines the number of threads that will be
-    // used to read the file (see ImfThreading.h).
+    // used to read the file, and threadPool the pool that these
+    // threads belong to (see ImfThreading.h).
+    //
+    // If memoryMapped is true, the file is opened through an
+    // MmapIStream (see ImfMmapIO.h) rather than a StdIFStream;
+    // compressed pixel data is then decoded directly from the
+    // mapped pages without first being copied into a buffer.
     //-----------------------------------------------------------
 
     IMF_EXPORT
-    InputFile (const char fileName[], int numThreads = globalThreadCount());
+    InputFile (const char fileName[],
+               int numThreads = globalThreadCount(),
+               bool memoryMapped = false,
+               ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                   globalThreadPool());
 
 
     //-------------------------------------------------------------
@@ -80,11 +91,14 @@ class InputFile : public GenericInputFile
     // object will not close the file.
     //
     // numThreads determines the number of threads that will be
-    // used to read the file (see ImfThreading.h).
+    // used to read the file, and threadPool the pool that these
+    // threads belong to (see ImfThreading.h).
     //-------------------------------------------------------------
 
     IMF_EXPORT
-    InputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int numThreads = globalThreadCount());
+    InputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int numThreads = globalThreadCount(),
+               ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                   globalThreadPool());
 
 
     //-----------
@@ -163,12 +177,15 @@ class InputFile : public GenericInputFile
     //
     // Optimization depends on:
     //   the file type (only scanline data is supported),
-    //   the framebuffer channels (RGB/RGBA mono or stereo)
-    //   the framebuffer channel types (all channels half-float format only)
-    //   the file channels (RGB/RGBA mono or stereo)
-    //   the file channel types (all channel half-float format only)
+    //   the channel sampling (no subsampled channels in the file)
+    //   the channel types (the same in the file and the framebuffer,
+    //     or half in the file and float in the framebuffer)
     //   whether SSE2 instruction support was detected at compile time
     //
+    // Any number of channels is supported, in planar or interleaved
+    // framebuffer layouts; half channels that are interleaved with
+    // each other in the framebuffer are copied together.
+    //
     // Calling isOptimizationEnabled before setFrameBuffer will throw an exception
     //
     //---------------------------------------------------------------
@@ -204,6 +221,28 @@ class InputFile : public GenericInputFile
     void		readPixels (int scanLine);
 
 
+    //---------------------------------------------------------------
+    // Read pixel data asynchronously:
+    //
+    // readPixelsAsync(s1,s2) starts reading the scan lines that
+    // readPixels(s1,s2) would read, and returns an AsyncRead that
+    // can be used to wait for the read to complete.  The callback,
+    // if it is not 0, is called with userData when the read
+    // completes.  See ScanLineInputFile::readPixelsAsync() and
+    // ImfAsyncRead.h.
+    //
+    // Only scan line files are read in the background.  For tiled
+    // and deep files, readPixelsAsync() reads the pixels, calls the
+    // callback, and returns a complete AsyncRead; errors are thrown
+    // right away.
+    //---------------------------------------------------------------
+
+    IMF_EXPORT
+    AsyncRead		readPixelsAsync (int scanLine1, int scanLine2,
+                                         AsyncRead::Callback callback = 0,
+                                         void *userData = 0);
+
+
     //----------------------------------------------
     // Read a block of raw pixel data from the file,
     // without uncompressing it (this function is
@@ -236,6 +275,54 @@ class InputFile : public GenericInputFile
     void		rawPixelDataToBuffer (int scanLine,
 					      char *pixelData,
 					      int &pixelDataSize) const;   
+
+
+    //---------------------------------------------------------------
+    // Decode a block of raw pixel data, as returned by rawPixelData()
+    // or rawPixelDataToBuffer(), into frameBuffer, without using the
+    // file's frame buffer.  See ScanLineInputFile::readPixels() for
+    // details; this call is thread safe, and it does not block.
+    //
+    // firstScanLineInChunk(y) and lastScanLineInChunk(y) return the
+    // first and last scan lines in the same block as scan line y.
+    //---------------------------------------------------------------
+
+    IMF_EXPORT
+    void		readPixels (const char *rawPixelData,
+				    int rawPixelDataSize,
+				    const FrameBuffer &frameBuffer,
+				    int scanLine1,
+				    int scanLine2) const;
+
+    IMF_EXPORT
+    int			firstScanLineInChunk (int y) const;
+
+    IMF_EXPORT
+    int			lastScanLineInChunk (int y) const;
+
+
+    //---------------------------------------------------------------
+    // Reduced-resolution reads of DWA compressed files:
+    //
+    // readPixelsDcOnly(frameBuffer,s1,s2) decodes only the DC
+    // components of the lossy DCT channels of a DWAA or DWAB
+    // compressed file, and stores scan lines s1 through s2 of an
+    // image at 1/8 resolution, whose data window is returned by
+    // dcOnlyDataWindow(), in frameBuffer.  dcOnlyReadsAvailable()
+    // returns true if the file can be read this way; tiled files
+    // cannot.  See ScanLineInputFile::readPixelsDcOnly() for details.
+    //---------------------------------------------------------------
+
+    IMF_EXPORT
+    bool		dcOnlyReadsAvailable () const;
+
+    IMF_EXPORT
+    IMATH_NAMESPACE::Box2i dcOnlyDataWindow () const;
+
+    IMF_EXPORT
+    void		readPixelsDcOnly (const FrameBuffer &frameBuffer,
+					  int scanLine1,
+					  int scanLine2);
     
  
 
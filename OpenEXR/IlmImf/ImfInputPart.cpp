@@ -98,6 +98,32 @@ InputPart::readPixels (int scanLine)
     file->readPixels(scanLine);
 }
 
+AsyncRead
+InputPart::readPixelsAsync (int scanLine1, int scanLine2,
+                            AsyncRead::Callback callback, void *userData)
+{
+    return file->readPixelsAsync(scanLine1, scanLine2, callback, userData);
+}
+
+bool
+InputPart::dcOnlyReadsAvailable () const
+{
+    return file->dcOnlyReadsAvailable();
+}
+
+IMATH_NAMESPACE::Box2i
+InputPart::dcOnlyDataWindow () const
+{
+    return file->dcOnlyDataWindow();
+}
+
+void
+InputPart::readPixelsDcOnly (const FrameBuffer &frameBuffer,
+                             int scanLine1, int scanLine2)
+{
+    file->readPixelsDcOnly(frameBuffer, scanLine1, scanLine2);
+}
+
 void
 InputPart::rawPixelData (int firstScanLine, const char *&pixelData, int &pixelDataSize)
 {
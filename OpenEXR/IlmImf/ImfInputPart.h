@@ -74,6 +74,17 @@ class InputPart
         IMF_EXPORT
         void                readPixels (int scanLine);
         IMF_EXPORT
+        AsyncRead           readPixelsAsync (int scanLine1, int scanLine2,
+                                             AsyncRead::Callback callback = 0,
+                                             void *userData = 0);
+        IMF_EXPORT
+        bool                dcOnlyReadsAvailable () const;
+        IMF_EXPORT
+        IMATH_NAMESPACE::Box2i dcOnlyDataWindow () const;
+        IMF_EXPORT
+        void                readPixelsDcOnly (const FrameBuffer &frameBuffer,
+                                              int scanLine1, int scanLine2);
+        IMF_EXPORT
         void                rawPixelData (int firstScanLine,
                                           const char *&pixelData,
                                           int &pixelDataSize);
@@ -38,13 +38,15 @@
 OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
 
 InputPartData::InputPartData(InputStreamMutex* mutex, const Header &header,
-                             int partNumber, int numThreads, int version):
+                             int partNumber, int numThreads, int version,
+                             ILMTHREAD_NAMESPACE::ThreadPool* threadPool):
         header(header),
         numThreads(numThreads),
         partNumber(partNumber),
         version(version),       
         mutex(mutex),
-        completed(false)
+        completed(false),
+        threadPool(threadPool)
 {
 }
 
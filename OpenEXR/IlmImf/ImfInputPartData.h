@@ -40,6 +40,7 @@
 #include "ImfInputStreamMutex.h"
 #include "ImfHeader.h"
 #include "ImfNamespace.h"
+#include "IlmThreadForward.h"
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -53,10 +54,12 @@ struct InputPartData
         InputStreamMutex*       mutex;
         std::vector<Int64>      chunkOffsets;
         bool                    completed;
+        ILMTHREAD_NAMESPACE::ThreadPool* threadPool;
 
         IMF_EXPORT
         InputPartData(InputStreamMutex* mutex, const Header &header,
-                      int partNumber, int numThreads, int version);
+                      int partNumber, int numThreads, int version,
+                      ILMTHREAD_NAMESPACE::ThreadPool* threadPool);
 
 };
 
@@ -52,7 +52,11 @@
 #include <ImfConvert.h>
 #include <ImfPartType.h>
 #include <ImfTileDescription.h>
+#include <ImfSystemSpecific.h>
+#include <ImfPixelCopySimd.h>
 #include "ImfNamespace.h"
+#include <string.h>
+#include <algorithm>
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
 
@@ -276,6 +280,202 @@ numLinesInBuffer (Compressor * compressor)
 }
 
 
+//
+// Helper functions for copyIntoFrameBuffer() and copyFromFrameBuffer():
+// copy a horizontal row of values of the same type, in native byte
+// order, between a line or tile buffer and a frame buffer.  The values
+// may be unaligned in both places.
+//
+
+static void
+copyValuesIntoFrameBuffer (const char *& readPtr,
+                           char * writePtr,
+                           const char * endPtr,
+                           size_t xStride,
+                           size_t size)
+{
+    if (writePtr > endPtr)
+        return;
+
+    if (xStride == size)
+    {
+        size_t numBytes = endPtr - writePtr + size;
+        memcpy (writePtr, readPtr, numBytes);
+        readPtr += numBytes;
+    }
+    else
+    {
+        while (writePtr <= endPtr)
+        {
+            memcpy (writePtr, readPtr, size);
+            readPtr += size;
+            writePtr += xStride;
+        }
+    }
+}
+
+
+static void
+copyHalfsIntoFloatFrameBuffer (const char *& readPtr,
+                               char * writePtr,
+                               const char * endPtr,
+                               size_t xStride)
+{
+    if (writePtr > endPtr)
+        return;
+
+    size_t numPixels = (endPtr - writePtr) / xStride + 1;
+    convertHalfToFloat (readPtr, writePtr, xStride, numPixels);
+    readPtr += numPixels * sizeof (half);
+}
+
+
+//
+// Helper functions for the other conversions to and from half in
+// copyIntoFrameBuffer().  They convert a row of pixels in blocks,
+// through buffers on the stack, with the half library's array
+// conversion functions, and produce the same results as the
+// per-pixel functions in ImfConvert.h.
+//
+
+static const size_t CONVERSION_BLOCK_SIZE = 64;
+
+
+static size_t
+conversionBlockSize (const char * writePtr, const char * endPtr, size_t xStride)
+{
+    return std::min (CONVERSION_BLOCK_SIZE,
+                     size_t ((endPtr - writePtr) / xStride + 1));
+}
+
+
+static void
+copyFloatsIntoHalfFrameBuffer (const char *& readPtr,
+                               char * writePtr,
+                               const char * endPtr,
+                               size_t xStride)
+{
+    float f[CONVERSION_BLOCK_SIZE];
+    half h[CONVERSION_BLOCK_SIZE];
+
+    while (writePtr <= endPtr)
+    {
+        size_t n = conversionBlockSize (writePtr, endPtr, xStride);
+
+        memcpy (f, readPtr, n * sizeof (float));
+        floatToHalfArray (f, h, n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            //
+            // Like floatToHalf(), turn finite floats that are too
+            // large into infinities rather than rounding them down.
+            //
+
+            if (f[i] > HALF_MAX)
+                h[i] = half::posInf();
+            else if (f[i] < -HALF_MAX)
+                h[i] = half::negInf();
+
+            *(half *) writePtr = h[i];
+            writePtr += xStride;
+        }
+
+        readPtr += n * sizeof (float);
+    }
+}
+
+
+static void
+copyHalfsIntoUintFrameBuffer (const char *& readPtr,
+                              char * writePtr,
+                              const char * endPtr,
+                              size_t xStride)
+{
+    float f[CONVERSION_BLOCK_SIZE];
+
+    while (writePtr <= endPtr)
+    {
+        size_t n = conversionBlockSize (writePtr, endPtr, xStride);
+
+        halfToFloatArray ((const half *) readPtr, f, n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            *(unsigned int *) writePtr = floatToUint (f[i]);
+            writePtr += xStride;
+        }
+
+        readPtr += n * sizeof (half);
+    }
+}
+
+
+static void
+copyUintsIntoHalfFrameBuffer (const char *& readPtr,
+                              char * writePtr,
+                              const char * endPtr,
+                              size_t xStride)
+{
+    unsigned int ui[CONVERSION_BLOCK_SIZE];
+    float f[CONVERSION_BLOCK_SIZE];
+    half h[CONVERSION_BLOCK_SIZE];
+
+    const float inf = half::posInf();
+
+    while (writePtr <= endPtr)
+    {
+        size_t n = conversionBlockSize (writePtr, endPtr, xStride);
+
+        memcpy (ui, readPtr, n * sizeof (unsigned int));
+
+        for (size_t i = 0; i < n; ++i)
+            f[i] = (ui[i] > HALF_MAX)? inf: float (ui[i]);
+
+        floatToHalfArray (f, h, n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            *(half *) writePtr = h[i];
+            writePtr += xStride;
+        }
+
+        readPtr += n * sizeof (unsigned int);
+    }
+}
+
+
+static void
+copyValuesFromFrameBuffer (char *& writePtr,
+                           const char *& readPtr,
+                           const char * endPtr,
+                           size_t xStride,
+                           size_t size)
+{
+    if (readPtr > endPtr)
+        return;
+
+    size_t numPixels = (endPtr - readPtr) / xStride + 1;
+
+    if (xStride == size)
+    {
+        memcpy (writePtr, readPtr, numPixels * size);
+    }
+    else if (size == sizeof (half))
+    {
+        gatherHalf (readPtr, xStride, writePtr, numPixels);
+    }
+    else
+    {
+        for (size_t i = 0; i < numPixels; ++i)
+            memcpy (writePtr + i * size, readPtr + i * xStride, size);
+    }
+
+    writePtr += numPixels * size;
+    readPtr += numPixels * xStride;
+}
+
+
 void
 copyIntoFrameBuffer (const char *& readPtr,
 		     char * writePtr,
@@ -352,7 +552,11 @@ copyIntoFrameBuffer (const char *& readPtr,
         //
         // Convert the pixels from the file's machine-
         // independent representation, and store the
-        // results in the frame buffer.
+        // results in the frame buffer.  On little-endian
+        // machines, the XDR representation of a value is
+        // the same as its native representation, and the
+        // native-format copy and conversion functions can
+        // be used.
         //
 
         switch (typeInFrameBuffer)
@@ -363,6 +567,13 @@ copyIntoFrameBuffer (const char *& readPtr,
             {
               case OPENEXR_IMF_INTERNAL_NAMESPACE::UINT:
 
+                if (GLOBAL_SYSTEM_LITTLE_ENDIAN)
+                {
+                    copyValuesIntoFrameBuffer (readPtr, writePtr, endPtr,
+                                               xStride, sizeof (unsigned int));
+                    break;
+                }
+
                 while (writePtr <= endPtr)
                 {
                     Xdr::read <CharPtrIO> (readPtr, *(unsigned int *) writePtr);
@@ -372,6 +583,13 @@ copyIntoFrameBuffer (const char *& readPtr,
 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::HALF:
 
+                if (GLOBAL_SYSTEM_LITTLE_ENDIAN)
+                {
+                    copyHalfsIntoUintFrameBuffer (readPtr, writePtr, endPtr,
+                                                  xStride);
+                    break;
+                }
+
                 while (writePtr <= endPtr)
                 {
                     half h;
@@ -403,6 +621,13 @@ copyIntoFrameBuffer (const char *& readPtr,
             {
               case OPENEXR_IMF_INTERNAL_NAMESPACE::UINT:
 
+                if (GLOBAL_SYSTEM_LITTLE_ENDIAN)
+                {
+                    copyUintsIntoHalfFrameBuffer (readPtr, writePtr, endPtr,
+                                                  xStride);
+                    break;
+                }
+
                 while (writePtr <= endPtr)
                 {
                     unsigned int ui;
@@ -414,6 +639,13 @@ copyIntoFrameBuffer (const char *& readPtr,
                 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::HALF:
 
+                if (GLOBAL_SYSTEM_LITTLE_ENDIAN)
+                {
+                    copyValuesIntoFrameBuffer (readPtr, writePtr, endPtr,
+                                               xStride, sizeof (half));
+                    break;
+                }
+
                 while (writePtr <= endPtr)
                 {
                     Xdr::read <CharPtrIO> (readPtr, *(half *) writePtr);
@@ -423,6 +655,13 @@ copyIntoFrameBuffer (const char *& readPtr,
 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::FLOAT:
 
+                if (GLOBAL_SYSTEM_LITTLE_ENDIAN)
+                {
+                    copyFloatsIntoHalfFrameBuffer (readPtr, writePtr, endPtr,
+                                                   xStride);
+                    break;
+                }
+
                 while (writePtr <= endPtr)
                 {
                     float f;
@@ -454,6 +693,13 @@ copyIntoFrameBuffer (const char *& readPtr,
 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::HALF:
 
+                if (GLOBAL_SYSTEM_LITTLE_ENDIAN)
+                {
+                    copyHalfsIntoFloatFrameBuffer (readPtr, writePtr, endPtr,
+                                                   xStride);
+                    break;
+                }
+
                 while (writePtr <= endPtr)
                 {
                     half h;
@@ -465,6 +711,13 @@ copyIntoFrameBuffer (const char *& readPtr,
 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::FLOAT:
 
+                if (GLOBAL_SYSTEM_LITTLE_ENDIAN)
+                {
+                    copyValuesIntoFrameBuffer (readPtr, writePtr, endPtr,
+                                               xStride, sizeof (float));
+                    break;
+                }
+
                 while (writePtr <= endPtr)
                 {
                     Xdr::read <CharPtrIO> (readPtr, *(float *) writePtr);
@@ -497,25 +750,14 @@ copyIntoFrameBuffer (const char *& readPtr,
             {
               case OPENEXR_IMF_INTERNAL_NAMESPACE::UINT:
 
-                while (writePtr <= endPtr)
-                {
-                    for (size_t i = 0; i < sizeof (unsigned int); ++i)
-                        writePtr[i] = readPtr[i];
-
-                    readPtr += sizeof (unsigned int);
-                    writePtr += xStride;
-                }
+                copyValuesIntoFrameBuffer (readPtr, writePtr, endPtr,
+                                           xStride, sizeof (unsigned int));
                 break;
 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::HALF:
 
-                while (writePtr <= endPtr)
-                {
-                    half h = *(half *) readPtr;
-                    *(unsigned int *) writePtr = halfToUint (h);
-                    readPtr += sizeof (half);
-                    writePtr += xStride;
-                }
+                copyHalfsIntoUintFrameBuffer (readPtr, writePtr, endPtr,
+                                              xStride);
                 break;
 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::FLOAT:
@@ -545,50 +787,20 @@ copyIntoFrameBuffer (const char *& readPtr,
             {
               case OPENEXR_IMF_INTERNAL_NAMESPACE::UINT:
 
-                while (writePtr <= endPtr)
-                {
-                    unsigned int ui;
-
-                    for (size_t i = 0; i < sizeof (unsigned int); ++i)
-                        ((char *)&ui)[i] = readPtr[i];
-
-                    *(half *) writePtr = uintToHalf (ui);
-                    readPtr += sizeof (unsigned int);
-                    writePtr += xStride;
-                }
+                copyUintsIntoHalfFrameBuffer (readPtr, writePtr, endPtr,
+                                              xStride);
                 break;
 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::HALF:
 
-                // If we're tightly packed, just memcpy
-                if (xStride == sizeof(half)) {
-                    int numBytes = endPtr-writePtr+sizeof(half);
-                    memcpy(writePtr, readPtr, numBytes);
-                    readPtr  += numBytes;
-                    writePtr += numBytes;                    
-                } else {
-                    while (writePtr <= endPtr)
-                    {
-                        *(half *) writePtr = *(half *)readPtr;
-                        readPtr += sizeof (half);
-                        writePtr += xStride;
-                    }
-                }
+                copyValuesIntoFrameBuffer (readPtr, writePtr, endPtr,
+                                           xStride, sizeof (half));
                 break;
 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::FLOAT:
 
-                while (writePtr <= endPtr)
-                {
-                    float f;
-
-                    for (size_t i = 0; i < sizeof (float); ++i)
-                        ((char *)&f)[i] = readPtr[i];
-
-                    *(half *) writePtr = floatToHalf (f);
-                    readPtr += sizeof (float);
-                    writePtr += xStride;
-                }
+                copyFloatsIntoHalfFrameBuffer (readPtr, writePtr, endPtr,
+                                               xStride);
                 break;
               default:
                   
@@ -617,25 +829,14 @@ copyIntoFrameBuffer (const char *& readPtr,
 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::HALF:
 
-                while (writePtr <= endPtr)
-                {
-                    half h = *(half *) readPtr;
-                    *(float *) writePtr = float (h);
-                    readPtr += sizeof (half);
-                    writePtr += xStride;
-                }
+                copyHalfsIntoFloatFrameBuffer (readPtr, writePtr, endPtr,
+                                               xStride);
                 break;
 
               case OPENEXR_IMF_INTERNAL_NAMESPACE::FLOAT:
 
-                while (writePtr <= endPtr)
-                {
-                    for (size_t i = 0; i < sizeof (float); ++i)
-                        writePtr[i] = readPtr[i];
-
-                    readPtr += sizeof (float);
-                    writePtr += xStride;
-                }
+                copyValuesIntoFrameBuffer (readPtr, writePtr, endPtr,
+                                           xStride, sizeof (float));
                 break;
               default:
                   
@@ -1387,6 +1588,19 @@ convertInPlace (char *& writePtr,
 		PixelType type,
                 size_t numPixels)
 {
+    if (GLOBAL_SYSTEM_LITTLE_ENDIAN)
+    {
+        //
+        // The native and XDR representations are the same.
+        //
+
+        size_t numBytes = numPixels * pixelTypeSize (type);
+        memmove (writePtr, readPtr, numBytes);
+        writePtr += numBytes;
+        readPtr += numBytes;
+        return;
+    }
+
     switch (type)
     {
       case OPENEXR_IMF_INTERNAL_NAMESPACE::UINT:
@@ -1436,7 +1650,7 @@ copyFromFrameBuffer (char *& writePtr,
     // buffer to an output file's line or tile buffer.
     //
 
-    if (format == Compressor::XDR)
+    if (format == Compressor::XDR && !GLOBAL_SYSTEM_LITTLE_ENDIAN)
     {
         //
         // The the line or tile buffer is in XDR format.
@@ -1480,41 +1694,29 @@ copyFromFrameBuffer (char *& writePtr,
     else
     {
         //
-        // The the line or tile buffer is in NATIVE format.
+        // The the line or tile buffer is in NATIVE format,
+        // or in XDR format on a little-endian machine, where
+        // the two representations are the same.
         //
 
         switch (type)
         {
           case OPENEXR_IMF_INTERNAL_NAMESPACE::UINT:
 
-            while (readPtr <= endPtr)
-            {
-                for (size_t i = 0; i < sizeof (unsigned int); ++i)
-                    *writePtr++ = readPtr[i];
-
-                readPtr += xStride;
-            }
+            copyValuesFromFrameBuffer (writePtr, readPtr, endPtr,
+                                       xStride, sizeof (unsigned int));
             break;
 
           case OPENEXR_IMF_INTERNAL_NAMESPACE::HALF:
 
-            while (readPtr <= endPtr)
-            {
-                *(half *) writePtr = *(const half *) readPtr;
-                writePtr += sizeof (half);
-                readPtr += xStride;
-            }
+            copyValuesFromFrameBuffer (writePtr, readPtr, endPtr,
+                                       xStride, sizeof (half));
             break;
 
           case OPENEXR_IMF_INTERNAL_NAMESPACE::FLOAT:
 
-            while (readPtr <= endPtr)
-            {
-                for (size_t i = 0; i < sizeof (float); ++i)
-                    *writePtr++ = readPtr[i];
-
-                readPtr += xStride;
-            }
+            copyValuesFromFrameBuffer (writePtr, readPtr, endPtr,
+                                       xStride, sizeof (float));
             break;
             
           default:
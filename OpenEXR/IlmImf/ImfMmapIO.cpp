@@ -0,0 +1,267 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//
+//	Low-level file input for OpenEXR based on
+//	operating system memory-mapped files.
+//
+//-----------------------------------------------------------------------------
+
+#include <ImfMmapIO.h>
+#include "Iex.h"
+
+#if defined _WIN32 || defined _WIN64
+    #ifdef NOMINMAX
+        #undef NOMINMAX
+    #endif
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include <errno.h>
+#include <string.h>
+
+#include "ImfNamespace.h"
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+
+#if defined _WIN32 || defined _WIN64
+
+MmapIStream::MmapIStream (const char fileName[]):
+    OPENEXR_IMF_INTERNAL_NAMESPACE::IStream (fileName),
+    _buffer (0),
+    _length (0),
+    _pos (0),
+    _fileHandle (INVALID_HANDLE_VALUE),
+    _mappingHandle (0)
+{
+    HANDLE file = CreateFileA (fileName,
+                               GENERIC_READ,
+                               FILE_SHARE_READ,
+                               0,
+                               OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL,
+                               0);
+
+    if (file == INVALID_HANDLE_VALUE)
+        THROW (IEX_NAMESPACE::InputExc, "Cannot open file "
+               "\"" << fileName << "\" (error " << GetLastError() << ").");
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx (file, &size))
+    {
+        CloseHandle (file);
+        THROW (IEX_NAMESPACE::InputExc, "Cannot determine the size of file "
+               "\"" << fileName << "\".");
+    }
+
+    _fileHandle = file;
+    _length = size.QuadPart;
+
+    if (_length == 0)
+        return;
+
+    HANDLE mapping = CreateFileMappingA (file, 0, PAGE_READONLY, 0, 0, 0);
+
+    if (mapping == 0)
+    {
+        CloseHandle (file);
+        THROW (IEX_NAMESPACE::InputExc, "Cannot memory-map file "
+               "\"" << fileName << "\" (error " << GetLastError() << ").");
+    }
+
+    _mappingHandle = mapping;
+    _buffer = (char *) MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (_buffer == 0)
+    {
+        CloseHandle (mapping);
+        CloseHandle (file);
+        THROW (IEX_NAMESPACE::InputExc, "Cannot memory-map file "
+               "\"" << fileName << "\" (error " << GetLastError() << ").");
+    }
+}
+
+
+MmapIStream::~MmapIStream ()
+{
+    if (_buffer)
+        UnmapViewOfFile (_buffer);
+
+    if (_mappingHandle)
+        CloseHandle ((HANDLE) _mappingHandle);
+
+    if (_fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle ((HANDLE) _fileHandle);
+}
+
+#else
+
+MmapIStream::MmapIStream (const char fileName[]):
+    OPENEXR_IMF_INTERNAL_NAMESPACE::IStream (fileName),
+    _buffer (0),
+    _length (0),
+    _pos (0)
+{
+    int fd = ::open (fileName, O_RDONLY);
+
+    if (fd < 0)
+        IEX_NAMESPACE::throwErrnoExc();
+
+    struct stat st;
+
+    if (::fstat (fd, &st) < 0)
+    {
+        int err = errno;
+        ::close (fd);
+        IEX_NAMESPACE::throwErrnoExc ("%T.", err);
+    }
+
+    _length = st.st_size;
+
+    if (_length > 0)
+    {
+        void *p = ::mmap (0, _length, PROT_READ, MAP_SHARED, fd, 0);
+
+        if (p == MAP_FAILED)
+        {
+            int err = errno;
+            ::close (fd);
+            IEX_NAMESPACE::throwErrnoExc ("%T.", err);
+        }
+
+        _buffer = (char *) p;
+    }
+
+    //
+    // The mapping stays valid after the file descriptor is closed.
+    //
+
+    ::close (fd);
+}
+
+
+MmapIStream::~MmapIStream ()
+{
+    if (_buffer)
+        ::munmap (_buffer, _length);
+}
+
+#endif
+
+
+bool
+MmapIStream::isMemoryMapped () const
+{
+    return true;
+}
+
+
+bool
+MmapIStream::read (char c[/*n*/], int n)
+{
+    if (n < 0 || _pos > _length || Int64 (n) > _length - _pos)
+    {
+        THROW (IEX_NAMESPACE::InputExc, "Early end of file: read " <<
+               (_pos < _length ? _length - _pos : 0) << " out of " <<
+               n << " requested bytes.");
+    }
+
+    memcpy (c, _buffer + _pos, n);
+    _pos += n;
+
+    return _pos < _length;
+}
+
+
+char *
+MmapIStream::readMemoryMapped (int n)
+{
+    if (n < 0 || _pos > _length || Int64 (n) > _length - _pos)
+        throw IEX_NAMESPACE::InputExc ("Reading past end of file.");
+
+    char *retVal = _buffer + _pos;
+    _pos += n;
+    return retVal;
+}
+
+
+bool
+MmapIStream::isStatelessRead () const
+{
+    return true;
+}
+
+
+void
+MmapIStream::readAt (char c[/*n*/], int n, Int64 pos)
+{
+    if (n < 0 || pos > _length || Int64 (n) > _length - pos)
+        throw IEX_NAMESPACE::InputExc ("Reading past end of file.");
+
+    memcpy (c, _buffer + pos, n);
+}
+
+
+Int64
+MmapIStream::tellg ()
+{
+    return _pos;
+}
+
+
+void
+MmapIStream::seekg (Int64 pos)
+{
+    _pos = pos;
+}
+
+
+Int64
+MmapIStream::length () const
+{
+    return _length;
+}
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_EXIT
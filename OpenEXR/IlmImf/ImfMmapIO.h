@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef INCLUDED_IMF_MMAP_IO_H
+#define INCLUDED_IMF_MMAP_IO_H
+
+//-----------------------------------------------------------------------------
+//
+//	Low-level file input for OpenEXR based on
+//	operating system memory-mapped files.
+//
+//-----------------------------------------------------------------------------
+
+#include "ImfIO.h"
+#include "ImfNamespace.h"
+#include "ImfExport.h"
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
+
+//-------------------------------------------------------------
+// class MmapIStream -- an implementation of class
+// OPENEXR_IMF_INTERNAL_NAMESPACE::IStream that maps the entire
+// file into the address space of the process.
+//
+// The stream reports isMemoryMapped() == true, so the scan
+// line and tile readers decompress directly out of the mapped
+// pages instead of copying each chunk into a private buffer.
+// The mapping is read-only and shared, so the pages can be
+// shared with other processes reading the same file.
+//-------------------------------------------------------------
+
+class MmapIStream: public OPENEXR_IMF_INTERNAL_NAMESPACE::IStream
+{
+  public:
+
+    //-------------------------------------------------------
+    // A constructor that opens and maps the file with the
+    // given name.  The destructor will unmap and close the
+    // file.  Pointers returned by readMemoryMapped() remain
+    // valid until the MmapIStream is destroyed.
+    //-------------------------------------------------------
+
+    IMF_EXPORT
+    MmapIStream (const char fileName[]);
+
+    IMF_EXPORT
+    virtual ~MmapIStream ();
+
+    IMF_EXPORT
+    virtual bool	isMemoryMapped () const;
+    IMF_EXPORT
+    virtual bool	read (char c[/*n*/], int n);
+    IMF_EXPORT
+    virtual char *	readMemoryMapped (int n);
+    IMF_EXPORT
+    virtual bool	isStatelessRead () const;
+    IMF_EXPORT
+    virtual void	readAt (char c[/*n*/], int n, Int64 pos);
+    IMF_EXPORT
+    virtual Int64	tellg ();
+    IMF_EXPORT
+    virtual void	seekg (Int64 pos);
+
+
+    //--------------------------------
+    // Total length of the mapped file
+    //--------------------------------
+
+    IMF_EXPORT
+    Int64		length () const;
+
+  private:
+
+    char *		_buffer;
+    Int64		_length;
+    Int64		_pos;
+
+#if defined _WIN32 || defined _WIN64
+    void *		_fileHandle;
+    void *		_mappingHandle;
+#endif
+};
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif
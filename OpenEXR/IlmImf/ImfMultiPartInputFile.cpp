@@ -39,6 +39,7 @@
 #include "ImfBoxAttribute.h"
 #include "ImfFloatAttribute.h"
 #include "ImfStdIO.h"
+#include "ImfMmapIO.h"
 #include "ImfTileOffsets.h"
 #include "ImfMisc.h"
 #include "ImfTiledMisc.h"
@@ -64,6 +65,7 @@ OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
 
 using ILMTHREAD_NAMESPACE::Mutex;
 using ILMTHREAD_NAMESPACE::Lock;
+using ILMTHREAD_NAMESPACE::ThreadPool;
 using IMATH_NAMESPACE::Box2i;
 
 using std::vector;
@@ -84,6 +86,7 @@ struct MultiPartInputFile::Data: public InputStreamMutex
     bool                        deleteStream;   // If we should delete the stream during destruction.
     vector<InputPartData*>      parts;          // Data to initialize Output files.
     int                         numThreads;     // Number of threads
+    ThreadPool *                threadPool;     // Pool for the parts' tasks
     bool                        reconstructChunkOffsetTable;    // If we should reconstruct
                                                                 // the offset table if it's broken.
     std::map<int,GenericInputFile*> _inputFiles;
@@ -102,10 +105,12 @@ struct MultiPartInputFile::Data: public InputStreamMutex
    
    InputPartData*          getPart(int partNumber);
    
-    Data (bool deleteStream, int numThreads, bool reconstructChunkOffsetTable):
+    Data (bool deleteStream, int numThreads, bool reconstructChunkOffsetTable,
+          ThreadPool *threadPool):
         InputStreamMutex(),
         deleteStream (deleteStream),
         numThreads (numThreads),
+        threadPool (threadPool),
         reconstructChunkOffsetTable(reconstructChunkOffsetTable)
     {
     }
@@ -127,12 +132,18 @@ struct MultiPartInputFile::Data: public InputStreamMutex
 
 MultiPartInputFile::MultiPartInputFile(const char fileName[],
                            int numThreads,
-                           bool reconstructChunkOffsetTable):
-    _data(new Data(true, numThreads, reconstructChunkOffsetTable))
+                           bool reconstructChunkOffsetTable,
+                           bool memoryMapped,
+                           ThreadPool &threadPool):
+    _data(new Data(true, numThreads, reconstructChunkOffsetTable, &threadPool))
 {
     try
     {
-        _data->is = new StdIFStream (fileName);
+        if (memoryMapped)
+            _data->is = new MmapIStream (fileName);
+        else
+            _data->is = new StdIFStream (fileName);
+
         initialize();
     }
     catch (IEX_NAMESPACE::BaseExc &e)
@@ -152,8 +163,9 @@ MultiPartInputFile::MultiPartInputFile(const char fileName[],
 
 MultiPartInputFile::MultiPartInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream& is,
                                         int numThreads,
-                                        bool reconstructChunkOffsetTable):
-    _data(new Data(false, numThreads, reconstructChunkOffsetTable))
+                                        bool reconstructChunkOffsetTable,
+                                        ThreadPool &threadPool):
+    _data(new Data(false, numThreads, reconstructChunkOffsetTable, &threadPool))
 {
     try
     {
@@ -424,7 +436,8 @@ MultiPartInputFile::initialize()
         
     for (size_t i = 0; i < _data->_headers.size(); i++)
         _data->parts.push_back(
-                new InputPartData(_data, _data->_headers[i], i, _data->numThreads, _data->version));
+                new InputPartData(_data, _data->_headers[i], i, _data->numThreads,
+                                  _data->version, _data->threadPool));
 
     _data->readChunkOffsetTables(_data->reconstructChunkOffsetTable);
 }
@@ -532,6 +545,7 @@ MultiPartInputFile::Data::chunkOffsetReconstruction(OPENEXR_IMF_INTERNAL_NAMESPA
                 case B44_COMPRESSION :
                 case B44A_COMPRESSION :
                 case DWAA_COMPRESSION :
+                case ZSTD_COMPRESSION :
                     rowsizes[i]=32;
                     break;
                 case ZIP_COMPRESSION :
@@ -47,15 +47,33 @@ OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
 class MultiPartInputFile : public GenericInputFile
 {
   public:
+
+    //-----------------------------------------------------------
+    // A constructor that opens the file with the specified name.
+    // Destroying the MultiPartInputFile object will close the
+    // file.
+    //
+    // If memoryMapped is true, the file is opened through an
+    // MmapIStream (see ImfMmapIO.h) rather than a StdIFStream.
+    //
+    // The parts of the file decompress their pixel data with
+    // tasks in threadPool.
+    //-----------------------------------------------------------
+
     IMF_EXPORT
     MultiPartInputFile(const char fileName[],
                        int numThreads = globalThreadCount(),
-                       bool reconstructChunkOffsetTable = true);
+                       bool reconstructChunkOffsetTable = true,
+                       bool memoryMapped = false,
+                       ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                           globalThreadPool());
 
     IMF_EXPORT
     MultiPartInputFile(IStream& is,
                        int numThreads = globalThreadCount(),
-                       bool reconstructChunkOffsetTable = true);
+                       bool reconstructChunkOffsetTable = true,
+                       ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                           globalThreadPool());
 
     IMF_EXPORT
     virtual ~MultiPartInputFile();
@@ -60,6 +60,7 @@ OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
 
 using IMATH_NAMESPACE::Box2i;
 using ILMTHREAD_NAMESPACE::Lock;
+using ILMTHREAD_NAMESPACE::ThreadPool;
     
 
 using std::vector;
@@ -72,6 +73,7 @@ struct MultiPartOutputFile::Data: public OutputStreamMutex
         vector<OutputPartData*>         parts;        // Contains data to initialize Output files.
         bool                            deleteStream; // If we should delete the stream when destruction.
         int                             numThreads;   // The number of threads.
+        ThreadPool *                    threadPool;   // Pool for the parts' tasks.
         std::map<int, GenericOutputFile*>    _outputFiles;
         std::vector<Header>                  _headers;
         
@@ -109,10 +111,11 @@ struct MultiPartOutputFile::Data: public OutputStreamMutex
         bool                    checkSharedAttributesValues (const Header & src,
                                                              const Header & dst, 
                                                              std::vector<std::string> & conflictingAttributes) const;
-        Data (bool deleteStream, int numThreads):
+        Data (bool deleteStream, int numThreads, ThreadPool *threadPool):
             OutputStreamMutex(),
             deleteStream (deleteStream),
-            numThreads (numThreads)
+            numThreads (numThreads),
+            threadPool (threadPool)
         {
         }
         
@@ -196,9 +199,10 @@ MultiPartOutputFile::MultiPartOutputFile (const char fileName[],
                                           const Header * headers,
                                           int parts,
                                           bool overrideSharedAttributes,
-                                          int numThreads)
+                                          int numThreads,
+                                          ThreadPool &threadPool)
 :
-    _data (new Data (true, numThreads))
+    _data (new Data (true, numThreads, &threadPool))
 {
     // grab headers
     _data->_headers.resize(parts);
@@ -218,7 +222,7 @@ MultiPartOutputFile::MultiPartOutputFile (const char fileName[],
 
         _data->os = new StdOFStream (fileName);
         for (size_t i = 0; i < _data->_headers.size(); i++)
-            _data->parts.push_back( new OutputPartData(_data, _data->_headers[i], i, numThreads, parts>1 ) );
+            _data->parts.push_back( new OutputPartData(_data, _data->_headers[i], i, numThreads, parts>1, &threadPool ) );
 
         writeMagicNumberAndVersionField(*_data->os, &_data->_headers[0],_data->_headers.size());
         _data->writeHeadersToFile(_data->_headers);
@@ -243,8 +247,9 @@ MultiPartOutputFile::MultiPartOutputFile(OStream& os,
                                          const Header* headers, 
                                          int parts, 
                                          bool overrideSharedAttributes, 
-                                         int numThreads): 
-                                         _data(new Data(false,numThreads))
+                                         int numThreads,
+                                         ThreadPool &threadPool): 
+                                         _data(new Data(false,numThreads,&threadPool))
 {
     // grab headers
     _data->_headers.resize(parts);
@@ -264,7 +269,7 @@ MultiPartOutputFile::MultiPartOutputFile(OStream& os,
         //
         
         for (size_t i = 0; i < _data->_headers.size(); i++)
-            _data->parts.push_back( new OutputPartData(_data, _data->_headers[i], i, numThreads, parts>1 ) );
+            _data->parts.push_back( new OutputPartData(_data, _data->_headers[i], i, numThreads, parts>1, &threadPool ) );
         
         writeMagicNumberAndVersionField(*_data->os, &_data->_headers[0],_data->_headers.size());
         _data->writeHeadersToFile(_data->_headers);
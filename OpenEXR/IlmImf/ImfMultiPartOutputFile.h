@@ -65,6 +65,7 @@ OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
 //                             set false to check for inconsistencies, true
 //                             to copy the values over from the first header.
 //  numThreads - number of threads that should be used in encoding the data.
+//  threadPool - the thread pool whose worker threads encode the data.
 //
     
 class MultiPartOutputFile : public GenericOutputFile
@@ -75,14 +76,18 @@ class MultiPartOutputFile : public GenericOutputFile
                             const Header * headers,
                             int parts,
                             bool overrideSharedAttributes = false,
-                            int numThreads = globalThreadCount());
+                            int numThreads = globalThreadCount(),
+                            ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                                globalThreadPool());
                             
         IMF_EXPORT
         MultiPartOutputFile(OStream & os,
                             const Header * headers,
                             int parts,
                             bool overrideSharedAttributes = false,
-                            int numThreads = globalThreadCount());                            
+                            int numThreads = globalThreadCount(),
+                            ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                                globalThreadPool());
 
         //
         // return number of parts in file
@@ -41,10 +41,12 @@
 
 #include "ImfSimd.h"
 #include "ImfSystemSpecific.h"
+#include "ImfPixelCopySimd.h"
 #include <iostream>
 #include "ImfChannelList.h"
 #include "ImfFrameBuffer.h"
 #include "ImfStringVectorAttribute.h"
+#include <string.h>
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -225,6 +227,28 @@ void optimizedWriteToRGBA (unsigned short*& readPtrRed,
                            const size_t& pixelsToCopySSE,
                            const size_t& pixelsToCopyNormal)
 {
+    //
+    // If the processor supports AVX2 or AVX-512, copy as many
+    // pixels as possible with the wider registers first; the SSE2
+    // code below copies the remaining 8-pixel blocks.
+    //
+
+    size_t pixelsCopiedWide = interleaveRGBA (readPtrRed,
+                                              readPtrGreen,
+                                              readPtrBlue,
+                                              readPtrAlpha,
+                                              writePtr,
+                                              pixelsToCopySSE * 8);
+
+    readPtrRed   += pixelsCopiedWide;
+    readPtrGreen += pixelsCopiedWide;
+    readPtrBlue  += pixelsCopiedWide;
+    readPtrAlpha += pixelsCopiedWide;
+    writePtr     += pixelsCopiedWide * 4;
+
+    const size_t pixelsToCopySSERemaining =
+        pixelsToCopySSE - pixelsCopiedWide / 8;
+
     bool readPtrAreAligned = true;
 
     readPtrAreAligned &= isPointerSSEAligned(readPtrRed);
@@ -241,7 +265,7 @@ void optimizedWriteToRGBA (unsigned short*& readPtrRed,
                                               (__m128i*&)readPtrBlue,
                                               (__m128i*&)readPtrAlpha,
                                               (__m128i*&)writePtr,
-                                              pixelsToCopySSE);
+                                              pixelsToCopySSERemaining);
     }
     else if (!readPtrAreAligned && writePtrIsAligned)
     {
@@ -250,7 +274,7 @@ void optimizedWriteToRGBA (unsigned short*& readPtrRed,
                                              (__m128i*&)readPtrBlue,
                                              (__m128i*&)readPtrAlpha,
                                              (__m128i*&)writePtr,
-                                             pixelsToCopySSE);
+                                             pixelsToCopySSERemaining);
     }
     else if (readPtrAreAligned && !writePtrIsAligned)
     {
@@ -259,7 +283,7 @@ void optimizedWriteToRGBA (unsigned short*& readPtrRed,
                                              (__m128i*&)readPtrBlue,
                                              (__m128i*&)readPtrAlpha,
                                              (__m128i*&)writePtr,
-                                             pixelsToCopySSE);
+                                             pixelsToCopySSERemaining);
     }
     else if(readPtrAreAligned && writePtrIsAligned)
     {
@@ -268,7 +292,7 @@ void optimizedWriteToRGBA (unsigned short*& readPtrRed,
                                             (__m128i*&)readPtrBlue,
                                             (__m128i*&)readPtrAlpha,
                                             (__m128i*&)writePtr,
-                                            pixelsToCopySSE);
+                                            pixelsToCopySSERemaining);
     }
 
     writeToRGBANormal (readPtrRed, readPtrGreen, readPtrBlue, readPtrAlpha,
@@ -386,6 +410,27 @@ optimizedWriteToRGBAFillA (unsigned short*& readPtrRed,
                            const size_t& pixelsToCopySSE,
                            const size_t& pixelsToCopyNormal)
 {
+    //
+    // If the processor supports AVX2 or AVX-512, copy as many
+    // pixels as possible with the wider registers first; the SSE2
+    // code below copies the remaining 8-pixel blocks.
+    //
+
+    size_t pixelsCopiedWide = interleaveRGBAFillA (readPtrRed,
+                                                   readPtrGreen,
+                                                   readPtrBlue,
+                                                   alphaFillValue,
+                                                   writePtr,
+                                                   pixelsToCopySSE * 8);
+
+    readPtrRed   += pixelsCopiedWide;
+    readPtrGreen += pixelsCopiedWide;
+    readPtrBlue  += pixelsCopiedWide;
+    writePtr     += pixelsCopiedWide * 4;
+
+    const size_t pixelsToCopySSERemaining =
+        pixelsToCopySSE - pixelsCopiedWide / 8;
+
     bool readPtrAreAligned = true;
 
     readPtrAreAligned &= isPointerSSEAligned (readPtrRed);
@@ -401,7 +446,7 @@ optimizedWriteToRGBAFillA (unsigned short*& readPtrRed,
                                                    (__m128i*&)readPtrBlue,
                                                    alphaFillValue,
                                                    (__m128i*&)writePtr,
-                                                   pixelsToCopySSE);
+                                                   pixelsToCopySSERemaining);
     }
     else if (!readPtrAreAligned && writePtrIsAligned)
     {
@@ -410,7 +455,7 @@ optimizedWriteToRGBAFillA (unsigned short*& readPtrRed,
                                                   (__m128i*&)readPtrBlue,
                                                   alphaFillValue,
                                                   (__m128i*&)writePtr,
-                                                  pixelsToCopySSE);
+                                                  pixelsToCopySSERemaining);
     }
     else if (readPtrAreAligned && !writePtrIsAligned)
     {
@@ -419,7 +464,7 @@ optimizedWriteToRGBAFillA (unsigned short*& readPtrRed,
                                                   (__m128i*&)readPtrBlue,
                                                   alphaFillValue,
                                                   (__m128i*&)writePtr,
-                                                  pixelsToCopySSE);
+                                                  pixelsToCopySSERemaining);
     }
     else if (readPtrAreAligned && writePtrIsAligned)
     {
@@ -428,7 +473,7 @@ optimizedWriteToRGBAFillA (unsigned short*& readPtrRed,
                                                  (__m128i*&)readPtrBlue,
                                                  alphaFillValue,
                                                  (__m128i*&)writePtr,
-                                                 pixelsToCopySSE);
+                                                 pixelsToCopySSERemaining);
     }
 
     writeToRGBAFillANormal (readPtrRed,
@@ -635,6 +680,161 @@ void optimizedWriteToRGB (unsigned short*& readPtrRed,
 
 
 
+//------------------------------------------------------------------------
+//
+// Write to an arbitrary number of interleaved channels
+//
+//------------------------------------------------------------------------
+
+//
+// Using SSE intrinsics.  CHANNELS (one to four) consecutive channels
+// of eight pixels are interleaved in registers, and each pixel's
+// values are then stored with a single, fixed-size copy; pixelStride
+// is the number of channels in a pixel.  A null read pointer means
+// that the channel is filled with a constant value.
+//
+template<int CHANNELS>
+EXR_FORCEINLINE
+void
+writeToInterleavedSSETemplate (const unsigned short * const * readPtrs,
+                               const unsigned short * fillValues,
+                               unsigned short * writePtr,
+                               size_t pixelStride,
+                               size_t pixelsToCopySSE)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i fillRegisters[4];
+
+    for (int c = 0; c < 4; ++c)
+    {
+        fillRegisters[c] = (c < CHANNELS && !readPtrs[c])?
+                               _mm_set1_epi16 (short (fillValues[c])): zero;
+    }
+
+    __m128i pixelRegisters[4];
+    const unsigned short * pixels = (const unsigned short *) pixelRegisters;
+
+    for (size_t i = 0; i < pixelsToCopySSE; ++i)
+    {
+        __m128i registers[4];
+
+        for (int c = 0; c < 4; ++c)
+        {
+            registers[c] = (c < CHANNELS && readPtrs[c])?
+                _mm_loadu_si128 ((const __m128i *) (readPtrs[c] + i * 8)):
+                fillRegisters[c];
+        }
+
+        __m128i lo01 = _mm_unpacklo_epi16 (registers[0], registers[1]);
+        __m128i lo23 = _mm_unpacklo_epi16 (registers[2], registers[3]);
+        __m128i hi01 = _mm_unpackhi_epi16 (registers[0], registers[1]);
+        __m128i hi23 = _mm_unpackhi_epi16 (registers[2], registers[3]);
+
+        pixelRegisters[0] = _mm_unpacklo_epi32 (lo01, lo23);
+        pixelRegisters[1] = _mm_unpackhi_epi32 (lo01, lo23);
+        pixelRegisters[2] = _mm_unpacklo_epi32 (hi01, hi23);
+        pixelRegisters[3] = _mm_unpackhi_epi32 (hi01, hi23);
+
+        if (CHANNELS == 4)
+        {
+            for (int r = 0; r < 4; ++r)
+            {
+                _mm_storel_epi64 ((__m128i *) writePtr, pixelRegisters[r]);
+                writePtr += pixelStride;
+
+                _mm_storeh_pd ((double *) writePtr,
+                               _mm_castsi128_pd (pixelRegisters[r]));
+                writePtr += pixelStride;
+            }
+        }
+        else
+        {
+            for (int p = 0; p < 8; ++p)
+            {
+                memcpy (writePtr, pixels + p * 4,
+                        CHANNELS * sizeof (unsigned short));
+                writePtr += pixelStride;
+            }
+        }
+    }
+}
+
+//
+// Not using SSE intrinsics.
+//
+EXR_FORCEINLINE
+void
+writeToInterleavedNormal (const unsigned short * const * readPtrs,
+                          const unsigned short * fillValues,
+                          size_t nbChannels,
+                          size_t firstPixel,
+                          unsigned short * writePtr,
+                          size_t pixelStride,
+                          size_t pixelsToCopy)
+{
+    for (size_t i = firstPixel; i < firstPixel + pixelsToCopy; ++i)
+    {
+        for (size_t c = 0; c < nbChannels; ++c)
+            writePtr[c] = readPtrs[c]? readPtrs[c][i]: fillValues[c];
+
+        writePtr += pixelStride;
+    }
+}
+
+//
+// Interleave nbChannels channels into pixels of nbChannels values each.
+// The channels are copied in groups of up to four, which keeps all
+// the channels' read pointers and the written pixels in the cache.
+// readPtrs[c] may be null, in which case channel c is filled with
+// fillValues[c].
+//
+inline
+void
+optimizedWriteToInterleaved (const unsigned short * const * readPtrs,
+                             const unsigned short * fillValues,
+                             size_t nbChannels,
+                             unsigned short * writePtr,
+                             const size_t& pixelsToCopySSE,
+                             const size_t& pixelsToCopyNormal)
+{
+    for (size_t c = 0; c < nbChannels; c += 4)
+    {
+        const unsigned short * const * r = readPtrs + c;
+        const unsigned short * f = fillValues + c;
+        unsigned short * w = writePtr + c;
+
+        switch (nbChannels - c < 4? nbChannels - c: 4)
+        {
+          case 1:
+            writeToInterleavedSSETemplate<1> (r, f, w, nbChannels,
+                                              pixelsToCopySSE);
+            break;
+
+          case 2:
+            writeToInterleavedSSETemplate<2> (r, f, w, nbChannels,
+                                              pixelsToCopySSE);
+            break;
+
+          case 3:
+            writeToInterleavedSSETemplate<3> (r, f, w, nbChannels,
+                                              pixelsToCopySSE);
+            break;
+
+          default:
+            writeToInterleavedSSETemplate<4> (r, f, w, nbChannels,
+                                              pixelsToCopySSE);
+            break;
+        }
+    }
+
+    writeToInterleavedNormal (readPtrs, fillValues, nbChannels,
+                              pixelsToCopySSE * 8,
+                              writePtr + pixelsToCopySSE * 8 * nbChannels,
+                              nbChannels, pixelsToCopyNormal);
+}
+
+
+
 
 #else // ! defined IMF_HAVE_SSE2
 
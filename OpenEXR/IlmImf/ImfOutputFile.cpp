@@ -48,6 +48,7 @@
 #include <ImfChannelList.h>
 #include <ImfMisc.h>
 #include <ImfStdIO.h>
+#include <ImfWriteBehindIO.h>
 #include <ImfCompressor.h>
 #include "ImathBox.h"
 #include "ImathFun.h"
@@ -210,6 +211,9 @@ struct OutputFile::Data
     int                  partNumber;            // the output part number
     OutputStreamMutex *  _streamData;         
     bool                 _deleteStream;
+    ThreadPool *         threadPool;            // runs the line buffer tasks
+    WriteBehindOStream * writeBehindStream;     // wraps _streamData->os if
+                                                // write-behind is on
      Data (int numThreads);
     ~Data ();
 
@@ -224,7 +228,9 @@ OutputFile::Data::Data (int numThreads):
     lineOffsetsPosition (0),
     partNumber (-1),
     _streamData(0),
-    _deleteStream(false)
+    _deleteStream(false),
+    threadPool(&globalThreadPool()),
+    writeBehindStream(0)
 {
     //
     // We need at least one lineBuffer, but if threading is used,
@@ -654,11 +660,13 @@ LineBufferTask::execute ()
 OutputFile::OutputFile
     (const char fileName[],
      const Header &header,
-     int numThreads)
+     int numThreads,
+     ThreadPool &threadPool)
 :
     _data (new Data (numThreads))
     
 {
+    _data->threadPool = &threadPool;
     _data->_streamData=new OutputStreamMutex ();
     _data->_deleteStream=true;
     try
@@ -698,10 +706,12 @@ OutputFile::OutputFile
 OutputFile::OutputFile
     (OPENEXR_IMF_INTERNAL_NAMESPACE::OStream &os,
      const Header &header,
-     int numThreads)
+     int numThreads,
+     ThreadPool &threadPool)
 :
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     
     _data->_streamData=new OutputStreamMutex ();
     _data->_deleteStream=false;
@@ -747,6 +757,7 @@ OutputFile::OutputFile(const OutputPartData* part) : _data(NULL)
 
         _data = new Data (part->numThreads);
         _data->_streamData = part->mutex;
+        _data->threadPool = part->threadPool;
         _data->_deleteStream=false;
         _data->multiPart=part->multipart;
 
@@ -858,6 +869,17 @@ OutputFile::~OutputFile ()
             }
         }
 
+        if (_data->writeBehindStream)
+        {
+            //
+            // Wait for the queued data, and detach
+            // the write-behind stream from the file.
+            //
+
+            _data->_streamData->os = &_data->writeBehindStream->stream();
+            delete _data->writeBehindStream;
+        }
+
         if (_data->_deleteStream && _data->_streamData)
             delete _data->_streamData->os;
 
@@ -1041,7 +1063,7 @@ OutputFile::writePixels (int numScanLines)
 
                 for (int i = 0; i < numTasks; i++)
 		{
-                    ThreadPool::addGlobalTask
+                    _data->threadPool->addTask
                         (new LineBufferTask (&taskGroup, _data, first + i,
                                              scanLineMin, scanLineMax));
 		}
@@ -1064,7 +1086,7 @@ OutputFile::writePixels (int numScanLines)
 
                 for (int i = 0; i < numTasks; i++)
 		{
-                    ThreadPool::addGlobalTask
+                    _data->threadPool->addTask
                         (new LineBufferTask (&taskGroup, _data, first - i,
                                              scanLineMin, scanLineMax));
 		}
@@ -1154,7 +1176,7 @@ OutputFile::writePixels (int numScanLines)
                 // Add nextCompressBuffer as a compression task
 		//
 
-                ThreadPool::addGlobalTask
+                _data->threadPool->addTask
                     (new LineBufferTask (&taskGroup, _data, nextCompressBuffer,
                                          scanLineMin, scanLineMax));
                 
@@ -1217,6 +1239,72 @@ OutputFile::currentScanLine () const
 }
 
 
+void
+OutputFile::setWriteBehind (size_t maxBytesInFlight)
+{
+    Lock lock (*_data->_streamData);
+
+    if (_data->partNumber != -1)
+    {
+        THROW (IEX_NAMESPACE::ArgExc, "Cannot use write-behind for "
+               "part " << _data->partNumber << " of image file "
+               "\"" << fileName() << "\".  Write-behind is only "
+               "available for single-part files.");
+    }
+
+    if (maxBytesInFlight > 0)
+    {
+        if (_data->writeBehindStream)
+        {
+            _data->writeBehindStream->setMaxBytesInFlight (maxBytesInFlight);
+        }
+        else
+        {
+            _data->writeBehindStream =
+                new WriteBehindOStream (*_data->_streamData->os,
+                                        maxBytesInFlight,
+                                        *_data->threadPool);
+
+            _data->_streamData->os = _data->writeBehindStream;
+        }
+    }
+    else if (_data->writeBehindStream)
+    {
+        WriteBehindOStream *writeBehindStream = _data->writeBehindStream;
+
+        _data->writeBehindStream = 0;
+        _data->_streamData->os = &writeBehindStream->stream();
+
+        try
+        {
+            writeBehindStream->flush();
+        }
+        catch (IEX_NAMESPACE::BaseExc &e)
+        {
+            delete writeBehindStream;
+
+            REPLACE_EXC (e, "Failed to write pixel data to image "
+                            "file \"" << fileName() << "\". " << e);
+            throw;
+        }
+
+        delete writeBehindStream;
+    }
+}
+
+
+size_t
+OutputFile::writeBehind () const
+{
+    Lock lock (*_data->_streamData);
+
+    if (_data->writeBehindStream)
+        return _data->writeBehindStream->maxBytesInFlight();
+
+    return 0;
+}
+
+
 void	
 OutputFile::copyPixels (InputFile &in)
 {
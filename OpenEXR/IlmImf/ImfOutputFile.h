@@ -66,12 +66,15 @@ class OutputFile : public GenericOutputFile
     // the file.
     //
     // numThreads determines the number of threads that will be
-    // used to write the file (see ImfThreading.h).
+    // used to write the file, and threadPool the pool that these
+    // threads belong to (see ImfThreading.h).
     //-----------------------------------------------------------
 
     IMF_EXPORT
     OutputFile (const char fileName[], const Header &header,
-                int numThreads = globalThreadCount());
+                int numThreads = globalThreadCount(),
+                ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                    globalThreadPool());
 
 
     //------------------------------------------------------------
@@ -83,12 +86,15 @@ class OutputFile : public GenericOutputFile
     // close the file.
     //
     // numThreads determines the number of threads that will be
-    // used to write the file (see ImfThreading.h).
+    // used to write the file, and threadPool the pool that these
+    // threads belong to (see ImfThreading.h).
     //------------------------------------------------------------
 
     IMF_EXPORT
     OutputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::OStream &os, const Header &header,
-                int numThreads = globalThreadCount());
+                int numThreads = globalThreadCount(),
+                ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                    globalThreadPool());
 
 
     //-------------------------------------------------
@@ -184,6 +190,40 @@ class OutputFile : public GenericOutputFile
     int			currentScanLine () const;
 
 
+    //------------------------------------------------------------------
+    // Write-behind:
+    //
+    // Normally writePixels() stores each compressed line buffer in the
+    // file before it moves on to the next one.  After a call to
+    // setWriteBehind(n), with n > 0, writePixels() hands the compressed
+    // line buffers to a task in the file's thread pool instead, which
+    // writes them to the file in the background, while more line
+    // buffers are compressed or while the caller prepares the next
+    // scan lines.  At most n bytes of compressed data are queued;
+    // writePixels() waits for the background task when the queue is
+    // full.  (See ImfWriteBehindIO.h.)
+    //
+    // setWriteBehind(0) waits until all queued data have been written,
+    // and turns write-behind off.  If a background write failed,
+    // setWriteBehind() throws an exception; if the failure happens
+    // earlier, the next call to writePixels() throws the exception.
+    // Destroying the OutputFile also waits for the queued data, but it
+    // does not report errors.
+    //
+    // writeBehind() returns the current limit, or 0 if write-behind
+    // is off.
+    //
+    // Write-behind is not available for parts of multi-part files;
+    // for them, setWriteBehind() throws an IEX_NAMESPACE::ArgExc.
+    //------------------------------------------------------------------
+
+    IMF_EXPORT
+    void		setWriteBehind (size_t maxBytesInFlight);
+
+    IMF_EXPORT
+    size_t		writeBehind () const;
+
+
     //--------------------------------------------------------------
     // Shortcut to copy all pixels from an InputFile into this file,
     // without uncompressing and then recompressing the pixel data.
@@ -39,12 +39,14 @@ OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
 
 
 OutputPartData::OutputPartData(OutputStreamMutex* mutex, const Header &header,
-                               int partNumber, int numThreads, bool multipart):
+                               int partNumber, int numThreads, bool multipart,
+                               ILMTHREAD_NAMESPACE::ThreadPool* threadPool):
         header(header),
         numThreads(numThreads),
         partNumber(partNumber),
         multipart(multipart),
-        mutex(mutex)
+        mutex(mutex),
+        threadPool(threadPool)
 {
 }
 
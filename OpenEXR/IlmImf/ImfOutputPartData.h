@@ -39,6 +39,7 @@
 #include "ImfForward.h"
 #include "ImfNamespace.h"
 #include "ImfExport.h"
+#include "IlmThreadForward.h"
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -51,10 +52,12 @@ struct OutputPartData
     int                     partNumber;
     bool                    multipart;
     OutputStreamMutex*      mutex;
+    ILMTHREAD_NAMESPACE::ThreadPool* threadPool;
 
     IMF_EXPORT
     OutputPartData(OutputStreamMutex* mutex, const Header &header,
-                   int partNumber, int numThreads, bool multipart);
+                   int partNumber, int numThreads, bool multipart,
+                   ILMTHREAD_NAMESPACE::ThreadPool* threadPool);
 
 };
 
@@ -0,0 +1,901 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2014, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//
+//	Pixel copy and conversion kernels with run-time CPU dispatch.
+//
+//	The AVX2 and AVX-512 kernels are compiled with GCC style target
+//	attributes, so that the rest of the library does not have to be
+//	built for those instruction sets.  They are only called after
+//	CpuId has confirmed that both the processor and the operating
+//	system support the corresponding registers.
+//
+//-----------------------------------------------------------------------------
+
+#include "ImfPixelCopySimd.h"
+#include "ImfSimd.h"
+#include "ImfSystemSpecific.h"
+#include "OpenEXRConfig.h"
+
+#include <half.h>
+#include <algorithm>
+#include <string.h>
+
+#if defined (IMF_HAVE_SSE2) && \
+    defined (OPENEXR_IMF_HAVE_GCC_INLINE_ASM_AVX) && \
+    defined (OPENEXR_IMF_HAVE_GCC_TARGET_AVX512)
+    #define IMF_HAVE_WIDE_SIMD_KERNELS 1
+    #include <immintrin.h>
+#endif
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+namespace {
+
+//
+// Baseline kernels (the interleaving functions leave
+// all of the work to the SSE2 code in the caller)
+//
+
+void
+convertHalfToFloatBaseline (const char *src,
+                            char *dst,
+                            size_t dstStride,
+                            size_t n)
+{
+    //
+    // The half library's array conversion is vectorized, too, but
+    // only for contiguous destinations; for other strides, convert
+    // through a buffer on the stack.
+    //
+
+    if (dstStride == sizeof (float))
+    {
+        halfToFloatArray ((const half *) src, (float *) dst, n);
+        return;
+    }
+
+    const size_t BLOCK_SIZE = 64;
+    float tmp[BLOCK_SIZE];
+
+    while (n > 0)
+    {
+        size_t m = std::min (n, BLOCK_SIZE);
+        halfToFloatArray ((const half *) src, tmp, m);
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            *(float *) dst = tmp[i];
+            dst += dstStride;
+        }
+
+        src += m * sizeof (half);
+        n -= m;
+    }
+}
+
+
+void
+gatherHalfBaseline (const char *src,
+                    size_t srcStride,
+                    char *dst,
+                    size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        *(half *) dst = *(const half *) src;
+        src += srcStride;
+        dst += sizeof (half);
+    }
+}
+
+
+size_t
+interleaveRGBABaseline (const unsigned short *,
+                        const unsigned short *,
+                        const unsigned short *,
+                        const unsigned short *,
+                        unsigned short *,
+                        size_t)
+{
+    return 0;
+}
+
+
+size_t
+interleaveRGBAFillABaseline (const unsigned short *,
+                             const unsigned short *,
+                             const unsigned short *,
+                             unsigned short,
+                             unsigned short *,
+                             size_t)
+{
+    return 0;
+}
+
+
+//
+// Byte reordering for the ZIP compressors.  The kernels take
+// separate pointers to the two halves of the split data; the
+// wide kernels hand their leftover bytes to the baseline kernels.
+//
+
+void
+splitBytesBaseline (const char *src, size_t n, char *even, char *odd)
+{
+    size_t i = 0;
+
+#ifdef IMF_HAVE_SSE2
+
+    const __m128i mask = _mm_set1_epi16 (0x00ff);
+
+    for (; i + 32 <= n; i += 32)
+    {
+        __m128i a = _mm_loadu_si128 ((const __m128i *) (src + i));
+        __m128i b = _mm_loadu_si128 ((const __m128i *) (src + i + 16));
+
+        _mm_storeu_si128 ((__m128i *) even,
+                          _mm_packus_epi16 (_mm_and_si128 (a, mask),
+                                            _mm_and_si128 (b, mask)));
+
+        _mm_storeu_si128 ((__m128i *) odd,
+                          _mm_packus_epi16 (_mm_srli_epi16 (a, 8),
+                                            _mm_srli_epi16 (b, 8)));
+        even += 16;
+        odd += 16;
+    }
+
+#endif
+
+    for (; i + 2 <= n; i += 2)
+    {
+        *(even++) = src[i];
+        *(odd++) = src[i + 1];
+    }
+
+    if (i < n)
+        *even = src[i];
+}
+
+
+void
+mergeBytesBaseline (const char *even, const char *odd, size_t n, char *dst)
+{
+    size_t i = 0;
+
+#ifdef IMF_HAVE_SSE2
+
+    for (; i + 32 <= n; i += 32)
+    {
+        __m128i a = _mm_loadu_si128 ((const __m128i *) even);
+        __m128i b = _mm_loadu_si128 ((const __m128i *) odd);
+
+        _mm_storeu_si128 ((__m128i *) (dst + i), _mm_unpacklo_epi8 (a, b));
+        _mm_storeu_si128 ((__m128i *) (dst + i + 16), _mm_unpackhi_epi8 (a, b));
+
+        even += 16;
+        odd += 16;
+    }
+
+#endif
+
+    for (; i + 2 <= n; i += 2)
+    {
+        dst[i] = *(even++);
+        dst[i + 1] = *(odd++);
+    }
+
+    if (i < n)
+        dst[i] = *even;
+}
+
+
+#ifdef IMF_HAVE_WIDE_SIMD_KERNELS
+
+//
+// Strides above this limit do not fit into the 32-bit
+// offsets of the gather and scatter instructions.
+//
+
+const size_t MAX_GATHER_STRIDE = 0x7fffffff / 16;
+
+
+//
+// The F16C conversion instructions quiet signaling NaNs, whereas
+// the half-to-float lookup table preserves every bit of the NaN
+// payload.  Lanes with an all-ones exponent are therefore rebuilt
+// from the half bits: sign, all-ones exponent, shifted mantissa.
+//
+
+__attribute__((target("avx2,f16c")))
+inline __m256
+fixInfNan (__m128i h, __m256 f)
+{
+    const __m256i w = _mm256_cvtepu16_epi32 (h);
+    const __m256i expMask = _mm256_set1_epi32 (0x7c00);
+
+    const __m256i special =
+        _mm256_cmpeq_epi32 (_mm256_and_si256 (w, expMask), expMask);
+
+    if (_mm256_testz_si256 (special, special))
+        return f;
+
+    const __m256i bits = _mm256_or_si256 (
+        _mm256_or_si256 (
+            _mm256_slli_epi32 (_mm256_and_si256 (w, _mm256_set1_epi32 (0x8000)), 16),
+            _mm256_set1_epi32 (0x7f800000)),
+        _mm256_slli_epi32 (_mm256_and_si256 (w, _mm256_set1_epi32 (0x03ff)), 13));
+
+    return _mm256_blendv_ps (f,
+                             _mm256_castsi256_ps (bits),
+                             _mm256_castsi256_ps (special));
+}
+
+
+__attribute__((target("avx2,f16c")))
+void
+convertHalfToFloatAvx2 (const char *src,
+                        char *dst,
+                        size_t dstStride,
+                        size_t n)
+{
+    size_t i = 0;
+
+    if (dstStride == sizeof (float))
+    {
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i h = _mm_loadu_si128 ((const __m128i *) src);
+            __m256  f = fixInfNan (h, _mm256_cvtph_ps (h));
+
+            _mm256_storeu_ps ((float *) dst, f);
+
+            src += 8 * sizeof (half);
+            dst += 8 * sizeof (float);
+        }
+    }
+    else
+    {
+        float tmp[8] __attribute__((aligned (32)));
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i h = _mm_loadu_si128 ((const __m128i *) src);
+            _mm256_store_ps (tmp, fixInfNan (h, _mm256_cvtph_ps (h)));
+
+            for (int j = 0; j < 8; ++j)
+            {
+                *(float *) dst = tmp[j];
+                dst += dstStride;
+            }
+
+            src += 8 * sizeof (half);
+        }
+    }
+
+    _mm256_zeroupper();
+    convertHalfToFloatBaseline (src, dst, dstStride, n - i);
+}
+
+
+__attribute__((target("avx2")))
+void
+gatherHalfAvx2 (const char *src,
+                size_t srcStride,
+                char *dst,
+                size_t n)
+{
+    size_t i = 0;
+
+    if (srcStride <= MAX_GATHER_STRIDE)
+    {
+        const int s = int (srcStride);
+
+        const __m256i offsets =
+            _mm256_setr_epi32 (0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+
+        const __m256i lowMask = _mm256_set1_epi32 (0xffff);
+
+        //
+        // Each lane loads 32 bits, two bytes more than the half it
+        // needs.  For every half except the last one those two bytes
+        // still lie inside the frame buffer, so the last half is
+        // always left to the scalar loop.
+        //
+
+        for (; i + 8 < n; i += 8)
+        {
+            __m256i v = _mm256_i32gather_epi32 ((const int *) src, offsets, 1);
+            v = _mm256_and_si256 (v, lowMask);
+
+            __m128i h = _mm_packus_epi32 (_mm256_castsi256_si128 (v),
+                                          _mm256_extracti128_si256 (v, 1));
+
+            _mm_storeu_si128 ((__m128i *) dst, h);
+
+            src += 8 * srcStride;
+            dst += 8 * sizeof (half);
+        }
+
+        _mm256_zeroupper();
+    }
+
+    gatherHalfBaseline (src, srcStride, dst, n - i);
+}
+
+
+__attribute__((target("avx2")))
+size_t
+interleaveRGBAAvx2 (const unsigned short *r,
+                    const unsigned short *g,
+                    const unsigned short *b,
+                    const unsigned short *a,
+                    unsigned short *dst,
+                    size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i rv = _mm256_loadu_si256 ((const __m256i *) (r + i));
+        __m256i gv = _mm256_loadu_si256 ((const __m256i *) (g + i));
+        __m256i bv = _mm256_loadu_si256 ((const __m256i *) (b + i));
+        __m256i av = _mm256_loadu_si256 ((const __m256i *) (a + i));
+
+        //
+        // Within each 128-bit lane, rg and ba hold pixels 0-3 (lo)
+        // or 4-7 (hi) of that lane; unpacking them again yields
+        // whole RGBA pixels, still split across the two lanes.
+        //
+
+        __m256i rgLo = _mm256_unpacklo_epi16 (rv, gv);
+        __m256i rgHi = _mm256_unpackhi_epi16 (rv, gv);
+        __m256i baLo = _mm256_unpacklo_epi16 (bv, av);
+        __m256i baHi = _mm256_unpackhi_epi16 (bv, av);
+
+        __m256i p0 = _mm256_unpacklo_epi32 (rgLo, baLo);  // 0 1 | 8 9
+        __m256i p1 = _mm256_unpackhi_epi32 (rgLo, baLo);  // 2 3 | 10 11
+        __m256i p2 = _mm256_unpacklo_epi32 (rgHi, baHi);  // 4 5 | 12 13
+        __m256i p3 = _mm256_unpackhi_epi32 (rgHi, baHi);  // 6 7 | 14 15
+
+        __m256i *out = (__m256i *) (dst + 4 * i);
+
+        _mm256_storeu_si256 (out + 0, _mm256_permute2x128_si256 (p0, p1, 0x20));
+        _mm256_storeu_si256 (out + 1, _mm256_permute2x128_si256 (p2, p3, 0x20));
+        _mm256_storeu_si256 (out + 2, _mm256_permute2x128_si256 (p0, p1, 0x31));
+        _mm256_storeu_si256 (out + 3, _mm256_permute2x128_si256 (p2, p3, 0x31));
+    }
+
+    _mm256_zeroupper();
+    return i;
+}
+
+
+__attribute__((target("avx2")))
+size_t
+interleaveRGBAFillAAvx2 (const unsigned short *r,
+                         const unsigned short *g,
+                         const unsigned short *b,
+                         unsigned short alpha,
+                         unsigned short *dst,
+                         size_t n)
+{
+    const __m256i av = _mm256_set1_epi16 (short (alpha));
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i rv = _mm256_loadu_si256 ((const __m256i *) (r + i));
+        __m256i gv = _mm256_loadu_si256 ((const __m256i *) (g + i));
+        __m256i bv = _mm256_loadu_si256 ((const __m256i *) (b + i));
+
+        __m256i rgLo = _mm256_unpacklo_epi16 (rv, gv);
+        __m256i rgHi = _mm256_unpackhi_epi16 (rv, gv);
+        __m256i baLo = _mm256_unpacklo_epi16 (bv, av);
+        __m256i baHi = _mm256_unpackhi_epi16 (bv, av);
+
+        __m256i p0 = _mm256_unpacklo_epi32 (rgLo, baLo);
+        __m256i p1 = _mm256_unpackhi_epi32 (rgLo, baLo);
+        __m256i p2 = _mm256_unpacklo_epi32 (rgHi, baHi);
+        __m256i p3 = _mm256_unpackhi_epi32 (rgHi, baHi);
+
+        __m256i *out = (__m256i *) (dst + 4 * i);
+
+        _mm256_storeu_si256 (out + 0, _mm256_permute2x128_si256 (p0, p1, 0x20));
+        _mm256_storeu_si256 (out + 1, _mm256_permute2x128_si256 (p2, p3, 0x20));
+        _mm256_storeu_si256 (out + 2, _mm256_permute2x128_si256 (p0, p1, 0x31));
+        _mm256_storeu_si256 (out + 3, _mm256_permute2x128_si256 (p2, p3, 0x31));
+    }
+
+    _mm256_zeroupper();
+    return i;
+}
+
+
+__attribute__((target("avx2")))
+void
+splitBytesAvx2 (const char *src, size_t n, char *even, char *odd)
+{
+    const __m256i mask = _mm256_set1_epi16 (0x00ff);
+    size_t i = 0;
+
+    for (; i + 64 <= n; i += 64)
+    {
+        __m256i a = _mm256_loadu_si256 ((const __m256i *) (src + i));
+        __m256i b = _mm256_loadu_si256 ((const __m256i *) (src + i + 32));
+
+        //
+        // The packs work within 128-bit lanes; the permutation
+        // puts the four 64-bit quarters back in order.
+        //
+
+        __m256i e = _mm256_packus_epi16 (_mm256_and_si256 (a, mask),
+                                         _mm256_and_si256 (b, mask));
+
+        __m256i o = _mm256_packus_epi16 (_mm256_srli_epi16 (a, 8),
+                                         _mm256_srli_epi16 (b, 8));
+
+        _mm256_storeu_si256 ((__m256i *) even,
+                             _mm256_permute4x64_epi64 (e, 0xd8));
+
+        _mm256_storeu_si256 ((__m256i *) odd,
+                             _mm256_permute4x64_epi64 (o, 0xd8));
+        even += 32;
+        odd += 32;
+    }
+
+    _mm256_zeroupper();
+    splitBytesBaseline (src + i, n - i, even, odd);
+}
+
+
+__attribute__((target("avx2")))
+void
+mergeBytesAvx2 (const char *even, const char *odd, size_t n, char *dst)
+{
+    size_t i = 0;
+
+    for (; i + 64 <= n; i += 64)
+    {
+        __m256i a = _mm256_loadu_si256 ((const __m256i *) even);
+        __m256i b = _mm256_loadu_si256 ((const __m256i *) odd);
+
+        __m256i lo = _mm256_unpacklo_epi8 (a, b);   // 0-15 | 32-47
+        __m256i hi = _mm256_unpackhi_epi8 (a, b);   // 16-31 | 48-63
+
+        _mm256_storeu_si256 ((__m256i *) (dst + i),
+                             _mm256_permute2x128_si256 (lo, hi, 0x20));
+
+        _mm256_storeu_si256 ((__m256i *) (dst + i + 32),
+                             _mm256_permute2x128_si256 (lo, hi, 0x31));
+        even += 32;
+        odd += 32;
+    }
+
+    _mm256_zeroupper();
+    mergeBytesBaseline (even, odd, n - i, dst + i);
+}
+
+
+__attribute__((target("avx512f,avx512bw")))
+void
+convertHalfToFloatAvx512 (const char *src,
+                          char *dst,
+                          size_t dstStride,
+                          size_t n)
+{
+    const __m512i expMask  = _mm512_set1_epi32 (0x7c00);
+    const __m512i signMask = _mm512_set1_epi32 (0x8000);
+    const __m512i mantMask = _mm512_set1_epi32 (0x03ff);
+    const __m512i infBits  = _mm512_set1_epi32 (0x7f800000);
+
+    const bool contiguous = (dstStride == sizeof (float));
+    const bool scatter = !contiguous && dstStride <= MAX_GATHER_STRIDE;
+
+    const int s = int (scatter? dstStride: 0);
+
+    const __m512i offsets =
+        _mm512_setr_epi32 ( 0 * s,  1 * s,  2 * s,  3 * s,
+                            4 * s,  5 * s,  6 * s,  7 * s,
+                            8 * s,  9 * s, 10 * s, 11 * s,
+                           12 * s, 13 * s, 14 * s, 15 * s);
+
+    size_t i = 0;
+
+    if (contiguous || scatter)
+    {
+        for (; i + 16 <= n; i += 16)
+        {
+            __m256i h = _mm256_loadu_si256 ((const __m256i *) src);
+            __m512  f = _mm512_cvtph_ps (h);
+
+            //
+            // Restore NaN payloads; see fixInfNan().
+            //
+
+            __m512i w = _mm512_cvtepu16_epi32 (h);
+
+            __mmask16 special =
+                _mm512_cmpeq_epi32_mask (_mm512_and_si512 (w, expMask), expMask);
+
+            if (special)
+            {
+                __m512i bits = _mm512_or_si512 (
+                    _mm512_or_si512 (
+                        _mm512_slli_epi32 (_mm512_and_si512 (w, signMask), 16),
+                        infBits),
+                    _mm512_slli_epi32 (_mm512_and_si512 (w, mantMask), 13));
+
+                f = _mm512_mask_mov_ps (f, special, _mm512_castsi512_ps (bits));
+            }
+
+            if (contiguous)
+            {
+                _mm512_storeu_ps ((float *) dst, f);
+                dst += 16 * sizeof (float);
+            }
+            else
+            {
+                _mm512_i32scatter_ps (dst, offsets, f, 1);
+                dst += 16 * dstStride;
+            }
+
+            src += 16 * sizeof (half);
+        }
+
+        _mm256_zeroupper();
+    }
+
+    convertHalfToFloatAvx2 (src, dst, dstStride, n - i);
+}
+
+
+__attribute__((target("avx512f,avx512bw")))
+void
+gatherHalfAvx512 (const char *src,
+                  size_t srcStride,
+                  char *dst,
+                  size_t n)
+{
+    size_t i = 0;
+
+    if (srcStride <= MAX_GATHER_STRIDE)
+    {
+        const int s = int (srcStride);
+
+        const __m512i offsets =
+            _mm512_setr_epi32 ( 0 * s,  1 * s,  2 * s,  3 * s,
+                                4 * s,  5 * s,  6 * s,  7 * s,
+                                8 * s,  9 * s, 10 * s, 11 * s,
+                               12 * s, 13 * s, 14 * s, 15 * s);
+
+        //
+        // As in gatherHalfAvx2(), the last half is never
+        // gathered, to avoid reading past the frame buffer.
+        //
+
+        for (; i + 16 < n; i += 16)
+        {
+            __m512i v = _mm512_i32gather_epi32 (offsets, src, 1);
+            _mm256_storeu_si256 ((__m256i *) dst, _mm512_cvtepi32_epi16 (v));
+
+            src += 16 * srcStride;
+            dst += 16 * sizeof (half);
+        }
+
+        _mm256_zeroupper();
+    }
+
+    gatherHalfAvx2 (src, srcStride, dst, n - i);
+}
+
+
+//
+// Interleaves four registers of 32 channel values each into
+// 128 RGBA values.  After the two rounds of unpacking, the four
+// results hold pixels {0-1, 8-9, 16-17, 24-25}, {2-3, 10-11, ...},
+// {4-5, 12-13, ...} and {6-7, 14-15, ...} in their 128-bit lanes;
+// two rounds of lane shuffles put the pixels back in order.
+//
+
+__attribute__((target("avx512f,avx512bw")))
+inline void
+interleave32 (__m512i rv, __m512i gv, __m512i bv, __m512i av, __m512i *out)
+{
+    __m512i rgLo = _mm512_unpacklo_epi16 (rv, gv);
+    __m512i rgHi = _mm512_unpackhi_epi16 (rv, gv);
+    __m512i baLo = _mm512_unpacklo_epi16 (bv, av);
+    __m512i baHi = _mm512_unpackhi_epi16 (bv, av);
+
+    __m512i p0 = _mm512_unpacklo_epi32 (rgLo, baLo);
+    __m512i p1 = _mm512_unpackhi_epi32 (rgLo, baLo);
+    __m512i p2 = _mm512_unpacklo_epi32 (rgHi, baHi);
+    __m512i p3 = _mm512_unpackhi_epi32 (rgHi, baHi);
+
+    //
+    // q0 = {0-1, 16-17, 2-3, 18-19}, q1 = {8-9, 24-25, 10-11, 26-27},
+    // q2 = {4-5, 20-21, 6-7, 22-23}, q3 = {12-13, 28-29, 14-15, 30-31}
+    //
+
+    __m512i q0 = _mm512_shuffle_i64x2 (p0, p1, _MM_SHUFFLE (2, 0, 2, 0));
+    __m512i q1 = _mm512_shuffle_i64x2 (p0, p1, _MM_SHUFFLE (3, 1, 3, 1));
+    __m512i q2 = _mm512_shuffle_i64x2 (p2, p3, _MM_SHUFFLE (2, 0, 2, 0));
+    __m512i q3 = _mm512_shuffle_i64x2 (p2, p3, _MM_SHUFFLE (3, 1, 3, 1));
+
+    _mm512_storeu_si512 (out + 0, _mm512_shuffle_i64x2 (q0, q2, _MM_SHUFFLE (2, 0, 2, 0)));
+    _mm512_storeu_si512 (out + 1, _mm512_shuffle_i64x2 (q1, q3, _MM_SHUFFLE (2, 0, 2, 0)));
+    _mm512_storeu_si512 (out + 2, _mm512_shuffle_i64x2 (q0, q2, _MM_SHUFFLE (3, 1, 3, 1)));
+    _mm512_storeu_si512 (out + 3, _mm512_shuffle_i64x2 (q1, q3, _MM_SHUFFLE (3, 1, 3, 1)));
+}
+
+
+__attribute__((target("avx512f,avx512bw")))
+size_t
+interleaveRGBAAvx512 (const unsigned short *r,
+                      const unsigned short *g,
+                      const unsigned short *b,
+                      const unsigned short *a,
+                      unsigned short *dst,
+                      size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32)
+    {
+        interleave32 (_mm512_loadu_si512 (r + i),
+                      _mm512_loadu_si512 (g + i),
+                      _mm512_loadu_si512 (b + i),
+                      _mm512_loadu_si512 (a + i),
+                      (__m512i *) (dst + 4 * i));
+    }
+
+    _mm256_zeroupper();
+
+    return i + interleaveRGBAAvx2 (r + i, g + i, b + i, a + i,
+                                   dst + 4 * i, n - i);
+}
+
+
+__attribute__((target("avx512f,avx512bw")))
+size_t
+interleaveRGBAFillAAvx512 (const unsigned short *r,
+                           const unsigned short *g,
+                           const unsigned short *b,
+                           unsigned short alpha,
+                           unsigned short *dst,
+                           size_t n)
+{
+    const __m512i av = _mm512_set1_epi16 (short (alpha));
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32)
+    {
+        interleave32 (_mm512_loadu_si512 (r + i),
+                      _mm512_loadu_si512 (g + i),
+                      _mm512_loadu_si512 (b + i),
+                      av,
+                      (__m512i *) (dst + 4 * i));
+    }
+
+    _mm256_zeroupper();
+
+    return i + interleaveRGBAFillAAvx2 (r + i, g + i, b + i, alpha,
+                                        dst + 4 * i, n - i);
+}
+
+#endif // IMF_HAVE_WIDE_SIMD_KERNELS
+
+
+//
+// Dispatch table.  The pointers are statically initialized to
+// the baseline kernels, so they are valid even before the dynamic
+// initialization below has selected the widest kernels.
+//
+
+struct Kernels
+{
+    void   (*convertHalfToFloat) (const char *, char *, size_t, size_t);
+    void   (*gatherHalf) (const char *, size_t, char *, size_t);
+
+    size_t (*interleaveRGBA) (const unsigned short *,
+                              const unsigned short *,
+                              const unsigned short *,
+                              const unsigned short *,
+                              unsigned short *,
+                              size_t);
+
+    size_t (*interleaveRGBAFillA) (const unsigned short *,
+                                   const unsigned short *,
+                                   const unsigned short *,
+                                   unsigned short,
+                                   unsigned short *,
+                                   size_t);
+
+    void   (*splitBytes) (const char *, size_t, char *, char *);
+    void   (*mergeBytes) (const char *, const char *, size_t, char *);
+};
+
+
+Kernels kernels =
+{
+    convertHalfToFloatBaseline,
+    gatherHalfBaseline,
+    interleaveRGBABaseline,
+    interleaveRGBAFillABaseline,
+    splitBytesBaseline,
+    mergeBytesBaseline
+};
+
+SimdLevel currentLevel = SIMD_BASELINE;
+
+
+SimdLevel
+detectSimdLevel ()
+{
+#ifdef IMF_HAVE_WIDE_SIMD_KERNELS
+
+    CpuId cpuId;
+
+    if (cpuId.avx && cpuId.avx2 && cpuId.f16c)
+    {
+        if (cpuId.avx512f && cpuId.avx512bw)
+            return SIMD_AVX512;
+
+        return SIMD_AVX2;
+    }
+
+#endif
+
+    return SIMD_BASELINE;
+}
+
+
+const SimdLevel supportedLevel = detectSimdLevel();
+
+bool initialized = (setSimdLevel (supportedLevel), true);
+
+} // namespace
+
+
+SimdLevel
+maxSimdLevel ()
+{
+    return supportedLevel;
+}
+
+
+SimdLevel
+simdLevel ()
+{
+    return currentLevel;
+}
+
+
+void
+setSimdLevel (SimdLevel level)
+{
+    if (level > supportedLevel)
+        level = supportedLevel;
+
+    Kernels k =
+    {
+        convertHalfToFloatBaseline,
+        gatherHalfBaseline,
+        interleaveRGBABaseline,
+        interleaveRGBAFillABaseline,
+        splitBytesBaseline,
+        mergeBytesBaseline
+    };
+
+#ifdef IMF_HAVE_WIDE_SIMD_KERNELS
+
+    if (level >= SIMD_AVX2)
+    {
+        k.convertHalfToFloat  = convertHalfToFloatAvx2;
+        k.gatherHalf          = gatherHalfAvx2;
+        k.interleaveRGBA      = interleaveRGBAAvx2;
+        k.interleaveRGBAFillA = interleaveRGBAFillAAvx2;
+        k.splitBytes          = splitBytesAvx2;
+        k.mergeBytes          = mergeBytesAvx2;
+    }
+
+    if (level >= SIMD_AVX512)
+    {
+        k.convertHalfToFloat  = convertHalfToFloatAvx512;
+        k.gatherHalf          = gatherHalfAvx512;
+        k.interleaveRGBA      = interleaveRGBAAvx512;
+        k.interleaveRGBAFillA = interleaveRGBAFillAAvx512;
+    }
+
+#endif
+
+    kernels = k;
+    currentLevel = level;
+}
+
+
+void
+convertHalfToFloat (const char *src, char *dst, size_t dstStride, size_t n)
+{
+    kernels.convertHalfToFloat (src, dst, dstStride, n);
+}
+
+
+void
+gatherHalf (const char *src, size_t srcStride, char *dst, size_t n)
+{
+    kernels.gatherHalf (src, srcStride, dst, n);
+}
+
+
+size_t
+interleaveRGBA (const unsigned short *r,
+                const unsigned short *g,
+                const unsigned short *b,
+                const unsigned short *a,
+                unsigned short *dst,
+                size_t n)
+{
+    return kernels.interleaveRGBA (r, g, b, a, dst, n);
+}
+
+
+size_t
+interleaveRGBAFillA (const unsigned short *r,
+                     const unsigned short *g,
+                     const unsigned short *b,
+                     unsigned short alpha,
+                     unsigned short *dst,
+                     size_t n)
+{
+    return kernels.interleaveRGBAFillA (r, g, b, alpha, dst, n);
+}
+
+
+void
+splitBytes (const char *src, size_t n, char *dst)
+{
+    kernels.splitBytes (src, n, dst, dst + (n + 1) / 2);
+}
+
+
+void
+mergeBytes (const char *src, size_t n, char *dst)
+{
+    kernels.mergeBytes (src, src + (n + 1) / 2, n, dst);
+}
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2014, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_IMF_PIXEL_COPY_SIMD_H
+#define INCLUDED_IMF_PIXEL_COPY_SIMD_H
+
+//-----------------------------------------------------------------------------
+//
+//	Pixel copy and conversion kernels with run-time CPU dispatch.
+//
+//	The library is compiled for a baseline instruction set (SSE2 on
+//	x86-64).  When the compiler supports target attributes, wider
+//	AVX2 and AVX-512 versions of the kernels below are compiled as
+//	well, and the widest version that the processor supports is
+//	selected when the library is loaded.
+//
+//	The kernels operate on native-order (little-endian) half data;
+//	callers are responsible for only using them where the pixel data
+//	are already in native order.
+//
+//-----------------------------------------------------------------------------
+
+#include "ImfNamespace.h"
+#include "ImfExport.h"
+
+#include <cstddef>
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
+
+
+enum SimdLevel
+{
+    SIMD_BASELINE,	// instruction set the library was compiled for
+    SIMD_AVX2,		// AVX2 and F16C
+    SIMD_AVX512,	// AVX-512F and AVX-512BW
+
+    NUM_SIMD_LEVELS	// number of different levels
+};
+
+
+//
+// The widest level supported by both this build of the
+// library and the processor it is running on.
+//
+
+IMF_EXPORT SimdLevel	maxSimdLevel ();
+
+
+//
+// The level currently used by the kernels.  Initially this
+// is maxSimdLevel().  setSimdLevel() lets tests and benchmarks
+// select a narrower level; it is clamped to maxSimdLevel(), and
+// it must not be called while other threads are reading or
+// writing files.
+//
+
+IMF_EXPORT SimdLevel	simdLevel ();
+IMF_EXPORT void		setSimdLevel (SimdLevel level);
+
+
+//
+// Convert n contiguous half values at src to float values,
+// written to dst, dst + dstStride, dst + 2 * dstStride, ...
+// The results are bit-for-bit identical to half::operator float(),
+// including infinities, NaNs and denormals.
+//
+
+IMF_EXPORT
+void	convertHalfToFloat (const char *src,
+			    char *dst,
+			    size_t dstStride,
+			    size_t n);
+
+
+//
+// Copy n half values from src, src + srcStride, src + 2 * srcStride,
+// ... into a contiguous array at dst.
+//
+
+IMF_EXPORT
+void	gatherHalf (const char *src,
+		    size_t srcStride,
+		    char *dst,
+		    size_t n);
+
+
+//
+// Interleave n pixels from four separate half channels into RGBA
+// quadruples at dst (interleaveRGBAFillA() fills in a constant
+// alpha value instead of reading an alpha channel).  The functions
+// only copy whole blocks of 16 pixels, and only at SIMD_AVX2 and
+// above; they return the number of pixels copied, and the caller
+// copies the remaining pixels.
+//
+
+IMF_EXPORT
+size_t	interleaveRGBA (const unsigned short *r,
+			const unsigned short *g,
+			const unsigned short *b,
+			const unsigned short *a,
+			unsigned short *dst,
+			size_t n);
+
+IMF_EXPORT
+size_t	interleaveRGBAFillA (const unsigned short *r,
+			     const unsigned short *g,
+			     const unsigned short *b,
+			     unsigned short alpha,
+			     unsigned short *dst,
+			     size_t n);
+
+
+//
+// Byte reordering for the ZIP and ZIPS compression methods.
+// splitBytes() copies the n bytes at src to dst such that the
+// bytes with even indices are stored in the first (n + 1) / 2
+// bytes of dst, followed by the bytes with odd indices.
+// mergeBytes() undoes the reordering.
+//
+
+IMF_EXPORT
+void	splitBytes (const char *src, size_t n, char *dst);
+
+IMF_EXPORT
+void	mergeBytes (const char *src, size_t n, char *dst);
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif
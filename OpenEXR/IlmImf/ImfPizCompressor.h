@@ -42,6 +42,7 @@
 //
 //-----------------------------------------------------------------------------
 
+#include "ImfChannelList.h"
 #include "ImfCompressor.h"
 #include "ImfNamespace.h"
 #include "ImfExport.h"
@@ -112,7 +113,7 @@ class PizCompressor: public Compressor
     unsigned short *	_tmpBuffer;
     char *		_outBuffer;
     int			_numChans;
-    const ChannelList &	_channels;
+    ChannelList		_channels;
     ChannelData *	_channelData;
     int			_minX;
     int			_maxX;
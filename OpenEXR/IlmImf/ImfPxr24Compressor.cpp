@@ -68,7 +68,10 @@
 #include "ImfChannelList.h"
 #include "ImfMisc.h"
 #include "ImfCheckedArithmetic.h"
+#include "ImfPixelCopySimd.h"
+#include "ImfSimd.h"
 #include "ImfNamespace.h"
+#include "OpenEXRConfig.h"
 
 #include <ImathFun.h>
 #include <Iex.h>
@@ -78,6 +81,18 @@
 #include <assert.h>
 #include <algorithm>
 
+//
+// AVX2 versions of the per-scan-line conversion, difference coding
+// and byte-plane split, selected at run time according to simdLevel().
+//
+
+#if defined (IMF_HAVE_SSE2) && \
+    defined (OPENEXR_IMF_HAVE_GCC_INLINE_ASM_AVX) && \
+    defined (OPENEXR_IMF_HAVE_GCC_TARGET_AVX512)
+    #define IMF_HAVE_PXR24_WIDE_KERNELS 1
+    #include <immintrin.h>
+#endif
+
 using namespace std;
 using namespace IMATH_NAMESPACE;
 
@@ -160,6 +175,380 @@ floatToFloat24 (float f)
     return (s >> 8) | i;
 }
 
+#ifdef IMF_HAVE_PXR24_WIDE_KERNELS
+
+//
+// The kernels below process the first n & ~7 (FLOAT and UINT) or
+// n & ~15 (HALF) samples of one scan line of one channel, and return
+// the number of samples they have processed.  Like the scalar loops
+// in Pxr24Compressor::compress() and uncompress(), they advance the
+// input or output pointers and update the running pixel value, so
+// that the scalar loops can finish the scan line.  The results are
+// bit-for-bit identical to those of the scalar loops.
+//
+
+__attribute__((target("avx2")))
+inline __m256i
+previousElements32 (__m256i cur, __m256i prev)
+{
+    //
+    // {prev[7], cur[0], cur[1], ... cur[6]}
+    //
+
+    return _mm256_alignr_epi8
+        (cur, _mm256_permute2x128_si256 (prev, cur, 0x21), 12);
+}
+
+
+__attribute__((target("avx2")))
+inline __m256i
+prefixSum32 (__m256i x, __m256i carry)
+{
+    //
+    // Running sum of the eight 32-bit elements of x, plus carry
+    // (which holds the same value in all elements).
+    //
+
+    x = _mm256_add_epi32 (x, _mm256_slli_si256 (x, 4));
+    x = _mm256_add_epi32 (x, _mm256_slli_si256 (x, 8));
+
+    __m256i lo = _mm256_permute2x128_si256 (x, x, 0x08);
+    x = _mm256_add_epi32 (x, _mm256_shuffle_epi32 (lo, 0xff));
+
+    return _mm256_add_epi32 (x, carry);
+}
+
+
+__attribute__((target("avx2")))
+int
+compressUintAvx2 (const char *&inPtr,
+                  int n,
+                  unsigned char *ptr[4],
+                  unsigned int &previousPixel)
+{
+    //
+    // Byte shuffle that gathers the most significant bytes of the
+    // four differences in each 128-bit lane into the lane's first
+    // 32-bit element, the second most significant bytes into the
+    // second element, and so on; a cross-lane permute then puts
+    // the eight bytes for each output plane into one 64-bit element.
+    //
+
+    const __m256i planes = _mm256_setr_epi8
+        (3, 7, 11, 15, 2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12,
+         3, 7, 11, 15, 2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12);
+
+    const __m256i gather = _mm256_setr_epi32 (0, 4, 1, 5, 2, 6, 3, 7);
+
+    __m256i prev = _mm256_set1_epi32 (previousPixel);
+    int m = n & ~7;
+
+    for (int j = 0; j < m; j += 8)
+    {
+        __m256i pixel = _mm256_loadu_si256 ((const __m256i *) inPtr);
+        inPtr += 8 * sizeof (unsigned int);
+
+        __m256i diff = _mm256_sub_epi32
+            (pixel, previousElements32 (pixel, prev));
+
+        prev = pixel;
+
+        __m256i b = _mm256_permutevar8x32_epi32
+            (_mm256_shuffle_epi8 (diff, planes), gather);
+
+        __m128i b01 = _mm256_castsi256_si128 (b);
+        __m128i b23 = _mm256_extracti128_si256 (b, 1);
+
+        _mm_storel_epi64 ((__m128i *) ptr[0], b01);
+        _mm_storel_epi64 ((__m128i *) ptr[1], _mm_unpackhi_epi64 (b01, b01));
+        _mm_storel_epi64 ((__m128i *) ptr[2], b23);
+        _mm_storel_epi64 ((__m128i *) ptr[3], _mm_unpackhi_epi64 (b23, b23));
+
+        for (int k = 0; k < 4; ++k)
+            ptr[k] += 8;
+    }
+
+    if (m > 0)
+        previousPixel = (unsigned int) _mm256_extract_epi32 (prev, 7);
+
+    return m;
+}
+
+
+__attribute__((target("avx2")))
+int
+compressHalfAvx2 (const char *&inPtr,
+                  int n,
+                  unsigned char *ptr[2],
+                  unsigned int &previousPixel)
+{
+    //
+    // Split the 16-bit differences into high and low bytes,
+    // eight of each per 128-bit lane, then move the high bytes
+    // of both lanes into the low lane and the low bytes into
+    // the high lane.
+    //
+
+    const __m256i planes = _mm256_setr_epi8
+        (1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14,
+         1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14);
+
+    __m256i prev = _mm256_set1_epi16 ((short) previousPixel);
+    int m = n & ~15;
+
+    for (int j = 0; j < m; j += 16)
+    {
+        __m256i pixel = _mm256_loadu_si256 ((const __m256i *) inPtr);
+        inPtr += 16 * sizeof (half);
+
+        __m256i shifted = _mm256_alignr_epi8
+            (pixel, _mm256_permute2x128_si256 (prev, pixel, 0x21), 14);
+
+        __m256i diff = _mm256_sub_epi16 (pixel, shifted);
+        prev = pixel;
+
+        __m256i b = _mm256_permute4x64_epi64
+            (_mm256_shuffle_epi8 (diff, planes), 0xd8);
+
+        _mm_storeu_si128 ((__m128i *) ptr[0], _mm256_castsi256_si128 (b));
+        _mm_storeu_si128 ((__m128i *) ptr[1], _mm256_extracti128_si256 (b, 1));
+
+        ptr[0] += 16;
+        ptr[1] += 16;
+    }
+
+    if (m > 0)
+        previousPixel = (unsigned short) _mm256_extract_epi16 (prev, 15);
+
+    return m;
+}
+
+
+__attribute__((target("avx2")))
+int
+compressFloatAvx2 (const char *&inPtr,
+                   int n,
+                   unsigned char *ptr[3],
+                   unsigned int &previousPixel)
+{
+    const __m256i planes = _mm256_setr_epi8
+        (2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12, -1, -1, -1, -1,
+         2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12, -1, -1, -1, -1);
+
+    const __m256i gather = _mm256_setr_epi32 (0, 4, 1, 5, 2, 6, 3, 7);
+
+    const __m256i expMask = _mm256_set1_epi32 (0x7f800000);
+    const __m256i absMask = _mm256_set1_epi32 (0x7fffffff);
+    const __m256i sigMask = _mm256_set1_epi32 (0x007fffff);
+    const __m256i roundBit = _mm256_set1_epi32 (0x00000080);
+    const __m256i maxFinite = _mm256_set1_epi32 (0x007f7fff);
+    const __m256i one = _mm256_set1_epi32 (1);
+    const __m256i zero = _mm256_setzero_si256();
+
+    __m256i prev = _mm256_set1_epi32 (previousPixel);
+    int m = n & ~7;
+
+    for (int j = 0; j < m; j += 8)
+    {
+        __m256i u = _mm256_loadu_si256 ((const __m256i *) inPtr);
+        inPtr += 8 * sizeof (float);
+
+        //
+        // floatToFloat24(): round finite numbers to 15 significand
+        // bits, unless that overflows the exponent ...
+        //
+
+        __m256i em = _mm256_and_si256 (u, absMask);
+        __m256i truncated = _mm256_srli_epi32 (em, 8);
+
+        __m256i rounded = _mm256_srli_epi32
+            (_mm256_add_epi32 (em, _mm256_and_si256 (u, roundBit)), 8);
+
+        __m256i overflow = _mm256_cmpgt_epi32 (rounded, maxFinite);
+        __m256i i = _mm256_blendv_epi8 (rounded, truncated, overflow);
+
+        //
+        // ... truncate infinities and NaNs, but keep at least one
+        // significand bit of a NaN.
+        //
+
+        __m256i sig = _mm256_and_si256 (u, sigMask);
+
+        __m256i special = _mm256_cmpeq_epi32
+            (_mm256_and_si256 (u, expMask), expMask);
+
+        __m256i lostNan = _mm256_andnot_si256
+            (_mm256_cmpeq_epi32 (sig, zero),
+             _mm256_cmpeq_epi32 (_mm256_srli_epi32 (sig, 8), zero));
+
+        __m256i nonFinite = _mm256_or_si256
+            (truncated, _mm256_and_si256 (lostNan, one));
+
+        i = _mm256_blendv_epi8 (i, nonFinite, special);
+
+        __m256i pixel24 = _mm256_or_si256
+            (_mm256_srli_epi32 (_mm256_andnot_si256 (absMask, u), 8), i);
+
+        //
+        // Differences and byte planes.
+        //
+
+        __m256i diff = _mm256_sub_epi32
+            (pixel24, previousElements32 (pixel24, prev));
+
+        prev = pixel24;
+
+        __m256i b = _mm256_permutevar8x32_epi32
+            (_mm256_shuffle_epi8 (diff, planes), gather);
+
+        __m128i b01 = _mm256_castsi256_si128 (b);
+        __m128i b2 = _mm256_extracti128_si256 (b, 1);
+
+        _mm_storel_epi64 ((__m128i *) ptr[0], b01);
+        _mm_storel_epi64 ((__m128i *) ptr[1], _mm_unpackhi_epi64 (b01, b01));
+        _mm_storel_epi64 ((__m128i *) ptr[2], b2);
+
+        for (int k = 0; k < 3; ++k)
+            ptr[k] += 8;
+    }
+
+    if (m > 0)
+        previousPixel = (unsigned int) _mm256_extract_epi32 (prev, 7);
+
+    return m;
+}
+
+
+__attribute__((target("avx2")))
+int
+uncompressUintAvx2 (const unsigned char *ptr[4],
+                    int n,
+                    char *&writePtr,
+                    unsigned int &pixel)
+{
+    __m256i carry = _mm256_set1_epi32 (pixel);
+    int m = n & ~7;
+
+    for (int j = 0; j < m; j += 8)
+    {
+        __m256i b0 = _mm256_cvtepu8_epi32
+            (_mm_loadl_epi64 ((const __m128i *) ptr[0]));
+        __m256i b1 = _mm256_cvtepu8_epi32
+            (_mm_loadl_epi64 ((const __m128i *) ptr[1]));
+        __m256i b2 = _mm256_cvtepu8_epi32
+            (_mm_loadl_epi64 ((const __m128i *) ptr[2]));
+        __m256i b3 = _mm256_cvtepu8_epi32
+            (_mm_loadl_epi64 ((const __m128i *) ptr[3]));
+
+        for (int k = 0; k < 4; ++k)
+            ptr[k] += 8;
+
+        __m256i diff = _mm256_or_si256
+            (_mm256_or_si256 (_mm256_slli_epi32 (b0, 24),
+                              _mm256_slli_epi32 (b1, 16)),
+             _mm256_or_si256 (_mm256_slli_epi32 (b2, 8), b3));
+
+        __m256i x = prefixSum32 (diff, carry);
+        carry = _mm256_permutevar8x32_epi32 (x, _mm256_set1_epi32 (7));
+
+        _mm256_storeu_si256 ((__m256i *) writePtr, x);
+        writePtr += 8 * sizeof (unsigned int);
+    }
+
+    if (m > 0)
+        pixel = (unsigned int) _mm256_extract_epi32 (carry, 0);
+
+    return m;
+}
+
+
+__attribute__((target("avx2")))
+int
+uncompressHalfAvx2 (const unsigned char *ptr[2],
+                    int n,
+                    char *&writePtr,
+                    unsigned int &pixel)
+{
+    const __m256i lastWord = _mm256_set1_epi16 (0x0f0e);
+
+    __m256i carry = _mm256_set1_epi16 ((short) pixel);
+    int m = n & ~15;
+
+    for (int j = 0; j < m; j += 16)
+    {
+        __m128i hi = _mm_loadu_si128 ((const __m128i *) ptr[0]);
+        __m128i lo = _mm_loadu_si128 ((const __m128i *) ptr[1]);
+
+        ptr[0] += 16;
+        ptr[1] += 16;
+
+        __m256i x = _mm256_setr_m128i (_mm_unpacklo_epi8 (lo, hi),
+                                       _mm_unpackhi_epi8 (lo, hi));
+
+        x = _mm256_add_epi16 (x, _mm256_slli_si256 (x, 2));
+        x = _mm256_add_epi16 (x, _mm256_slli_si256 (x, 4));
+        x = _mm256_add_epi16 (x, _mm256_slli_si256 (x, 8));
+
+        __m256i l = _mm256_permute2x128_si256 (x, x, 0x08);
+        x = _mm256_add_epi16 (x, _mm256_shuffle_epi8 (l, lastWord));
+        x = _mm256_add_epi16 (x, carry);
+
+        carry = _mm256_shuffle_epi8
+            (_mm256_permute2x128_si256 (x, x, 0x11), lastWord);
+
+        _mm256_storeu_si256 ((__m256i *) writePtr, x);
+        writePtr += 16 * sizeof (half);
+    }
+
+    if (m > 0)
+        pixel = (unsigned short) _mm256_extract_epi16 (carry, 0);
+
+    return m;
+}
+
+
+__attribute__((target("avx2")))
+int
+uncompressFloatAvx2 (const unsigned char *ptr[3],
+                     int n,
+                     char *&writePtr,
+                     unsigned int &pixel)
+{
+    __m256i carry = _mm256_set1_epi32 (pixel);
+    int m = n & ~7;
+
+    for (int j = 0; j < m; j += 8)
+    {
+        __m256i b0 = _mm256_cvtepu8_epi32
+            (_mm_loadl_epi64 ((const __m128i *) ptr[0]));
+        __m256i b1 = _mm256_cvtepu8_epi32
+            (_mm_loadl_epi64 ((const __m128i *) ptr[1]));
+        __m256i b2 = _mm256_cvtepu8_epi32
+            (_mm_loadl_epi64 ((const __m128i *) ptr[2]));
+
+        for (int k = 0; k < 3; ++k)
+            ptr[k] += 8;
+
+        __m256i diff = _mm256_or_si256
+            (_mm256_or_si256 (_mm256_slli_epi32 (b0, 24),
+                              _mm256_slli_epi32 (b1, 16)),
+             _mm256_slli_epi32 (b2, 8));
+
+        __m256i x = prefixSum32 (diff, carry);
+        carry = _mm256_permutevar8x32_epi32 (x, _mm256_set1_epi32 (7));
+
+        _mm256_storeu_si256 ((__m256i *) writePtr, x);
+        writePtr += 8 * sizeof (float);
+    }
+
+    if (m > 0)
+        pixel = (unsigned int) _mm256_extract_epi32 (carry, 0);
+
+    return m;
+}
+
+#endif
+
 
 void
 notEnoughData ()
@@ -297,6 +686,10 @@ Pxr24Compressor::compress (const char *inPtr,
 
     unsigned char *tmpBufferEnd = _tmpBuffer;
 
+    #ifdef IMF_HAVE_PXR24_WIDE_KERNELS
+	bool wide = (simdLevel() >= SIMD_AVX2);
+    #endif
+
     for (int y = minY; y <= maxY; ++y)
     {
 	for (ChannelList::ConstIterator i = _channels.begin();
@@ -312,6 +705,7 @@ Pxr24Compressor::compress (const char *inPtr,
 
 	    unsigned char *ptr[4];
 	    unsigned int previousPixel = 0;
+	    int j = 0;
 
 	    switch (c.type)
 	    {
@@ -323,7 +717,12 @@ Pxr24Compressor::compress (const char *inPtr,
 		ptr[3] = ptr[2] + n;
 		tmpBufferEnd = ptr[3] + n;
 
-		for (int j = 0; j < n; ++j)
+		#ifdef IMF_HAVE_PXR24_WIDE_KERNELS
+		    if (wide)
+			j = compressUintAvx2 (inPtr, n, ptr, previousPixel);
+		#endif
+
+		for (; j < n; ++j)
 		{
 		    unsigned int pixel;
 		    char *pPtr = (char *) &pixel;
@@ -348,7 +747,12 @@ Pxr24Compressor::compress (const char *inPtr,
 		ptr[1] = ptr[0] + n;
 		tmpBufferEnd = ptr[1] + n;
 
-		for (int j = 0; j < n; ++j)
+		#ifdef IMF_HAVE_PXR24_WIDE_KERNELS
+		    if (wide)
+			j = compressHalfAvx2 (inPtr, n, ptr, previousPixel);
+		#endif
+
+		for (; j < n; ++j)
 		{
 		    half pixel;
 
@@ -371,7 +775,12 @@ Pxr24Compressor::compress (const char *inPtr,
 		ptr[2] = ptr[1] + n;
 		tmpBufferEnd = ptr[2] + n;
 
-		for (int j = 0; j < n; ++j)
+		#ifdef IMF_HAVE_PXR24_WIDE_KERNELS
+		    if (wide)
+			j = compressFloatAvx2 (inPtr, n, ptr, previousPixel);
+		#endif
+
+		for (; j < n; ++j)
 		{
 		    float pixel;
 		    char *pPtr = (char *) &pixel;
@@ -442,6 +851,10 @@ Pxr24Compressor::uncompress (const char *inPtr,
     const unsigned char *tmpBufferEnd = _tmpBuffer;
     char *writePtr = _outBuffer;
 
+    #ifdef IMF_HAVE_PXR24_WIDE_KERNELS
+	bool wide = (simdLevel() >= SIMD_AVX2);
+    #endif
+
     for (int y = minY; y <= maxY; ++y)
     {
 	for (ChannelList::ConstIterator i = _channels.begin();
@@ -457,6 +870,7 @@ Pxr24Compressor::uncompress (const char *inPtr,
 
 	    const unsigned char *ptr[4];
 	    unsigned int pixel = 0;
+	    int j = 0;
 
 	    switch (c.type)
 	    {
@@ -471,7 +885,12 @@ Pxr24Compressor::uncompress (const char *inPtr,
 		if ( (uLongf)(tmpBufferEnd - _tmpBuffer) > tmpSize)
 		    notEnoughData();
 
-		for (int j = 0; j < n; ++j)
+		#ifdef IMF_HAVE_PXR24_WIDE_KERNELS
+		    if (wide)
+			j = uncompressUintAvx2 (ptr, n, writePtr, pixel);
+		#endif
+
+		for (; j < n; ++j)
 		{
 		    unsigned int diff = (*(ptr[0]++) << 24) |
 					(*(ptr[1]++) << 16) |
@@ -497,7 +916,12 @@ Pxr24Compressor::uncompress (const char *inPtr,
         if ( (uLongf)(tmpBufferEnd - _tmpBuffer) > tmpSize)
 		    notEnoughData();
 
-		for (int j = 0; j < n; ++j)
+		#ifdef IMF_HAVE_PXR24_WIDE_KERNELS
+		    if (wide)
+			j = uncompressHalfAvx2 (ptr, n, writePtr, pixel);
+		#endif
+
+		for (; j < n; ++j)
 		{
 		    unsigned int diff = (*(ptr[0]++) << 8) |
 					 *(ptr[1]++);
@@ -521,7 +945,12 @@ Pxr24Compressor::uncompress (const char *inPtr,
         if ( (uLongf) (tmpBufferEnd - _tmpBuffer) > tmpSize)
 		    notEnoughData();
 
-		for (int j = 0; j < n; ++j)
+		#ifdef IMF_HAVE_PXR24_WIDE_KERNELS
+		    if (wide)
+			j = uncompressFloatAvx2 (ptr, n, writePtr, pixel);
+		#endif
+
+		for (; j < n; ++j)
 		{
 		    unsigned int diff = (*(ptr[0]++) << 24) |
 					(*(ptr[1]++) << 16) |
@@ -40,6 +40,7 @@
 //
 //-----------------------------------------------------------------------------
 
+#include "ImfChannelList.h"
 #include "ImfCompressor.h"
 #include "ImfNamespace.h"
 #include "ImfExport.h"
@@ -105,7 +106,7 @@ class Pxr24Compressor: public Compressor
     int			_numScanLines;
     unsigned char *	_tmpBuffer;
     char *		_outBuffer;
-    const ChannelList &	_channels;
+    ChannelList		_channels;
     int			_minX;
     int			_maxX;
     int			_maxY;
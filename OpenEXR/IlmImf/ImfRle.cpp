@@ -34,6 +34,7 @@
 
 #include <string.h>
 #include "ImfRle.h"
+#include "ImfSimd.h"
 #include "ImfNamespace.h"
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
@@ -43,8 +44,172 @@ namespace {
 const int MIN_RUN_LENGTH = 3;
 const int MAX_RUN_LENGTH = 127;
 
+
+#ifdef IMF_HAVE_SSE2
+
+inline int
+firstSetBit (unsigned int mask)
+{
+    //
+    // Index of the lowest set bit in a non-zero mask.
+    //
+
+    #if defined (__GNUC__)
+
+	return __builtin_ctz (mask);
+
+    #else
+
+	int i = 0;
+
+	while (!(mask & 1))
+	{
+	    mask >>= 1;
+	    ++i;
+	}
+
+	return i;
+
+    #endif
+}
+
+
+//
+// Vectorized scans for rleCompress().  Both return a pointer to the
+// first byte at or after p that ends the current run, or stop if they
+// cannot decide before stop; the caller finishes the scan byte by byte.
+//
+
+inline const char *
+skipRepeats (const char *p, const char *stop, char c)
+{
+    //
+    // Skip bytes that are equal to c.
+    //
+
+    const __m128i v = _mm_set1_epi8 (c);
+
+    for (; p + 16 <= stop; p += 16)
+    {
+	int mask = _mm_movemask_epi8
+	    (_mm_cmpeq_epi8 (_mm_loadu_si128 ((const __m128i *) p), v));
+
+	if (mask != 0xffff)
+	    return p + firstSetBit (~mask & 0xffff);
+    }
+
+    return p;
+}
+
+
+inline const char *
+skipLiterals (const char *p, const char *stop, const char *inEnd)
+{
+    //
+    // Skip bytes that do not start a sequence of three identical
+    // bytes.  Every byte that the loop examines is followed by at
+    // least two more bytes before inEnd.
+    //
+
+    for (; p + 16 <= stop && p + 18 <= inEnd; p += 16)
+    {
+	__m128i a = _mm_loadu_si128 ((const __m128i *) p);
+	__m128i b = _mm_loadu_si128 ((const __m128i *) (p + 1));
+	__m128i c = _mm_loadu_si128 ((const __m128i *) (p + 2));
+
+	int mask = _mm_movemask_epi8
+	    (_mm_and_si128 (_mm_cmpeq_epi8 (a, b), _mm_cmpeq_epi8 (b, c)));
+
+	if (mask)
+	    return p + firstSetBit (mask);
+    }
+
+    return p;
+}
+
+#endif
+
+
+//
+// Copy or fill n bytes, where n is at most MAX_RUN_LENGTH + 1, without
+// touching any bytes outside the destination range.  For the short
+// copies that dominate run-length encoded data this is considerably
+// faster than calling memcpy() or memset() with a variable length.
+//
+
+inline void
+copyBytes (char *dst, const char *src, int n)
+{
+#ifdef IMF_HAVE_SSE2
+
+    if (n >= 16)
+    {
+	//
+	// Whole 16-byte blocks, then one last block that
+	// ends at dst + n and may overlap the previous one.
+	//
+
+	__m128i last = _mm_loadu_si128 ((const __m128i *) (src + n - 16));
+
+	for (int i = 0; i + 16 <= n; i += 16)
+	{
+	    _mm_storeu_si128 ((__m128i *) (dst + i),
+			      _mm_loadu_si128 ((const __m128i *) (src + i)));
+	}
+
+	_mm_storeu_si128 ((__m128i *) (dst + n - 16), last);
+	return;
+    }
+
+#endif
+
+    if (n >= 8)
+    {
+	char a[8], b[8];
+	memcpy (a, src, 8);
+	memcpy (b, src + n - 8, 8);
+	memcpy (dst, a, 8);
+	memcpy (dst + n - 8, b, 8);
+    }
+    else if (n >= 4)
+    {
+	char a[4], b[4];
+	memcpy (a, src, 4);
+	memcpy (b, src + n - 4, 4);
+	memcpy (dst, a, 4);
+	memcpy (dst + n - 4, b, 4);
+    }
+    else
+    {
+	while (n-- > 0)
+	    *dst++ = *src++;
+    }
 }
 
+
+inline void
+fillBytes (char *dst, char c, int n)
+{
+#ifdef IMF_HAVE_SSE2
+
+    if (n >= 16)
+    {
+	const __m128i v = _mm_set1_epi8 (c);
+
+	for (int i = 0; i + 16 <= n; i += 16)
+	    _mm_storeu_si128 ((__m128i *) (dst + i), v);
+
+	_mm_storeu_si128 ((__m128i *) (dst + n - 16), v);
+	return;
+    }
+
+#endif
+
+    memset (dst, c, n);
+}
+
+} // namespace
+
 //
 // Compress an array of bytes, using run-length encoding,
 // and return the length of the compressed data.
@@ -60,9 +225,15 @@ rleCompress (int inLength, const char in[], signed char out[])
 
     while (runStart < inEnd)
     {
-	while (runEnd < inEnd &&
-	       *runStart == *runEnd &&
-	       runEnd - runStart - 1 < MAX_RUN_LENGTH)
+	const char *runStop = (inEnd - runStart > MAX_RUN_LENGTH + 1)?
+				  runStart + MAX_RUN_LENGTH + 1: inEnd;
+
+	#ifdef IMF_HAVE_SSE2
+	    if (runEnd < runStop)
+		runEnd = skipRepeats (runEnd, runStop, *runStart);
+	#endif
+
+	while (runEnd < runStop && *runStart == *runEnd)
 	{
 	    ++runEnd;
 	}
@@ -83,22 +254,27 @@ rleCompress (int inLength, const char in[], signed char out[])
 	    // Uncompressable run
 	    //
 
-	    while (runEnd < inEnd &&
+	    const char *literalStop = (inEnd - runStart > MAX_RUN_LENGTH)?
+					  runStart + MAX_RUN_LENGTH: inEnd;
+
+	    #ifdef IMF_HAVE_SSE2
+		runEnd = skipLiterals (runEnd, literalStop, inEnd);
+	    #endif
+
+	    while (runEnd < literalStop &&
 		   ((runEnd + 1 >= inEnd ||
 		     *runEnd != *(runEnd + 1)) ||
 		    (runEnd + 2 >= inEnd ||
-		     *(runEnd + 1) != *(runEnd + 2))) &&
-		   runEnd - runStart < MAX_RUN_LENGTH)
+		     *(runEnd + 1) != *(runEnd + 2))))
 	    {
 		++runEnd;
 	    }
 
 	    *outWrite++ = runStart - runEnd;
 
-	    while (runStart < runEnd)
-	    {
-		*outWrite++ = *(signed char *) (runStart++);
-	    }
+	    copyBytes ((char *) outWrite, runStart, runEnd - runStart);
+	    outWrite += runEnd - runStart;
+	    runStart = runEnd;
 	}
 
 	++runEnd;
@@ -129,9 +305,9 @@ rleUncompress (int inLength, int maxLength, const signed char in[], char out[])
 	    if (0 > (maxLength -= count))
 		return 0;
 
-        memcpy(out, in, count);
-        out += count;
-        in  += count;
+	    copyBytes (out, (const char *) in, count);
+	    out += count;
+	    in  += count;
 	}
 	else
 	{
@@ -141,8 +317,8 @@ rleUncompress (int inLength, int maxLength, const signed char in[], char out[])
 	    if (0 > (maxLength -= count + 1))
 		return 0;
 
-        memset(out, *(char*)in, count+1);
-        out += count+1;
+	    fillBytes (out, *(char*)in, count+1);
+	    out += count+1;
 
 	    in++;
 	}
@@ -40,10 +40,12 @@
 //-----------------------------------------------------------------------------
 
 #include "ImfScanLineInputFile.h"
+#include "ImfAsyncReadData.h"
 #include "ImfChannelList.h"
 #include "ImfMisc.h"
 #include "ImfStdIO.h"
 #include "ImfCompressor.h"
+#include "ImfDwaCompressor.h"
 #include "ImathBox.h"
 #include "ImathFun.h"
 #include <ImfXdr.h>
@@ -81,7 +83,6 @@ using ILMTHREAD_NAMESPACE::Mutex;
 using ILMTHREAD_NAMESPACE::Lock;
 using ILMTHREAD_NAMESPACE::Semaphore;
 using ILMTHREAD_NAMESPACE::Task;
-using ILMTHREAD_NAMESPACE::TaskGroup;
 using ILMTHREAD_NAMESPACE::ThreadPool;
 
 namespace {
@@ -145,8 +146,7 @@ struct LineBuffer
     Compressor *	compressor;
     Compressor::Format	format;
     int			number;
-    bool		hasException;
-    string		exception;
+    bool		readPending;
 
     LineBuffer (Compressor * const comp);
     ~LineBuffer ();
@@ -167,8 +167,7 @@ LineBuffer::LineBuffer (Compressor *comp):
     compressor (comp),
     format (defaultFormat(compressor)),
     number (-1),
-    hasException (false),
-    exception (),
+    readPending (false),
     _sem (1)
 {
     // empty
@@ -177,7 +176,7 @@ LineBuffer::LineBuffer (Compressor *comp):
 
 LineBuffer::~LineBuffer ()
 {
-    delete compressor;
+    returnCompressor (compressor);
 }
 
 /// helper struct used to detect the order that the channels are stored
@@ -186,13 +185,15 @@ struct sliceOptimizationData
 {
     const char * base;   ///< pointer to pixel data 
     bool fill;           ///< is this channel being filled with constant, instead of read?
-    half fillValue;      ///< if filling, the value to use
+    double fillValue;    ///< if filling, the value to use
     size_t offset;       ///< position this channel will be in the read buffer, accounting for previous channels, as well as their type
-    PixelType type;      ///< type of channel
+    PixelType type;      ///< type of channel in the frame buffer
+    PixelType typeInFile;///< type of channel in the file (same as type if filling)
     size_t xStride;      ///< x-stride of channel in buffer (must be set to cause channels to interleave)
     size_t yStride;      ///< y-stride of channel in buffer (must be same in all channels, else order will change, which is bad)
     int xSampling;       ///< channel x sampling
     int ySampling;       ///< channel y sampling
+    size_t groupSize;    ///< number of half channels interleaved with this one and the ones that follow it (1 if copied on its own, 0 if part of an earlier channel's group)
             
             
     /// we need to keep the list sorted in the order they'll be written to memory
@@ -201,7 +202,221 @@ struct sliceOptimizationData
         return base < other.base;
     }
 };
-    
+
+
+
+//
+// Build the table of slices that is used to copy pixel data from
+// the line buffers into a frame buffer: one entry for each channel
+// in the frame buffer, and one for each channel in the file that
+// must be skipped.  fileName is only used for error messages.
+//
+
+void
+sliceTable (const ChannelList &channels,
+            const FrameBuffer &frameBuffer,
+            const char fileName[],
+            vector<InSliceInfo> &slices)
+{
+    //
+    // Check if the frame buffer is compatible with the file.
+    //
+
+    for (FrameBuffer::ConstIterator j = frameBuffer.begin();
+	 j != frameBuffer.end();
+	 ++j)
+    {
+	ChannelList::ConstIterator i = channels.find (j.name());
+
+	if (i == channels.end())
+	    continue;
+
+	if (i.channel().xSampling != j.slice().xSampling ||
+	    i.channel().ySampling != j.slice().ySampling)
+	    THROW (IEX_NAMESPACE::ArgExc, "X and/or y subsampling factors "
+				"of \"" << i.name() << "\" channel "
+				"of input file \"" << fileName << "\" are "
+				"not compatible with the frame buffer's "
+				"subsampling factors.");
+    }
+
+    slices.clear();
+    ChannelList::ConstIterator i = channels.begin();
+
+    for (FrameBuffer::ConstIterator j = frameBuffer.begin();
+	 j != frameBuffer.end();
+	 ++j)
+    {
+	while (i != channels.end() && strcmp (i.name(), j.name()) < 0)
+	{
+	    //
+	    // Channel i is present in the file but not
+	    // in the frame buffer; data for channel i
+	    // will be skipped during readPixels().
+	    //
+
+	    slices.push_back (InSliceInfo (i.channel().type,
+					   i.channel().type,
+					   0, // base
+					   0, // xStride
+					   0, // yStride
+					   i.channel().xSampling,
+					   i.channel().ySampling,
+					   false,  // fill
+					   true, // skip
+					   0.0)); // fillValue
+	    ++i;
+	}
+
+	bool fill = false;
+
+	if (i == channels.end() || strcmp (i.name(), j.name()) > 0)
+	{
+	    //
+	    // Channel i is present in the frame buffer, but not in the file.
+	    // In the frame buffer, slice j will be filled with a default value.
+	    //
+
+	    fill = true;
+	}
+
+	slices.push_back (InSliceInfo (j.slice().type,
+				       fill? j.slice().type:
+				             i.channel().type,
+				       j.slice().base,
+				       j.slice().xStride,
+				       j.slice().yStride,
+				       j.slice().xSampling,
+				       j.slice().ySampling,
+				       fill,
+				       false, // skip
+				       j.slice().fillValue));
+
+	if (i != channels.end() && !fill)
+	    ++i;
+    }
+}
+
+
+//
+// Convert scan lines scanLineMin to scanLineMax of an uncompressed
+// line buffer back from the machine-independent representation, and
+// store the result in the frame buffer described by slices.
+//
+
+void
+copyLineBufferIntoFrameBuffer (const vector<InSliceInfo> &slices,
+                               const char *uncompressedData,
+                               Compressor::Format format,
+                               const vector<size_t> &offsetInLineBuffer,
+                               int minX, int maxX, int minY,
+                               LineOrder lineOrder,
+                               int scanLineMin, int scanLineMax)
+{
+    int yStart, yStop, dy;
+
+    if (lineOrder == INCREASING_Y)
+    {
+        yStart = scanLineMin;
+        yStop = scanLineMax + 1;
+        dy = 1;
+    }
+    else
+    {
+        yStart = scanLineMax;
+        yStop = scanLineMin - 1;
+        dy = -1;
+    }
+
+    for (int y = yStart; y != yStop; y += dy)
+    {
+        //
+        // Convert one scan line's worth of pixel data back
+        // from the machine-independent representation, and
+        // store the result in the frame buffer.
+        //
+
+        const char *readPtr = uncompressedData +
+                              offsetInLineBuffer[y - minY];
+
+        //
+        // Iterate over all image channels.
+        //
+
+        for (unsigned int i = 0; i < slices.size(); ++i)
+        {
+            //
+            // Test if scan line y of this channel contains any data
+            // (the scan line contains data only if y % ySampling == 0).
+            //
+
+            const InSliceInfo &slice = slices[i];
+
+            if (modp (y, slice.ySampling) != 0)
+                continue;
+
+            //
+            // Find the x coordinates of the leftmost and rightmost
+            // sampled pixels (i.e. pixels within the data window
+            // for which x % xSampling == 0).
+            //
+
+            int dMinX = divp (minX, slice.xSampling);
+            int dMaxX = divp (maxX, slice.xSampling);
+
+            //
+            // Fill the frame buffer with pixel data.
+            //
+
+            if (slice.skip)
+            {
+                //
+                // The file contains data for this channel, but
+                // the frame buffer contains no slice for this channel.
+                //
+
+                skipChannel (readPtr, slice.typeInFile, dMaxX - dMinX + 1);
+            }
+            else
+            {
+                //
+                // The frame buffer contains a slice for this channel.
+                //
+
+                char *linePtr  = slice.base +
+                                    divp (y, slice.ySampling) *
+                                    slice.yStride;
+
+                char *writePtr = linePtr + dMinX * slice.xStride;
+                char *endPtr   = linePtr + dMaxX * slice.xStride;
+
+                copyIntoFrameBuffer (readPtr, writePtr, endPtr,
+                                     slice.xStride, slice.fill,
+                                     slice.fillValue, format,
+                                     slice.typeInFrameBuffer,
+                                     slice.typeInFile);
+            }
+        }
+    }
+}
+
+
+
+//
+// The parameters of a reduced-resolution read, shared by the
+// line buffer tasks that carry it out (see readPixelsDcOnly()).
+//
+
+struct DcOnlyRead
+{
+    vector<InSliceInfo>	slices;             // info about channels in file
+    vector<size_t>	offsetInLineBuffer; // offset of each reduced scan
+                                            // line in its line buffer
+    Box2i		dataWindow;         // data window of the reduced image
+    int			scanLineMin;        // reduced scan lines to read
+    int			scanLineMax;
+};
+
 
 } // namespace
 
@@ -234,7 +449,12 @@ struct ScanLineInputFile::Data: public Mutex
     int                 partNumber;         // part number
 
     bool                memoryMapped;       // if the stream is memory mapped
+    bool                statelessRead;      // if line buffer tasks read
+                                            // their own data from the stream
+    ThreadPool *        threadPool;         // runs the line buffer tasks
     OptimizationMode    optimizationMode;   // optimizibility of the input file
+    ChannelList         channelsToDecode;   // channels the line buffers'
+                                            // compressors uncompress
     vector<sliceOptimizationData>  optimizationData; ///< channel ordering for optimized reading
     
     Data (int numThreads);
@@ -250,7 +470,9 @@ struct ScanLineInputFile::Data: public Mutex
 
 ScanLineInputFile::Data::Data (int numThreads):
         partNumber(-1),
-        memoryMapped(false)
+        memoryMapped(false),
+        statelessRead(false),
+        threadPool(&globalThreadPool())
 {
     //
     // We need at least one lineBuffer, but if threading is used,
@@ -451,6 +673,106 @@ readPixelData (InputStreamMutex *streamData,
         ifd->nextLineBufferMinY = minY - ifd->linesInBuffer;
 }
 
+
+void
+readPixelDataAt (InputStreamMutex *streamData,
+                 ScanLineInputFile::Data *ifd,
+                 int minY,
+                 char *buffer,
+                 int &dataSize)
+{
+    //
+    // Read a single line buffer from the input file using
+    // stateless reads.  Unlike readPixelData(), this function
+    // neither uses nor changes the stream's reading position,
+    // so it can be called by line buffer tasks in parallel,
+    // without holding the stream lock.
+    //
+
+    int lineBufferNumber = (minY - ifd->minY) / ifd->linesInBuffer;
+
+    Int64 lineOffset = ifd->lineOffsets[lineBufferNumber];
+
+    if (lineOffset == 0)
+	THROW (IEX_NAMESPACE::InputExc, "Scan line " << minY << " is missing.");
+
+    //
+    // Read the data block's header: the part number (in a
+    // multi-part file), the y coordinate and the data size.
+    //
+
+    bool multiPart = isMultiPart (ifd->version);
+    int headerSize = (multiPart? 3: 2) * Xdr::size<int>();
+
+    char header[3 * sizeof (int)];
+    streamData->is->readAt (header, headerSize, lineOffset);
+
+    const char *readPtr = header;
+    int yInFile;
+
+    if (multiPart)
+    {
+        int partNumber;
+        Xdr::read <CharPtrIO> (readPtr, partNumber);
+
+        if (partNumber != ifd->partNumber)
+        {
+            THROW (IEX_NAMESPACE::ArgExc, "Unexpected part number " << partNumber
+                   << ", should be " << ifd->partNumber << ".");
+        }
+    }
+
+    Xdr::read <CharPtrIO> (readPtr, yInFile);
+    Xdr::read <CharPtrIO> (readPtr, dataSize);
+
+    if (yInFile != minY)
+        throw IEX_NAMESPACE::InputExc ("Unexpected data block y coordinate.");
+
+    if (dataSize < 0 || dataSize > (int) ifd->lineBufferSize)
+	throw IEX_NAMESPACE::InputExc ("Unexpected data block length.");
+
+    //
+    // Read the pixel data.
+    //
+
+    streamData->is->readAt (buffer, dataSize, lineOffset + headerSize);
+}
+
+
+void
+fetchLineBuffer (InputStreamMutex *streamData,
+                 ScanLineInputFile::Data *ifd,
+                 LineBuffer *lineBuffer)
+{
+    //
+    // If the line buffer's data has not been read from the file
+    // yet (because the stream supports stateless reads, and the
+    // read was deferred to the line buffer task), read it now.
+    //
+
+    if (!lineBuffer->readPending)
+        return;
+
+    lineBuffer->readPending = false;
+
+    try
+    {
+        readPixelDataAt (streamData, ifd, lineBuffer->minY,
+                         lineBuffer->buffer,
+                         lineBuffer->dataSize);
+    }
+    catch (...)
+    {
+        //
+        // Make sure the next request for this line buffer
+        // reads it again, rather than using a partial result.
+        //
+
+        lineBuffer->number = -1;
+        throw;
+    }
+}
+
                         
 
 //
@@ -462,7 +784,8 @@ class LineBufferTask : public Task
 {
   public:
 
-    LineBufferTask (TaskGroup *group,
+    LineBufferTask (AsyncRead::Data *request,
+                    InputStreamMutex *streamData,
                     ScanLineInputFile::Data *ifd,
 		    LineBuffer *lineBuffer,
                     int scanLineMin,
@@ -475,6 +798,8 @@ class LineBufferTask : public Task
 
   private:
 
+    AsyncRead::Data *		_request;
+    InputStreamMutex *		_streamData;
     ScanLineInputFile::Data *	_ifd;
     LineBuffer *		_lineBuffer;
     int				_scanLineMin;
@@ -484,13 +809,16 @@ class LineBufferTask : public Task
 
 
 LineBufferTask::LineBufferTask
-    (TaskGroup *group,
+    (AsyncRead::Data *request,
+     InputStreamMutex *streamData,
      ScanLineInputFile::Data *ifd,
      LineBuffer *lineBuffer,
      int scanLineMin,
      int scanLineMax,OptimizationMode optimizationMode)
 :
-    Task (group),
+    Task (request->taskGroup),
+    _request (request),
+    _streamData (streamData),
     _ifd (ifd),
     _lineBuffer (lineBuffer),
     _scanLineMin (scanLineMin),
@@ -508,6 +836,7 @@ LineBufferTask::~LineBufferTask ()
     //
 
     _lineBuffer->post ();
+    _request->finishTask ();
 }
 
 
@@ -516,6 +845,12 @@ LineBufferTask::execute ()
 {
     try
     {
+        //
+        // Read the data, if this task is responsible for it
+        //
+
+        fetchLineBuffer (_streamData, _ifd, _lineBuffer);
+
         //
         // Uncompress the data, if necessary
         //
@@ -555,107 +890,153 @@ LineBufferTask::execute ()
             }
         }
         
-        int yStart, yStop, dy;
+        copyLineBufferIntoFrameBuffer (_ifd->slices,
+                                       _lineBuffer->uncompressedData,
+                                       _lineBuffer->format,
+                                       _ifd->offsetInLineBuffer,
+                                       _ifd->minX, _ifd->maxX, _ifd->minY,
+                                       _ifd->lineOrder,
+                                       _scanLineMin, _scanLineMax);
+    }
+    catch (std::exception &e)
+    {
+        _request->setException (e.what());
+    }
+    catch (...)
+    {
+        _request->setException ("unrecognized exception");
+    }
+}
 
-        if (_ifd->lineOrder == INCREASING_Y)
-        {
-            yStart = _scanLineMin;
-            yStop = _scanLineMax + 1;
-            dy = 1;
-        }
-        else
-        {
-            yStart = _scanLineMax;
-            yStop = _scanLineMin - 1;
-            dy = -1;
-        }
-    
-        for (int y = yStart; y != yStop; y += dy)
-        {
-            //
-            // Convert one scan line's worth of pixel data back
-            // from the machine-independent representation, and
-            // store the result in the frame buffer.
-            //
-    
-            const char *readPtr = _lineBuffer->uncompressedData +
-                                  _ifd->offsetInLineBuffer[y - _ifd->minY];
-    
-            //
-            // Iterate over all image channels.
-            //
-    
-            for (unsigned int i = 0; i < _ifd->slices.size(); ++i)
-            {
-                //
-                // Test if scan line y of this channel contains any data
-		// (the scan line contains data only if y % ySampling == 0).
-                //
-    
-                const InSliceInfo &slice = _ifd->slices[i];
-    
-                if (modp (y, slice.ySampling) != 0)
-                    continue;
-    
-                //
-                // Find the x coordinates of the leftmost and rightmost
-                // sampled pixels (i.e. pixels within the data window
-                // for which x % xSampling == 0).
-                //
-    
-                int dMinX = divp (_ifd->minX, slice.xSampling);
-                int dMaxX = divp (_ifd->maxX, slice.xSampling);
-    
-                //
-		// Fill the frame buffer with pixel data.
-                //
-    
-                if (slice.skip)
-                {
-                    //
-                    // The file contains data for this channel, but
-                    // the frame buffer contains no slice for this channel.
-                    //
-    
-                    skipChannel (readPtr, slice.typeInFile, dMaxX - dMinX + 1);
-                }
-                else
-                {
-                    //
-                    // The frame buffer contains a slice for this channel.
-                    //
-    
-                    char *linePtr  = slice.base +
-                                        divp (y, slice.ySampling) *
-                                        slice.yStride;
-    
-                    char *writePtr = linePtr + dMinX * slice.xStride;
-                    char *endPtr   = linePtr + dMaxX * slice.xStride;
-                    
-                    copyIntoFrameBuffer (readPtr, writePtr, endPtr,
-                                         slice.xStride, slice.fill,
-                                         slice.fillValue, _lineBuffer->format,
-                                         slice.typeInFrameBuffer,
-                                         slice.typeInFile);
-                }
-            }
+
+//
+// A LineBufferTaskDcOnly uncompresses a line buffer of a DWA
+// compressed file at 1/8 resolution, and copies the pixels into
+// the frame buffer of a reduced-resolution read.
+//
+
+class LineBufferTaskDcOnly : public Task
+{
+  public:
+
+    LineBufferTaskDcOnly (AsyncRead::Data *request,
+                          InputStreamMutex *streamData,
+                          ScanLineInputFile::Data *ifd,
+                          LineBuffer *lineBuffer,
+                          const DcOnlyRead *dcOnly);
+
+    virtual ~LineBufferTaskDcOnly ();
+
+    virtual void		execute ();
+
+  private:
+
+    AsyncRead::Data *		_request;
+    InputStreamMutex *		_streamData;
+    ScanLineInputFile::Data *	_ifd;
+    LineBuffer *		_lineBuffer;
+    const DcOnlyRead *		_dcOnly;
+};
+
+
+LineBufferTaskDcOnly::LineBufferTaskDcOnly
+    (AsyncRead::Data *request,
+     InputStreamMutex *streamData,
+     ScanLineInputFile::Data *ifd,
+     LineBuffer *lineBuffer,
+     const DcOnlyRead *dcOnly)
+:
+    Task (request->taskGroup),
+    _request (request),
+    _streamData (streamData),
+    _ifd (ifd),
+    _lineBuffer (lineBuffer),
+    _dcOnly (dcOnly)
+{
+    // empty
+}
+
+
+LineBufferTaskDcOnly::~LineBufferTaskDcOnly ()
+{
+    //
+    // Signal that the line buffer is now free
+    //
+
+    _lineBuffer->post ();
+    _request->finishTask ();
+}
+
+
+void
+LineBufferTaskDcOnly::execute ()
+{
+    try
+    {
+        fetchLineBuffer (_streamData, _ifd, _lineBuffer);
+
+        int uncompressedSize = 0;
+        int maxY = min (_lineBuffer->maxY, _ifd->maxY);
+
+        for (int i = _lineBuffer->minY - _ifd->minY;
+             i <= maxY - _ifd->minY;
+             ++i)
+        {
+            uncompressedSize += (int) _ifd->bytesPerLine[i];
+        }
+
+        //
+        // readPixelsDcOnly() has checked that the file is DWA
+        // compressed.  The reduced pixels replace any uncompressed
+        // full-resolution pixels in the compressor's output buffer.
+        //
+
+        DwaCompressor *compressor =
+            static_cast <DwaCompressor *> (_lineBuffer->compressor);
+
+        const char *reducedData = 0;
+        _lineBuffer->uncompressedData = 0;
+
+        if (_lineBuffer->dataSize < uncompressedSize)
+        {
+            compressor->uncompressDcOnly (_lineBuffer->buffer,
+                                          _lineBuffer->dataSize,
+                                          _lineBuffer->minY,
+                                          reducedData);
+        }
+        else
+        {
+            compressor->reduceUncompressed (_lineBuffer->buffer,
+                                            _lineBuffer->dataSize,
+                                            _lineBuffer->minY,
+                                            reducedData);
         }
+
+        const Box2i &dataWindow = _dcOnly->dataWindow;
+
+        int reducedMinY = dataWindow.min.y +
+                          (_lineBuffer->minY - _ifd->minY) / 8;
+
+        int reducedMaxY = dataWindow.min.y + (maxY - _ifd->minY) / 8;
+
+        copyLineBufferIntoFrameBuffer (_dcOnly->slices,
+                                       reducedData,
+                                       compressor->format(),
+                                       _dcOnly->offsetInLineBuffer,
+                                       dataWindow.min.x,
+                                       dataWindow.max.x,
+                                       reducedMinY,
+                                       _ifd->lineOrder,
+                                       max (reducedMinY, _dcOnly->scanLineMin),
+                                       min (reducedMaxY, _dcOnly->scanLineMax));
     }
     catch (std::exception &e)
     {
-        if (!_lineBuffer->hasException)
-        {
-            _lineBuffer->exception = e.what();
-            _lineBuffer->hasException = true;
-        }
+        _request->setException (e.what());
     }
     catch (...)
     {
-        if (!_lineBuffer->hasException)
-        {
-            _lineBuffer->exception = "unrecognized exception";
-            _lineBuffer->hasException = true;
-        }
+        _request->setException ("unrecognized exception");
     }
 }
 
@@ -663,13 +1044,18 @@ LineBufferTask::execute ()
 #ifdef IMF_HAVE_SSE2
 //
 // IIF format is more restricted than a perfectly generic one,
-// so it is possible to perform some optimizations.
+// so it is possible to perform some optimizations: no channel
+// is subsampled, the line buffer is in native byte order, and
+// setFrameBuffer() has already worked out where each channel's
+// data are in the line buffer, and which channels are interleaved
+// with each other in the frame buffer.
 //
 class LineBufferTaskIIF : public Task
 {
     public:
         
-        LineBufferTaskIIF (TaskGroup *group,
+        LineBufferTaskIIF (AsyncRead::Data *request,
+                           InputStreamMutex *streamData,
                            ScanLineInputFile::Data *ifd,
                            LineBuffer *lineBuffer,
                            int scanLineMin,
@@ -679,22 +1065,11 @@ class LineBufferTaskIIF : public Task
         virtual ~LineBufferTaskIIF ();
                            
         virtual void                execute ();
-        
-        template<typename TYPE>
-        void getWritePointer (int y,
-                              unsigned short*& pOutWritePointerRight,
-                              size_t& outPixelsToCopySSE,
-                              size_t& outPixelsToCopyNormal,int bank=0) const;
-                              
-        template<typename TYPE>
-        void getWritePointerStereo (int y,
-                                    unsigned short*& outWritePointerRight,
-                                    unsigned short*& outWritePointerLeft,
-                                    size_t& outPixelsToCopySSE,
-                                    size_t& outPixelsToCopyNormal) const;
 
     private:
         
+        AsyncRead::Data *           _request;
+        InputStreamMutex *          _streamData;
         ScanLineInputFile::Data *   _ifd;
         LineBuffer *                _lineBuffer;
         int                         _scanLineMin;
@@ -704,7 +1079,8 @@ class LineBufferTaskIIF : public Task
 };
 
 LineBufferTaskIIF::LineBufferTaskIIF
-    (TaskGroup *group,
+    (AsyncRead::Data *request,
+     InputStreamMutex *streamData,
      ScanLineInputFile::Data *ifd,
      LineBuffer *lineBuffer,
      int scanLineMin,
@@ -712,7 +1088,9 @@ LineBufferTaskIIF::LineBufferTaskIIF
      OptimizationMode optimizationMode
     )
     :
-     Task (group),
+     Task (request->taskGroup),
+     _request (request),
+     _streamData (streamData),
      _ifd (ifd),
      _lineBuffer (lineBuffer),
      _scanLineMin (scanLineMin),
@@ -739,97 +1117,20 @@ LineBufferTaskIIF::~LineBufferTaskIIF ()
      //
      
      _lineBuffer->post ();
+     _request->finishTask ();
 }
  
-// Return 0 if we are to skip because of sampling
-// channelBank is 0 for the first group of channels, 1 for the second
-template<typename TYPE>
-void LineBufferTaskIIF::getWritePointer 
-                            (int y,
-                             unsigned short*& outWritePointerRight,
-                             size_t& outPixelsToCopySSE,
-                             size_t& outPixelsToCopyNormal,
-                             int channelBank
-                            ) const
-{
-      // Channels are saved alphabetically, so the order is B G R.
-      // The last slice (R) will give us the location of our write pointer.
-      // The only slice that we support skipping is alpha, i.e. the first one.  
-      // This does not impact the write pointer or the pixels to copy at all.
-      
-      size_t nbSlicesInBank = _ifd->optimizationData.size();
-      
-      int sizeOfSingleValue = sizeof(TYPE);
-      
-      if(_ifd->optimizationData.size()>4)
-      {
-          // there are two banks - we only copy one at once
-          nbSlicesInBank/=2;
-      }
-
-      
-      size_t firstChannel = 0;
-      if(channelBank==1)
-      {
-          firstChannel = _ifd->optimizationData.size()/2;
-      }
-      
-       sliceOptimizationData& firstSlice = _ifd->optimizationData[firstChannel];
-      
-      if (modp (y, firstSlice.ySampling) != 0)
-      {
-          outPixelsToCopySSE    = 0;
-          outPixelsToCopyNormal = 0;
-          outWritePointerRight  = 0;
-      }
-      
-      const char* linePtr1  = firstSlice.base +
-      divp (y, firstSlice.ySampling) *
-      firstSlice.yStride;
-      
-      int dMinX1 = divp (_ifd->minX, firstSlice.xSampling);
-      int dMaxX1 = divp (_ifd->maxX, firstSlice.xSampling);
-      
-      // Construct the writePtr so that we start writing at
-      // linePtr + Min offset in the line.
-      outWritePointerRight =  (unsigned short*)(linePtr1 +
-      dMinX1 * firstSlice.xStride );
-      
-      size_t bytesToCopy  = ((linePtr1 + dMaxX1 * firstSlice.xStride ) -
-      (linePtr1 + dMinX1 * firstSlice.xStride )) + 2;
-      size_t shortsToCopy = bytesToCopy / sizeOfSingleValue;
-      size_t pixelsToCopy = (shortsToCopy / nbSlicesInBank ) + 1;
-      
-      // We only support writing to SSE if we have no pixels to copy normally
-      outPixelsToCopySSE    = pixelsToCopy / 8;
-      outPixelsToCopyNormal = pixelsToCopy % 8;
-      
-}
-
-
-template<typename TYPE>
-void LineBufferTaskIIF::getWritePointerStereo 
-                          (int y,
-                           unsigned short*& outWritePointerRight,
-                           unsigned short*& outWritePointerLeft,
-                           size_t& outPixelsToCopySSE,
-                           size_t& outPixelsToCopyNormal) const
-{
-   getWritePointer<TYPE>(y,outWritePointerRight,outPixelsToCopySSE,outPixelsToCopyNormal,0);
-   
-   
-   if(outWritePointerRight)
-   {
-       getWritePointer<TYPE>(y,outWritePointerLeft,outPixelsToCopySSE,outPixelsToCopyNormal,1);
-   }
-   
-}
-
 void
 LineBufferTaskIIF::execute()
 {
     try
     {
+        //
+        // Read the data, if this task is responsible for it
+        //
+
+        fetchLineBuffer (_streamData, _ifd, _lineBuffer);
+
         //
         // Uncompress the data, if necessary
         //
@@ -884,6 +1185,26 @@ LineBufferTaskIIF::execute()
             dy = -1;
         }
         
+        //
+        // Every channel has the same number of pixels in a scan line;
+        // they are copied in blocks of eight pixels, and then one by one.
+        //
+
+        const vector<sliceOptimizationData> &optData = _ifd->optimizationData;
+
+        size_t pixelsPerLine = _ifd->maxX - _ifd->minX + 1;
+        size_t pixelsToCopySSE = pixelsPerLine / 8;
+        size_t pixelsToCopyNormal = pixelsPerLine % 8;
+
+        vector<const unsigned short *> readPointers (optData.size());
+        vector<unsigned short> fillValues (optData.size());
+
+        for (size_t i = 0; i < optData.size(); ++i)
+        {
+            if (optData[i].fill && optData[i].type == HALF)
+                fillValues[i] = half (optData[i].fillValue).bits();
+        }
+
         for (int y = yStart; y != yStop; y += dy)
         {
             if (modp (y, _optimizationMode._ySampling) != 0)
@@ -899,79 +1220,87 @@ LineBufferTaskIIF::execute()
             // but with an offet based on calculated array.
             // _ifd->offsetInLineBuffer contains offsets based on which
             // line we are currently processing.
-            // Stride will be taken into consideration later.
-                
+            // Each channel's data starts at its offset (in halfs)
+            // times the number of pixels in the line.
                 
             const char* readPtr = _lineBuffer->uncompressedData +
             _ifd->offsetInLineBuffer[y - _ifd->minY];
             
-            size_t pixelsToCopySSE = 0;
-            size_t pixelsToCopyNormal = 0;
-            
-            unsigned short* writePtrLeft = 0;
-            unsigned short* writePtrRight = 0;
-            
-            size_t channels = _ifd->optimizationData.size();
-       
-            if(channels>4)
-            {
-                getWritePointerStereo<half>(y, writePtrRight, writePtrLeft, pixelsToCopySSE, pixelsToCopyNormal);
-            }
-            else 
-            {
-                getWritePointer<half>(y, writePtrRight, pixelsToCopySSE, pixelsToCopyNormal);
-            }
-            
-            if (writePtrRight == 0 && pixelsToCopySSE == 0 && pixelsToCopyNormal == 0)
-            {
-                continue;
-            }
-            
-            
-            //
-            // support reading up to eight channels
-            //
-            unsigned short* readPointers[8];
-            
-            for (size_t i = 0; i < channels ; ++i)
+            for (size_t i = 0; i < optData.size(); ++i)
             {
-                readPointers[i] = (unsigned short*)readPtr + (_ifd->optimizationData[i].offset * (pixelsToCopySSE * 8 + pixelsToCopyNormal));
+                readPointers[i] = optData[i].fill?
+                    0:
+                    (const unsigned short*)readPtr + optData[i].offset * pixelsPerLine;
             }
-            
-            //RGB only
-            if(channels==3 || channels == 6 )
-            {
-                    optimizedWriteToRGB(readPointers[0], readPointers[1], readPointers[2], writePtrRight, pixelsToCopySSE, pixelsToCopyNormal);
-                  
-                    //stereo RGB
-                    if( channels == 6)
-                    {
-                        optimizedWriteToRGB(readPointers[3], readPointers[4], readPointers[5], writePtrLeft, pixelsToCopySSE, pixelsToCopyNormal);
-                    }                
-            //RGBA
-            }else if(channels==4 || channels==8)
+
+            for (size_t i = 0; i < optData.size(); i += optData[i].groupSize)
             {
-                
-                if(_ifd->optimizationData[3].fill)
+                const sliceOptimizationData &data = optData[i];
+
+                char *linePtr = const_cast<char *> (data.base) + y * data.yStride;
+                char *writePtr = linePtr + _ifd->minX * data.xStride;
+
+                if (data.groupSize == 1)
+                {
+                    //
+                    // A channel that is not interleaved with other half
+                    // channels: copy it on its own, converting half to
+                    // float if necessary.
+                    //
+
+                    char *endPtr = linePtr + _ifd->maxX * data.xStride;
+                    const char *channelReadPtr = (const char *) readPointers[i];
+
+                    copyIntoFrameBuffer (channelReadPtr, writePtr, endPtr,
+                                         data.xStride, data.fill,
+                                         data.fillValue, Compressor::NATIVE,
+                                         data.type, data.typeInFile);
+                    continue;
+                }
+
+                unsigned short *writePtrShort = (unsigned short *) writePtr;
+                unsigned short *r = const_cast<unsigned short *> (readPointers[i]);
+                unsigned short *g = const_cast<unsigned short *> (readPointers[i + 1]);
+                unsigned short *b = (data.groupSize > 2)? 
+                    const_cast<unsigned short *> (readPointers[i + 2]): 0;
+
+                if (data.groupSize == 3 && r && g && b)
                 {
-                    optimizedWriteToRGBAFillA(readPointers[0], readPointers[1], readPointers[2], _ifd->optimizationData[3].fillValue.bits() , writePtrRight, pixelsToCopySSE, pixelsToCopyNormal);
-                }else{
-                    optimizedWriteToRGBA(readPointers[0], readPointers[1], readPointers[2], readPointers[3] , writePtrRight, pixelsToCopySSE, pixelsToCopyNormal);
+                    //RGB
+                    optimizedWriteToRGB (r, g, b, writePtrShort,
+                                         pixelsToCopySSE, pixelsToCopyNormal);
                 }
-                
-                //stereo RGBA
-                if( channels == 8)
+                else if (data.groupSize == 4 && r && g && b)
                 {
-                    if(_ifd->optimizationData[7].fill)
+                    //RGBA
+                    unsigned short *a = const_cast<unsigned short *> (readPointers[i + 3]);
+
+                    if (a)
+                    {
+                        optimizedWriteToRGBA (r, g, b, a, writePtrShort,
+                                              pixelsToCopySSE, pixelsToCopyNormal);
+                    }
+                    else
                     {
-                        optimizedWriteToRGBAFillA(readPointers[4], readPointers[5], readPointers[6], _ifd->optimizationData[7].fillValue.bits() , writePtrLeft, pixelsToCopySSE, pixelsToCopyNormal);
-                    }else{
-                        optimizedWriteToRGBA(readPointers[4], readPointers[5], readPointers[6], readPointers[7] , writePtrLeft, pixelsToCopySSE, pixelsToCopyNormal);
+                        optimizedWriteToRGBAFillA (r, g, b, fillValues[i + 3],
+                                                   writePtrShort,
+                                                   pixelsToCopySSE,
+                                                   pixelsToCopyNormal);
                     }
                 }
-            }
-            else {
-                throw(IEX_NAMESPACE::LogicExc("IIF mode called with incorrect channel pattern"));
+                else
+                {
+                    //
+                    // any other number of interleaved channels
+                    //
+
+                    optimizedWriteToInterleaved (&readPointers[i],
+                                                 &fillValues[i],
+                                                 data.groupSize,
+                                                 writePtrShort,
+                                                 pixelsToCopySSE,
+                                                 pixelsToCopyNormal);
+                }
             }
             
             // If we are in NO_OPTIMIZATION mode, this class will never
@@ -981,39 +1310,33 @@ LineBufferTaskIIF::execute()
     }
     catch (std::exception &e)
     {
-        if (!_lineBuffer->hasException)
-        {
-            _lineBuffer->exception = e.what();
-            _lineBuffer->hasException = true;
-        }
+        _request->setException (e.what());
     }
     catch (...)
     {
-        if (!_lineBuffer->hasException)
-        {
-            _lineBuffer->exception = "unrecognized exception";
-            _lineBuffer->hasException = true;
-        }
+        _request->setException ("unrecognized exception");
     }
 }
 #endif
 
 
 Task *
-newLineBufferTask (TaskGroup *group,
+newLineBufferTask (AsyncRead::Data *request,
                    InputStreamMutex *streamData,
                    ScanLineInputFile::Data *ifd,
                    int number,
                    int scanLineMin,
                    int scanLineMax,
-                   OptimizationMode optimizationMode)
+                   OptimizationMode optimizationMode,
+                   const DcOnlyRead *dcOnly)
 {
      //
      // Wait for a line buffer to become available, fill the line
      // buffer with raw data from the file if necessary, and create
      // a new LineBufferTask whose execute() method will uncompress
      // the contents of the buffer and copy the pixels into the
-     // frame buffer.
+     // frame buffer.  For reduced-resolution reads, the task is a
+     // LineBufferTaskDcOnly instead.
      //
      
      LineBuffer *lineBuffer = ifd->getLineBuffer (number);
@@ -1021,6 +1344,17 @@ newLineBufferTask (TaskGroup *group,
      try
      {
          lineBuffer->wait ();
+
+         if (dcOnly && lineBuffer->uncompressedData != 0)
+         {
+             //
+             // The line buffer's data have been uncompressed, and its
+             // dataSize is now that of the uncompressed data.  Reduced-
+             // resolution reads need the compressed data; read them again.
+             //
+
+             lineBuffer->number = -1;
+         }
          
          if (lineBuffer->number != number)
          {
@@ -1030,21 +1364,23 @@ newLineBufferTask (TaskGroup *group,
              lineBuffer->number = number;
              lineBuffer->uncompressedData = 0;
              
-             readPixelData (streamData, ifd, lineBuffer->minY,
-                            lineBuffer->buffer,
-                            lineBuffer->dataSize);
-         }
-     }
-     catch (std::exception &e)
-     {
-         if (!lineBuffer->hasException)
-         {
-             lineBuffer->exception = e.what();
-             lineBuffer->hasException = true;
+             if (ifd->statelessRead)
+             {
+                 //
+                 // Let the line buffer task read the data;
+                 // this way several tasks can fetch their
+                 // data from the file at the same time.
+                 //
+
+                 lineBuffer->readPending = true;
+             }
+             else
+             {
+                 readPixelData (streamData, ifd, lineBuffer->minY,
+                                lineBuffer->buffer,
+                                lineBuffer->dataSize);
+             }
          }
-         lineBuffer->number = -1;
-         lineBuffer->post();
-         throw;
      }
      catch (...)
      {
@@ -1054,8 +1390,6 @@ newLineBufferTask (TaskGroup *group,
          // re-throw the exception.
          //
          
-         lineBuffer->exception = "unrecognized exception";
-         lineBuffer->hasException = true;
          lineBuffer->number = -1;
          lineBuffer->post();
          throw;
@@ -1067,11 +1401,17 @@ newLineBufferTask (TaskGroup *group,
      
      Task* retTask = 0;
      
+     if (dcOnly)
+     {
+         retTask = new LineBufferTaskDcOnly (request, streamData, ifd,
+                                             lineBuffer, dcOnly);
+     }
+     else
 #ifdef IMF_HAVE_SSE2     
      if (optimizationMode._optimizable)
      {
          
-         retTask = new LineBufferTaskIIF (group, ifd, lineBuffer,
+         retTask = new LineBufferTaskIIF (request, streamData, ifd, lineBuffer,
                                           scanLineMin, scanLineMax,
                                           optimizationMode);
       
@@ -1079,14 +1419,120 @@ newLineBufferTask (TaskGroup *group,
      else
 #endif         
      {
-         retTask = new LineBufferTask (group, ifd, lineBuffer,
+         retTask = new LineBufferTask (request, streamData, ifd, lineBuffer,
                                        scanLineMin, scanLineMax,
                                        optimizationMode);
      }
+
+     request->addTask();
      
      return retTask;
      
  }
+
+
+void
+readLineBuffers (AsyncRead::Data *request,
+                 InputStreamMutex *streamData,
+                 ScanLineInputFile::Data *ifd,
+                 int scanLineMin,
+                 int scanLineMax,
+                 const DcOnlyRead *dcOnly = 0)
+{
+    //
+    // We impose a numbering scheme on the lineBuffers where the first
+    // scanline is contained in lineBuffer 1.
+    //
+    // Determine the first and last lineBuffer numbers in this scanline
+    // range. We always attempt to read the scanlines in the order that
+    // they are stored in the file.
+    //
+
+    int start, stop, dl;
+
+    if (ifd->lineOrder == INCREASING_Y)
+    {
+        start = (scanLineMin - ifd->minY) / ifd->linesInBuffer;
+        stop  = (scanLineMax - ifd->minY) / ifd->linesInBuffer + 1;
+        dl = 1;
+    }
+    else
+    {
+        start = (scanLineMax - ifd->minY) / ifd->linesInBuffer;
+        stop  = (scanLineMin - ifd->minY) / ifd->linesInBuffer - 1;
+        dl = -1;
+    }
+
+    //
+    // Add the line buffer tasks to the request's task group.
+    //
+    // The tasks will execute in the order that they are created
+    // because we lock the line buffers during construction and the
+    // constructors are called by the main thread.  Hence, in order
+    // for a successive task to execute the previous task which
+    // used that line buffer must have completed already.
+    //
+    // The tasks are handed to the thread pool in batches of
+    // one task per line buffer: creating a task may have to
+    // wait for the task that last used its line buffer, so
+    // that task must already have been added to the pool.
+    //
+
+    vector<Task *> tasks;
+    tasks.reserve (ifd->lineBuffers.size());
+
+    try
+    {
+        for (int l = start; l != stop; l += dl)
+        {
+            tasks.push_back (newLineBufferTask (request,
+                                                streamData,
+                                                ifd, l,
+                                                scanLineMin,
+                                                scanLineMax,
+                                                ifd->optimizationMode,
+                                                dcOnly));
+
+            if (tasks.size() == ifd->lineBuffers.size())
+            {
+                ifd->threadPool->addTasks (&tasks[0], tasks.size());
+                tasks.clear();
+            }
+        }
+    }
+    catch (...)
+    {
+        //
+        // The request waits for the tasks we created
+        // so far; make sure they all run.
+        //
+
+        if (!tasks.empty())
+            ifd->threadPool->addTasks (&tasks[0], tasks.size());
+
+        throw;
+    }
+
+    if (!tasks.empty())
+        ifd->threadPool->addTasks (&tasks[0], tasks.size());
+}
+
+
+void
+waitForLineBufferTasks (ScanLineInputFile::Data *ifd)
+{
+    //
+    // Wait until the tasks of earlier asynchronous reads have
+    // released all line buffers.  Until then those tasks may
+    // still be writing into the frame buffer.
+    //
+
+    for (size_t i = 0; i < ifd->lineBuffers.size(); ++i)
+    {
+        ifd->lineBuffers[i]->wait();
+        ifd->lineBuffers[i]->post();
+    }
+}
  
   
 
@@ -1114,12 +1560,14 @@ void ScanLineInputFile::initialize(const Header& header)
 
         for (size_t i = 0; i < _data->lineBuffers.size(); i++)
         {
-            _data->lineBuffers[i] = new LineBuffer (newCompressor
+            _data->lineBuffers[i] = new LineBuffer (borrowCompressor
                                                 (_data->header.compression(),
                                                  maxBytesPerLine,
                                                  _data->header));
         }
 
+        _data->channelsToDecode = _data->header.channels();
+
         _data->linesInBuffer =
             numLinesInBuffer (_data->lineBuffers[0]->compressor);
 
@@ -1158,8 +1606,11 @@ ScanLineInputFile::ScanLineInputFile(InputPartData* part)
         throw IEX_NAMESPACE::ArgExc("Can't build a ScanLineInputFile from a type-mismatched part.");
 
     _data = new Data(part->numThreads);
+    _data->threadPool = part->threadPool;
     _streamData = part->mutex;
     _data->memoryMapped = _streamData->is->isMemoryMapped();
+    _data->statelessRead = !_data->memoryMapped &&
+                           _streamData->is->isStatelessRead();
 
     _data->version = part->version;
 
@@ -1179,13 +1630,16 @@ ScanLineInputFile::ScanLineInputFile(InputPartData* part)
 ScanLineInputFile::ScanLineInputFile
     (const Header &header,
      OPENEXR_IMF_INTERNAL_NAMESPACE::IStream *is,
-     int numThreads)
+     int numThreads,
+     ThreadPool &threadPool)
 :
     _data (new Data (numThreads)),
     _streamData (new InputStreamMutex())
 {
+    _data->threadPool = &threadPool;
     _streamData->is = is;
     _data->memoryMapped = is->isMemoryMapped();
+    _data->statelessRead = !_data->memoryMapped && is->isStatelessRead();
 
     initialize(header);
     
@@ -1205,6 +1659,8 @@ ScanLineInputFile::ScanLineInputFile
 
 ScanLineInputFile::~ScanLineInputFile ()
 {
+    waitForLineBufferTasks (_data);
+
     if (!_data->memoryMapped)
     {
         for (size_t i = 0; i < _data->lineBuffers.size(); i++)
@@ -1251,75 +1707,65 @@ namespace
 {
     
     
-// returns the optimization state for the given arrangement of frame bufers
+// returns the optimization state for the given arrangement of frame bufers,
+// and splits the channels into groups that are copied together.
 // this assumes:
-//   both the file and framebuffer are half float data
+//   the file and framebuffer types are the same, or half and float
 //   both the file and framebuffer have xSampling and ySampling=1
 //   entries in optData are sorted into their interleave order (i.e. by base address)
 //   These tests are done by SetFrameBuffer as it is building optData
 //  
 OptimizationMode
-detectOptimizationMode (const vector<sliceOptimizationData>& optData)
+detectOptimizationMode (vector<sliceOptimizationData>& optData)
 {
     OptimizationMode w;
     
     // need to be compiled with SSE optimisations: if not, just returns false
 #ifdef IMF_HAVE_SSE2
     
-    
-    // only handle reading 3,4,6 or 8 channels
-    switch(optData.size())
-    {
-        case 3 : break;
-        case 4 : break;
-        case 6 : break;
-        case 8 : break;
-        default :
-            return w;
-    }
-    
-    //
-    // the point at which data switches between the primary and secondary bank
-    //
-    size_t bankSize = optData.size()>4 ? optData.size()/2 : optData.size();
-    
-    for(size_t i=0;i<optData.size();i++)
+    if (optData.empty())
+        return w;
+
+    for (size_t i = 0; i < optData.size(); i += optData[i].groupSize)
     {
-        const sliceOptimizationData& data = optData[i];
-        // can't fill anything other than channel 3 or channel 7
-        if(data.fill)
-        {
-            if(i!=3 && i!=7)
-            {
-                return w;
-            }
-        }
-        
-        // cannot have gaps in the channel layout, so the stride must be (number of channels written in the bank)*2
-        if(data.xStride !=bankSize*2)
+        //
+        // a half channel whose x stride is n halfs starts a group of
+        // n interleaved channels if the next n-1 channels are half
+        // channels at the following addresses, with the same strides.
+        // Channels that don't fit into a group are copied one by one.
+        //
+
+        sliceOptimizationData& data = optData[i];
+        data.groupSize = 1;
+
+        if (data.type != HALF || data.xStride < 4 || data.xStride % 2 != 0)
+            continue;
+
+        size_t n = data.xStride / 2;
+
+        if (i + n > optData.size())
+            continue;
+
+        bool interleaved = true;
+
+        for (size_t j = 1; j < n && interleaved; ++j)
         {
-            return w;
-        }
-        
-        // each bank of channels must be channel interleaved: each channel base pointer must be (previous channel+2)
-        // this also means channel sampling pattern must be consistent, as must yStride
-        if(i!=0 && i!=bankSize)
-        {
-            if(data.base!=optData[i-1].base+2)
-            {
-                return w;
-            }
-        }
-        if(i!=0)
-        {
-            
-            if(data.yStride!=optData[i-1].yStride)
-            {
-                return w;
-            }
+            const sliceOptimizationData& other = optData[i + j];
+
+            interleaved = other.type == HALF &&
+                          other.base == data.base + 2 * j &&
+                          other.xStride == data.xStride &&
+                          other.yStride == data.yStride;
         }
+
+        if (!interleaved)
+            continue;
+
+        data.groupSize = n;
+
+        for (size_t j = 1; j < n; ++j)
+            optData[i + j].groupSize = 0;
     }
-    
 
     w._ySampling=optData[0].ySampling;
     w._optimizable=true;
@@ -1337,29 +1783,19 @@ ScanLineInputFile::setFrameBuffer (const FrameBuffer &frameBuffer)
 {
     Lock lock (*_streamData);
 
+    waitForLineBufferTasks (_data);
+
     
     
-    const ChannelList &channels = _data->header.channels();
-    for (FrameBuffer::ConstIterator j = frameBuffer.begin();
-	 j != frameBuffer.end();
-	 ++j)
-    {
-	ChannelList::ConstIterator i = channels.find (j.name());
-
-	if (i == channels.end())
-	    continue;
+    //
+    // Initialize the slice table for readPixels().
+    //
 
-	if (i.channel().xSampling != j.slice().xSampling ||
-	    i.channel().ySampling != j.slice().ySampling)
-	    THROW (IEX_NAMESPACE::ArgExc, "X and/or y subsampling factors "
-				"of \"" << i.name() << "\" channel "
-				"of input file \"" << fileName() << "\" are "
-				"not compatible with the frame buffer's "
-				"subsampling factors.");
-    }
+    vector<InSliceInfo> slices;
+    sliceTable (_data->header.channels(), frameBuffer, fileName(), slices);
 
     // optimization is possible if this is a little endian system
-    // and both inputs and outputs are half floats
+    // and no channel needs a conversion other than half to float
     // 
     bool optimizationPossible = true;
     
@@ -1370,112 +1806,57 @@ ScanLineInputFile::setFrameBuffer (const FrameBuffer &frameBuffer)
     
     vector<sliceOptimizationData> optData;
     
-
-    //
-    // Initialize the slice table for readPixels().
-    //
-
-    vector<InSliceInfo> slices;
-    ChannelList::ConstIterator i = channels.begin();
-    
     // current offset of channel: pixel data starts at offset*width into the
     // decompressed scanline buffer
     size_t offset = 0;
     
-    for (FrameBuffer::ConstIterator j = frameBuffer.begin();
-	 j != frameBuffer.end();
-	 ++j)
+    for (size_t k = 0; k < slices.size(); ++k)
     {
-	while (i != channels.end() && strcmp (i.name(), j.name()) < 0)
-	{
-	    //
-	    // Channel i is present in the file but not
-	    // in the frame buffer; data for channel i
-	    // will be skipped during readPixels().
-	    //
-
-	    slices.push_back (InSliceInfo (i.channel().type,
-					   i.channel().type,
-					   0, // base
-					   0, // xStride
-					   0, // yStride
-					   i.channel().xSampling,
-					   i.channel().ySampling,
-					   false,  // fill
-					   true, // skip
-					   0.0)); // fillValue
-	    
-              switch(i.channel().type)
-              {
-                  case OPENEXR_IMF_INTERNAL_NAMESPACE::HALF :
-                      offset++;
-                      break;
-                  case OPENEXR_IMF_INTERNAL_NAMESPACE::FLOAT :
-                      offset+=2;
-                      break;
-                  case OPENEXR_IMF_INTERNAL_NAMESPACE::UINT :
-                      offset+=2;
-                      break;
-              }
-              ++i;
-	}
-
-	bool fill = false;
-
-	if (i == channels.end() || strcmp (i.name(), j.name()) > 0)
-	{
-	    //
-	    // Channel i is present in the frame buffer, but not in the file.
-	    // In the frame buffer, slice j will be filled with a default value.
-	    //
-
-	    fill = true;
-	}
-
-	slices.push_back (InSliceInfo (j.slice().type,
-				       fill? j.slice().type:
-				             i.channel().type,
-				       j.slice().base,
-				       j.slice().xStride,
-				       j.slice().yStride,
-				       j.slice().xSampling,
-				       j.slice().ySampling,
-				       fill,
-				       false, // skip
-				       j.slice().fillValue));
-
-          if(!fill && i.channel().type!=OPENEXR_IMF_INTERNAL_NAMESPACE::HALF)
+          const InSliceInfo &slice = slices[k];
+
+          //
+          // The optimized code finds each channel's data at a
+          // fixed offset in the line buffer, which is only possible
+          // if none of the channels in the file are subsampled.
+          //
+          if(slice.xSampling!=1 || slice.ySampling!=1)
           {
               optimizationPossible = false;
           }
-          
-          if(j.slice().type != OPENEXR_IMF_INTERNAL_NAMESPACE::HALF)
-          {
-              optimizationPossible = false;
-          }
-          if(j.slice().xSampling!=1 || j.slice().ySampling!=1)
+
+          //
+          // the optimized code copies channels of the same type, and
+          // converts half channels to float
+          //
+          if(!slice.skip &&
+             !slice.fill &&
+             slice.typeInFile != slice.typeInFrameBuffer &&
+             (slice.typeInFile != OPENEXR_IMF_INTERNAL_NAMESPACE::HALF ||
+              slice.typeInFrameBuffer != OPENEXR_IMF_INTERNAL_NAMESPACE::FLOAT))
           {
               optimizationPossible = false;
           }
 
-          
-          if(optimizationPossible)
+          if(optimizationPossible && !slice.skip)
           {
               sliceOptimizationData dat;
-              dat.base = j.slice().base;
-              dat.fill = fill;
-              dat.fillValue = j.slice().fillValue;
+              dat.base = slice.base;
+              dat.fill = slice.fill;
+              dat.fillValue = slice.fillValue;
               dat.offset = offset;
-              dat.xStride = j.slice().xStride;
-              dat.yStride = j.slice().yStride;
-              dat.xSampling = j.slice().xSampling;
-              dat.ySampling = j.slice().ySampling;
+              dat.type = slice.typeInFrameBuffer;
+              dat.typeInFile = slice.typeInFile;
+              dat.xStride = slice.xStride;
+              dat.yStride = slice.yStride;
+              dat.xSampling = slice.xSampling;
+              dat.ySampling = slice.ySampling;
+              dat.groupSize = 1;
               optData.push_back(dat);
           }
           
-          if(!fill)
+          if(!slice.fill)
           {
-              switch(i.channel().type)
+              switch(slice.typeInFile)
               {
                   case OPENEXR_IMF_INTERNAL_NAMESPACE::HALF :
                       offset++;
@@ -1488,14 +1869,8 @@ ScanLineInputFile::setFrameBuffer (const FrameBuffer &frameBuffer)
                       break;
               }
           }
-          
-
-          
-	if (i != channels.end() && !fill)
-	    ++i;
     }
 
-   
    if(optimizationPossible)
    {
        //
@@ -1512,6 +1887,39 @@ ScanLineInputFile::setFrameBuffer (const FrameBuffer &frameBuffer)
        _data->optimizationMode._optimizable=false;
    }
     
+    //
+    // Let the compressors skip the channels that are not in the
+    // frame buffer.  Line buffers that a compressor uncompressed
+    // for a different set of channels must then be read again.
+    //
+
+    ChannelList channelsToDecode;
+    const ChannelList &channels = _data->header.channels();
+
+    for (ChannelList::ConstIterator i = channels.begin();
+         i != channels.end();
+         ++i)
+    {
+        if (frameBuffer.findSlice (i.name()))
+            channelsToDecode.insert (i.name(), i.channel());
+    }
+
+    if (!(channelsToDecode == _data->channelsToDecode))
+    {
+        for (size_t i = 0; i < _data->lineBuffers.size(); ++i)
+        {
+            LineBuffer *lineBuffer = _data->lineBuffers[i];
+
+            if (lineBuffer->compressor &&
+                lineBuffer->compressor->setChannelsToDecode (channelsToDecode))
+            {
+                lineBuffer->number = -1;
+            }
+        }
+
+        _data->channelsToDecode = channelsToDecode;
+    }
+
     //
     // Store the new frame buffer.
     //
@@ -1565,63 +1973,23 @@ ScanLineInputFile::readPixels (int scanLine1, int scanLine2)
 			       "the image file's data window.");
 
         //
-        // We impose a numbering scheme on the lineBuffers where the first
-        // scanline is contained in lineBuffer 1.
-        //
-        // Determine the first and last lineBuffer numbers in this scanline
-        // range. We always attempt to read the scanlines in the order that
-        // they are stored in the file.
+        // Create a request for the line buffer tasks.  When the
+        // request goes out of scope, its destructor waits until
+        // all tasks are complete.
         //
 
-        int start, stop, dl;
+        AsyncRead request (new AsyncRead::Data (fileName(), 0, 0));
 
-        if (_data->lineOrder == INCREASING_Y)
-        {
-            start = (scanLineMin - _data->minY) / _data->linesInBuffer;
-            stop  = (scanLineMax - _data->minY) / _data->linesInBuffer + 1;
-            dl = 1;
-        }
-        else
-        {
-            start = (scanLineMax - _data->minY) / _data->linesInBuffer;
-            stop  = (scanLineMin - _data->minY) / _data->linesInBuffer - 1;
-            dl = -1;
-        }
+        readLineBuffers (request.data(), _streamData, _data,
+                         scanLineMin, scanLineMax);
 
         //
-        // Create a task group for all line buffer tasks.  When the
-	// task group goes out of scope, the destructor waits until
-	// all tasks are complete.
+        // finish all tasks
         //
-        
-        {
-            TaskGroup taskGroup;
-    
-            //
-            // Add the line buffer tasks.
-            //
-            // The tasks will execute in the order that they are created
-            // because we lock the line buffers during construction and the
-            // constructors are called by the main thread.  Hence, in order
-	    // for a successive task to execute the previous task which
-	    // used that line buffer must have completed already.
-            //
-    
-            for (int l = start; l != stop; l += dl)
-            {
-                ThreadPool::addGlobalTask (newLineBufferTask (&taskGroup,
-                                                              _streamData,
-                                                              _data, l,
-                                                              scanLineMin,
-                                                              scanLineMax,
-                                                              _data->optimizationMode));
-            }
-        
-	    //
-            // finish all tasks
-	    //
-        }
-        
+
+        request.data()->finishTask();
+        request.data()->waitForTasks();
+
 	//
 	// Exeption handling:
 	//
@@ -1629,28 +1997,12 @@ ScanLineInputFile::readPixels (int scanLine1, int scanLine2)
 	// those exceptions occurred in another thread, not in the thread
 	// that is executing this call to ScanLineInputFile::readPixels().
 	// LineBufferTask::execute() has caught all exceptions and stored
-	// the exceptions' what() strings in the line buffers.
-	// Now we check if any line buffer contains a stored exception; if
-	// this is the case then we re-throw the exception in this thread.
-	// (It is possible that multiple line buffers contain stored
-	// exceptions.  We re-throw the first exception we find and
-	// ignore all others.)
+	// the first exception's what() string in the request.  If there
+	// is a stored exception, we re-throw it in this thread.
 	//
 
-	const string *exception = 0;
-
-        for (size_t i = 0; i < _data->lineBuffers.size(); ++i)
-	{
-            LineBuffer *lineBuffer = _data->lineBuffers[i];
-
-	    if (lineBuffer->hasException && !exception)
-		exception = &lineBuffer->exception;
-
-	    lineBuffer->hasException = false;
-	}
-
-	if (exception)
-	    throw IEX_NAMESPACE::IoExc (*exception);
+	if (request.data()->hasException)
+	    throw IEX_NAMESPACE::IoExc (request.data()->exception);
     }
     catch (IEX_NAMESPACE::BaseExc &e)
     {
@@ -1668,6 +2020,67 @@ ScanLineInputFile::readPixels (int scanLine)
 }
 
 
+AsyncRead
+ScanLineInputFile::readPixelsAsync (int scanLine1,
+                                    int scanLine2,
+                                    AsyncRead::Callback callback,
+                                    void *userData)
+{
+    AsyncRead request (new AsyncRead::Data (fileName(), callback, userData));
+
+    try
+    {
+        Lock lock (*_streamData);
+
+	if (_data->slices.size() == 0)
+	    throw IEX_NAMESPACE::ArgExc ("No frame buffer specified "
+			       "as pixel data destination.");
+
+	int scanLineMin = min (scanLine1, scanLine2);
+	int scanLineMax = max (scanLine1, scanLine2);
+
+	if (scanLineMin < _data->minY || scanLineMax > _data->maxY)
+	    throw IEX_NAMESPACE::ArgExc ("Tried to read scan line outside "
+			       "the image file's data window.");
+
+        //
+        // Errors while reading the data from the file are
+        // reported through the request, like errors in the
+        // line buffer tasks.
+        //
+
+        try
+        {
+            readLineBuffers (request.data(), _streamData, _data,
+                             scanLineMin, scanLineMax);
+        }
+        catch (std::exception &e)
+        {
+            request.data()->setException (e.what());
+        }
+        catch (...)
+        {
+            request.data()->setException ("unrecognized exception");
+        }
+    }
+    catch (IEX_NAMESPACE::BaseExc &e)
+    {
+	REPLACE_EXC (e, "Error reading pixel data from image "
+		        "file \"" << fileName() << "\". " << e);
+	throw;
+    }
+
+    //
+    // Release the file's lock before the request can complete,
+    // so that the completion callback does not run while we
+    // hold the lock.
+    //
+
+    request.data()->finishTask();
+    return request;
+}
+
+
 void
 ScanLineInputFile::rawPixelData (int firstScanLine,
 				 const char *&pixelData,
@@ -1733,4 +2146,257 @@ void ScanLineInputFile::rawPixelDataToBuffer(int scanLine,
 }
 
 
+void
+ScanLineInputFile::readPixels (const char *rawPixelData,
+                               int rawPixelDataSize,
+                               const FrameBuffer &frameBuffer,
+                               int scanLine1,
+                               int scanLine2) const
+{
+    try
+    {
+        decodeRawPixelData (_data->header, rawPixelData, rawPixelDataSize,
+                            frameBuffer, scanLine1, scanLine2);
+    }
+    catch (IEX_NAMESPACE::BaseExc &e)
+    {
+	REPLACE_EXC (e, "Error decoding pixel data from image "
+		        "file \"" << fileName() << "\". " << e);
+	throw;
+    }
+}
+
+
+void
+ScanLineInputFile::decodeRawPixelData (const Header &header,
+                                       const char *rawPixelData,
+                                       int rawPixelDataSize,
+                                       const FrameBuffer &frameBuffer,
+                                       int scanLine1,
+                                       int scanLine2)
+{
+    const Box2i &dataWindow = header.dataWindow();
+
+    int scanLineMin = min (scanLine1, scanLine2);
+    int scanLineMax = max (scanLine1, scanLine2);
+
+    if (scanLineMin < dataWindow.min.y || scanLineMax > dataWindow.max.y)
+        throw IEX_NAMESPACE::ArgExc ("Tried to read scan line outside "
+                                     "the image file's data window.");
+
+    vector<size_t> bytesPerLine;
+    size_t maxBytesPerLine = bytesPerLineTable (header, bytesPerLine);
+
+    Compressor *compressor = borrowCompressor (header.compression(),
+                                               maxBytesPerLine,
+                                               header);
+
+    try
+    {
+        int linesInBuffer = numLinesInBuffer (compressor);
+
+        int minY = lineBufferMinY (scanLineMin, dataWindow.min.y,
+                                   linesInBuffer);
+
+        int maxY = min (minY + linesInBuffer - 1, dataWindow.max.y);
+
+        if (scanLineMax > maxY)
+            throw IEX_NAMESPACE::ArgExc ("Tried to read scan lines from "
+                                         "more than one block of raw "
+                                         "pixel data.");
+
+        vector<size_t> offsetInLineBuffer;
+        offsetInLineBufferTable (bytesPerLine,
+                                 minY - dataWindow.min.y,
+                                 maxY - dataWindow.min.y,
+                                 linesInBuffer,
+                                 offsetInLineBuffer);
+
+        int uncompressedSize = 0;
+
+        for (int y = minY; y <= maxY; ++y)
+            uncompressedSize += (int) bytesPerLine[y - dataWindow.min.y];
+
+        //
+        // Uncompress the data, if necessary.  If the data are not
+        // compressed, they are in XDR format, regardless of the
+        // compressor's output format.
+        //
+
+        const char *uncompressedData = rawPixelData;
+        int dataSize = rawPixelDataSize;
+        Compressor::Format format = Compressor::XDR;
+
+        if (compressor && rawPixelDataSize < uncompressedSize)
+        {
+            dataSize = compressor->uncompress (rawPixelData,
+                                               rawPixelDataSize,
+                                               minY,
+                                               uncompressedData);
+            format = compressor->format();
+        }
+
+        if (dataSize < uncompressedSize)
+            throw IEX_NAMESPACE::InputExc ("Raw pixel data block is "
+                                           "too small for its scan lines.");
+
+        vector<InSliceInfo> slices;
+        sliceTable (header.channels(), frameBuffer,
+                    "(raw pixel data)", slices);
+
+        copyLineBufferIntoFrameBuffer (slices,
+                                       uncompressedData,
+                                       format,
+                                       offsetInLineBuffer,
+                                       dataWindow.min.x,
+                                       dataWindow.max.x,
+                                       dataWindow.min.y,
+                                       header.lineOrder(),
+                                       scanLineMin, scanLineMax);
+    }
+    catch (...)
+    {
+        returnCompressor (compressor);
+        throw;
+    }
+
+    returnCompressor (compressor);
+}
+
+
+int
+ScanLineInputFile::firstScanLineInChunk (int y) const
+{
+    return lineBufferMinY (y, _data->minY, _data->linesInBuffer);
+}
+
+
+int
+ScanLineInputFile::lastScanLineInChunk (int y) const
+{
+    return min (firstScanLineInChunk (y) + _data->linesInBuffer - 1,
+                _data->maxY);
+}
+
+
+bool
+ScanLineInputFile::dcOnlyReadsAvailable () const
+{
+    Compression compression = _data->header.compression();
+
+    if (compression != DWAA_COMPRESSION && compression != DWAB_COMPRESSION)
+        return false;
+
+    const ChannelList &channels = _data->header.channels();
+
+    for (ChannelList::ConstIterator i = channels.begin();
+         i != channels.end();
+         ++i)
+    {
+        if (i.channel().xSampling != 1 || i.channel().ySampling != 1)
+            return false;
+    }
+
+    return true;
+}
+
+
+Box2i
+ScanLineInputFile::dcOnlyDataWindow () const
+{
+    Box2i dataWindow (_data->header.dataWindow());
+
+    dataWindow.max.x = dataWindow.min.x +
+                       (dataWindow.max.x - dataWindow.min.x) / 8;
+
+    dataWindow.max.y = dataWindow.min.y +
+                       (dataWindow.max.y - dataWindow.min.y) / 8;
+
+    return dataWindow;
+}
+
+
+void
+ScanLineInputFile::readPixelsDcOnly (const FrameBuffer &frameBuffer,
+                                     int scanLine1,
+                                     int scanLine2)
+{
+    try
+    {
+        Lock lock (*_streamData);
+
+        if (!dcOnlyReadsAvailable())
+            throw IEX_NAMESPACE::ArgExc ("Reduced-resolution reads require "
+                                         "DWAA or DWAB compression and no "
+                                         "subsampled channels.");
+
+        DcOnlyRead dcOnly;
+
+        dcOnly.dataWindow = dcOnlyDataWindow();
+        dcOnly.scanLineMin = min (scanLine1, scanLine2);
+        dcOnly.scanLineMax = max (scanLine1, scanLine2);
+
+        const Box2i &dataWindow = dcOnly.dataWindow;
+
+        if (dcOnly.scanLineMin < dataWindow.min.y ||
+            dcOnly.scanLineMax > dataWindow.max.y)
+        {
+            throw IEX_NAMESPACE::ArgExc ("Tried to read scan line outside "
+                                         "the reduced data window.");
+        }
+
+        sliceTable (_data->header.channels(), frameBuffer,
+                    fileName(), dcOnly.slices);
+
+        //
+        // All reduced scan lines have the same size, and each
+        // line buffer holds 1/8 as many of them as full scan lines.
+        //
+
+        const ChannelList &channels = _data->header.channels();
+        size_t bytesPerLine = 0;
+
+        for (ChannelList::ConstIterator i = channels.begin();
+             i != channels.end();
+             ++i)
+        {
+            bytesPerLine += pixelTypeSize (i.channel().type) *
+                            (dataWindow.max.x - dataWindow.min.x + 1);
+        }
+
+        for (int i = 0; i < (_data->linesInBuffer + 7) / 8; ++i)
+            dcOnly.offsetInLineBuffer.push_back (i * bytesPerLine);
+
+        //
+        // Read the line buffers that hold the full-resolution
+        // scan lines that correspond to the reduced ones.
+        //
+
+        int scanLineMin = _data->minY +
+                          8 * (dcOnly.scanLineMin - dataWindow.min.y);
+
+        int scanLineMax = min (_data->maxY,
+                               _data->minY + 7 +
+                               8 * (dcOnly.scanLineMax - dataWindow.min.y));
+
+        AsyncRead request (new AsyncRead::Data (fileName(), 0, 0));
+
+        readLineBuffers (request.data(), _streamData, _data,
+                         scanLineMin, scanLineMax, &dcOnly);
+
+        request.data()->finishTask();
+        request.data()->waitForTasks();
+
+        if (request.data()->hasException)
+            throw IEX_NAMESPACE::IoExc (request.data()->exception);
+    }
+    catch (IEX_NAMESPACE::BaseExc &e)
+    {
+	REPLACE_EXC (e, "Error reading pixel data from image "
+		        "file \"" << fileName() << "\". " << e);
+	throw;
+    }
+}
+
+
 OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_EXIT
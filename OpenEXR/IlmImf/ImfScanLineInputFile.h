@@ -48,6 +48,7 @@
 #include "ImfInputStreamMutex.h"
 #include "ImfInputPartData.h"
 #include "ImfGenericInputFile.h"
+#include "ImfAsyncRead.h"
 #include "ImfExport.h"
 #include "ImfNamespace.h"
 
@@ -58,13 +59,16 @@ class ScanLineInputFile : public GenericInputFile
 {
   public:
 
-    //------------
-    // Constructor
-    //------------
+    //------------------------------------------------------
+    // Constructor -- pixel data are decompressed by tasks
+    // in threadPool
+    //------------------------------------------------------
 
     IMF_EXPORT
     ScanLineInputFile (const Header &header, OPENEXR_IMF_INTERNAL_NAMESPACE::IStream *is,
-                       int numThreads = globalThreadCount());
+                       int numThreads = globalThreadCount(),
+                       ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                           globalThreadPool());
 
 
     //-----------------------------------------
@@ -185,6 +189,31 @@ class ScanLineInputFile : public GenericInputFile
     void		readPixels (int scanLine);
 
 
+    //---------------------------------------------------------------
+    // Read pixel data asynchronously:
+    //
+    // readPixelsAsync(s1,s2) hands the work for readPixels(s1,s2)
+    // to the file's thread pool and returns without waiting for it
+    // to complete.  The returned AsyncRead can be used to wait for
+    // the read, or to check if it is complete; the callback, if it
+    // is not 0, is called with userData when the read completes.
+    // Errors that occur while reading or decompressing the data
+    // are reported by AsyncRead::wait().
+    //
+    // The file decodes the data through a fixed set of line buffers
+    // (two per thread).  readPixelsAsync() blocks while a line buffer
+    // it needs is still in use by an earlier task, for instance if
+    // the scan line range covers more line buffers than the file has.
+    // See ImfAsyncRead.h for the rules for the frame buffer while a
+    // read is in flight.
+    //---------------------------------------------------------------
+
+    IMF_EXPORT
+    AsyncRead		readPixelsAsync (int scanLine1, int scanLine2,
+                                         AsyncRead::Callback callback = 0,
+                                         void *userData = 0);
+
+
     //----------------------------------------------
     // Read a block of raw pixel data from the file,
     // without uncompressing it (this function is
@@ -217,6 +246,103 @@ class ScanLineInputFile : public GenericInputFile
     void                rawPixelDataToBuffer(int scanLine,
 					     char *pixelData,
 					     int &pixelDataSize) const;
+
+
+    //---------------------------------------------------------------
+    // Decode a block of raw pixel data:
+    //
+    // readPixels(rawPixelData,rawPixelDataSize,frameBuffer,s1,s2)
+    // uncompresses a block of raw pixel data, as returned by
+    // rawPixelData() or rawPixelDataToBuffer(), and stores the scan
+    // lines with y coordinates in the interval [min (s1, s2),
+    // max (s1, s2)] in frameBuffer.  Both s1 and s2 must be within
+    // the block, that is, within the interval
+    // [firstScanLineInChunk(s1), lastScanLineInChunk(s1)].
+    //
+    // decodeRawPixelData() does the same, given only the header
+    // of the file that the data came from; the file itself need
+    // not be open, for instance if the data were read by another
+    // process.
+    //
+    // These calls do not block, and they are thread safe for
+    // clients with their own threading model.  The file's frame
+    // buffer is not used.
+    //---------------------------------------------------------------
+
+    IMF_EXPORT
+    void                readPixels (const char *rawPixelData,
+                                    int rawPixelDataSize,
+                                    const FrameBuffer &frameBuffer,
+                                    int scanLine1,
+                                    int scanLine2) const;
+
+    IMF_EXPORT
+    static void         decodeRawPixelData (const Header &header,
+                                            const char *rawPixelData,
+                                            int rawPixelDataSize,
+                                            const FrameBuffer &frameBuffer,
+                                            int scanLine1,
+                                            int scanLine2);
+
+
+    //---------------------------------------------------------------
+    // firstScanLineInChunk() returns the row number of the first row
+    // that's stored in the same block of raw pixel data as scan line y.
+    // Depending on the compression mode, this may not be the same as y.
+    //
+    // lastScanLineInChunk() returns the row number of the last row
+    // that's stored in the same block as scan line y.  The last block
+    // in the file may be smaller than all the others.
+    //---------------------------------------------------------------
+
+    IMF_EXPORT
+    int                 firstScanLineInChunk (int y) const;
+
+    IMF_EXPORT
+    int                 lastScanLineInChunk (int y) const;
+
+
+    //---------------------------------------------------------------
+    // Reduced-resolution reads of DWA compressed files:
+    //
+    // DWAA and DWAB compression store the DC component of each 8x8
+    // pixel block of a lossy DCT channel apart from the AC components.
+    // readPixelsDcOnly() decodes only the DC components, and produces
+    // an image at 1/8 of the width and height of the full image, much
+    // faster than readPixels() produces the full image.  Each pixel of
+    // the reduced image stands for one 8x8 block of the full image:
+    // lossy DCT channels get the block's DC value, other channels the
+    // average of the block (for UINT channels, its top-left sample).
+    //
+    // dcOnlyReadsAvailable() returns true if the file can be read at
+    // reduced resolution: it must be DWAA or DWAB compressed, and it
+    // must not contain subsampled channels.
+    //
+    // dcOnlyDataWindow() returns the data window of the reduced image.
+    // Its min corner is the same as that of the file's data window,
+    // and its width and height are those of the data window divided
+    // by 8, rounded up.
+    //
+    // readPixelsDcOnly(frameBuffer,s1,s2) reads the scan lines of the
+    // reduced image with y coordinates in the interval [min (s1, s2),
+    // max (s1, s2)], and stores them in frameBuffer, whose slices are
+    // addressed in the coordinates of dcOnlyDataWindow().  Both s1 and
+    // s2 must be within the interval [dcOnlyDataWindow().min.y,
+    // dcOnlyDataWindow().max.y].  The file's own frame buffer is
+    // neither used nor changed.  If the file cannot be read at reduced
+    // resolution, readPixelsDcOnly() throws an IEX_NAMESPACE::ArgExc.
+    //---------------------------------------------------------------
+
+    IMF_EXPORT
+    bool                dcOnlyReadsAvailable () const;
+
+    IMF_EXPORT
+    IMATH_NAMESPACE::Box2i dcOnlyDataWindow () const;
+
+    IMF_EXPORT
+    void                readPixelsDcOnly (const FrameBuffer &frameBuffer,
+                                          int scanLine1,
+                                          int scanLine2);
     
   
     struct Data;
@@ -60,6 +60,7 @@
 #include "ImfEnvmapAttribute.h"
 #include "ImfDeepImageStateAttribute.h"
 #include "ImfFloatAttribute.h"
+#include "ImfIntAttribute.h"
 #include "ImfKeyCodeAttribute.h"
 #include "ImfMatrixAttribute.h"
 #include "ImfRationalAttribute.h"
@@ -379,4 +380,26 @@ IMF_STD_ATTRIBUTE_DEF
 IMF_STD_ATTRIBUTE_DEF (dwaCompressionLevel, DwaCompressionLevel, float)
 
 
+//
+// zipCompressionLevel -- sets the zlib compression level, from 1 (fastest)
+// to 9 (smallest files), for images compressed with the ZIP or ZIPS
+// method.  0 stores the data without deflating them, and values less
+// than 0 select zlib's default level.
+//
+
+IMF_STD_ATTRIBUTE_DEF (zipCompressionLevel, ZipCompressionLevel, int)
+
+
+//
+// zstdCompressionLevel -- sets the Zstandard compression level for
+// images compressed with the ZSTD method.  Higher levels produce
+// smaller files but take longer to write; decoding speed is nearly
+// the same for all levels.  Negative levels are faster still.
+// Values outside the range that the zstd library supports are
+// clamped to that range.
+//
+
+IMF_STD_ATTRIBUTE_DEF (zstdCompressionLevel, ZstdCompressionLevel, int)
+
+
 #endif
@@ -42,12 +42,13 @@ namespace {
 #if defined(IMF_HAVE_SSE2) &&  defined(__GNUC__)
 
     // Helper functions for gcc + SSE enabled
+    // (sub-leaf 0 is selected for leaves that have sub-leaves)
     void cpuid(int n, int &eax, int &ebx, int &ecx, int &edx)
     {
         __asm__ __volatile__ (
             "cpuid"
             : /* Output  */ "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) 
-            : /* Input   */ "a"(n)
+            : /* Input   */ "a"(n), "c"(0)
             : /* Clobber */);
     }
 
@@ -91,7 +92,10 @@ CpuId::CpuId():
     sse4_1(false), 
     sse4_2(false), 
     avx(false), 
-    f16c(false)
+    f16c(false),
+    avx2(false),
+    avx512f(false),
+    avx512bw(false)
 {
     bool osxsave = false;
     int  max     = 0;
@@ -122,6 +126,16 @@ CpuId::CpuId():
             {
                 avx = f16c = false;
             }
+            else if (max >= 7)
+            {
+                // eax bits 5 to 7 - AVX-512 opmask and ZMM registers managed
+                bool zmmState = ((eax & 0xe0) == 0xe0);
+
+                cpuid(7, eax, ebx, ecx, edx);
+                avx2     = ( ebx & (1<< 5) );
+                avx512f  = ( ebx & (1<<16) ) && zmmState;
+                avx512bw = ( ebx & (1<<30) ) && zmmState;
+            }
         }
     }
 }
@@ -163,6 +163,9 @@ class IMF_EXPORT CpuId
         bool sse4_2;
         bool avx;
         bool f16c;
+        bool avx2;
+        bool avx512f;
+        bool avx512bw;
 };
 
 
@@ -59,4 +59,11 @@ setGlobalThreadCount (int count)
 }
 
 
+ILMTHREAD_NAMESPACE::ThreadPool &
+globalThreadPool ()
+{
+    return ILMTHREAD_NAMESPACE::ThreadPool::globalThreadPool();
+}
+
+
 OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -37,6 +37,7 @@
 
 #include "ImfExport.h"
 #include "ImfNamespace.h"
+#include "IlmThreadForward.h"
 
 //-----------------------------------------------------------------------------
 //
@@ -70,6 +71,12 @@
 //	  each file to try to occupy all worker threads in the library's
 //	  thread pool.
 //
+//	* Finally, each input or output file can be given its own
+//	  ILMTHREAD_NAMESPACE::ThreadPool instead of the global one,
+//	  so that different kinds of work, for example interactive
+//	  reads and background conversions, do not compete for the
+//	  same worker threads.
+//
 //-----------------------------------------------------------------------------
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
@@ -90,6 +97,15 @@ IMF_EXPORT int     globalThreadCount ();
 IMF_EXPORT void    setGlobalThreadCount (int count);
 
 
+//-----------------------------------------------------------------------------
+// Return the Imf-global thread pool, whose size is controlled by
+// setGlobalThreadCount().  Input and output files use this pool
+// unless a different one is passed to their constructors.
+//-----------------------------------------------------------------------------
+
+IMF_EXPORT ILMTHREAD_NAMESPACE::ThreadPool &	globalThreadPool ();
+
+
 OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif
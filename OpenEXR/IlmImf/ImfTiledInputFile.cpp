@@ -39,6 +39,7 @@
 //-----------------------------------------------------------------------------
 
 #include "ImfTiledInputFile.h"
+#include "ImfAsyncReadData.h"
 #include "ImfTileDescriptionAttribute.h"
 #include "ImfChannelList.h"
 #include "ImfMisc.h"
@@ -77,7 +78,6 @@ using ILMTHREAD_NAMESPACE::Mutex;
 using ILMTHREAD_NAMESPACE::Lock;
 using ILMTHREAD_NAMESPACE::Semaphore;
 using ILMTHREAD_NAMESPACE::Task;
-using ILMTHREAD_NAMESPACE::TaskGroup;
 using ILMTHREAD_NAMESPACE::ThreadPool;
 
 namespace {
@@ -143,8 +143,7 @@ struct TileBuffer
     int			dy;
     int			lx;
     int			ly;
-    bool		hasException;
-    string		exception;
+    bool		readPending;
 
      TileBuffer (Compressor * const comp);
     ~TileBuffer ();
@@ -168,8 +167,7 @@ TileBuffer::TileBuffer (Compressor *comp):
     dy (-1),
     lx (-1),
     ly (-1),
-    hasException (false),
-    exception (),
+    readPending (false),
     _sem (1)
 {
     // empty
@@ -178,9 +176,200 @@ TileBuffer::TileBuffer (Compressor *comp):
 
 TileBuffer::~TileBuffer ()
 {
-    delete compressor;
+    returnCompressor (compressor);
 }
 
+
+//
+// Build the table of slices that is used to copy pixel data from
+// the tile buffers into a frame buffer: one entry for each channel
+// in the frame buffer, and one for each channel in the file that
+// must be skipped.  fileName is only used for error messages.
+//
+
+void
+sliceTable (const ChannelList &channels,
+            const FrameBuffer &frameBuffer,
+            const char fileName[],
+            vector<TInSliceInfo> &slices)
+{
+    //
+    // Check if the frame buffer is compatible with the file.
+    //
+
+    for (FrameBuffer::ConstIterator j = frameBuffer.begin();
+         j != frameBuffer.end();
+         ++j)
+    {
+        ChannelList::ConstIterator i = channels.find (j.name());
+
+        if (i == channels.end())
+            continue;
+
+        if (i.channel().xSampling != j.slice().xSampling ||
+            i.channel().ySampling != j.slice().ySampling)
+            THROW (IEX_NAMESPACE::ArgExc, "X and/or y subsampling factors "
+				"of \"" << i.name() << "\" channel "
+				"of input file \"" << fileName << "\" are "
+				"not compatible with the frame buffer's "
+				"subsampling factors.");
+    }
+
+    slices.clear();
+    ChannelList::ConstIterator i = channels.begin();
+
+    for (FrameBuffer::ConstIterator j = frameBuffer.begin();
+         j != frameBuffer.end();
+         ++j)
+    {
+        while (i != channels.end() && strcmp (i.name(), j.name()) < 0)
+        {
+            //
+            // Channel i is present in the file but not
+            // in the frame buffer; data for channel i
+            // will be skipped during readPixels().
+            //
+
+            slices.push_back (TInSliceInfo (i.channel().type,
+					    i.channel().type,
+					    0,      // base
+					    0,      // xStride
+					    0,      // yStride
+					    false,  // fill
+					    true,   // skip
+					    0.0));  // fillValue
+            ++i;
+        }
+
+        bool fill = false;
+
+        if (i == channels.end() || strcmp (i.name(), j.name()) > 0)
+        {
+            //
+            // Channel i is present in the frame buffer, but not in the file.
+            // In the frame buffer, slice j will be filled with a default value.
+            //
+
+            fill = true;
+        }
+
+        slices.push_back (TInSliceInfo (j.slice().type,
+                                        fill? j.slice().type: i.channel().type,
+                                        j.slice().base,
+                                        j.slice().xStride,
+                                        j.slice().yStride,
+                                        fill,
+                                        false, // skip
+                                        j.slice().fillValue,
+                                        (j.slice().xTileCoords)? 1: 0,
+                                        (j.slice().yTileCoords)? 1: 0));
+
+        if (i != channels.end() && !fill)
+            ++i;
+    }
+
+    while (i != channels.end())
+    {
+	//
+	// Channel i is present in the file but not
+	// in the frame buffer; data for channel i
+	// will be skipped during readPixels().
+	//
+
+	slices.push_back (TInSliceInfo (i.channel().type,
+					i.channel().type,
+					0, // base
+					0, // xStride
+					0, // yStride
+					false,  // fill
+					true, // skip
+					0.0)); // fillValue
+	++i;
+    }
+}
+
+
+//
+// Convert an uncompressed tile of pixel data, which covers the pixels
+// in tileRange, back from the machine-independent representation, and
+// store the result in the frame buffer described by slices.
+//
+
+void
+copyTileIntoFrameBuffer (const vector<TInSliceInfo> &slices,
+                         const char *uncompressedData,
+                         Compressor::Format format,
+                         const Box2i &tileRange)
+{
+    int numPixelsPerScanLine = tileRange.max.x - tileRange.min.x + 1;
+
+    const char *readPtr = uncompressedData;
+                                                    // points to where we
+                                                    // read from in the
+                                                    // tile block
+    
+    //
+    // Iterate over the scan lines in the tile.
+    //
+
+    for (int y = tileRange.min.y; y <= tileRange.max.y; ++y)
+    {
+        //
+        // Iterate over all image channels.
+        //
+        
+        for (unsigned int i = 0; i < slices.size(); ++i)
+        {
+            const TInSliceInfo &slice = slices[i];
+
+            //
+            // These offsets are used to facilitate both
+            // absolute and tile-relative pixel coordinates.
+            //
+        
+            int xOffset = slice.xTileCoords * tileRange.min.x;
+            int yOffset = slice.yTileCoords * tileRange.min.y;
+
+            //
+            // Fill the frame buffer with pixel data.
+            //
+
+            if (slice.skip)
+            {
+                //
+                // The file contains data for this channel, but
+                // the frame buffer contains no slice for this channel.
+                //
+
+                skipChannel (readPtr, slice.typeInFile,
+                             numPixelsPerScanLine);
+            }
+            else
+            {
+                //
+                // The frame buffer contains a slice for this channel.
+                //
+
+                char *writePtr = slice.base +
+                                 (y - yOffset) * slice.yStride +
+                                 (tileRange.min.x - xOffset) *
+                                 slice.xStride;
+
+                char *endPtr = writePtr +
+                               (numPixelsPerScanLine - 1) * slice.xStride;
+                                
+                copyIntoFrameBuffer (readPtr, writePtr, endPtr,
+                                     slice.xStride,
+                                     slice.fill, slice.fillValue,
+                                     format,
+                                     slice.typeInFrameBuffer,
+                                     slice.typeInFile);
+            }
+        }
+    }
+}
+
+
 } // namespace
 
 
@@ -237,6 +426,11 @@ struct TiledInputFile::Data: public Mutex
 
     bool            memoryMapped;                   // if the stream is memory mapped
 
+    bool            statelessRead;                  // if tile buffer tasks read
+                                                    // their own data from the stream
+
+    ThreadPool *    threadPool;                     // runs the tile buffer tasks
+
     InputStreamMutex * _streamData;
     bool                _deleteStream;
 
@@ -256,6 +450,8 @@ TiledInputFile::Data::Data (int numThreads):
     multiPartBackwardSupport(false),
     numThreads(numThreads),
     memoryMapped(false),
+    statelessRead(false),
+    threadPool(&globalThreadPool()),
     _streamData(NULL),
     _deleteStream(false)
 {
@@ -399,6 +595,85 @@ readTileData (InputStreamMutex *streamData,
 }
 
 
+void
+readTileDataAt (InputStreamMutex *streamData,
+                TiledInputFile::Data *ifd,
+                int dx, int dy,
+                int lx, int ly,
+                char *buffer,
+                int &dataSize)
+{
+    //
+    // Read a single tile block from the file using stateless reads.
+    // Unlike readTileData(), this function neither uses nor changes
+    // the stream's reading position, so it can be called by tile
+    // buffer tasks in parallel, without holding the stream lock.
+    //
+
+    Int64 tileOffset = ifd->tileOffsets (dx, dy, lx, ly);
+
+    if (tileOffset == 0)
+    {
+        THROW (IEX_NAMESPACE::InputExc, "Tile (" << dx << ", " << dy << ", " <<
+			      lx << ", " << ly << ") is missing.");
+    }
+
+    //
+    // Read the tile's header: the part number (in a multi-part
+    // file), the tile coordinates, the level numbers and the
+    // data size.
+    //
+
+    bool multiPart = isMultiPart (ifd->version);
+    int headerSize = (multiPart? 6: 5) * Xdr::size<int>();
+
+    char header[6 * sizeof (int)];
+    streamData->is->readAt (header, headerSize, tileOffset);
+
+    const char *readPtr = header;
+    int tileXCoord, tileYCoord, levelX, levelY;
+
+    if (multiPart)
+    {
+        int partNumber;
+        Xdr::read <CharPtrIO> (readPtr, partNumber);
+
+        if (partNumber != ifd->partNumber)
+        {
+            THROW (IEX_NAMESPACE::ArgExc, "Unexpected part number " << partNumber
+                   << ", should be " << ifd->partNumber << ".");
+        }
+    }
+
+    Xdr::read <CharPtrIO> (readPtr, tileXCoord);
+    Xdr::read <CharPtrIO> (readPtr, tileYCoord);
+    Xdr::read <CharPtrIO> (readPtr, levelX);
+    Xdr::read <CharPtrIO> (readPtr, levelY);
+    Xdr::read <CharPtrIO> (readPtr, dataSize);
+
+    if (tileXCoord != dx)
+        throw IEX_NAMESPACE::InputExc ("Unexpected tile x coordinate.");
+
+    if (tileYCoord != dy)
+        throw IEX_NAMESPACE::InputExc ("Unexpected tile y coordinate.");
+
+    if (levelX != lx)
+        throw IEX_NAMESPACE::InputExc ("Unexpected tile x level number coordinate.");
+
+    if (levelY != ly)
+        throw IEX_NAMESPACE::InputExc ("Unexpected tile y level number coordinate.");
+
+    if (dataSize < 0 || dataSize > (int) ifd->tileBufferSize)
+        throw IEX_NAMESPACE::InputExc ("Unexpected tile block length.");
+
+    //
+    // Read the pixel data.
+    //
+
+    streamData->is->readAt (buffer, dataSize, tileOffset + headerSize);
+}
+
+
 void
 readNextTileData (InputStreamMutex *streamData,
                   TiledInputFile::Data *ifd,
@@ -459,7 +734,7 @@ class TileBufferTask : public Task
 {
   public:
 
-    TileBufferTask (TaskGroup *group,
+    TileBufferTask (AsyncRead::Data *request,
                     TiledInputFile::Data *ifd,
 		    TileBuffer *tileBuffer);
                     
@@ -469,17 +744,19 @@ class TileBufferTask : public Task
     
   private:
 
+    AsyncRead::Data *		_request;
     TiledInputFile::Data *	_ifd;
     TileBuffer *		_tileBuffer;
 };
 
 
 TileBufferTask::TileBufferTask
-    (TaskGroup *group,
+    (AsyncRead::Data *request,
      TiledInputFile::Data *ifd,
      TileBuffer *tileBuffer)
 :
-    Task (group),
+    Task (request->taskGroup),
+    _request (request),
     _ifd (ifd),
     _tileBuffer (tileBuffer)
 {
@@ -494,6 +771,7 @@ TileBufferTask::~TileBufferTask ()
     //
 
     _tileBuffer->post ();
+    _request->finishTask ();
 }
 
 
@@ -502,6 +780,21 @@ TileBufferTask::execute ()
 {
     try
     {
+        //
+        // Read the data, if this task is responsible for it
+        //
+
+        if (_tileBuffer->readPending)
+        {
+            _tileBuffer->readPending = false;
+
+            readTileDataAt (_ifd->_streamData, _ifd,
+                            _tileBuffer->dx, _tileBuffer->dy,
+                            _tileBuffer->lx, _tileBuffer->ly,
+                            _tileBuffer->buffer,
+                            _tileBuffer->dataSize);
+        }
+
         //
         // Calculate information about the tile
         //
@@ -550,94 +843,26 @@ TileBufferTask::execute ()
         // Convert the tile of pixel data back from the machine-independent
 	// representation, and store the result in the frame buffer.
         //
-    
-        const char *readPtr = _tileBuffer->uncompressedData;
-                                                        // points to where we
-                                                        // read from in the
-                                                        // tile block
-        
-        //
-        // Iterate over the scan lines in the tile.
-        //
-    
-        for (int y = tileRange.min.y; y <= tileRange.max.y; ++y)
-        {
-            //
-            // Iterate over all image channels.
-            //
-            
-            for (unsigned int i = 0; i < _ifd->slices.size(); ++i)
-            {
-                const TInSliceInfo &slice = _ifd->slices[i];
-    
-                //
-                // These offsets are used to facilitate both
-                // absolute and tile-relative pixel coordinates.
-                //
-            
-                int xOffset = slice.xTileCoords * tileRange.min.x;
-                int yOffset = slice.yTileCoords * tileRange.min.y;
-    
-                //
-                // Fill the frame buffer with pixel data.
-                //
-    
-                if (slice.skip)
-                {
-                    //
-                    // The file contains data for this channel, but
-                    // the frame buffer contains no slice for this channel.
-                    //
-    
-                    skipChannel (readPtr, slice.typeInFile,
-                                 numPixelsPerScanLine);
-                }
-                else
-                {
-                    //
-                    // The frame buffer contains a slice for this channel.
-                    //
-    
-                    char *writePtr = slice.base +
-                                     (y - yOffset) * slice.yStride +
-                                     (tileRange.min.x - xOffset) *
-                                     slice.xStride;
-
-                    char *endPtr = writePtr +
-                                   (numPixelsPerScanLine - 1) * slice.xStride;
-                                    
-                    copyIntoFrameBuffer (readPtr, writePtr, endPtr,
-                                         slice.xStride,
-                                         slice.fill, slice.fillValue,
-                                         _tileBuffer->format,
-                                         slice.typeInFrameBuffer,
-                                         slice.typeInFile);
-                }
-            }
-        }
+
+        copyTileIntoFrameBuffer (_ifd->slices,
+                                 _tileBuffer->uncompressedData,
+                                 _tileBuffer->format,
+                                 tileRange);
     }
     catch (std::exception &e)
     {
-        if (!_tileBuffer->hasException)
-        {
-            _tileBuffer->exception = e.what ();
-            _tileBuffer->hasException = true;
-        }
+        _request->setException (e.what ());
     }
     catch (...)
     {
-        if (!_tileBuffer->hasException)
-        {
-            _tileBuffer->exception = "unrecognized exception";
-            _tileBuffer->hasException = true;
-        }
+        _request->setException ("unrecognized exception");
     }
 }
 
 
 TileBufferTask *
 newTileBufferTask
-    (TaskGroup *group,
+    (AsyncRead::Data *request,
      InputStreamMutex *streamData,
      TiledInputFile::Data *ifd,
      int number,
@@ -665,9 +890,22 @@ newTileBufferTask
 
 	tileBuffer->uncompressedData = 0;
 
-	readTileData (streamData, ifd, dx, dy, lx, ly,
-		      tileBuffer->buffer,
-		      tileBuffer->dataSize);
+	if (ifd->statelessRead)
+	{
+	    //
+	    // Let the tile buffer task read the data; this way
+	    // several tasks can fetch their data from the file
+	    // at the same time.
+	    //
+
+	    tileBuffer->readPending = true;
+	}
+	else
+	{
+	    readTileData (streamData, ifd, dx, dy, lx, ly,
+			  tileBuffer->buffer,
+			  tileBuffer->dataSize);
+	}
     }
     catch (...)
     {
@@ -681,16 +919,22 @@ newTileBufferTask
 	throw;
     }
 
-    return new TileBufferTask (group, ifd, tileBuffer);
+    TileBufferTask *task = new TileBufferTask (request, ifd, tileBuffer);
+    request->addTask();
+
+    return task;
 }
 
 
 } // namespace
 
 
-TiledInputFile::TiledInputFile (const char fileName[], int numThreads):
+TiledInputFile::TiledInputFile (const char fileName[],
+                                int numThreads,
+                                ThreadPool &threadPool):
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_streamData=NULL;
     _data->_deleteStream=true;
     
@@ -763,9 +1007,12 @@ TiledInputFile::TiledInputFile (const char fileName[], int numThreads):
 }
 
 
-TiledInputFile::TiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int numThreads):
+TiledInputFile::TiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is,
+                                int numThreads,
+                                ThreadPool &threadPool):
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_deleteStream=false;
     //
     // This constructor is called when a user
@@ -795,6 +1042,8 @@ TiledInputFile::TiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int
         // file is guaranteed to be single part, regular image
         _data->tileOffsets.readFrom (*(_data->_streamData->is), _data->fileIsComplete,false,false);
 	_data->memoryMapped = _data->_streamData->is->isMemoryMapped();
+	_data->statelessRead = !_data->memoryMapped &&
+			       _data->_streamData->is->isStatelessRead();
 	_data->_streamData->currentPosition = _data->_streamData->is->tellg();
     }
     catch (IEX_NAMESPACE::BaseExc &e)
@@ -818,9 +1067,11 @@ TiledInputFile::TiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int
 TiledInputFile::TiledInputFile (const Header &header,
                                 OPENEXR_IMF_INTERNAL_NAMESPACE::IStream *is,
                                 int version,
-                                int numThreads) :
+                                int numThreads,
+                                ThreadPool &threadPool) :
     _data (new Data (numThreads))
 {
+    _data->threadPool = &threadPool;
     _data->_deleteStream=false;
     _data->_streamData = new InputStreamMutex();
     //
@@ -837,6 +1088,7 @@ TiledInputFile::TiledInputFile (const Header &header,
     initialize();
     _data->tileOffsets.readFrom (*(_data->_streamData->is),_data->fileIsComplete,false,false);
     _data->memoryMapped = is->isMemoryMapped();
+    _data->statelessRead = !_data->memoryMapped && is->isStatelessRead();
     _data->_streamData->currentPosition = _data->_streamData->is->tellg();
 }
 
@@ -859,7 +1111,8 @@ TiledInputFile::compatibilityInitialize(OPENEXR_IMF_INTERNAL_NAMESPACE::IStream&
     // (TODO) maybe change the third parameter of the constructor of MultiPartInputFile later.
     //
     _data->multiPartBackwardSupport = true;
-    _data->multiPartFile = new MultiPartInputFile(is, _data->numThreads);
+    _data->multiPartFile = new MultiPartInputFile(is, _data->numThreads, true,
+                                                  *_data->threadPool);
     InputPartData* part = _data->multiPartFile->getPart(0);
 
     multiPartInitialize(part);
@@ -876,7 +1129,10 @@ TiledInputFile::multiPartInitialize(InputPartData* part)
     _data->header = part->header;
     _data->version = part->version;
     _data->partNumber = part->partNumber;
+    _data->threadPool = part->threadPool;
     _data->memoryMapped = _data->_streamData->is->isMemoryMapped();
+    _data->statelessRead = !_data->memoryMapped &&
+                           _data->_streamData->is->isStatelessRead();
     initialize();
     _data->tileOffsets.readFrom(part->chunkOffsets,_data->fileIsComplete);
     _data->_streamData->currentPosition = _data->_streamData->is->tellg();
@@ -949,7 +1205,7 @@ TiledInputFile::initialize ()
 
     for (size_t i = 0; i < _data->tileBuffers.size(); i++)
     {
-        _data->tileBuffers[i] = new TileBuffer (newTileCompressor
+        _data->tileBuffers[i] = new TileBuffer (borrowTileCompressor
 						  (_data->header.compression(),
 						   _data->maxBytesPerTileLine,
 						   _data->tileDesc.ySize,
@@ -969,6 +1225,8 @@ TiledInputFile::initialize ()
 
 TiledInputFile::~TiledInputFile ()
 {
+    waitForTileBufferTasks();
+
     if (!_data->memoryMapped)
         for (size_t i = 0; i < _data->tileBuffers.size(); i++)
             delete [] _data->tileBuffers[i]->buffer;
@@ -1009,109 +1267,40 @@ TiledInputFile::setFrameBuffer (const FrameBuffer &frameBuffer)
 {
     Lock lock (*_data->_streamData);
 
+    waitForTileBufferTasks();
+
     //
     // Set the frame buffer
     //
 
     //
-    // Check if the new frame buffer descriptor is
-    // compatible with the image file header.
+    // Initialize the slice table for readPixels().
     //
 
-    const ChannelList &channels = _data->header.channels();
-
-    for (FrameBuffer::ConstIterator j = frameBuffer.begin();
-         j != frameBuffer.end();
-         ++j)
-    {
-        ChannelList::ConstIterator i = channels.find (j.name());
-
-        if (i == channels.end())
-            continue;
-
-        if (i.channel().xSampling != j.slice().xSampling ||
-            i.channel().ySampling != j.slice().ySampling)
-            THROW (IEX_NAMESPACE::ArgExc, "X and/or y subsampling factors "
-				"of \"" << i.name() << "\" channel "
-				"of input file \"" << fileName() << "\" are "
-				"not compatible with the frame buffer's "
-				"subsampling factors.");
-    }
+    vector<TInSliceInfo> slices;
+    sliceTable (_data->header.channels(), frameBuffer, fileName(), slices);
 
     //
-    // Initialize the slice table for readPixels().
+    // Tell the compressors which channels are in the frame buffer,
+    // so that they can skip the others when they uncompress a tile.
     //
 
-    vector<TInSliceInfo> slices;
-    ChannelList::ConstIterator i = channels.begin();
+    ChannelList channelsToDecode;
+    const ChannelList &channels = _data->header.channels();
 
-    for (FrameBuffer::ConstIterator j = frameBuffer.begin();
-         j != frameBuffer.end();
-         ++j)
+    for (ChannelList::ConstIterator i = channels.begin();
+         i != channels.end();
+         ++i)
     {
-        while (i != channels.end() && strcmp (i.name(), j.name()) < 0)
-        {
-            //
-            // Channel i is present in the file but not
-            // in the frame buffer; data for channel i
-            // will be skipped during readPixels().
-            //
-
-            slices.push_back (TInSliceInfo (i.channel().type,
-					    i.channel().type,
-					    0,      // base
-					    0,      // xStride
-					    0,      // yStride
-					    false,  // fill
-					    true,   // skip
-					    0.0));  // fillValue
-            ++i;
-        }
-
-        bool fill = false;
-
-        if (i == channels.end() || strcmp (i.name(), j.name()) > 0)
-        {
-            //
-            // Channel i is present in the frame buffer, but not in the file.
-            // In the frame buffer, slice j will be filled with a default value.
-            //
-
-            fill = true;
-        }
-
-        slices.push_back (TInSliceInfo (j.slice().type,
-                                        fill? j.slice().type: i.channel().type,
-                                        j.slice().base,
-                                        j.slice().xStride,
-                                        j.slice().yStride,
-                                        fill,
-                                        false, // skip
-                                        j.slice().fillValue,
-                                        (j.slice().xTileCoords)? 1: 0,
-                                        (j.slice().yTileCoords)? 1: 0));
-
-        if (i != channels.end() && !fill)
-            ++i;
+        if (frameBuffer.findSlice (i.name()))
+            channelsToDecode.insert (i.name(), i.channel());
     }
 
-    while (i != channels.end())
+    for (size_t i = 0; i < _data->tileBuffers.size(); ++i)
     {
-	//
-	// Channel i is present in the file but not
-	// in the frame buffer; data for channel i
-	// will be skipped during readPixels().
-	//
-
-	slices.push_back (TInSliceInfo (i.channel().type,
-					i.channel().type,
-					0, // base
-					0, // xStride
-					0, // yStride
-					false,  // fill
-					true, // skip
-					0.0)); // fillValue
-	++i;
+        if (_data->tileBuffers[i]->compressor)
+            _data->tileBuffers[i]->compressor->setChannelsToDecode
+                (channelsToDecode);
     }
 
     //
@@ -1138,6 +1327,126 @@ TiledInputFile::isComplete () const
 }
 
 
+void
+TiledInputFile::readTileBuffers (AsyncRead::Data *request,
+                                 int dx1, int dx2, int dy1, int dy2,
+                                 int lx, int ly)
+{
+    if (_data->slices.size() == 0)
+        throw IEX_NAMESPACE::ArgExc ("No frame buffer specified "
+                           "as pixel data destination.");
+
+    if (!isValidLevel (lx, ly))
+        THROW (IEX_NAMESPACE::ArgExc,
+               "Level coordinate "
+               "(" << lx << ", " << ly << ") "
+               "is invalid.");
+
+    //
+    // Determine the first and last tile coordinates in both dimensions.
+    // We always attempt to read the range of tiles in the order that
+    // they are stored in the file.
+    //
+
+    if (dx1 > dx2)
+        std::swap (dx1, dx2);
+
+    if (dy1 > dy2)
+        std::swap (dy1, dy2);
+
+    //
+    // Check the whole range of tiles before we create any tasks.
+    //
+
+    if (!isValidTile (dx1, dy1, lx, ly))
+        THROW (IEX_NAMESPACE::ArgExc,
+               "Tile (" << dx1 << ", " << dy1 << ", " <<
+               lx << "," << ly << ") is not a valid tile.");
+
+    if (!isValidTile (dx2, dy2, lx, ly))
+        THROW (IEX_NAMESPACE::ArgExc,
+               "Tile (" << dx2 << ", " << dy2 << ", " <<
+               lx << "," << ly << ") is not a valid tile.");
+
+    int dyStart = dy1;
+    int dyStop  = dy2 + 1;
+    int dY      = 1;
+
+    if (_data->lineOrder == DECREASING_Y)
+    {
+        dyStart = dy2;
+        dyStop  = dy1 - 1;
+        dY      = -1;
+    }
+
+    //
+    // Add the tile buffer tasks to the request's task group.
+    //
+    // The tasks are handed to the thread pool in batches of
+    // one task per tile buffer, because creating a task may
+    // have to wait for the previous user of its tile buffer.
+    //
+
+    int tileNumber = 0;
+    vector<Task *> tasks;
+    tasks.reserve (_data->tileBuffers.size());
+
+    try
+    {
+        for (int dy = dyStart; dy != dyStop; dy += dY)
+        {
+            for (int dx = dx1; dx <= dx2; dx++)
+            {
+                tasks.push_back (newTileBufferTask (request,
+                                                    _data->_streamData,
+                                                    _data,
+                                                    tileNumber++,
+                                                    dx, dy,
+                                                    lx, ly));
+
+                if (tasks.size() == _data->tileBuffers.size())
+                {
+                    _data->threadPool->addTasks (&tasks[0], tasks.size());
+                    tasks.clear();
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        //
+        // The request waits for the tasks we created
+        // so far; make sure they all run.
+        //
+
+        if (!tasks.empty())
+            _data->threadPool->addTasks (&tasks[0], tasks.size());
+
+        throw;
+    }
+
+    if (!tasks.empty())
+        _data->threadPool->addTasks (&tasks[0], tasks.size());
+}
+
+
+void
+TiledInputFile::waitForTileBufferTasks ()
+{
+    //
+    // Wait until the tasks of earlier asynchronous reads have
+    // released all tile buffers.  Until then those tasks may
+    // still be writing into the frame buffer.
+    //
+
+    for (size_t i = 0; i < _data->tileBuffers.size(); ++i)
+    {
+        _data->tileBuffers[i]->wait();
+        _data->tileBuffers[i]->post();
+    }
+}
+
+
 void
 TiledInputFile::readTiles (int dx1, int dx2, int dy1, int dy2, int lx, int ly)
 {
@@ -1149,71 +1458,22 @@ TiledInputFile::readTiles (int dx1, int dx2, int dy1, int dy2, int lx, int ly)
     {
         Lock lock (*_data->_streamData);
 
-        if (_data->slices.size() == 0)
-            throw IEX_NAMESPACE::ArgExc ("No frame buffer specified "
-			       "as pixel data destination.");
-        
-        if (!isValidLevel (lx, ly))
-            THROW (IEX_NAMESPACE::ArgExc,
-                   "Level coordinate "
-                   "(" << lx << ", " << ly << ") "
-                   "is invalid.");
-
         //
-        // Determine the first and last tile coordinates in both dimensions.
-        // We always attempt to read the range of tiles in the order that
-        // they are stored in the file.
+        // Create a request for the tile buffer tasks.  When the
+        // request goes out of scope, its destructor waits until
+        // all tasks are complete.
         //
-                               
-        if (dx1 > dx2)
-            std::swap (dx1, dx2);
-        
-        if (dy1 > dy2)
-            std::swap (dy1, dy2);
-        
-        int dyStart = dy1;
-	int dyStop  = dy2 + 1;
-	int dY      = 1;
 
-        if (_data->lineOrder == DECREASING_Y)
-        {
-            dyStart = dy2;
-            dyStop  = dy1 - 1;
-            dY      = -1;
-        }
+        AsyncRead request (new AsyncRead::Data (fileName(), 0, 0));
+
+        readTileBuffers (request.data(), dx1, dx2, dy1, dy2, lx, ly);
 
         //
-        // Create a task group for all tile buffer tasks.  When the
-	// task group goes out of scope, the destructor waits until
-	// all tasks are complete.
+        // finish all tasks
         //
-        
-        {
-            TaskGroup taskGroup;
-            int tileNumber = 0;
-    
-            for (int dy = dyStart; dy != dyStop; dy += dY)
-            {
-                for (int dx = dx1; dx <= dx2; dx++)
-                {
-                    if (!isValidTile (dx, dy, lx, ly))
-                        THROW (IEX_NAMESPACE::ArgExc,
-			       "Tile (" << dx << ", " << dy << ", " <<
-			       lx << "," << ly << ") is not a valid tile.");
-                    
-                    ThreadPool::addGlobalTask (newTileBufferTask (&taskGroup,
-                                                                  _data->_streamData,
-                                                                  _data,
-                                                                  tileNumber++,
-                                                                  dx, dy,
-                                                                  lx, ly));
-                }
-            }
 
-	    //
-            // finish all tasks
-	    //
-        }
+        request.data()->finishTask();
+        request.data()->waitForTasks();
 
 	//
 	// Exeption handling:
@@ -1222,28 +1482,63 @@ TiledInputFile::readTiles (int dx1, int dx2, int dy1, int dy2, int lx, int ly)
 	// those exceptions occurred in another thread, not in the thread
 	// that is executing this call to TiledInputFile::readTiles().
 	// TileBufferTask::execute() has caught all exceptions and stored
-	// the exceptions' what() strings in the tile buffers.
-	// Now we check if any tile buffer contains a stored exception; if
-	// this is the case then we re-throw the exception in this thread.
-	// (It is possible that multiple tile buffers contain stored
-	// exceptions.  We re-throw the first exception we find and
-	// ignore all others.)
+	// the first exception's what() string in the request.  If there
+	// is a stored exception, we re-throw it in this thread.
 	//
 
-	const string *exception = 0;
+	if (request.data()->hasException)
+	    throw IEX_NAMESPACE::IoExc (request.data()->exception);
+    }
+    catch (IEX_NAMESPACE::BaseExc &e)
+    {
+        REPLACE_EXC (e, "Error reading pixel data from image "
+                        "file \"" << fileName() << "\". " << e);
+        throw;
+    }
+}
 
-        for (size_t i = 0; i < _data->tileBuffers.size(); ++i)
-	{
-            TileBuffer *tileBuffer = _data->tileBuffers[i];
 
-	    if (tileBuffer->hasException && !exception)
-		exception = &tileBuffer->exception;
+void	
+TiledInputFile::readTiles (int dx1, int dx2, int dy1, int dy2, int l)
+{
+    readTiles (dx1, dx2, dy1, dy2, l, l);
+}
 
-	    tileBuffer->hasException = false;
-	}
 
-	if (exception)
-	    throw IEX_NAMESPACE::IoExc (*exception);
+AsyncRead
+TiledInputFile::readTilesAsync (int dx1, int dx2, int dy1, int dy2,
+                                int lx, int ly,
+                                AsyncRead::Callback callback,
+                                void *userData)
+{
+    AsyncRead request (new AsyncRead::Data (fileName(), callback, userData));
+
+    try
+    {
+        Lock lock (*_data->_streamData);
+
+        //
+        // Invalid arguments are reported right away; errors while
+        // reading the data from the file are reported through the
+        // request, like errors in the tile buffer tasks.
+        //
+
+        try
+        {
+            readTileBuffers (request.data(), dx1, dx2, dy1, dy2, lx, ly);
+        }
+        catch (IEX_NAMESPACE::ArgExc &)
+        {
+            throw;
+        }
+        catch (std::exception &e)
+        {
+            request.data()->setException (e.what());
+        }
+        catch (...)
+        {
+            request.data()->setException ("unrecognized exception");
+        }
     }
     catch (IEX_NAMESPACE::BaseExc &e)
     {
@@ -1251,13 +1546,25 @@ TiledInputFile::readTiles (int dx1, int dx2, int dy1, int dy2, int lx, int ly)
                         "file \"" << fileName() << "\". " << e);
         throw;
     }
+
+    //
+    // Release the file's lock before the request can complete,
+    // so that the completion callback does not run while we
+    // hold the lock.
+    //
+
+    request.data()->finishTask();
+    return request;
 }
 
 
-void	
-TiledInputFile::readTiles (int dx1, int dx2, int dy1, int dy2, int l)
+AsyncRead
+TiledInputFile::readTilesAsync (int dx1, int dx2, int dy1, int dy2,
+                                int l,
+                                AsyncRead::Callback callback,
+                                void *userData)
 {
-    readTiles (dx1, dx2, dy1, dy2, l, l);
+    return readTilesAsync (dx1, dx2, dy1, dy2, l, l, callback, userData);
 }
 
 
@@ -1324,6 +1631,128 @@ TiledInputFile::rawTileData (int &dx, int &dy,
 }
 
 
+void
+TiledInputFile::readTile (const char *rawTileData,
+                          int rawTileDataSize,
+                          const FrameBuffer &frameBuffer,
+                          int dx, int dy,
+                          int lx, int ly) const
+{
+    try
+    {
+        decodeRawTileData (_data->header, rawTileData, rawTileDataSize,
+                           frameBuffer, dx, dy, lx, ly);
+    }
+    catch (IEX_NAMESPACE::BaseExc &e)
+    {
+        REPLACE_EXC (e, "Error decoding pixel data from image "
+			"file \"" << fileName() << "\". " << e);
+        throw;
+    }
+}
+
+
+void
+TiledInputFile::decodeRawTileData (const Header &header,
+                                   const char *rawTileData,
+                                   int rawTileDataSize,
+                                   const FrameBuffer &frameBuffer,
+                                   int dx, int dy,
+                                   int lx, int ly)
+{
+    if (!header.hasTileDescription())
+        throw IEX_NAMESPACE::ArgExc ("Cannot decode a tile of an image "
+                                     "without a tile description.");
+
+    const TileDescription &tileDesc = header.tileDescription();
+    const Box2i &dataWindow = header.dataWindow();
+
+    //
+    // Check the tile coordinates
+    //
+
+    int *numXTiles = 0;
+    int *numYTiles = 0;
+    int numXLevels;
+    int numYLevels;
+
+    precalculateTileInfo (tileDesc,
+                          dataWindow.min.x, dataWindow.max.x,
+                          dataWindow.min.y, dataWindow.max.y,
+                          numXTiles, numYTiles,
+                          numXLevels, numYLevels);
+
+    bool validTile = (lx < numXLevels && lx >= 0) &&
+                     (ly < numYLevels && ly >= 0) &&
+                     (dx < numXTiles[lx] && dx >= 0) &&
+                     (dy < numYTiles[ly] && dy >= 0);
+
+    delete [] numXTiles;
+    delete [] numYTiles;
+
+    if (!validTile)
+        throw IEX_NAMESPACE::ArgExc ("Tried to read a tile outside "
+                                     "the image file's data window.");
+
+    Box2i tileRange = OPENEXR_IMF_INTERNAL_NAMESPACE::dataWindowForTile (
+            tileDesc,
+            dataWindow.min.x, dataWindow.max.x,
+            dataWindow.min.y, dataWindow.max.y,
+            dx, dy, lx, ly);
+
+    size_t bytesPerPixel = calculateBytesPerPixel (header);
+
+    int sizeOfTile = bytesPerPixel *
+                     (tileRange.max.x - tileRange.min.x + 1) *
+                     (tileRange.max.y - tileRange.min.y + 1);
+
+    Compressor *compressor = borrowTileCompressor
+                                (header.compression(),
+                                 bytesPerPixel * tileDesc.xSize,
+                                 tileDesc.ySize,
+                                 header);
+
+    try
+    {
+        //
+        // Uncompress the data, if necessary.  If the tile is not
+        // compressed, it's in XDR format, regardless of the
+        // compressor's output format.
+        //
+
+        const char *uncompressedData = rawTileData;
+        int dataSize = rawTileDataSize;
+        Compressor::Format format = Compressor::XDR;
+
+        if (compressor && rawTileDataSize < sizeOfTile)
+        {
+            dataSize = compressor->uncompressTile (rawTileData,
+                                                   rawTileDataSize,
+                                                   tileRange,
+                                                   uncompressedData);
+            format = compressor->format();
+        }
+
+        if (dataSize < sizeOfTile)
+            throw IEX_NAMESPACE::InputExc ("Raw tile data are too small "
+                                           "for the tile.");
+
+        vector<TInSliceInfo> slices;
+        sliceTable (header.channels(), frameBuffer,
+                    "(raw tile data)", slices);
+
+        copyTileIntoFrameBuffer (slices, uncompressedData, format, tileRange);
+    }
+    catch (...)
+    {
+        returnCompressor (compressor);
+        throw;
+    }
+
+    returnCompressor (compressor);
+}
+
+
 unsigned int
 TiledInputFile::tileXSize () const
 {
@@ -48,6 +48,7 @@
 #include "ImfTileDescription.h"
 #include "ImfThreading.h"
 #include "ImfGenericInputFile.h"
+#include "ImfAsyncRead.h"
 #include "ImfTiledOutputFile.h"
 #include "ImfNamespace.h"
 #include "ImfExport.h"
@@ -64,14 +65,17 @@ class TiledInputFile : public GenericInputFile
     // reads the file header.  The constructor throws an IEX_NAMESPACE::ArgExc
     // exception if the file is not tiled.
     // The numThreads parameter specifies how many worker threads this
-    // file will try to keep busy when decompressing individual tiles.
+    // file will try to keep busy when decompressing individual tiles;
+    // the tiles are decompressed by tasks in threadPool.
     // Destroying TiledInputFile objects constructed with this constructor
     // automatically closes the corresponding files.
     //--------------------------------------------------------------------
 
     IMF_EXPORT
     TiledInputFile (const char fileName[],
-                    int numThreads = globalThreadCount ());
+                    int numThreads = globalThreadCount (),
+                    ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                        globalThreadPool ());
 
     
     // ----------------------------------------------------------
@@ -83,7 +87,9 @@ class TiledInputFile : public GenericInputFile
     // ----------------------------------------------------------
 
     IMF_EXPORT
-    TiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int numThreads = globalThreadCount ());
+    TiledInputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is, int numThreads = globalThreadCount (),
+                    ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                        globalThreadPool ());
 
 
     //-----------
@@ -374,6 +380,38 @@ class TiledInputFile : public GenericInputFile
                                    int l = 0);
 
 
+    //------------------------------------------------------------
+    // Read pixel data asynchronously:
+    //
+    // The readTilesAsync() functions hand the work for the
+    // corresponding readTiles() call to the file's thread pool
+    // and return without waiting for it to complete.  The returned
+    // AsyncRead can be used to wait for the read, or to check if
+    // it is complete; the callback, if it is not 0, is called with
+    // userData when the read completes.  Invalid tile or level
+    // coordinates are reported right away, other errors are
+    // reported by AsyncRead::wait().
+    //
+    // readTilesAsync() blocks while a tile buffer it needs is still
+    // in use by an earlier task, for instance if the range covers
+    // more tiles than the file has tile buffers (two per thread).
+    // See ImfAsyncRead.h for the rules for the frame buffer while
+    // a read is in flight.
+    //------------------------------------------------------------
+
+    IMF_EXPORT
+    AsyncRead		readTilesAsync (int dx1, int dx2, int dy1, int dy2,
+                                        int lx, int ly,
+                                        AsyncRead::Callback callback = 0,
+                                        void *userData = 0);
+
+    IMF_EXPORT
+    AsyncRead		readTilesAsync (int dx1, int dx2, int dy1, int dy2,
+                                        int l = 0,
+                                        AsyncRead::Callback callback = 0,
+                                        void *userData = 0);
+
+
     //--------------------------------------------------
     // Read a tile of raw pixel data from the file,
     // without uncompressing it (this function is
@@ -390,6 +428,38 @@ class TiledInputFile : public GenericInputFile
 				     const char *&pixelData,
 				     int &pixelDataSize);
 
+
+    //--------------------------------------------------------------
+    // Decode a tile of raw pixel data:
+    //
+    // readTile(rawTileData,rawTileDataSize,frameBuffer,dx,dy,lx,ly)
+    // uncompresses tile (dx,dy,lx,ly), as returned by rawTileData(),
+    // and stores its pixels in frameBuffer.
+    //
+    // decodeRawTileData() does the same, given only the header of
+    // the file that the tile came from; the file itself need not be
+    // open, for instance if the tile was read by another process.
+    //
+    // These calls do not block, and they are thread safe for
+    // clients with their own threading model.  The file's frame
+    // buffer is not used.
+    //--------------------------------------------------------------
+
+    IMF_EXPORT
+    void		readTile (const char *rawTileData,
+				  int rawTileDataSize,
+				  const FrameBuffer &frameBuffer,
+				  int dx, int dy,
+				  int lx, int ly) const;
+
+    IMF_EXPORT
+    static void		decodeRawTileData (const Header &header,
+					   const char *rawTileData,
+					   int rawTileDataSize,
+					   const FrameBuffer &frameBuffer,
+					   int dx, int dy,
+					   int lx, int ly);
+
     struct Data;
 
   private:
@@ -403,7 +473,7 @@ class TiledInputFile : public GenericInputFile
     TiledInputFile & operator = (const TiledInputFile &); // not implemented
 
     TiledInputFile (const Header &header, OPENEXR_IMF_INTERNAL_NAMESPACE::IStream *is, int version,
-                    int numThreads);
+                    int numThreads, ILMTHREAD_NAMESPACE::ThreadPool &threadPool);
 
     void		initialize ();
     void                multiPartInitialize(InputPartData* part);
@@ -412,6 +482,13 @@ class TiledInputFile : public GenericInputFile
     bool		isValidTile (int dx, int dy,
 				     int lx, int ly) const;
 
+    void		readTileBuffers (AsyncRead::Data *request,
+                                         int dx1, int dx2,
+                                         int dy1, int dy2,
+                                         int lx, int ly);
+
+    void		waitForTileBufferTasks ();
+
     size_t		bytesPerLineForTile (int dx, int dy,
 					     int lx, int ly) const;
 
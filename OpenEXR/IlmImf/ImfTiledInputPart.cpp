@@ -198,6 +198,23 @@ TiledInputPart::readTiles (int dx1, int dx2, int dy1, int dy2, int l)
     file->readTiles(dx1, dx2, dy1, dy2, l);
 }
 
+AsyncRead
+TiledInputPart::readTilesAsync (int dx1, int dx2, int dy1, int dy2,
+                                int lx, int ly,
+                                AsyncRead::Callback callback, void *userData)
+{
+    return file->readTilesAsync(dx1, dx2, dy1, dy2, lx, ly,
+                                callback, userData);
+}
+
+AsyncRead
+TiledInputPart::readTilesAsync (int dx1, int dx2, int dy1, int dy2,
+                                int l,
+                                AsyncRead::Callback callback, void *userData)
+{
+    return file->readTilesAsync(dx1, dx2, dy1, dy2, l, callback, userData);
+}
+
 void
 TiledInputPart::rawTileData (int &dx, int &dy, int &lx, int &ly,
              const char *&pixelData, int &pixelDataSize)
@@ -111,6 +111,16 @@ class TiledInputPart
         void                readTiles (int dx1, int dx2, int dy1, int dy2,
                                        int l = 0);
         IMF_EXPORT
+        AsyncRead           readTilesAsync (int dx1, int dx2, int dy1, int dy2,
+                                            int lx, int ly,
+                                            AsyncRead::Callback callback = 0,
+                                            void *userData = 0);
+        IMF_EXPORT
+        AsyncRead           readTilesAsync (int dx1, int dx2, int dy1, int dy2,
+                                            int l = 0,
+                                            AsyncRead::Callback callback = 0,
+                                            void *userData = 0);
+        IMF_EXPORT
         void                rawTileData (int &dx, int &dy,
                                          int &lx, int &ly,
                                          const char *&pixelData,
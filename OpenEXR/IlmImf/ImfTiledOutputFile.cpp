@@ -49,6 +49,7 @@
 #include <ImfMisc.h>
 #include <ImfTiledMisc.h>
 #include <ImfStdIO.h>
+#include <ImfWriteBehindIO.h>
 #include <ImfCompressor.h>
 #include "ImathBox.h"
 #include <ImfArray.h>
@@ -68,6 +69,7 @@
 #include <fstream>
 #include <assert.h>
 #include <map>
+#include <stdio.h>
 #include <algorithm>
 
 #include "ImfNamespace.h"
@@ -173,17 +175,27 @@ struct TileCoord
 
 struct BufferedTile
 {
-    char *	pixelData;
+    char *	pixelData;		// 0 if the tile is in the spill file
     int		pixelDataSize;
+    Int64	spillPosition;		// position in the spill file
 
     BufferedTile (const char *data, int size):
 	pixelData (0),
-	pixelDataSize(size)
+	pixelDataSize(size),
+	spillPosition (0)
     {
 	pixelData = new char[pixelDataSize];
 	memcpy (pixelData, data, pixelDataSize);
     }
 
+    BufferedTile (Int64 position, int size):
+	pixelData (0),
+	pixelDataSize(size),
+	spillPosition (position)
+    {
+	// empty
+    }
+
     ~BufferedTile()
     {
 	delete [] pixelData;
@@ -191,6 +203,88 @@ struct BufferedTile
 };
 
 
+//
+// A TileSpillFile holds out-of-order tiles that do not fit into
+// the memory limit set with TiledOutputFile::setTileBufferLimit().
+// The file is an anonymous temporary file; the operating system
+// deletes it when it is closed.  Tiles are only ever appended; the
+// space is not reused until the TiledOutputFile is destroyed.
+//
+
+class TileSpillFile
+{
+  public:
+
+     TileSpillFile ();
+    ~TileSpillFile ();
+
+    Int64		write (const char data[], int size);
+    void		read (Int64 position, char data[], int size);
+
+  private:
+
+    void		seek (Int64 position);
+
+    FILE *		_file;
+    Int64		_size;
+};
+
+
+TileSpillFile::TileSpillFile (): _file (tmpfile()), _size (0)
+{
+    if (_file == 0)
+	IEX_NAMESPACE::throwErrnoExc ("Cannot create temporary file "
+				      "for out-of-order tiles (%T).");
+}
+
+
+TileSpillFile::~TileSpillFile ()
+{
+    fclose (_file);
+}
+
+
+void
+TileSpillFile::seek (Int64 position)
+{
+    #if defined _WIN32 || defined _WIN64
+	int status = _fseeki64 (_file, position, SEEK_SET);
+    #else
+	int status = fseeko (_file, position, SEEK_SET);
+    #endif
+
+    if (status != 0)
+	IEX_NAMESPACE::throwErrnoExc ("Cannot seek in temporary file "
+				      "for out-of-order tiles (%T).");
+}
+
+
+Int64
+TileSpillFile::write (const char data[], int size)
+{
+    Int64 position = _size;
+    seek (position);
+
+    if (fwrite (data, 1, size, _file) != size_t (size))
+	IEX_NAMESPACE::throwErrnoExc ("Cannot write to temporary file "
+				      "for out-of-order tiles (%T).");
+
+    _size += size;
+    return position;
+}
+
+
+void
+TileSpillFile::read (Int64 position, char data[], int size)
+{
+    seek (position);
+
+    if (fread (data, 1, size, _file) != size_t (size))
+	IEX_NAMESPACE::throwErrnoExc ("Cannot read from temporary file "
+				      "for out-of-order tiles (%T).");
+}
+
+
 typedef map <TileCoord, BufferedTile *> TileMap;
 
 
@@ -274,8 +368,21 @@ struct TiledOutputFile::Data
     TileMap		tileMap;
     TileCoord		nextTileToWrite;
 
+    size_t		tileBufferLimit;	// max. bytes of out-of-order
+						// tiles in memory, or 0
+    size_t		bufferedTileBytes;	// bytes of tiles in tileMap,
+						// not counting spilled tiles
+    size_t		peakBufferedTileBytes;	// max. of bufferedTileBytes
+    Int64		spilledTileBytes;	// bytes moved to spillFile
+    TileSpillFile *	spillFile;		// created on first use
+    vector<char>	spillBuffer;		// spilled tile read back
+
     int                 partNumber;             // the output part number
 
+    ThreadPool *        threadPool;             // runs the tile buffer tasks
+    WriteBehindOStream * writeBehindStream;     // wraps the output stream
+                                                // if write-behind is on
+
      Data (int numThreads);
     ~Data ();
     
@@ -293,7 +400,14 @@ TiledOutputFile::Data::Data (int numThreads):
     numXTiles(0),
     numYTiles(0),
     tileOffsetsPosition (0),
-    partNumber(-1)
+    tileBufferLimit (0),
+    bufferedTileBytes (0),
+    peakBufferedTileBytes (0),
+    spilledTileBytes (0),
+    spillFile (0),
+    partNumber(-1),
+    threadPool(&globalThreadPool()),
+    writeBehindStream(0)
 {
     //
     // We need at least one tileBuffer, but if threading is used,
@@ -316,6 +430,8 @@ TiledOutputFile::Data::~Data ()
     for (TileMap::iterator i = tileMap.begin(); i != tileMap.end(); ++i)
 	delete i->second;
 
+    delete spillFile;
+
     for (size_t i = 0; i < tileBuffers.size(); i++)
         delete tileBuffers[i];
 }
@@ -565,12 +681,35 @@ bufferedTileWrite (OutputStreamMutex *streamData,
             // Write the tile, and then delete the tile's buffered data
             //
 
+            const BufferedTile *tile = i->second;
+            const char *tileData = tile->pixelData;
+
+            if (tileData)
+            {
+                ofd->bufferedTileBytes -= tile->pixelDataSize;
+            }
+            else
+            {
+                //
+                // The tile was moved to the spill file; read it back.
+                //
+
+                if (ofd->spillBuffer.size() < size_t (tile->pixelDataSize))
+                    ofd->spillBuffer.resize (tile->pixelDataSize);
+
+                ofd->spillFile->read (tile->spillPosition,
+                                      &ofd->spillBuffer[0],
+                                      tile->pixelDataSize);
+
+                tileData = &ofd->spillBuffer[0];
+            }
+
             writeTileData (streamData,
                            ofd,
 			   i->first.dx, i->first.dy,
 			   i->first.lx, i->first.ly,
-			   i->second->pixelData,
-			   i->second->pixelDataSize);
+			   tileData,
+			   tile->pixelDataSize);
 
             delete i->second;
             ofd->tileMap.erase (i);
@@ -587,11 +726,34 @@ bufferedTileWrite (OutputStreamMutex *streamData,
     {
         //
         // Create a new BufferedTile, copy the pixelData into it, and
-        // insert it into the tileMap.
+        // insert it into the tileMap.  If the tile does not fit into
+        // the memory limit, copy the pixelData into the spill file
+        // instead.
         //
 
-	ofd->tileMap[currentTile] =
-	    new BufferedTile ((const char *)pixelData, pixelDataSize);
+        if (ofd->tileBufferLimit > 0 &&
+            ofd->bufferedTileBytes + pixelDataSize > ofd->tileBufferLimit)
+        {
+            if (ofd->spillFile == 0)
+                ofd->spillFile = new TileSpillFile;
+
+            Int64 position = ofd->spillFile->write (pixelData, pixelDataSize);
+
+            ofd->tileMap[currentTile] =
+                new BufferedTile (position, pixelDataSize);
+
+            ofd->spilledTileBytes += pixelDataSize;
+        }
+        else
+        {
+            ofd->tileMap[currentTile] =
+                new BufferedTile ((const char *)pixelData, pixelDataSize);
+
+            ofd->bufferedTileBytes += pixelDataSize;
+
+            ofd->peakBufferedTileBytes = max (ofd->peakBufferedTileBytes,
+                                              ofd->bufferedTileBytes);
+        }
     }
 }
 
@@ -855,12 +1017,15 @@ TileBufferTask::execute ()
 TiledOutputFile::TiledOutputFile
     (const char fileName[],
      const Header &header,
-     int numThreads)
+     int numThreads,
+     ThreadPool &threadPool)
 :
     _data (new Data (numThreads)),
     _streamData (new OutputStreamMutex()),
     _deleteStream (true)
 {
+    _data->threadPool = &threadPool;
+
     try
     {
 	header.sanityCheck (true);
@@ -895,12 +1060,15 @@ TiledOutputFile::TiledOutputFile
 TiledOutputFile::TiledOutputFile
     (OPENEXR_IMF_INTERNAL_NAMESPACE::OStream &os,
      const Header &header,
-     int numThreads)
+     int numThreads,
+     ThreadPool &threadPool)
 :
     _data (new Data (numThreads)),
     _streamData (new OutputStreamMutex()),
     _deleteStream (false)
 {
+    _data->threadPool = &threadPool;
+
     try
     {
 	header.sanityCheck(true);
@@ -942,6 +1110,7 @@ TiledOutputFile::TiledOutputFile(const OutputPartData* part) :
 
         _streamData = part->mutex;
         _data = new Data(part->numThreads);
+        _data->threadPool = part->threadPool;
         _data->multipart=part->multipart;
         initialize(part->header);
         _data->partNumber = part->partNumber;
@@ -1079,6 +1248,17 @@ TiledOutputFile::~TiledOutputFile ()
             }
         }
         
+        if (_data->writeBehindStream)
+        {
+            //
+            // Wait for the queued data, and detach
+            // the write-behind stream from the file.
+            //
+
+            _streamData->os = &_data->writeBehindStream->stream();
+            delete _data->writeBehindStream;
+        }
+
         if (_deleteStream && _streamData)
             delete _streamData->os;
 
@@ -1258,11 +1438,11 @@ TiledOutputFile::writeTiles (int dx1, int dx2, int dy1, int dy2,
 
             while (nextCompBuffer < numTasks)
             {
-                ThreadPool::addGlobalTask (new TileBufferTask (&taskGroup,
-                                                               _data,
-                                                               nextCompBuffer++,
-                                                               dxComp, dyComp,
-                                                               lx, ly));
+                _data->threadPool->addTask (new TileBufferTask (&taskGroup,
+                                                                _data,
+                                                                nextCompBuffer++,
+                                                                dxComp, dyComp,
+                                                                lx, ly));
                 dxComp++;
 
                 if (dxComp > dx2)
@@ -1318,7 +1498,7 @@ TiledOutputFile::writeTiles (int dx1, int dx2, int dy1, int dy2,
                     // add nextCompBuffer as a compression Task
 		    //
 
-                    ThreadPool::addGlobalTask
+                    _data->threadPool->addTask
 			(new TileBufferTask (&taskGroup,
 					     _data,
 					     nextCompBuffer,
@@ -1410,6 +1590,112 @@ TiledOutputFile::writeTile (int dx, int dy, int l)
 }
 
 
+void
+TiledOutputFile::setWriteBehind (size_t maxBytesInFlight)
+{
+    Lock lock (*_streamData);
+
+    if (_data->partNumber != -1)
+    {
+        THROW (IEX_NAMESPACE::ArgExc, "Cannot use write-behind for "
+               "part " << _data->partNumber << " of image file "
+               "\"" << fileName() << "\".  Write-behind is only "
+               "available for single-part files.");
+    }
+
+    if (maxBytesInFlight > 0)
+    {
+        if (_data->writeBehindStream)
+        {
+            _data->writeBehindStream->setMaxBytesInFlight (maxBytesInFlight);
+        }
+        else
+        {
+            _data->writeBehindStream =
+                new WriteBehindOStream (*_streamData->os,
+                                        maxBytesInFlight,
+                                        *_data->threadPool);
+
+            _streamData->os = _data->writeBehindStream;
+        }
+    }
+    else if (_data->writeBehindStream)
+    {
+        WriteBehindOStream *writeBehindStream = _data->writeBehindStream;
+
+        _data->writeBehindStream = 0;
+        _streamData->os = &writeBehindStream->stream();
+
+        try
+        {
+            writeBehindStream->flush();
+        }
+        catch (IEX_NAMESPACE::BaseExc &e)
+        {
+            delete writeBehindStream;
+
+            REPLACE_EXC (e, "Failed to write pixel data to image "
+                            "file \"" << fileName() << "\". " << e);
+            throw;
+        }
+
+        delete writeBehindStream;
+    }
+}
+
+
+size_t
+TiledOutputFile::writeBehind () const
+{
+    Lock lock (*_streamData);
+
+    if (_data->writeBehindStream)
+        return _data->writeBehindStream->maxBytesInFlight();
+
+    return 0;
+}
+
+
+void
+TiledOutputFile::setTileBufferLimit (size_t maxBytes)
+{
+    Lock lock (*_streamData);
+    _data->tileBufferLimit = maxBytes;
+}
+
+
+size_t
+TiledOutputFile::tileBufferLimit () const
+{
+    Lock lock (*_streamData);
+    return _data->tileBufferLimit;
+}
+
+
+size_t
+TiledOutputFile::bufferedTileBytes () const
+{
+    Lock lock (*_streamData);
+    return _data->bufferedTileBytes;
+}
+
+
+size_t
+TiledOutputFile::peakBufferedTileBytes () const
+{
+    Lock lock (*_streamData);
+    return _data->peakBufferedTileBytes;
+}
+
+
+Int64
+TiledOutputFile::spilledTileBytes () const
+{
+    Lock lock (*_streamData);
+    return _data->spilledTileBytes;
+}
+
+
 void	
 TiledOutputFile::copyPixels (TiledInputFile &in)
 {
@@ -83,12 +83,16 @@ class TiledOutputFile : public GenericOutputFile
     // same order as they are in the file tends to be significantly
     // faster than reading the tiles in random order (see writeTile,
     // below).
+    //
+    // The tiles are compressed by tasks in threadPool.
     //-------------------------------------------------------------------
     
     IMF_EXPORT
     TiledOutputFile (const char fileName[],
 		     const Header &header,
-                     int numThreads = globalThreadCount ());
+                     int numThreads = globalThreadCount (),
+                     ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                         globalThreadPool ());
 
 
     // ----------------------------------------------------------------
@@ -101,7 +105,9 @@ class TiledOutputFile : public GenericOutputFile
     IMF_EXPORT
     TiledOutputFile (OPENEXR_IMF_INTERNAL_NAMESPACE::OStream &os,
 		     const Header &header,
-                     int numThreads = globalThreadCount ());
+                     int numThreads = globalThreadCount (),
+                     ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                         globalThreadPool ());
 
 
     //-----------------------------------------------------
@@ -418,6 +424,68 @@ class TiledOutputFile : public GenericOutputFile
                                     int l = 0);
 
 
+    //------------------------------------------------------------------
+    // Write-behind:
+    //
+    // setWriteBehind(n), with n > 0, lets writeTile() and writeTiles()
+    // hand the compressed tiles to a task in the file's thread pool,
+    // which writes them to the file in the background, instead of
+    // writing them before they return.  At most n bytes of compressed
+    // data are queued.  setWriteBehind(0) waits until all queued data
+    // have been written, and turns write-behind off.  writeBehind()
+    // returns the current limit, or 0.
+    //
+    // Errors are reported as for OutputFile::setWriteBehind().
+    // Write-behind is not available for parts of multi-part files.
+    //------------------------------------------------------------------
+
+    IMF_EXPORT
+    void		setWriteBehind (size_t maxBytesInFlight);
+
+    IMF_EXPORT
+    size_t		writeBehind () const;
+
+
+    //------------------------------------------------------------------
+    // Buffering of out-of-order tiles:
+    //
+    // If the file's line order is INCREASING_Y or DECREASING_Y, then
+    // a tile that is written before all of the tiles that precede it
+    // in the file is kept in memory until it can be stored.  Writing
+    // the tiles in random order may keep most of the image in memory
+    // that way.  (Files whose line order is RANDOM_Y store every tile
+    // right away, and never buffer any tiles.)
+    //
+    // setTileBufferLimit(n) limits the memory for out-of-order tiles
+    // to n bytes of compressed data.  Once the limit has been reached,
+    // further out-of-order tiles are moved to an anonymous temporary
+    // file until they can be stored in the image file.  n == 0, the
+    // default, means that there is no limit.  Tiles that are already
+    // in memory when the limit changes stay in memory.
+    //
+    // bufferedTileBytes() returns the number of bytes of tile data
+    // that are currently buffered in memory, and peakBufferedTileBytes()
+    // returns the largest number of bytes that have been buffered in
+    // memory at any time.  spilledTileBytes() returns the total number
+    // of bytes that have been moved to the temporary file.
+    //------------------------------------------------------------------
+
+    IMF_EXPORT
+    void		setTileBufferLimit (size_t maxBytes);
+
+    IMF_EXPORT
+    size_t		tileBufferLimit () const;
+
+    IMF_EXPORT
+    size_t		bufferedTileBytes () const;
+
+    IMF_EXPORT
+    size_t		peakBufferedTileBytes () const;
+
+    IMF_EXPORT
+    Int64		spilledTileBytes () const;
+
+
     //------------------------------------------------------------------
     // Shortcut to copy all pixels from a TiledInputFile into this file,
     // without uncompressing and then recompressing the pixel data.
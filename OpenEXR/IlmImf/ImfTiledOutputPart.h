@@ -109,6 +109,16 @@ class TiledOutputPart
         void                writeTiles (int dx1, int dx2, int dy1, int dy2,
                                         int l = 0);
         IMF_EXPORT
+        void                setTileBufferLimit (size_t maxBytes);
+        IMF_EXPORT
+        size_t              tileBufferLimit () const;
+        IMF_EXPORT
+        size_t              bufferedTileBytes () const;
+        IMF_EXPORT
+        size_t              peakBufferedTileBytes () const;
+        IMF_EXPORT
+        Int64               spilledTileBytes () const;
+        IMF_EXPORT
         void                copyPixels (TiledInputFile &in);
         IMF_EXPORT
         void                copyPixels (InputFile &in);
@@ -46,6 +46,7 @@
 
 
 #include <ImfWav.h>
+#include "ImfSimd.h"
 #include "ImfNamespace.h"
 
 OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
@@ -134,6 +135,185 @@ wdec16 (unsigned short  l, unsigned short  h,
     a = aa;
 }
 
+
+#ifdef IMF_HAVE_SSE2
+
+//
+// The same basis functions, for eight pairs of values at a time.
+// The results are bit-for-bit identical to the scalar functions,
+// including for data that did not come from wav2Encode():
+//
+// wenc14: (as + bs) >> 1 is computed without overflowing 16 bits
+// as (as >> 1) + (bs >> 1) + (as & bs & 1); the result of the
+// scalar code always fits into a short.  The other results are
+// truncated to 16 bits in the scalar code, so wrap-around 16-bit
+// arithmetic yields the same values.
+//
+// wenc16: adding A_OFFSET modulo 1 << 16 flips the sign bit, d < 0
+// if ao < b, and the floor of the unsigned average is the rounded
+// up average minus the lowest bit of ao ^ b.
+//
+
+const __m128i SIGN_BIT = _mm_set1_epi16 (short (0x8000));
+const __m128i ONE = _mm_set1_epi16 (1);
+
+
+inline void
+wenc14 (__m128i a, __m128i b, __m128i &l, __m128i &h)
+{
+    l = _mm_add_epi16 (_mm_add_epi16 (_mm_srai_epi16 (a, 1),
+                                      _mm_srai_epi16 (b, 1)),
+                       _mm_and_si128 (_mm_and_si128 (a, b), ONE));
+
+    h = _mm_sub_epi16 (a, b);
+}
+
+
+inline void
+wdec14 (__m128i l, __m128i h, __m128i &a, __m128i &b)
+{
+    a = _mm_add_epi16 (_mm_add_epi16 (l, _mm_and_si128 (h, ONE)),
+                       _mm_srai_epi16 (h, 1));
+
+    b = _mm_sub_epi16 (a, h);
+}
+
+
+inline void
+wenc16 (__m128i a, __m128i b, __m128i &l, __m128i &h)
+{
+    __m128i ao = _mm_xor_si128 (a, SIGN_BIT);
+
+    __m128i m = _mm_sub_epi16 (_mm_avg_epu16 (ao, b),
+                               _mm_and_si128 (_mm_xor_si128 (ao, b), ONE));
+
+    __m128i negative = _mm_cmplt_epi16 (a, _mm_xor_si128 (b, SIGN_BIT));
+
+    l = _mm_xor_si128 (m, _mm_and_si128 (negative, SIGN_BIT));
+    h = _mm_sub_epi16 (ao, b);
+}
+
+
+inline void
+wdec16 (__m128i l, __m128i h, __m128i &a, __m128i &b)
+{
+    b = _mm_sub_epi16 (l, _mm_srli_epi16 (h, 1));
+    a = _mm_xor_si128 (_mm_add_epi16 (h, b), SIGN_BIT);
+}
+
+
+//
+// Split 16 consecutive values into the values with even
+// indices and the values with odd indices, and back.
+//
+
+inline void
+deinterleave (const unsigned short *p, __m128i &even, __m128i &odd)
+{
+    __m128i v0 = _mm_loadu_si128 ((const __m128i *) p);
+    __m128i v1 = _mm_loadu_si128 ((const __m128i *) (p + 8));
+
+    even = _mm_packs_epi32 (_mm_srai_epi32 (_mm_slli_epi32 (v0, 16), 16),
+                            _mm_srai_epi32 (_mm_slli_epi32 (v1, 16), 16));
+
+    odd = _mm_packs_epi32 (_mm_srai_epi32 (v0, 16),
+                           _mm_srai_epi32 (v1, 16));
+}
+
+
+inline void
+interleave (__m128i even, __m128i odd, unsigned short *p)
+{
+    _mm_storeu_si128 ((__m128i *) p, _mm_unpacklo_epi16 (even, odd));
+    _mm_storeu_si128 ((__m128i *) (p + 8), _mm_unpackhi_epi16 (even, odd));
+}
+
+
+//
+// The first level of the 2D transform, where the four values
+// of each 2x2 block are adjacent in rows r0 and r1, for eight
+// blocks at a time.  The functions return the number of values
+// per row that they have transformed; the caller transforms the
+// remaining blocks.
+//
+
+template <bool W14>
+int
+encodeFirstLevel (unsigned short *r0, unsigned short *r1, int nx)
+{
+    int x = 0;
+
+    for (; x + 16 <= nx; x += 16)
+    {
+        __m128i a, b, c, d;
+        deinterleave (r0 + x, a, b);
+        deinterleave (r1 + x, c, d);
+
+        __m128i i00, i01, i10, i11;
+        __m128i o00, o01, o10, o11;
+
+        if (W14)
+        {
+            wenc14 (a, b, i00, i01);
+            wenc14 (c, d, i10, i11);
+            wenc14 (i00, i10, o00, o10);
+            wenc14 (i01, i11, o01, o11);
+        }
+        else
+        {
+            wenc16 (a, b, i00, i01);
+            wenc16 (c, d, i10, i11);
+            wenc16 (i00, i10, o00, o10);
+            wenc16 (i01, i11, o01, o11);
+        }
+
+        interleave (o00, o01, r0 + x);
+        interleave (o10, o11, r1 + x);
+    }
+
+    return x;
+}
+
+
+template <bool W14>
+int
+decodeFirstLevel (unsigned short *r0, unsigned short *r1, int nx)
+{
+    int x = 0;
+
+    for (; x + 16 <= nx; x += 16)
+    {
+        __m128i a, b, c, d;
+        deinterleave (r0 + x, a, b);
+        deinterleave (r1 + x, c, d);
+
+        __m128i i00, i01, i10, i11;
+        __m128i o00, o01, o10, o11;
+
+        if (W14)
+        {
+            wdec14 (a, c, i00, i10);
+            wdec14 (b, d, i01, i11);
+            wdec14 (i00, i01, o00, o01);
+            wdec14 (i10, i11, o10, o11);
+        }
+        else
+        {
+            wdec16 (a, c, i00, i10);
+            wdec16 (b, d, i01, i11);
+            wdec16 (i00, i01, o00, o01);
+            wdec16 (i10, i11, o10, o11);
+        }
+
+        interleave (o00, o01, r0 + x);
+        interleave (o10, o11, r1 + x);
+    }
+
+    return x;
+}
+
+#endif
+
 } // namespace
 
 
@@ -178,6 +358,23 @@ wav2Encode
 	    unsigned short *px = py;
 	    unsigned short *ex = py + ox * (nx - p2);
 
+#ifdef IMF_HAVE_SSE2
+
+	    //
+	    // On the first level, with adjacent x values,
+	    // most of the blocks can be done with SSE2
+	    //
+
+	    if (ox1 == 1)
+	    {
+		if (w14)
+		    px += encodeFirstLevel<true> (px, px + oy1, nx);
+		else
+		    px += encodeFirstLevel<false> (px, px + oy1, nx);
+	    }
+
+#endif
+
 	    //
 	    // X loop
 	    //
@@ -309,6 +506,18 @@ wav2Decode
 	    unsigned short *px = py;
 	    unsigned short *ex = py + ox * (nx - p2);
 
+#ifdef IMF_HAVE_SSE2
+
+	    if (ox1 == 1)
+	    {
+		if (w14)
+		    px += decodeFirstLevel<true> (px, px + oy1, nx);
+		else
+		    px += decodeFirstLevel<false> (px, px + oy1, nx);
+	    }
+
+#endif
+
 	    //
 	    // X loop
 	    //
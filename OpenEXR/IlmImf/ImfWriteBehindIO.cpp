@@ -0,0 +1,404 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------
+//
+//	Low-level file output that overlaps writing with the
+//	caller's work.
+//
+//-----------------------------------------------------------------------------
+
+#include <ImfWriteBehindIO.h>
+#include "IlmThreadPool.h"
+#include "IlmThreadMutex.h"
+#include "IlmThreadSemaphore.h"
+#include "Iex.h"
+
+#include <deque>
+#include <vector>
+#include <string>
+
+#include "ImfNamespace.h"
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+using ILMTHREAD_NAMESPACE::Mutex;
+using ILMTHREAD_NAMESPACE::Lock;
+using ILMTHREAD_NAMESPACE::Semaphore;
+using ILMTHREAD_NAMESPACE::Task;
+using ILMTHREAD_NAMESPACE::TaskGroup;
+using ILMTHREAD_NAMESPACE::ThreadPool;
+using std::deque;
+using std::vector;
+using std::string;
+
+
+namespace {
+
+//
+// Small writes, for example the chunk headers that precede the
+// pixel data, are appended to the last block in the queue until
+// the block has grown to this size.
+//
+
+const size_t BLOCK_SIZE = 65536;
+
+} // namespace
+
+
+struct WriteBehindOStream::Data
+{
+    OStream *		os;			// receives the data
+    ThreadPool *	threadPool;		// runs the writer task
+    Int64		position;		// current position, including
+						// queued data
+    size_t		maxBytesInFlight;
+
+    Mutex		mutex;			// protects the members below
+    deque< vector<char> > queue;		// blocks not yet taken by
+						// the writer task
+    size_t		bytesInFlight;		// bytes queued or being written
+    bool		writerActive;		// writer task has been started
+						// and has not finished yet
+    int			numWaiting;		// threads waiting for the
+						// writer task
+    Semaphore		writerProgress;		// posted once per waiting thread
+						// when the writer task makes
+						// progress
+    bool		hasException;
+    string		exception;
+
+    TaskGroup		taskGroup;		// declared last, so that its
+						// destructor waits for the
+						// writer task before the other
+						// members are destroyed
+
+     Data (OStream &os, size_t maxBytesInFlight, ThreadPool &threadPool);
+
+    void		waitForWriter (Lock &lock);
+    void		notifyWaiting ();
+    void		checkException ();
+};
+
+
+WriteBehindOStream::Data::Data (OStream &o,
+                                size_t m,
+                                ThreadPool &t)
+:
+    os (&o),
+    threadPool (&t),
+    position (o.tellp()),
+    maxBytesInFlight (m),
+    bytesInFlight (0),
+    writerActive (false),
+    numWaiting (0),
+    writerProgress (0),
+    hasException (false)
+{
+    // empty
+}
+
+
+void
+WriteBehindOStream::Data::waitForWriter (Lock &lock)
+{
+    //
+    // Called with the mutex locked; unlock it while we wait.
+    //
+
+    ++numWaiting;
+    lock.release();
+    writerProgress.wait();
+    lock.acquire();
+}
+
+
+void
+WriteBehindOStream::Data::notifyWaiting ()
+{
+    //
+    // Called with the mutex locked.
+    //
+
+    while (numWaiting > 0)
+    {
+        --numWaiting;
+        writerProgress.post();
+    }
+}
+
+
+void
+WriteBehindOStream::Data::checkException ()
+{
+    //
+    // Called with the mutex locked.  An exception that
+    // occurred in the writer task is re-thrown in every
+    // subsequent call; the stream is unusable afterwards.
+    //
+
+    if (hasException)
+        throw IEX_NAMESPACE::IoExc (exception);
+}
+
+
+namespace {
+
+//
+// A WriteBehindTask writes the queued blocks to the other
+// stream, in order, until the queue is empty.
+//
+
+class WriteBehindTask: public Task
+{
+  public:
+
+    WriteBehindTask (TaskGroup *group, WriteBehindOStream::Data *data);
+
+    virtual void	execute ();
+
+  private:
+
+    WriteBehindOStream::Data *	_data;
+};
+
+
+WriteBehindTask::WriteBehindTask (TaskGroup *group,
+                                  WriteBehindOStream::Data *data)
+:
+    Task (group),
+    _data (data)
+{
+    // empty
+}
+
+
+void
+WriteBehindTask::execute ()
+{
+    Lock lock (_data->mutex);
+
+    while (!_data->queue.empty())
+    {
+        vector<char> block;
+        block.swap (_data->queue.front());
+        _data->queue.pop_front();
+
+        //
+        // Write the block without holding the mutex, so that
+        // write() can queue more data in the meantime.
+        //
+
+        lock.release();
+
+        string exception;
+        bool failed = false;
+
+        try
+        {
+            _data->os->write (&block[0], int (block.size()));
+        }
+        catch (std::exception &e)
+        {
+            exception = e.what();
+            failed = true;
+        }
+        catch (...)
+        {
+            exception = "unrecognized exception";
+            failed = true;
+        }
+
+        lock.acquire();
+        _data->bytesInFlight -= block.size();
+
+        if (failed)
+        {
+            if (!_data->hasException)
+            {
+                _data->exception = exception;
+                _data->hasException = true;
+            }
+
+            //
+            // The data queued after the failed block cannot
+            // end up in the right place in the file anymore.
+            //
+
+            for (size_t i = 0; i < _data->queue.size(); ++i)
+                _data->bytesInFlight -= _data->queue[i].size();
+
+            _data->queue.clear();
+        }
+
+        _data->notifyWaiting();
+    }
+
+    _data->writerActive = false;
+    _data->notifyWaiting();
+}
+
+} // namespace
+
+
+WriteBehindOStream::WriteBehindOStream (OStream &os,
+                                        size_t maxBytesInFlight,
+                                        ThreadPool &threadPool)
+:
+    OPENEXR_IMF_INTERNAL_NAMESPACE::OStream (os.fileName()),
+    _data (new Data (os, maxBytesInFlight, threadPool))
+{
+    // empty
+}
+
+
+WriteBehindOStream::~WriteBehindOStream ()
+{
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+        //
+        // We cannot safely throw any exceptions from here.
+        // The exception has already been reported by the
+        // call that failed, or it is lost, because nobody
+        // called flush() before destroying the stream.
+        //
+    }
+
+    delete _data;
+}
+
+
+void
+WriteBehindOStream::write (const char c[/*n*/], int n)
+{
+    Lock lock (_data->mutex);
+    _data->checkException();
+
+    //
+    // Wait until there is room for the new data.
+    //
+
+    while (_data->bytesInFlight > 0 &&
+           _data->bytesInFlight + n > _data->maxBytesInFlight)
+    {
+        _data->waitForWriter (lock);
+        _data->checkException();
+    }
+
+    if (_data->queue.empty() || _data->queue.back().size() >= BLOCK_SIZE)
+        _data->queue.push_back (vector<char>());
+
+    vector<char> &block = _data->queue.back();
+    block.insert (block.end(), c, c + n);
+
+    _data->bytesInFlight += n;
+    _data->position += n;
+
+    if (!_data->writerActive)
+    {
+        //
+        // Start a writer task.  If the thread pool has no worker
+        // threads, addTask() runs the task right away, so the
+        // mutex must be unlocked first.
+        //
+
+        _data->writerActive = true;
+        lock.release();
+
+        _data->threadPool->addTask
+            (new WriteBehindTask (&_data->taskGroup, _data));
+    }
+}
+
+
+Int64
+WriteBehindOStream::tellp ()
+{
+    Lock lock (_data->mutex);
+    return _data->position;
+}
+
+
+void
+WriteBehindOStream::seekp (Int64 pos)
+{
+    flush();
+
+    Lock lock (_data->mutex);
+    _data->os->seekp (pos);
+    _data->position = pos;
+}
+
+
+void
+WriteBehindOStream::flush ()
+{
+    Lock lock (_data->mutex);
+
+    while (_data->writerActive)
+        _data->waitForWriter (lock);
+
+    _data->checkException();
+}
+
+
+size_t
+WriteBehindOStream::maxBytesInFlight () const
+{
+    Lock lock (_data->mutex);
+    return _data->maxBytesInFlight;
+}
+
+
+void
+WriteBehindOStream::setMaxBytesInFlight (size_t maxBytesInFlight)
+{
+    Lock lock (_data->mutex);
+    _data->maxBytesInFlight = maxBytesInFlight;
+}
+
+
+OStream &
+WriteBehindOStream::stream () const
+{
+    return *_data->os;
+}
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef INCLUDED_IMF_WRITE_BEHIND_IO_H
+#define INCLUDED_IMF_WRITE_BEHIND_IO_H
+
+//-----------------------------------------------------------------------------
+//
+//	Low-level file output that overlaps writing with the
+//	caller's work.
+//
+//-----------------------------------------------------------------------------
+
+#include "ImfIO.h"
+#include "ImfThreading.h"
+#include "ImfNamespace.h"
+#include "ImfExport.h"
+#include "IlmThreadForward.h"
+
+#include <stddef.h>
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
+
+//-------------------------------------------------------------
+// class WriteBehindOStream -- an implementation of class
+// OPENEXR_IMF_INTERNAL_NAMESPACE::OStream that passes the
+// data to another OStream in the background.
+//
+// write() copies the data into a queue and returns; a task in
+// the given thread pool writes the queued data to the other
+// stream, in order.  The number of bytes that have been queued
+// but not yet written is limited to maxBytesInFlight; write()
+// waits for the background task when the limit would be
+// exceeded.  (A single write() that is larger than the limit
+// waits until the queue is empty.)
+//
+// seekp() and flush() wait until all queued data have been
+// written.  If writing to the other stream fails, the next
+// call to write(), seekp() or flush() throws an exception, and
+// all data queued after the failure are discarded.
+//
+// The other stream is only accessed by one thread at a time,
+// but not always by the thread that calls write().  If the
+// thread pool has no worker threads, the data are written
+// before write() returns.
+//-------------------------------------------------------------
+
+class WriteBehindOStream: public OPENEXR_IMF_INTERNAL_NAMESPACE::OStream
+{
+  public:
+
+    //-------------------------------------------------------
+    // A constructor that attaches the new WriteBehindOStream
+    // to stream os.  The current position of os becomes the
+    // current position of the WriteBehindOStream.
+    // The destructor waits until all queued data have been
+    // written, but it does not close os.
+    //-------------------------------------------------------
+
+    IMF_EXPORT
+    WriteBehindOStream (OPENEXR_IMF_INTERNAL_NAMESPACE::OStream &os,
+                        size_t maxBytesInFlight,
+                        ILMTHREAD_NAMESPACE::ThreadPool &threadPool =
+                            globalThreadPool());
+
+    IMF_EXPORT
+    virtual ~WriteBehindOStream ();
+
+    IMF_EXPORT
+    virtual void	write (const char c[/*n*/], int n);
+    IMF_EXPORT
+    virtual Int64	tellp ();
+    IMF_EXPORT
+    virtual void	seekp (Int64 pos);
+
+
+    //--------------------------------------------------------
+    // Wait until all queued data have been written to the
+    // other stream, and throw an exception if writing failed.
+    //--------------------------------------------------------
+
+    IMF_EXPORT
+    void		flush ();
+
+
+    //-------------------------------------------
+    // Query and change the in-flight byte limit
+    //-------------------------------------------
+
+    IMF_EXPORT
+    size_t		maxBytesInFlight () const;
+    IMF_EXPORT
+    void		setMaxBytesInFlight (size_t maxBytesInFlight);
+
+
+    //-------------------------------------------
+    // Access to the stream that receives the data
+    //-------------------------------------------
+
+    IMF_EXPORT
+    OPENEXR_IMF_INTERNAL_NAMESPACE::OStream &	stream () const;
+
+    struct Data;
+
+  private:
+
+    WriteBehindOStream (const WriteBehindOStream &);		 // not implemented
+    WriteBehindOStream & operator = (const WriteBehindOStream &); // not implemented
+
+    Data *		_data;
+};
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif
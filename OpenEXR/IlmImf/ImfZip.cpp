@@ -36,6 +36,7 @@
 #include "ImfCheckedArithmetic.h"
 #include "ImfNamespace.h"
 #include "ImfSimd.h"
+#include "ImfPixelCopySimd.h"
 #include "Iex.h"
 
 #include <math.h>
@@ -45,14 +46,16 @@ OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
 
 Imf::Zip::Zip(size_t maxRawSize):
     _maxRawSize(maxRawSize),
-    _tmpBuffer(0)
+    _tmpBuffer(0),
+    _level(Z_DEFAULT_COMPRESSION)
 {
     _tmpBuffer = new char[_maxRawSize];
 }
 
 Imf::Zip::Zip(size_t maxScanLineSize, size_t numScanLines):
     _maxRawSize(0),
-    _tmpBuffer(0)
+    _tmpBuffer(0),
+    _level(Z_DEFAULT_COMPRESSION)
 {
     _maxRawSize = uiMult (maxScanLineSize, numScanLines);
     _tmpBuffer  = new char[_maxRawSize];
@@ -77,117 +80,106 @@ Imf::Zip::maxCompressedSize()
                   size_t (100));
 }
 
+void
+Imf::Zip::setLevel (int level)
+{
+    if (level > Z_BEST_COMPRESSION)
+        level = Z_BEST_COMPRESSION;
+    else if (level < Z_NO_COMPRESSION)
+        level = Z_DEFAULT_COMPRESSION;
+
+    _level = level;
+}
+
 int
-Imf::Zip::compress(const char *raw, int rawSize, char *compressed)
+Imf::Zip::level () const
 {
-    //
-    // Reorder the pixel data.
-    //
+    return _level;
+}
 
-    {
-        char *t1 = _tmpBuffer;
-        char *t2 = _tmpBuffer + (rawSize + 1) / 2;
-        const char *stop = raw + rawSize;
-
-        while (true)
-        {
-            if (raw < stop)
-            *(t1++) = *(raw++);
-            else
-            break;
-
-            if (raw < stop)
-            *(t2++) = *(raw++);
-            else
-            break;
-        }
-    }
+namespace {
+
+//
+// The predictor replaces each byte, except the first one, with its
+// difference from the preceding byte, plus 128; reconstruct() sums
+// the differences again.  Both work in place.
+//
+
+void
+predict (char *buf, size_t n)
+{
+    unsigned char *t    = (unsigned char *) buf + 1;
+    unsigned char *stop = (unsigned char *) buf + n;
+    int p = t[-1];
+
+#ifdef IMF_HAVE_SSE2
 
     //
-    // Predictor.
+    // Each block of 16 bytes is shifted up by one byte to line up
+    // every byte with its predecessor; the lowest lane is filled
+    // in with the last (original) byte of the previous block.
     //
 
+    const __m128i c = _mm_set1_epi8 (-128);
+    __m128i vPrev = _mm_cvtsi32_si128 (p & 0xff);
+
+    for (; t + 16 <= stop; t += 16)
     {
-        unsigned char *t    = (unsigned char *) _tmpBuffer + 1;
-        unsigned char *stop = (unsigned char *) _tmpBuffer + rawSize;
-        int p = t[-1];
-
-        while (t < stop)
-        {
-            int d = int (t[0]) - p + (128 + 256);
-            p = t[0];
-            t[0] = d;
-            ++t;
-        }
+        __m128i d = _mm_loadu_si128 ((const __m128i *) t);
+        __m128i e = _mm_or_si128 (_mm_slli_si128 (d, 1), vPrev);
+
+        vPrev = _mm_srli_si128 (d, 15);
+        _mm_storeu_si128 ((__m128i *) t,
+                          _mm_add_epi8 (_mm_sub_epi8 (d, e), c));
     }
 
-    //
-    // Compress the data using zlib
-    //
+    p = _mm_cvtsi128_si32 (vPrev);
 
-    uLongf outSize = int(ceil(rawSize * 1.01)) + 100;
+#endif
 
-    if (Z_OK != ::compress ((Bytef *)compressed, &outSize,
-                (const Bytef *) _tmpBuffer, rawSize))
+    while (t < stop)
     {
-        throw Iex::BaseExc ("Data compression (zlib) failed.");
+        int d = int (t[0]) - p + (128 + 256);
+        p = t[0];
+        t[0] = d;
+        ++t;
     }
-
-    return outSize;
 }
 
-#ifdef IMF_HAVE_SSE4_1
 
-static void
-reconstruct_sse41(char *buf, size_t outSize)
+void
+reconstruct (char *buf, size_t n)
 {
-    static const size_t bytesPerChunk = sizeof(__m128i);
-    const size_t vOutSize = outSize / bytesPerChunk;
-
-    const __m128i c = _mm_set1_epi8(-128);
-    const __m128i shuffleMask = _mm_set1_epi8(15);
+    unsigned char *t    = (unsigned char *) buf + 1;
+    unsigned char *stop = (unsigned char *) buf + n;
 
-    // The first element doesn't have its high bit flipped during compression,
-    // so it must not be flipped here.  To make the SIMD loop nice and
-    // uniform, we pre-flip the bit so that the loop will unflip it again.
-    buf[0] += -128;
+#ifdef IMF_HAVE_SSE2
 
-    __m128i *vBuf = reinterpret_cast<__m128i *>(buf);
-    __m128i vPrev = _mm_setzero_si128();
-    for (size_t i=0; i<vOutSize; ++i)
-    {
-        __m128i d = _mm_add_epi8(_mm_loadu_si128(vBuf), c);
+    //
+    // Within each block of 16 bytes the sums are computed as a
+    // prefix sum in four steps.  Adding the last byte of the previous
+    // block to the lowest lane first carries it into all 16 sums,
+    // which avoids a byte broadcast (and the need for SSSE3).
+    //
 
-        // Compute the prefix sum of elements.
-        d = _mm_add_epi8(d, _mm_slli_si128(d, 1));
-        d = _mm_add_epi8(d, _mm_slli_si128(d, 2));
-        d = _mm_add_epi8(d, _mm_slli_si128(d, 4));
-        d = _mm_add_epi8(d, _mm_slli_si128(d, 8));
-        d = _mm_add_epi8(d, vPrev);
+    const __m128i c = _mm_set1_epi8 (-128);
+    __m128i vPrev = _mm_cvtsi32_si128 (t[-1]);
 
-        _mm_storeu_si128(vBuf++, d);
+    for (; t + 16 <= stop; t += 16)
+    {
+        __m128i d = _mm_add_epi8 (_mm_loadu_si128 ((const __m128i *) t), c);
 
-        // Broadcast the high byte in our result to all lanes of the prev
-        // value for the next iteration.
-        vPrev = _mm_shuffle_epi8(d, shuffleMask);
-    }
+        d = _mm_add_epi8 (d, vPrev);
+        d = _mm_add_epi8 (d, _mm_slli_si128 (d, 1));
+        d = _mm_add_epi8 (d, _mm_slli_si128 (d, 2));
+        d = _mm_add_epi8 (d, _mm_slli_si128 (d, 4));
+        d = _mm_add_epi8 (d, _mm_slli_si128 (d, 8));
 
-    unsigned char prev = _mm_extract_epi8(vPrev, 15);
-    for (size_t i=vOutSize*bytesPerChunk; i<outSize; ++i)
-    {
-        unsigned char d = prev + buf[i] - 128;
-        buf[i] = d;
-        prev = d;
+        _mm_storeu_si128 ((__m128i *) t, d);
+        vPrev = _mm_srli_si128 (d, 15);
     }
-}
-
-#else
 
-static void
-reconstruct_scalar(char *buf, size_t outSize)
-{
-    unsigned char *t    = (unsigned char *) buf + 1;
-    unsigned char *stop = (unsigned char *) buf + outSize;
+#endif
 
     while (t < stop)
     {
@@ -197,68 +189,63 @@ reconstruct_scalar(char *buf, size_t outSize)
     }
 }
 
-#endif
-
-
-#ifdef IMF_HAVE_SSE2
+} // namespace
 
-static void
-interleave_sse2(const char *source, size_t outSize, char *out)
+void
+Imf::Zip::preprocess (const char *raw, size_t rawSize, char *out)
 {
-    static const size_t bytesPerChunk = 2*sizeof(__m128i);
+    //
+    // Reorder the pixel data.
+    //
 
-    const size_t vOutSize = outSize / bytesPerChunk;
+    splitBytes (raw, rawSize, out);
 
-    const __m128i *v1 = reinterpret_cast<const __m128i *>(source);
-    const __m128i *v2 = reinterpret_cast<const __m128i *>(source + (outSize + 1) / 2);
-    __m128i *vOut = reinterpret_cast<__m128i *>(out);
+    //
+    // Predictor.
+    //
 
-    for (size_t i=0; i<vOutSize; ++i) {
-        __m128i a = _mm_loadu_si128(v1++);
-        __m128i b = _mm_loadu_si128(v2++);
+    if (rawSize > 0)
+        predict (out, rawSize);
+}
 
-        __m128i lo = _mm_unpacklo_epi8(a, b);
-        __m128i hi = _mm_unpackhi_epi8(a, b);
+void
+Imf::Zip::postprocess (char *buf, size_t size, char *raw)
+{
+    if (size == 0)
+        return;
 
-        _mm_storeu_si128(vOut++, lo);
-        _mm_storeu_si128(vOut++, hi);
-    }
+    //
+    // Predictor.
+    //
 
-    const char *t1 = reinterpret_cast<const char *>(v1);
-    const char *t2 = reinterpret_cast<const char *>(v2);
-    char *sOut = reinterpret_cast<char *>(vOut);
+    reconstruct (buf, size);
 
-    for (size_t i=vOutSize*bytesPerChunk; i<outSize; ++i)
-    {
-        *(sOut++) = (i%2==0) ? *(t1++) : *(t2++);
-    }
-}
+    //
+    // Reorder the pixel data.
+    //
 
-#else
+    mergeBytes (buf, size, raw);
+}
 
-static void
-interleave_scalar(const char *source, size_t outSize, char *out)
+int
+Imf::Zip::compress(const char *raw, int rawSize, char *compressed)
 {
-    const char *t1 = source;
-    const char *t2 = source + (outSize + 1) / 2;
-    char *s = out;
-    char *const stop = s + outSize;
+    preprocess (raw, rawSize, _tmpBuffer);
+
+    //
+    // Compress the data using zlib
+    //
 
-    while (true)
+    uLongf outSize = int(ceil(rawSize * 1.01)) + 100;
+
+    if (Z_OK != ::compress2 ((Bytef *)compressed, &outSize,
+                 (const Bytef *) _tmpBuffer, rawSize, _level))
     {
-        if (s < stop)
-            *(s++) = *(t1++);
-        else
-            break;
-
-        if (s < stop)
-            *(s++) = *(t2++);
-        else
-            break;
+        throw Iex::BaseExc ("Data compression (zlib) failed.");
     }
-}
 
-#endif
+    return outSize;
+}
 
 int
 Imf::Zip::uncompress(const char *compressed, int compressedSize,
@@ -281,23 +268,7 @@ Imf::Zip::uncompress(const char *compressed, int compressedSize,
         return outSize;
     }
 
-    //
-    // Predictor.
-    //
-#ifdef IMF_HAVE_SSE4_1
-    reconstruct_sse41(_tmpBuffer, outSize);
-#else
-    reconstruct_scalar(_tmpBuffer, outSize);
-#endif
-
-    //
-    // Reorder the pixel data.
-    //
-#ifdef IMF_HAVE_SSE2
-    interleave_sse2(_tmpBuffer, outSize, raw);
-#else
-    interleave_scalar(_tmpBuffer, outSize, raw);
-#endif
+    postprocess (_tmpBuffer, outSize, raw);
 
     return outSize;
 }
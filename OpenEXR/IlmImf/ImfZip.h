@@ -73,9 +73,32 @@ class Zip
         int uncompress(const char *compressed, int compressedSize,
                                                  char *raw);
 
+        //
+        // The zlib compression level used by compress(), from
+        // 0 (no compression) to 9 (best compression), or -1 for
+        // zlib's default level.  setLevel() clamps values above 9
+        // to 9 and replaces other negative values with -1.
+        //
+        IMF_EXPORT
+        void setLevel(int level);
+        IMF_EXPORT
+        int level() const;
+
+        //
+        // The byte reordering and predictor that compress() applies
+        // to the raw data before deflating them, and their inverse,
+        // for other compressors that use the same preprocessing.
+        // postprocess() overwrites the contents of buf.
+        //
+        IMF_EXPORT
+        static void preprocess(const char *raw, size_t rawSize, char *out);
+        IMF_EXPORT
+        static void postprocess(char *buf, size_t size, char *raw);
+
     private:
         size_t _maxRawSize;
         char  *_tmpBuffer;
+        int    _level;
 
         Zip();
         Zip(const Zip&);
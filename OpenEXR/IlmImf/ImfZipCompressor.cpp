@@ -42,6 +42,7 @@
 
 #include "ImfZipCompressor.h"
 #include "ImfCheckedArithmetic.h"
+#include "ImfStandardAttributes.h"
 #include "Iex.h"
 #include <zlib.h>
 #include "ImfNamespace.h"
@@ -61,6 +62,13 @@ ZipCompressor::ZipCompressor
     _zip(maxScanLineSize, numScanLines)
 {
     _outBuffer = new char[_zip.maxCompressedSize()];
+
+    //
+    // Check the header for a compression level attribute
+    //
+
+    if (hasZipCompressionLevel (hdr))
+        _zip.setLevel (zipCompressionLevel (hdr));
 }
 
 
@@ -0,0 +1,190 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------
+//
+//	class ZstdCompressor
+//
+//-----------------------------------------------------------------------------
+
+#include "OpenEXRConfig.h"
+
+#ifdef OPENEXR_IMF_HAVE_ZSTD
+
+#include "ImfZstdCompressor.h"
+#include "ImfZip.h"
+#include "ImfCheckedArithmetic.h"
+#include "ImfStandardAttributes.h"
+#include "Iex.h"
+#include <zstd.h>
+#include <algorithm>
+#include "ImfNamespace.h"
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+
+ZstdCompressor::ZstdCompressor
+    (const Header &hdr,
+     size_t maxScanLineSize,
+     size_t numScanLines)
+:
+    Compressor (hdr),
+    _numScanLines (numScanLines),
+    _maxRawSize (uiMult (maxScanLineSize, numScanLines)),
+    _maxCompressedSize (ZSTD_compressBound (_maxRawSize)),
+    _level (ZSTD_CLEVEL_DEFAULT),
+    _tmpBuffer (0),
+    _outBuffer (0),
+    _cctx (0),
+    _dctx (0)
+{
+    //
+    // The output buffer holds either compressed or uncompressed data
+    //
+
+    _tmpBuffer = new char[_maxRawSize];
+    _outBuffer = new char[std::max (_maxCompressedSize, _maxRawSize)];
+
+    //
+    // Check the header for a compression level attribute
+    //
+
+    if (hasZstdCompressionLevel (hdr))
+    {
+        _level = std::min (std::max (zstdCompressionLevel (hdr),
+                                     ZSTD_minCLevel()),
+                           ZSTD_maxCLevel());
+    }
+}
+
+
+ZstdCompressor::~ZstdCompressor ()
+{
+    ZSTD_freeCCtx (_cctx);
+    ZSTD_freeDCtx (_dctx);
+
+    delete [] _tmpBuffer;
+    delete [] _outBuffer;
+}
+
+
+int
+ZstdCompressor::numScanLines () const
+{
+    return _numScanLines;
+}
+
+
+int
+ZstdCompressor::compress (const char *inPtr,
+			  int inSize,
+			  int minY,
+			  const char *&outPtr)
+{
+    outPtr = _outBuffer;
+
+    //
+    // Special case - empty input buffer
+    //
+
+    if (inSize == 0)
+	return 0;
+
+    //
+    // The compression context is allocated on first use, so that
+    // compressors that only read files do not pay for it.
+    //
+
+    if (_cctx == 0)
+    {
+	_cctx = ZSTD_createCCtx();
+
+	if (_cctx == 0)
+	    throw IEX_NAMESPACE::BaseExc ("Cannot allocate zstd context.");
+    }
+
+    Zip::preprocess (inPtr, inSize, _tmpBuffer);
+
+    size_t outSize = ZSTD_compressCCtx (_cctx,
+					_outBuffer, _maxCompressedSize,
+					_tmpBuffer, inSize,
+					_level);
+
+    if (ZSTD_isError (outSize))
+	throw IEX_NAMESPACE::BaseExc ("Data compression (zstd) failed.");
+
+    return outSize;
+}
+
+
+int
+ZstdCompressor::uncompress (const char *inPtr,
+			    int inSize,
+			    int minY,
+			    const char *&outPtr)
+{
+    outPtr = _outBuffer;
+
+    //
+    // Special case - empty input buffer
+    //
+
+    if (inSize == 0)
+	return 0;
+
+    if (_dctx == 0)
+    {
+	_dctx = ZSTD_createDCtx();
+
+	if (_dctx == 0)
+	    throw IEX_NAMESPACE::BaseExc ("Cannot allocate zstd context.");
+    }
+
+    size_t outSize = ZSTD_decompressDCtx (_dctx,
+					  _tmpBuffer, _maxRawSize,
+					  inPtr, inSize);
+
+    if (ZSTD_isError (outSize))
+	throw IEX_NAMESPACE::InputExc ("Data decompression (zstd) failed.");
+
+    Zip::postprocess (_tmpBuffer, outSize, _outBuffer);
+
+    return outSize;
+}
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_SOURCE_EXIT
+
+#endif // OPENEXR_IMF_HAVE_ZSTD
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2014, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef INCLUDED_IMF_ZSTD_COMPRESSOR_H
+#define INCLUDED_IMF_ZSTD_COMPRESSOR_H
+
+//-----------------------------------------------------------------------------
+//
+//	class ZstdCompressor -- performs Zstandard compression, with the
+//	same byte reordering and predictor as the ZipCompressor
+//
+//-----------------------------------------------------------------------------
+
+#include "ImfCompressor.h"
+#include "ImfNamespace.h"
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_ENTER
+
+
+class ZstdCompressor: public Compressor
+{
+  public:
+
+    IMF_EXPORT
+    ZstdCompressor (const Header &hdr, 
+                    size_t maxScanLineSize,
+                    size_t numScanLines);
+
+    IMF_EXPORT
+    virtual ~ZstdCompressor ();
+
+    IMF_EXPORT
+    virtual int numScanLines () const;
+
+    IMF_EXPORT
+    virtual int	compress (const char *inPtr,
+			  int inSize,
+			  int minY,
+			  const char *&outPtr);
+
+    IMF_EXPORT
+    virtual int	uncompress (const char *inPtr,
+			    int inSize,
+			    int minY,
+			    const char *&outPtr);
+  private:
+
+    int			_numScanLines;
+    size_t		_maxRawSize;
+    size_t		_maxCompressedSize;
+    int			_level;
+    char *		_tmpBuffer;
+    char *		_outBuffer;
+    ZSTD_CCtx_s *	_cctx;
+    ZSTD_DCtx_s *	_dctx;
+};
+
+
+OPENEXR_IMF_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif
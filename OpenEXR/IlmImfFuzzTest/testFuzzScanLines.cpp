@@ -61,6 +61,7 @@
 // Handle the case when the custom namespace is not exposed
 #include <OpenEXRConfig.h>
 #include <ImfChannelList.h>
+#include <ImfCompressor.h>
 using namespace OPENEXR_IMF_INTERNAL_NAMESPACE;
 using namespace std;
 using namespace IMATH_NAMESPACE;
@@ -236,6 +237,9 @@ fuzzScanLines (int numThreads, Rand48 &random)
     {
         for (int comp = 0; comp < NUM_COMPRESSION_METHODS; ++comp)
         {
+            if (!isSupportedCompression (Compression (comp)))
+                continue;
+
             writeImage (goodFile, W, H, pixels, parts,Compression (comp));
             fuzzFile (goodFile, brokenFile, readImage, 5000, 3000, random);
         }
@@ -78,16 +78,30 @@
 #include "testCompositeDeepScanLine.h"
 #include "testMultiPartFileMixingBasic.h"
 #include "testInputPart.h"
+#include "testFileThreadPool.h"
+#include "testAsyncRead.h"
+#include "testPixelCopySimd.h"
 #include "testBackwardCompatibility.h"
 #include "testCopyMultiPartFile.h"
 #include "testPartHelper.h"
 #include "testOptimized.h"
 #include "testOptimizedInterleavePatterns.h"
+#include "testOptimizedMultiChannel.h"
+#include "testRawChunkDecode.h"
 #include "testBadTypeAttributes.h"
 #include "testFutureProofing.h"
 #include "testPartHelper.h"
 #include "testDwaCompressorSimd.h"
+#include "testDwaDcOnlyRead.h"
+#include "testDwaChannelSubset.h"
 #include "testRle.h"
+#include "testWriteBehind.h"
+#include "testTileBufferLimit.h"
+#include "testZipSimd.h"
+#include "testB44Simd.h"
+#include "testPxr24Simd.h"
+#include "testCompressorPool.h"
+#include "testZstdCompression.h"
 
 #include "tmpDir.h"
 #include "ImathRandom.h"
@@ -175,8 +189,11 @@ main (int argc, char *argv[])
     TEST (testStandardAttributes, "core");
     TEST (testOptimized, "basic");
     TEST (testOptimizedInterleavePatterns, "basic");
+    TEST (testOptimizedMultiChannel, "basic");
+    TEST (testRawChunkDecode, "basic");
     TEST (testYca, "basic");
     TEST (testTiledYa, "basic");
+    TEST (testTileBufferLimit, "basic");
     TEST (testNativeFormat, "basic");
     TEST (testMultiView, "basic");
     TEST (testIsComplete, "basic");
@@ -193,12 +210,23 @@ main (int argc, char *argv[])
     TEST (testMultiScanlinePartThreading, "multi");
     TEST (testMultiTiledPartThreading, "multi");
     TEST (testMultiPartThreading, "multi");
+    TEST (testFileThreadPool, "multi");
+    TEST (testAsyncRead, "multi");
+    TEST (testWriteBehind, "multi");
     TEST (testMultiPartApi, "multi");
     TEST (testMultiPartSharedAttributes, "multi");
     TEST (testCopyMultiPartFile, "multi");
     TEST (testBackwardCompatibility, "core");
     TEST (testFutureProofing, "core");
     TEST (testDwaCompressorSimd, "basic");
+    TEST (testDwaDcOnlyRead, "basic");
+    TEST (testDwaChannelSubset, "basic");
+    TEST (testPixelCopySimd, "basic");
+    TEST (testZipSimd, "basic");
+    TEST (testB44Simd, "basic");
+    TEST (testPxr24Simd, "basic");
+    TEST (testCompressorPool, "basic");
+    TEST (testZstdCompression, "basic");
     TEST (testRle, "core");
 
 
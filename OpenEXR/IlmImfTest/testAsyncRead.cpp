@@ -0,0 +1,416 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include <ImfOutputFile.h>
+#include <ImfInputFile.h>
+#include <ImfTiledOutputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfAsyncRead.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfArray.h>
+#include <IlmThreadPool.h>
+#include <IlmThreadMutex.h>
+#include <Iex.h>
+#include <half.h>
+#include <vector>
+#include <stdio.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+using ILMTHREAD_NAMESPACE::ThreadPool;
+using ILMTHREAD_NAMESPACE::Mutex;
+using ILMTHREAD_NAMESPACE::Lock;
+
+
+namespace {
+
+const int W = 117;
+const int H = 237;
+const int NUM_FILES = 3;
+
+
+struct Counter
+{
+    Counter (): count (0) {}
+
+    void
+    increment ()
+    {
+        Lock lock (mutex);
+        ++count;
+    }
+
+    int
+    value () const
+    {
+        Lock lock (mutex);
+        return count;
+    }
+
+    mutable Mutex	mutex;
+    int			count;
+};
+
+
+void
+countCompletion (void *userData)
+{
+    static_cast <Counter *> (userData)->increment();
+}
+
+
+void
+fillPixels (Array2D<half> &pixels, int seed)
+{
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+            pixels[y][x] = half ((x * 7 + y * 3 + seed * 11) % 100 / 10.0f);
+}
+
+
+void
+clearPixels (Array2D<half> &pixels)
+{
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+            pixels[y][x] = half (-1.0f);
+}
+
+
+void
+comparePixels (const Array2D<half> &p1, const Array2D<half> &p2)
+{
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+            assert (p1[y][x].bits() == p2[y][x].bits());
+}
+
+
+FrameBuffer
+frameBuffer (Array2D<half> &pixels)
+{
+    FrameBuffer fb;
+    fb.insert ("Y", Slice (HALF, (char *) &pixels[0][0],
+                           sizeof (half), sizeof (half) * W));
+    return fb;
+}
+
+
+Header
+makeHeader (bool tiled)
+{
+    Header header (W, H);
+    header.compression() = ZIP_COMPRESSION;
+    header.channels().insert ("Y", Channel (HALF));
+
+    if (tiled)
+        header.setTileDescription (TileDescription (32, 32, ONE_LEVEL));
+
+    return header;
+}
+
+
+string
+fileName (const string &tempDir, int i)
+{
+    char buf[64];
+    sprintf (buf, "imf_test_async_read_%d.exr", i);
+    return tempDir + buf;
+}
+
+
+void
+scanLineFiles (const string &tempDir, ThreadPool &pool)
+{
+    cout << "scan line files, " << pool.numThreads() << " threads" << endl;
+
+    Array2D<half> pixels[NUM_FILES];
+    Array2D<half> result[NUM_FILES];
+
+    for (int i = 0; i < NUM_FILES; ++i)
+    {
+        pixels[i].resizeErase (H, W);
+        result[i].resizeErase (H, W);
+        fillPixels (pixels[i], i);
+        clearPixels (result[i]);
+
+        OutputFile out (fileName (tempDir, i).c_str(),
+                        makeHeader (false), pool.numThreads(), pool);
+
+        out.setFrameBuffer (frameBuffer (pixels[i]));
+        out.writePixels (H);
+    }
+
+    //
+    // Keep reads from all files in flight at the same time,
+    // several for each file.
+    //
+
+    Counter counter;
+    int numReads = 0;
+
+    {
+        vector<InputFile *> in;
+        vector<AsyncRead> reads;
+
+        for (int i = 0; i < NUM_FILES; ++i)
+        {
+            in.push_back (new InputFile (fileName (tempDir, i).c_str(),
+                                         pool.numThreads(), false, pool));
+
+            in[i]->setFrameBuffer (frameBuffer (result[i]));
+        }
+
+        for (int y = 0; y < H; y += 40)
+        {
+            for (int i = 0; i < NUM_FILES; ++i)
+            {
+                reads.push_back (in[i]->readPixelsAsync
+                                    (y, min (y + 39, H - 1),
+                                     countCompletion, &counter));
+                ++numReads;
+            }
+        }
+
+        for (size_t i = 0; i < reads.size(); ++i)
+        {
+            reads[i].wait();
+            assert (reads[i].isComplete());
+        }
+
+        assert (counter.value() == numReads);
+
+        for (size_t i = 0; i < in.size(); ++i)
+            delete in[i];
+    }
+
+    for (int i = 0; i < NUM_FILES; ++i)
+        comparePixels (pixels[i], result[i]);
+
+    //
+    // Destroying the file waits for reads that are still in flight;
+    // so does destroying the last handle for a read.
+    //
+
+    {
+        clearPixels (result[0]);
+
+        AsyncRead read;
+        assert (read.isComplete());
+
+        {
+            InputFile in (fileName (tempDir, 0).c_str(),
+                          pool.numThreads(), false, pool);
+
+            in.setFrameBuffer (frameBuffer (result[0]));
+            AsyncRead r = in.readPixelsAsync (0, H - 1);
+            read = r;
+        }
+
+        comparePixels (pixels[0], result[0]);
+        read.wait();
+    }
+
+    for (int i = 0; i < NUM_FILES; ++i)
+        remove (fileName (tempDir, i).c_str());
+}
+
+
+void
+tiledFiles (const string &tempDir, ThreadPool &pool)
+{
+    cout << "tiled files, " << pool.numThreads() << " threads" << endl;
+
+    Array2D<half> pixels[NUM_FILES];
+    Array2D<half> result[NUM_FILES];
+
+    for (int i = 0; i < NUM_FILES; ++i)
+    {
+        pixels[i].resizeErase (H, W);
+        result[i].resizeErase (H, W);
+        fillPixels (pixels[i], i);
+        clearPixels (result[i]);
+
+        TiledOutputFile out (fileName (tempDir, i).c_str(),
+                             makeHeader (true), pool.numThreads(), pool);
+
+        out.setFrameBuffer (frameBuffer (pixels[i]));
+        out.writeTiles (0, out.numXTiles() - 1, 0, out.numYTiles() - 1);
+    }
+
+    Counter counter;
+    int numReads = 0;
+
+    {
+        vector<TiledInputFile *> in;
+        vector<AsyncRead> reads;
+
+        for (int i = 0; i < NUM_FILES; ++i)
+        {
+            in.push_back (new TiledInputFile (fileName (tempDir, i).c_str(),
+                                              pool.numThreads(), pool));
+
+            in[i]->setFrameBuffer (frameBuffer (result[i]));
+        }
+
+        for (int i = 0; i < NUM_FILES; ++i)
+        {
+            for (int dy = 0; dy < in[i]->numYTiles(); ++dy)
+            {
+                reads.push_back (in[i]->readTilesAsync
+                                    (0, in[i]->numXTiles() - 1, dy, dy, 0,
+                                     countCompletion, &counter));
+                ++numReads;
+            }
+        }
+
+        for (size_t i = 0; i < reads.size(); ++i)
+            reads[i].wait();
+
+        assert (counter.value() == numReads);
+
+        for (size_t i = 0; i < in.size(); ++i)
+            delete in[i];
+    }
+
+    for (int i = 0; i < NUM_FILES; ++i)
+        comparePixels (pixels[i], result[i]);
+
+    for (int i = 0; i < NUM_FILES; ++i)
+        remove (fileName (tempDir, i).c_str());
+}
+
+
+void
+errors (const string &tempDir, ThreadPool &pool)
+{
+    cout << "errors, " << pool.numThreads() << " threads" << endl;
+
+    Array2D<half> pixels (H, W);
+    fillPixels (pixels, 0);
+
+    string name = fileName (tempDir, 0);
+
+    {
+        //
+        // Write an incomplete file.
+        //
+
+        OutputFile out (name.c_str(), makeHeader (false),
+                        pool.numThreads(), pool);
+
+        out.setFrameBuffer (frameBuffer (pixels));
+        out.writePixels (H / 2);
+    }
+
+    InputFile in (name.c_str(), pool.numThreads(), false, pool);
+    in.setFrameBuffer (frameBuffer (pixels));
+
+    //
+    // Invalid arguments are reported right away.
+    //
+
+    try
+    {
+        in.readPixelsAsync (0, H);
+        assert (false);
+    }
+    catch (const IEX_NAMESPACE::ArgExc &)
+    {
+        // expected
+    }
+
+    //
+    // Errors while reading are reported by wait(), after
+    // the callback has been called.
+    //
+
+    Counter counter;
+    AsyncRead read = in.readPixelsAsync (0, H - 1, countCompletion, &counter);
+
+    try
+    {
+        read.wait();
+        assert (false);
+    }
+    catch (const IEX_NAMESPACE::IoExc &)
+    {
+        // expected
+    }
+
+    assert (read.isComplete());
+    assert (counter.value() == 1);
+
+    //
+    // The lines that are in the file can still be read.
+    //
+
+    in.readPixelsAsync (0, H / 4).wait();
+
+    remove (name.c_str());
+}
+
+} // namespace
+
+
+void
+testAsyncRead (const std::string &tempDir)
+{
+    try
+    {
+        cout << "Testing asynchronous reads" << endl;
+
+        int numThreads[] = {0, 1, 4};
+
+        for (int i = 0; i < 3; ++i)
+        {
+            ThreadPool pool (numThreads[i]);
+
+            scanLineFiles (tempDir, pool);
+            tiledFiles (tempDir, pool);
+            errors (tempDir, pool);
+        }
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
@@ -0,0 +1,336 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include "testB44Simd.h"
+
+#include <ImfB44Compressor.h>
+#include <ImfPixelCopySimd.h>
+#include <ImfHeader.h>
+#include <ImfChannelList.h>
+#include <ImathRandom.h>
+#include <half.h>
+#include <vector>
+#include <iostream>
+#include <string.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+
+
+namespace {
+
+const char *levelNames[] = {"baseline", "AVX2", "AVX-512"};
+
+
+//
+// Pixel data patterns for the HALF channels.  Each one steers
+// pack() towards a different range of shift values.
+//
+
+enum Pattern
+{
+    RANDOM_BITS,	// any bit pattern, including infinities and NaNs
+    SMOOTH,		// small differences, small shift values
+    NOISY,		// large differences, large shift values
+    FLAT,		// mostly constant areas, 3-byte blocks
+    NUM_PATTERNS
+};
+
+
+unsigned short
+pixelValue (Rand48 &rand, Pattern pattern, int x, int y)
+{
+    switch (pattern)
+    {
+      case RANDOM_BITS:
+
+        return (unsigned short) rand.nexti();
+
+      case SMOOTH:
+
+        return half (float (x * 0.01 + y * 0.02 +
+                            rand.nextf (-0.001, 0.001))).bits();
+
+      case NOISY:
+
+        return half (float (rand.nextf (-1000, 1000))).bits();
+
+      default:
+
+        if ((x / 4 + y / 4) % 5 == 0)
+            return half (float (rand.nextf (-1, 1))).bits();
+
+        return half (float ((x / 8) * 0.5 - 1)).bits();
+    }
+}
+
+
+Header
+makeHeader (int width, int height, bool withFloat)
+{
+    Header hdr (width, height);
+
+    hdr.channels().insert ("A", Channel (HALF));
+    hdr.channels().insert ("L", Channel (HALF, 1, 1, true));
+
+    if (withFloat)
+        hdr.channels().insert ("Z", Channel (FLOAT));
+
+    return hdr;
+}
+
+
+size_t
+lineSize (const Header &hdr)
+{
+    int width = hdr.dataWindow().max.x - hdr.dataWindow().min.x + 1;
+    size_t size = 0;
+
+    for (ChannelList::ConstIterator i = hdr.channels().begin();
+         i != hdr.channels().end();
+         ++i)
+    {
+        size += width * (i.channel().type == HALF? 2: 4);
+    }
+
+    return size;
+}
+
+
+void
+compressAll (const Header &hdr,
+             bool optFlatFields,
+             const vector<char> &raw,
+             vector<char> &compressed)
+{
+    B44Compressor comp (hdr, lineSize (hdr), 32, optFlatFields);
+
+    const char *outPtr;
+    int outSize = comp.compress (&raw[0], raw.size(), 0, outPtr);
+
+    compressed.assign (outPtr, outPtr + outSize);
+}
+
+
+void
+uncompressAll (const Header &hdr,
+               bool optFlatFields,
+               const vector<char> &compressed,
+               vector<char> &raw)
+{
+    B44Compressor comp (hdr, lineSize (hdr), 32, optFlatFields);
+
+    const char *outPtr;
+    int outSize = comp.uncompress (&compressed[0], compressed.size(),
+                                   0, outPtr);
+
+    raw.assign (outPtr, outPtr + outSize);
+}
+
+
+void
+testCompress (int width, int height, bool withFloat, Pattern pattern)
+{
+    //
+    // Compress and uncompress the same pixels with every
+    // instruction set level; the results must be identical
+    // to those of the baseline code.
+    //
+
+    Header hdr = makeHeader (width, height, withFloat);
+
+    Rand48 rand (width * 97 + height * 13 + pattern);
+    vector<char> raw;
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (ChannelList::ConstIterator i = hdr.channels().begin();
+             i != hdr.channels().end();
+             ++i)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                if (i.channel().type == HALF)
+                {
+                    unsigned short v = pixelValue (rand, pattern, x, y);
+                    raw.push_back (char (v));
+                    raw.push_back (char (v >> 8));
+                }
+                else
+                {
+                    for (int j = 0; j < 4; ++j)
+                        raw.push_back (char (rand.nexti()));
+                }
+            }
+        }
+    }
+
+    for (int flat = 0; flat < 2; ++flat)
+    {
+        SimdLevel maxLevel = maxSimdLevel();
+
+        setSimdLevel (SIMD_BASELINE);
+
+        vector<char> refCompressed;
+        vector<char> refRaw;
+
+        compressAll (hdr, flat, raw, refCompressed);
+        uncompressAll (hdr, flat, refCompressed, refRaw);
+
+        for (int l = SIMD_AVX2; l <= maxLevel; ++l)
+        {
+            setSimdLevel (SimdLevel (l));
+
+            vector<char> compressed;
+            vector<char> uncompressed;
+
+            compressAll (hdr, flat, raw, compressed);
+            assert (compressed == refCompressed);
+
+            uncompressAll (hdr, flat, refCompressed, uncompressed);
+            assert (uncompressed == refRaw);
+        }
+
+        setSimdLevel (maxLevel);
+    }
+}
+
+
+void
+testUnpack (Rand48 &rand)
+{
+    //
+    // Uncompress streams of random blocks, including blocks
+    // whose shift values are too large for the vectorized
+    // unpacking code, and compare the results with the
+    // baseline code.
+    //
+
+    const int width = 64;
+    const int height = 32;
+
+    Header hdr (width, height);
+    hdr.channels().insert ("A", Channel (HALF));
+
+    for (int n = 0; n < 20; ++n)
+    {
+        vector<char> compressed;
+
+        for (int i = 0; i < (width / 4) * (height / 4); ++i)
+        {
+            unsigned char b[14];
+
+            for (int j = 0; j < 14; ++j)
+                b[j] = (unsigned char) rand.nexti();
+
+            if (rand.nexti() % 4 == 0)
+            {
+                b[2] = 0xfc;
+                compressed.insert (compressed.end(), b, b + 3);
+            }
+            else
+            {
+                if (b[2] == 0xfc)
+                    b[2] = 0;
+                else if (rand.nexti() % 4 != 0)
+                    b[2] &= 0x3f;
+
+                compressed.insert (compressed.end(), b, b + 14);
+            }
+        }
+
+        SimdLevel maxLevel = maxSimdLevel();
+
+        setSimdLevel (SIMD_BASELINE);
+
+        vector<char> refRaw;
+        uncompressAll (hdr, false, compressed, refRaw);
+
+        for (int l = SIMD_AVX2; l <= maxLevel; ++l)
+        {
+            setSimdLevel (SimdLevel (l));
+
+            vector<char> raw;
+            uncompressAll (hdr, false, compressed, raw);
+            assert (raw == refRaw);
+        }
+
+        setSimdLevel (maxLevel);
+    }
+}
+
+} // namespace
+
+
+void
+testB44Simd (const std::string &)
+{
+    try
+    {
+        cout << "Testing B44 block packing for all instruction set levels"
+             << endl;
+
+        SimdLevel maxLevel = maxSimdLevel();
+
+        for (int l = SIMD_BASELINE; l <= maxLevel; ++l)
+            cout << "   " << levelNames[l] << endl;
+
+        static const int sizes[][2] =
+        {
+            {64, 32}, {37, 29}, {5, 7}, {1, 1}, {3, 32}
+        };
+
+        for (int i = 0; i < int (sizeof (sizes) / sizeof (sizes[0])); ++i)
+        {
+            for (int p = 0; p < NUM_PATTERNS; ++p)
+            {
+                testCompress (sizes[i][0], sizes[i][1], false, Pattern (p));
+                testCompress (sizes[i][0], sizes[i][1], true, Pattern (p));
+            }
+        }
+
+        Rand48 rand (0);
+        testUnpack (rand);
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
@@ -39,6 +39,7 @@
 #include <ImfInputFile.h>
 #include <ImfChannelList.h>
 #include <ImfArray.h>
+#include <ImfCompressor.h>
 #include <ImathRandom.h>
 #include <half.h>
 #include "compareFloat.h"
@@ -373,6 +374,9 @@ writeRead (const std::string &tempDir,
 	{
 	    for (int comp = 0; comp < NUM_COMPRESSION_METHODS; ++comp)
 	    {
+		if (!isSupportedCompression (Compression (comp)))
+		    continue;
+
 		writeRead (pi, ph, pf,
 			   filename.c_str(),
 			   w  * xs, h  * ys,
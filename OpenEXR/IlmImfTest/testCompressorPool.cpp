@@ -0,0 +1,353 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include "testCompressorPool.h"
+
+#include <ImfCompressor.h>
+#include <ImfInputFile.h>
+#include <ImfOutputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfTiledOutputFile.h>
+#include <ImfHeader.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfStandardAttributes.h>
+#include <ImfThreading.h>
+#include <ImathRandom.h>
+#include <half.h>
+#include <iostream>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+
+
+namespace {
+
+const int W = 117;
+const int H = 93;
+
+const char *channelNames[] = {"A", "B", "G", "R", "Z"};
+const int numChannels = sizeof (channelNames) / sizeof (channelNames[0]);
+
+
+Header
+makeHeader ()
+{
+    Header hdr (W, H);
+
+    for (int c = 0; c < numChannels; ++c)
+        hdr.channels().insert (channelNames[c], Channel (HALF));
+
+    return hdr;
+}
+
+
+void
+testBorrowAndReturn ()
+{
+    cout << "   borrowing and returning compressors" << endl;
+
+    setCompressorPoolSize (4);
+    assert (compressorPoolSize() == 4);
+
+    Header h1 = makeHeader();
+    size_t lineSize = W * numChannels * sizeof (half);
+
+    //
+    // A returned compressor is handed out again for an equivalent
+    // header, and its header() refers to the new header.
+    //
+
+    Compressor *a = borrowCompressor (PIZ_COMPRESSION, lineSize, h1);
+    assert (a != 0);
+    assert (&a->header() == &h1);
+    returnCompressor (a);
+
+    Header h2 = h1;
+    h2.insert ("comments", StringAttribute ("irrelevant"));
+
+    Compressor *b = borrowCompressor (PIZ_COMPRESSION, lineSize, h2);
+    assert (b == a);
+    assert (&b->header() == &h2);
+
+    //
+    // A borrowed compressor is not handed out twice.
+    //
+
+    Compressor *c = borrowCompressor (PIZ_COMPRESSION, lineSize, h2);
+    assert (c != 0 && c != b);
+
+    returnCompressor (b);
+    returnCompressor (c);
+
+    //
+    // Compressors for a different compression type, buffer size,
+    // data window, channel list or compression level are distinct.
+    //
+
+    b = borrowCompressor (PIZ_COMPRESSION, lineSize, h1);
+    c = borrowCompressor (PIZ_COMPRESSION, lineSize, h1);
+
+    vector<Compressor *> others;
+
+    others.push_back (borrowCompressor (ZIP_COMPRESSION, lineSize, h1));
+    others.push_back (borrowCompressor (PIZ_COMPRESSION, lineSize * 2, h1));
+    others.push_back (borrowTileCompressor (PIZ_COMPRESSION,
+                                            lineSize, 32, h1));
+
+    Header h3 = h1;
+    h3.dataWindow().max.y += 1;
+    others.push_back (borrowCompressor (PIZ_COMPRESSION, lineSize, h3));
+
+    Header h4 = h1;
+    h4.channels().insert ("Y", Channel (HALF));
+    others.push_back (borrowCompressor (PIZ_COMPRESSION, lineSize, h4));
+
+    Header h5 = h1;
+    addZipCompressionLevel (h5, 9);
+    Compressor *z1 = borrowCompressor (ZIP_COMPRESSION, lineSize, h1);
+    Compressor *z2 = borrowCompressor (ZIP_COMPRESSION, lineSize, h5);
+
+    for (size_t i = 0; i < others.size(); ++i)
+        assert (others[i] != 0 && others[i] != b && others[i] != c);
+
+    returnCompressor (z1);
+    returnCompressor (z2);
+
+    assert (borrowCompressor (ZIP_COMPRESSION, lineSize, h5) == z2);
+    assert (borrowCompressor (ZIP_COMPRESSION, lineSize, h1) == z1);
+
+    returnCompressor (z1);
+    returnCompressor (z2);
+
+    for (size_t i = 0; i < others.size(); ++i)
+        returnCompressor (others[i]);
+
+    returnCompressor (b);
+    returnCompressor (c);
+
+    //
+    // Shrinking the pool keeps the most recently returned compressors.
+    //
+
+    setCompressorPoolSize (1);
+    assert (borrowCompressor (PIZ_COMPRESSION, lineSize, h1) == c);
+    returnCompressor (c);
+
+    //
+    // NO_COMPRESSION has no compressor; compressors that were
+    // not borrowed from the pool are simply deleted.
+    //
+
+    assert (borrowCompressor (NO_COMPRESSION, lineSize, h1) == 0);
+    returnCompressor (0);
+    returnCompressor (newCompressor (RLE_COMPRESSION, lineSize, h1));
+
+    setCompressorPoolSize (0);
+    assert (compressorPoolSize() == 0);
+
+    a = borrowCompressor (PIZ_COMPRESSION, lineSize, h1);
+    assert (a != 0);
+    returnCompressor (a);
+}
+
+
+void
+fillPixels (vector<half> &pixels)
+{
+    Rand48 rand (7);
+    pixels.resize (numChannels * W * H);
+
+    for (int c = 0; c < numChannels; ++c)
+        for (int y = 0; y < H; ++y)
+            for (int x = 0; x < W; ++x)
+                pixels[(c * H + y) * W + x] =
+                    half (float (sin (x * 0.1 + c) * cos (y * 0.07) +
+                                 rand.nextf (-0.01, 0.01)));
+}
+
+
+void
+insertSlices (FrameBuffer &fb, vector<half> &pixels, const char *subset)
+{
+    for (int c = 0; c < numChannels; ++c)
+    {
+        if (subset && !strchr (subset, '0' + c))
+            continue;
+
+        fb.insert (channelNames[c],
+                   Slice (HALF,
+                          (char *) &pixels[c * H * W],
+                          sizeof (half),
+                          sizeof (half) * W));
+    }
+}
+
+
+void
+readImage (const string &fileName,
+           bool tiled,
+           const char *subset,
+           vector<half> &pixels)
+{
+    pixels.assign (numChannels * W * H, half (0.f));
+
+    FrameBuffer fb;
+    insertSlices (fb, pixels, subset);
+
+    if (tiled)
+    {
+        TiledInputFile in (fileName.c_str());
+        in.setFrameBuffer (fb);
+        in.readTiles (0, in.numXTiles() - 1, 0, in.numYTiles() - 1);
+    }
+    else
+    {
+        InputFile in (fileName.c_str());
+        in.setFrameBuffer (fb);
+        in.readPixels (0, H - 1);
+    }
+}
+
+
+void
+testFiles (const string &tempDir, Compression comp, bool tiled)
+{
+    cout << "   reading " << (tiled? "tiled": "scan line") << " files, "
+            "compression " << comp << endl;
+
+    string fileName = tempDir + "imf_test_compressor_pool.exr";
+
+    vector<half> pixels;
+    fillPixels (pixels);
+
+    {
+        Header hdr = makeHeader();
+        hdr.compression() = comp;
+
+        FrameBuffer fb;
+        insertSlices (fb, pixels, 0);
+
+        if (tiled)
+        {
+            hdr.setTileDescription (TileDescription (32, 16, ONE_LEVEL));
+            TiledOutputFile out (fileName.c_str(), hdr);
+            out.setFrameBuffer (fb);
+            out.writeTiles (0, out.numXTiles() - 1, 0, out.numYTiles() - 1);
+        }
+        else
+        {
+            OutputFile out (fileName.c_str(), hdr);
+            out.setFrameBuffer (fb);
+            out.writePixels (H);
+        }
+    }
+
+    //
+    // Read the file without pooling, then repeatedly with pooled
+    // compressors, alternating between all channels and a subset,
+    // so that the compressors that decode only some channels are
+    // reused for files that need all of them.
+    //
+
+    setCompressorPoolSize (0);
+
+    vector<half> reference;
+    readImage (fileName, tiled, 0, reference);
+
+    setCompressorPoolSize (32);
+
+    static const char *subsets[] = {"2", 0, "04", 0, "3", 0};
+
+    for (int i = 0; i < int (sizeof (subsets) / sizeof (subsets[0])); ++i)
+    {
+        vector<half> result;
+        readImage (fileName, tiled, subsets[i], result);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            if (subsets[i] && !strchr (subsets[i], '0' + c))
+                continue;
+
+            assert (!memcmp (&result[c * H * W],
+                             &reference[c * H * W],
+                             H * W * sizeof (half)));
+        }
+    }
+
+    remove (fileName.c_str());
+}
+
+} // namespace
+
+
+void
+testCompressorPool (const std::string &tempDir)
+{
+    try
+    {
+        cout << "Testing the compressor pool" << endl;
+
+        int poolSize = compressorPoolSize();
+        int threadCount = globalThreadCount();
+
+        testBorrowAndReturn();
+
+        for (int threads = 0; threads <= 3; threads += 3)
+        {
+            setGlobalThreadCount (threads);
+
+            testFiles (tempDir, DWAA_COMPRESSION, false);
+            testFiles (tempDir, DWAB_COMPRESSION, true);
+            testFiles (tempDir, PIZ_COMPRESSION, false);
+            testFiles (tempDir, B44_COMPRESSION, true);
+        }
+
+        setGlobalThreadCount (threadCount);
+        setCompressorPoolSize (poolSize);
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
@@ -37,6 +37,7 @@
 #include <ImfInputFile.h>
 #include <ImfChannelList.h>
 #include <ImfArray.h>
+#include <ImfCompressor.h>
 #include <half.h>
 
 #include <stdio.h>
@@ -187,6 +188,9 @@ writeCopyRead (const std::string &tempDir, const Array2D<half> &ph, int w, int h
 
     for (int comp = 0; comp < NUM_COMPRESSION_METHODS; ++comp)
     {
+	if (!isSupportedCompression (Compression (comp)))
+	    continue;
+
 	writeCopyRead (ph,
 		       filename1.c_str(),
 		       filename2.c_str(),
@@ -0,0 +1,434 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+
+
+#include "testDwaChannelSubset.h"
+
+#include <ImfInputFile.h>
+#include <ImfOutputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfTiledOutputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfTileDescription.h>
+#include <ImfPixelType.h>
+#include <ImfMisc.h>
+#include <ImathRandom.h>
+#include <half.h>
+#include <iostream>
+#include <vector>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+
+
+namespace {
+
+//
+// The channels cover all the ways that DWA compression stores
+// channels: R, G and B, and diffuse.R, diffuse.G and diffuse.B
+// are two color space converted sets, Y is lossy DCT compressed
+// on its own, A is RLE compressed, and Z and id are compressed
+// losslessly.
+//
+
+struct ChannelSpec
+{
+    const char *name;
+    PixelType   type;
+};
+
+const ChannelSpec channelSpecs[] =
+{
+    {"A",         HALF},
+    {"B",         HALF},
+    {"G",         HALF},
+    {"R",         HALF},
+    {"Y",         HALF},
+    {"Z",         FLOAT},
+    {"diffuse.B", FLOAT},
+    {"diffuse.G", FLOAT},
+    {"diffuse.R", FLOAT},
+    {"id",        UINT},
+};
+
+const int numChannels = sizeof (channelSpecs) / sizeof (channelSpecs[0]);
+
+//
+// Sets of channels to read; each string lists indices into
+// channelSpecs[].
+//
+
+const char *subsets[] =
+{
+    "5",        // Z only: no lossy DCT or RLE data are needed
+    "2",        // G: decodes the R, G, B set
+    "7",        // diffuse.G: skips the R, G, B set
+    "4",        // Y: skips both color space converted sets
+    "09",       // A and id
+    "38",       // R and diffuse.R
+    "0123456789",
+};
+
+const int numSubsets = sizeof (subsets) / sizeof (subsets[0]);
+
+
+struct Image
+{
+    int width;
+    int height;
+    Box2i dataWindow;
+    vector< vector<char> > channels;
+
+    Image (const Box2i &dw):
+        width (dw.max.x - dw.min.x + 1),
+        height (dw.max.y - dw.min.y + 1),
+        dataWindow (dw),
+        channels (numChannels)
+    {
+        for (int c = 0; c < numChannels; ++c)
+        {
+            channels[c].resize (width * height *
+                                pixelTypeSize (channelSpecs[c].type), 0);
+        }
+    }
+
+    void
+    erase ()
+    {
+        for (int c = 0; c < numChannels; ++c)
+            memset (&channels[c][0], 0, channels[c].size());
+    }
+
+    //
+    // Frame buffer for the channels listed in subset,
+    // or for all channels if subset is 0
+    //
+
+    FrameBuffer
+    frameBuffer (const char *subset = 0)
+    {
+        FrameBuffer fb;
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            if (subset && !strchr (subset, '0' + c))
+                continue;
+
+            size_t xs = pixelTypeSize (channelSpecs[c].type);
+            size_t ys = xs * width;
+            char *base = &channels[c][0] -
+                         xs * dataWindow.min.x - ys * dataWindow.min.y;
+
+            fb.insert (channelSpecs[c].name,
+                       Slice (channelSpecs[c].type, base, xs, ys));
+        }
+
+        return fb;
+    }
+};
+
+
+void
+fillImage (Image &image, Rand48 &rand)
+{
+    for (int c = 0; c < numChannels; ++c)
+    {
+        char *p = &image.channels[c][0];
+
+        for (int y = 0; y < image.height; ++y)
+        {
+            for (int x = 0; x < image.width; ++x)
+            {
+                //
+                // Smooth data with some noise for the lossy
+                // channels, so that blocks have AC components,
+                // and random values for the others.
+                //
+
+                float v = float (sin (x * 0.1 + c) * cos (y * 0.07) + 1.0 +
+                                 rand.nextf (0, 0.2));
+
+                switch (channelSpecs[c].type)
+                {
+                  case HALF:
+                    {
+                        half h (v);
+                        memcpy (p, &h, sizeof (h));
+                    }
+                    break;
+
+                  case FLOAT:
+                    memcpy (p, &v, sizeof (v));
+                    break;
+
+                  case UINT:
+                    {
+                        unsigned int ui = rand.nexti();
+                        memcpy (p, &ui, sizeof (ui));
+                    }
+                    break;
+
+                  default:
+                    assert (false);
+                }
+
+                p += pixelTypeSize (channelSpecs[c].type);
+            }
+        }
+    }
+}
+
+
+Header
+imageHeader (const Box2i &dataWindow, Compression compression)
+{
+    Header header (dataWindow, dataWindow);
+    header.compression() = compression;
+
+    for (int c = 0; c < numChannels; ++c)
+        header.channels().insert (channelSpecs[c].name,
+                                  Channel (channelSpecs[c].type));
+
+    return header;
+}
+
+
+void
+compareChannels (const Image &image, const Image &expected, const char *subset)
+{
+    for (int c = 0; c < numChannels; ++c)
+    {
+        if (strchr (subset, '0' + c))
+            assert (image.channels[c] == expected.channels[c]);
+        else
+            for (size_t i = 0; i < image.channels[c].size(); ++i)
+                assert (image.channels[c][i] == 0);
+    }
+}
+
+
+void
+testScanLineFile (const string &fileName,
+                  Compression compression,
+                  int numThreads,
+                  const Image &pixels)
+{
+    cout << "scan line file, compression " << compression <<
+            ", threads " << numThreads << endl;
+
+    {
+        OutputFile out (fileName.c_str(),
+                        imageHeader (pixels.dataWindow, compression));
+
+        Image tmp (pixels);
+        out.setFrameBuffer (tmp.frameBuffer());
+        out.writePixels (pixels.height);
+    }
+
+    const Box2i &dw = pixels.dataWindow;
+
+    //
+    // Read all channels for reference
+    //
+
+    Image full (dw);
+
+    {
+        InputFile in (fileName.c_str(), numThreads);
+        in.setFrameBuffer (full.frameBuffer());
+        in.readPixels (dw.min.y, dw.max.y);
+    }
+
+    //
+    // Read each subset with a new file, and in turn with one file
+    //
+
+    InputFile shared (fileName.c_str(), numThreads);
+
+    for (int s = 0; s < numSubsets; ++s)
+    {
+        Image image (dw);
+
+        InputFile in (fileName.c_str(), numThreads);
+        in.setFrameBuffer (image.frameBuffer (subsets[s]));
+        in.readPixels (dw.min.y, dw.max.y);
+        compareChannels (image, full, subsets[s]);
+
+        image.erase();
+        shared.setFrameBuffer (image.frameBuffer (subsets[s]));
+        shared.readPixels (dw.min.y, dw.max.y);
+        compareChannels (image, full, subsets[s]);
+    }
+
+    //
+    // Alternate between two frame buffers with different channels
+    // while reading the same scan lines, and read all channels
+    // again afterwards.
+    //
+
+    for (int s = 0; s + 1 < numSubsets; ++s)
+    {
+        Image image1 (dw);
+        Image image2 (dw);
+
+        FrameBuffer fb1 = image1.frameBuffer (subsets[s]);
+        FrameBuffer fb2 = image2.frameBuffer (subsets[s + 1]);
+
+        for (int y = dw.min.y; y <= dw.max.y; ++y)
+        {
+            shared.setFrameBuffer (fb1);
+            shared.readPixels (y);
+            shared.setFrameBuffer (fb2);
+            shared.readPixels (y);
+        }
+
+        compareChannels (image1, full, subsets[s]);
+        compareChannels (image2, full, subsets[s + 1]);
+    }
+
+    Image image (dw);
+    shared.setFrameBuffer (image.frameBuffer());
+    shared.readPixels (dw.min.y, dw.max.y);
+    compareChannels (image, full, subsets[numSubsets - 1]);
+
+    remove (fileName.c_str());
+}
+
+
+void
+testTiledFile (const string &fileName,
+               Compression compression,
+               int numThreads,
+               const Image &pixels)
+{
+    cout << "tiled file, compression " << compression <<
+            ", threads " << numThreads << endl;
+
+    {
+        Header header = imageHeader (pixels.dataWindow, compression);
+        header.setTileDescription (TileDescription (37, 29, ONE_LEVEL));
+
+        TiledOutputFile out (fileName.c_str(), header);
+
+        Image tmp (pixels);
+        out.setFrameBuffer (tmp.frameBuffer());
+        out.writeTiles (0, out.numXTiles() - 1, 0, out.numYTiles() - 1);
+    }
+
+    const Box2i &dw = pixels.dataWindow;
+
+    Image full (dw);
+
+    {
+        TiledInputFile in (fileName.c_str(), numThreads);
+        in.setFrameBuffer (full.frameBuffer());
+        in.readTiles (0, in.numXTiles() - 1, 0, in.numYTiles() - 1);
+    }
+
+    TiledInputFile shared (fileName.c_str(), numThreads);
+
+    for (int s = 0; s < numSubsets; ++s)
+    {
+        Image image (dw);
+
+        shared.setFrameBuffer (image.frameBuffer (subsets[s]));
+        shared.readTiles (0, shared.numXTiles() - 1,
+                          0, shared.numYTiles() - 1);
+
+        compareChannels (image, full, subsets[s]);
+
+        //
+        // Through the InputFile interface, which
+        // reads the tiles into a cache of its own
+        //
+
+        image.erase();
+
+        InputFile in (fileName.c_str(), numThreads);
+        in.setFrameBuffer (image.frameBuffer (subsets[s]));
+        in.readPixels (dw.min.y, dw.max.y);
+        compareChannels (image, full, subsets[s]);
+    }
+
+    remove (fileName.c_str());
+}
+
+} // namespace
+
+
+void
+testDwaChannelSubset (const string &tempDir)
+{
+    try
+    {
+        cout << "Testing DWA decoding of subsets of the channels" << endl;
+
+        string fileName = tempDir + "imf_test_dwa_channel_subset.exr";
+
+        Rand48 rand (0);
+
+        Image pixels (Box2i (V2i (3, -2), V2i (119, 72)));
+        fillImage (pixels, rand);
+
+        const Compression compressions[] = {DWAA_COMPRESSION,
+                                            DWAB_COMPRESSION};
+
+        for (int c = 0; c < 2; ++c)
+        {
+            for (int numThreads = 0; numThreads <= 3; numThreads += 3)
+            {
+                testScanLineFile (fileName, compressions[c],
+                                  numThreads, pixels);
+
+                testTiledFile (fileName, compressions[c],
+                               numThreads, pixels);
+            }
+        }
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
@@ -510,6 +510,225 @@ testFromHalfZigZag()
 }
 
 
+
+#ifdef IMF_HAVE_DWA_WIDE_KERNELS
+
+//
+// The AVX2 and AVX-512 kernels must produce bit-for-bit the
+// same results as the implementations they replace.
+//
+
+void
+compareBitExact (const void *expected, const void *test, size_t size)
+{
+    if (memcmp (expected, test, size) != 0)
+    {
+        const unsigned char *e = (const unsigned char *) expected;
+        const unsigned char *t = (const unsigned char *) test;
+
+        size_t i = 0;
+        while (e[i] == t[i])
+            ++i;
+
+        cout << "Results differ at byte " << i << endl;
+        assert (false);
+    }
+}
+
+
+//
+// Random values, with some of them replaced by zeros of
+// either sign.
+//
+
+float
+randomValue (Rand48 &rand48)
+{
+    float f = 100.0f * (rand48.nextf() - .5f);
+
+    if (rand48.nextf() < .1)
+        f = (rand48.nextf() < .5)? 0.0f: -0.0f;
+
+    return f;
+}
+
+
+template <int zeroedRows>
+void
+testInverseDctAvx2 (Rand48 &rand48, int numIter)
+{
+    SimdAlignedBuffer64f orig;
+    SimdAlignedBuffer64f test;
+
+    for (int iter = 0; iter < numIter; ++iter)
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            if (i < 8 * (8 - zeroedRows))
+                orig._buffer[i] = test._buffer[i] = randomValue (rand48);
+            else
+                orig._buffer[i] = test._buffer[i] = 0;
+        }
+
+        dctInverse8x8_scalar<zeroedRows> (orig._buffer);
+        dctInverse8x8_avx2<zeroedRows> (test._buffer);
+
+        compareBitExact (orig._buffer, test._buffer, 64 * sizeof (float));
+    }
+}
+
+
+void
+testCscWide (void (*forward) (float *, float *, float *),
+             void (*inverse) (float *, float *, float *),
+             int numIter)
+{
+    Rand48               rand48 (0);
+    SimdAlignedBuffer64f orig[3];
+    SimdAlignedBuffer64f test[3];
+
+    for (int iter = 0; iter < numIter; ++iter)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            for (int i = 0; i < 64; ++i)
+                orig[c]._buffer[i] = test[c]._buffer[i] = randomValue (rand48);
+        }
+
+        csc709Forward64 (orig[0]._buffer, orig[1]._buffer, orig[2]._buffer);
+        forward (test[0]._buffer, test[1]._buffer, test[2]._buffer);
+
+        for (int c = 0; c < 3; ++c)
+            compareBitExact (orig[c]._buffer, test[c]._buffer, 64 * sizeof (float));
+
+        for (int i = 0; i < 64; ++i)
+        {
+            csc709Inverse (orig[0]._buffer[i],
+                           orig[1]._buffer[i],
+                           orig[2]._buffer[i]);
+        }
+
+        inverse (test[0]._buffer, test[1]._buffer, test[2]._buffer);
+
+        for (int c = 0; c < 3; ++c)
+            compareBitExact (orig[c]._buffer, test[c]._buffer, 64 * sizeof (float));
+    }
+}
+
+
+void
+testWideKernels ()
+{
+    const int numIter = 100000;
+    CpuId     cpuid;
+
+    if (cpuid.avx && cpuid.avx2 && cpuid.f16c)
+    {
+        Rand48 rand48 (0);
+
+        cout << "   AVX2 kernels" << endl;
+
+        cout << "      dctInverse8x8_avx2()" << endl;
+        testInverseDctAvx2<0> (rand48, numIter);
+        testInverseDctAvx2<1> (rand48, numIter);
+        testInverseDctAvx2<2> (rand48, numIter);
+        testInverseDctAvx2<3> (rand48, numIter);
+        testInverseDctAvx2<4> (rand48, numIter);
+        testInverseDctAvx2<5> (rand48, numIter);
+        testInverseDctAvx2<6> (rand48, numIter);
+        testInverseDctAvx2<7> (rand48, numIter);
+
+        cout << "      dctForward8x8_avx2()" << endl;
+
+        SimdAlignedBuffer64f orig;
+        SimdAlignedBuffer64f test;
+
+        for (int iter = 0; iter < numIter; ++iter)
+        {
+            for (int i = 0; i < 64; ++i)
+                orig._buffer[i] = test._buffer[i] = randomValue (rand48);
+
+            dctForward8x8 (orig._buffer);
+            dctForward8x8_avx2 (test._buffer);
+
+            compareBitExact (orig._buffer, test._buffer, 64 * sizeof (float));
+        }
+
+        cout << "      csc709Forward64_avx2(), csc709Inverse64_avx2()" << endl;
+        testCscWide (csc709Forward64_avx2, csc709Inverse64_avx2, numIter);
+    }
+
+    if (cpuid.avx && cpuid.avx2 && cpuid.f16c &&
+        cpuid.avx512f && cpuid.avx512bw)
+    {
+        Rand48 rand48 (0);
+
+        cout << "   AVX-512 kernels" << endl;
+
+        cout << "      csc709Forward64_avx512(), csc709Inverse64_avx512()"
+             << endl;
+
+        testCscWide (csc709Forward64_avx512, csc709Inverse64_avx512, numIter);
+
+        cout << "      convertFloatToHalf64_avx512()" << endl;
+
+        SimdAlignedBuffer64f  src;
+        SimdAlignedBuffer64us expected;
+        SimdAlignedBuffer64us test;
+
+        for (int iter = 0; iter < numIter; ++iter)
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                if (i < 32)
+                    src._buffer[i] = (float)140000*(rand48.nextf()-.5);
+                else
+                    src._buffer[i] = (float)(rand48.nextf()-.5);
+            }
+
+            convertFloatToHalf64_scalar (expected._buffer, src._buffer);
+            convertFloatToHalf64_avx512 (test._buffer, src._buffer);
+
+            compareBitExact (expected._buffer, test._buffer,
+                             64 * sizeof (unsigned short));
+        }
+
+        //
+        // Check every half value that is not a NaN in every
+        // position, then random blocks.
+        //
+
+        cout << "      fromHalfZigZag_avx512()" << endl;
+
+        SimdAlignedBuffer64us srcHalf;
+        SimdAlignedBuffer64f  dstExpected;
+        SimdAlignedBuffer64f  dstTest;
+
+        for (int iter = 0; iter < 65536 + numIter; ++iter)
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                half h;
+
+                if (iter < 65536)
+                    h.setBits ((unsigned short) (iter + 1031 * i));
+                else
+                    h.setBits ((unsigned short) rand48.nexti());
+
+                srcHalf._buffer[i] = h.isNan()? 0: h.bits();
+            }
+
+            fromHalfZigZag_scalar (srcHalf._buffer, dstExpected._buffer);
+            fromHalfZigZag_avx512 (srcHalf._buffer, dstTest._buffer);
+
+            compareBitExact (dstExpected._buffer, dstTest._buffer,
+                             64 * sizeof (float));
+        }
+    }
+}
+
+#endif /* IMF_HAVE_DWA_WIDE_KERNELS */
+
 } // namespace
 
 void 
@@ -527,6 +746,10 @@ testDwaCompressorSimd (const string&)
 
         testDct();
 
+#ifdef IMF_HAVE_DWA_WIDE_KERNELS
+        testWideKernels();
+#endif
+
     }
     catch (const exception &e)
     {
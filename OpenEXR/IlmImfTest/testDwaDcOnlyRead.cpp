@@ -0,0 +1,572 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+
+#include "testDwaDcOnlyRead.h"
+
+#include <ImfInputFile.h>
+#include <ImfInputPart.h>
+#include <ImfMultiPartInputFile.h>
+#include <ImfOutputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfArray.h>
+#include <ImathRandom.h>
+#include <Iex.h>
+#include <half.h>
+#include <algorithm>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+
+
+namespace {
+
+//
+// The images have channels of all the kinds that DWA compression
+// distinguishes: R, G and B are color space converted and lossy
+// DCT compressed together, Y is lossy DCT compressed on its own,
+// A is RLE compressed, and Z and id are compressed losslessly.
+// G is stored as FLOAT, and id as UINT.
+//
+
+struct Pixels
+{
+    Array2D<half>         r;
+    Array2D<float>        g;
+    Array2D<half>         b;
+    Array2D<half>         y;
+    Array2D<half>         a;
+    Array2D<float>        z;
+    Array2D<unsigned int> id;
+
+    int width;
+    int height;
+
+    void
+    resize (int newWidth, int newHeight)
+    {
+        width = newWidth;
+        height = newHeight;
+        r.resizeErase (height, width);
+        g.resizeErase (height, width);
+        b.resizeErase (height, width);
+        y.resizeErase (height, width);
+        a.resizeErase (height, width);
+        z.resizeErase (height, width);
+        id.resizeErase (height, width);
+    }
+
+    void
+    erase ()
+    {
+        int n = width * height;
+        memset (&r[0][0], 0, sizeof (half) * n);
+        memset (&g[0][0], 0, sizeof (float) * n);
+        memset (&b[0][0], 0, sizeof (half) * n);
+        memset (&y[0][0], 0, sizeof (half) * n);
+        memset (&a[0][0], 0, sizeof (half) * n);
+        memset (&z[0][0], 0, sizeof (float) * n);
+        memset (&id[0][0], 0, sizeof (unsigned int) * n);
+    }
+
+    bool
+    operator == (const Pixels &other) const
+    {
+        int n = width * height;
+
+        return memcmp (&r[0][0], &other.r[0][0], sizeof (half) * n) == 0 &&
+               memcmp (&g[0][0], &other.g[0][0], sizeof (float) * n) == 0 &&
+               memcmp (&b[0][0], &other.b[0][0], sizeof (half) * n) == 0 &&
+               memcmp (&y[0][0], &other.y[0][0], sizeof (half) * n) == 0 &&
+               memcmp (&a[0][0], &other.a[0][0], sizeof (half) * n) == 0 &&
+               memcmp (&z[0][0], &other.z[0][0], sizeof (float) * n) == 0 &&
+               memcmp (&id[0][0], &other.id[0][0],
+                       sizeof (unsigned int) * n) == 0;
+    }
+};
+
+
+//
+// Frame buffer for the pixels; origin is the
+// pixel that goes into pixels[0][0].
+//
+
+template <class T>
+char *
+base (Array2D<T> &array, const V2i &origin, int width)
+{
+    return (char *) (&array[0][0] - origin.x - origin.y * width);
+}
+
+
+FrameBuffer
+frameBuffer (Pixels &pixels, const V2i &origin)
+{
+    int w = pixels.width;
+    FrameBuffer fb;
+
+    fb.insert ("R", Slice (HALF, base (pixels.r, origin, w),
+                           sizeof (half), sizeof (half) * w));
+
+    fb.insert ("G", Slice (FLOAT, base (pixels.g, origin, w),
+                           sizeof (float), sizeof (float) * w));
+
+    fb.insert ("B", Slice (HALF, base (pixels.b, origin, w),
+                           sizeof (half), sizeof (half) * w));
+
+    fb.insert ("Y", Slice (HALF, base (pixels.y, origin, w),
+                           sizeof (half), sizeof (half) * w));
+
+    fb.insert ("A", Slice (HALF, base (pixels.a, origin, w),
+                           sizeof (half), sizeof (half) * w));
+
+    fb.insert ("Z", Slice (FLOAT, base (pixels.z, origin, w),
+                           sizeof (float), sizeof (float) * w));
+
+    fb.insert ("id", Slice (UINT, base (pixels.id, origin, w),
+                            sizeof (unsigned int),
+                            sizeof (unsigned int) * w));
+
+    return fb;
+}
+
+
+//
+// Fill the lossy DCT channels with values that are constant in each
+// 8x8 block, so that the blocks have no AC components, and the full
+// image that is read back is exactly what the DC components describe.
+// The other channels get random values.
+//
+
+void
+fillPixels (Pixels &pixels, Rand48 &rand)
+{
+    for (int by = 0; by < pixels.height; by += 8)
+    {
+        for (int bx = 0; bx < pixels.width; bx += 8)
+        {
+            half r = half (float (rand.nextf (0, 4)));
+            float g = float (half (float (rand.nextf (0, 4))));
+            half b = half (float (rand.nextf (0, 4)));
+            half y = half (float (rand.nextf (0, 4)));
+
+            for (int j = by; j < min (by + 8, pixels.height); ++j)
+            {
+                for (int i = bx; i < min (bx + 8, pixels.width); ++i)
+                {
+                    pixels.r[j][i] = r;
+                    pixels.g[j][i] = g;
+                    pixels.b[j][i] = b;
+                    pixels.y[j][i] = y;
+                }
+            }
+        }
+    }
+
+    for (int j = 0; j < pixels.height; ++j)
+    {
+        for (int i = 0; i < pixels.width; ++i)
+        {
+            pixels.a[j][i] = half (float (rand.nextf (0, 1)));
+            pixels.z[j][i] = float (rand.nextf (-1e3, 1e3));
+            pixels.id[j][i] = rand.nexti();
+        }
+    }
+}
+
+
+//
+// The reduced image that readPixelsDcOnly() should produce from
+// the full image that is read back: the blocks of the lossy DCT
+// channels are constant, the other half and float channels are
+// averaged, adding the samples of each block in scan line order,
+// and the UINT channel keeps each block's top-left sample.
+//
+
+template <class T>
+T
+average (const Array2D<T> &array, int bx, int by, int width, int height)
+{
+    float sum = 0;
+    int n = 0;
+
+    for (int j = by; j < min (by + 8, height); ++j)
+    {
+        for (int i = bx; i < min (bx + 8, width); ++i)
+        {
+            sum += array[j][i];
+            ++n;
+        }
+    }
+
+    return T (sum / n);
+}
+
+
+void
+reducePixels (const Pixels &full, Pixels &reduced)
+{
+    reduced.resize ((full.width + 7) / 8, (full.height + 7) / 8);
+
+    for (int j = 0; j < reduced.height; ++j)
+    {
+        for (int i = 0; i < reduced.width; ++i)
+        {
+            int bx = i * 8;
+            int by = j * 8;
+
+            reduced.r[j][i] = full.r[by][bx];
+            reduced.g[j][i] = full.g[by][bx];
+            reduced.b[j][i] = full.b[by][bx];
+            reduced.y[j][i] = full.y[by][bx];
+            reduced.a[j][i] = average (full.a, bx, by, full.width, full.height);
+            reduced.z[j][i] = average (full.z, bx, by, full.width, full.height);
+            reduced.id[j][i] = full.id[by][bx];
+        }
+    }
+}
+
+
+void
+writeFile (const string &fileName,
+           const Box2i &dataWindow,
+           Compression compression,
+           LineOrder lineOrder,
+           Pixels &pixels)
+{
+    Header header (dataWindow, dataWindow);
+    header.compression() = compression;
+    header.lineOrder() = lineOrder;
+
+    header.channels().insert ("R", Channel (HALF));
+    header.channels().insert ("G", Channel (FLOAT));
+    header.channels().insert ("B", Channel (HALF));
+    header.channels().insert ("Y", Channel (HALF));
+    header.channels().insert ("A", Channel (HALF));
+    header.channels().insert ("Z", Channel (FLOAT));
+    header.channels().insert ("id", Channel (UINT));
+
+    OutputFile out (fileName.c_str(), header);
+    out.setFrameBuffer (frameBuffer (pixels, dataWindow.min));
+    out.writePixels (pixels.height);
+}
+
+
+void
+testDcOnlyRead (const string &fileName,
+                Compression compression,
+                LineOrder lineOrder,
+                int numThreads,
+                Rand48 &rand)
+{
+    cout << "compression " << compression << ", "
+            "line order " << lineOrder << ", "
+            "threads " << numThreads << endl;
+
+    //
+    // The DWA encoder extends partial blocks at the edges of the
+    // image by mirroring; with at least four pixels left over, the
+    // mirrored pixels stay in the block, and the block stays constant.
+    //
+
+    const int W = 173;
+    const int H = 93;
+    const Box2i dataWindow (V2i (-5, 3), V2i (-5 + W - 1, 3 + H - 1));
+
+    Pixels pixels;
+    pixels.resize (W, H);
+    fillPixels (pixels, rand);
+
+    writeFile (fileName, dataWindow, compression, lineOrder, pixels);
+
+    Pixels full;
+    full.resize (W, H);
+
+    InputFile in (fileName.c_str(), numThreads);
+    in.setFrameBuffer (frameBuffer (full, dataWindow.min));
+    in.readPixels (dataWindow.min.y, dataWindow.max.y);
+
+    assert (in.dcOnlyReadsAvailable());
+
+    Pixels expected;
+    reducePixels (full, expected);
+
+    Box2i reducedWindow = in.dcOnlyDataWindow();
+
+    assert (reducedWindow.min == dataWindow.min);
+    assert (reducedWindow.max.x - reducedWindow.min.x + 1 == expected.width);
+    assert (reducedWindow.max.y - reducedWindow.min.y + 1 == expected.height);
+
+    //
+    // Read the whole reduced image at once
+    //
+
+    Pixels reduced;
+    reduced.resize (expected.width, expected.height);
+    reduced.erase();
+
+    FrameBuffer reducedFb = frameBuffer (reduced, reducedWindow.min);
+    in.readPixelsDcOnly (reducedFb, reducedWindow.max.y, reducedWindow.min.y);
+
+    assert (reduced == expected);
+
+    //
+    // Read it one scan line at a time
+    //
+
+    reduced.erase();
+
+    for (int y = reducedWindow.min.y; y <= reducedWindow.max.y; ++y)
+        in.readPixelsDcOnly (reducedFb, y, y);
+
+    assert (reduced == expected);
+
+    //
+    // The reduced reads must not leave stale data behind for
+    // full-resolution reads from the same line buffers.
+    //
+
+    Pixels full2;
+    full2.resize (W, H);
+
+    in.setFrameBuffer (frameBuffer (full2, dataWindow.min));
+    in.readPixels (dataWindow.min.y, dataWindow.max.y);
+    assert (full2 == full);
+
+    //
+    // Read through an InputPart
+    //
+
+    {
+        MultiPartInputFile multiPart (fileName.c_str(), numThreads);
+        InputPart part (multiPart, 0);
+
+        assert (part.dcOnlyReadsAvailable());
+        assert (part.dcOnlyDataWindow() == reducedWindow);
+
+        reduced.erase();
+        part.readPixelsDcOnly (reducedFb,
+                               reducedWindow.min.y, reducedWindow.max.y);
+
+        assert (reduced == expected);
+    }
+
+    //
+    // Scan lines outside the reduced data window
+    //
+
+    try
+    {
+        in.readPixelsDcOnly (reducedFb,
+                             reducedWindow.min.y, reducedWindow.max.y + 1);
+        assert (false);
+    }
+    catch (const IEX_NAMESPACE::ArgExc &)
+    {
+        // expected
+    }
+
+    remove (fileName.c_str());
+}
+
+
+void
+testUncompressedBlocks (const string &fileName, Rand48 &rand)
+{
+    cout << "blocks stored without compression" << endl;
+
+    //
+    // Random bit patterns do not compress, so DWA compression
+    // stores the blocks of this image as they are.  Clearing
+    // the top exponent bit keeps the values small and finite.
+    //
+
+    const int W = 16;
+    const int H = 40;
+    const Box2i dataWindow (V2i (0, 0), V2i (W - 1, H - 1));
+
+    Array2D<float> pixels (H, W);
+
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+        {
+            unsigned int bits = (unsigned int) rand.nexti() & 0xbfffffff;
+            memcpy (&pixels[y][x], &bits, sizeof (float));
+        }
+
+    {
+        Header header (dataWindow, dataWindow);
+        header.compression() = DWAA_COMPRESSION;
+        header.channels().insert ("Z", Channel (FLOAT));
+
+        FrameBuffer fb;
+        fb.insert ("Z", Slice (FLOAT, (char *) &pixels[0][0],
+                               sizeof (float), sizeof (float) * W));
+
+        OutputFile out (fileName.c_str(), header);
+        out.setFrameBuffer (fb);
+        out.writePixels (H);
+    }
+
+    InputFile in (fileName.c_str());
+
+    const char *data;
+    int dataSize;
+    in.rawPixelData (0, data, dataSize);
+    assert (dataSize == W * 32 * (int) sizeof (float));
+
+    Box2i reducedWindow = in.dcOnlyDataWindow();
+    assert (reducedWindow == Box2i (V2i (0, 0), V2i (1, 4)));
+
+    Array2D<float> reduced (5, 2);
+
+    FrameBuffer fb;
+    fb.insert ("Z", Slice (FLOAT, (char *) &reduced[0][0],
+                           sizeof (float), sizeof (float) * 2));
+
+    in.readPixelsDcOnly (fb, 0, 4);
+
+    for (int y = 0; y < 5; ++y)
+        for (int x = 0; x < 2; ++x)
+            assert (reduced[y][x] == average (pixels, x * 8, y * 8, W, H));
+
+    remove (fileName.c_str());
+}
+
+
+void
+testUnavailable (const string &fileName)
+{
+    cout << "files that cannot be read at reduced resolution" << endl;
+
+    const Box2i dataWindow (V2i (0, 0), V2i (31, 31));
+    Array2D<half> pixels (32, 32);
+    memset (&pixels[0][0], 0, sizeof (half) * 32 * 32);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        //
+        // A ZIP compressed file, and a DWA compressed
+        // file with a subsampled channel.
+        //
+
+        Header header (dataWindow, dataWindow);
+        FrameBuffer fb;
+
+        fb.insert ("Y", Slice (HALF, (char *) &pixels[0][0],
+                               sizeof (half), sizeof (half) * 32));
+
+        header.channels().insert ("Y", Channel (HALF));
+
+        if (i == 0)
+        {
+            header.compression() = ZIP_COMPRESSION;
+        }
+        else
+        {
+            header.compression() = DWAB_COMPRESSION;
+            header.channels().insert ("RY", Channel (HALF, 2, 2));
+
+            fb.insert ("RY", Slice (HALF, (char *) &pixels[0][0],
+                                    sizeof (half), sizeof (half) * 16,
+                                    2, 2));
+        }
+
+        {
+            OutputFile out (fileName.c_str(), header);
+            out.setFrameBuffer (fb);
+            out.writePixels (32);
+        }
+
+        InputFile in (fileName.c_str());
+        assert (!in.dcOnlyReadsAvailable());
+
+        try
+        {
+            in.readPixelsDcOnly (fb, 0, 0);
+            assert (false);
+        }
+        catch (const IEX_NAMESPACE::ArgExc &)
+        {
+            // expected
+        }
+
+        remove (fileName.c_str());
+    }
+}
+
+} // namespace
+
+
+void
+testDwaDcOnlyRead (const string &tempDir)
+{
+    try
+    {
+        cout << "Testing reduced-resolution reads of DWA compressed files"
+             << endl;
+
+        string fileName = tempDir + "imf_test_dwa_dc_only_read.exr";
+
+        Rand48 rand (1);
+
+        const Compression compressions[] = {DWAA_COMPRESSION,
+                                            DWAB_COMPRESSION};
+
+        const LineOrder lineOrders[] = {INCREASING_Y, DECREASING_Y};
+
+        for (int c = 0; c < 2; ++c)
+            for (int l = 0; l < 2; ++l)
+                for (int numThreads = 0; numThreads <= 3; numThreads += 3)
+                    testDcOnlyRead (fileName, compressions[c],
+                                    lineOrders[l], numThreads, rand);
+
+        testUncompressedBlocks (fileName, rand);
+        testUnavailable (fileName);
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
@@ -41,6 +41,9 @@
 #include <ImfInputPart.h>
 #include <ImfOutputPart.h>
 #include <ImfStdIO.h>
+#include <ImfMmapIO.h>
+#include <ImfFileIO.h>
+#include <ImfInputFile.h>
 #include <ImfArray.h>
 
 #include <stdio.h>
@@ -263,6 +266,35 @@ writeReadScanLines (const char fileName[],
 	}
     }
     
+    {
+        cout << ", reading (stateless)";
+	FileIStream ifs (fileName);
+	assert (ifs.isStatelessRead());
+	RgbaInputFile in (ifs, 4);
+
+	const Box2i &dw = in.dataWindow();
+	int w = dw.max.x - dw.min.x + 1;
+	int h = dw.max.y - dw.min.y + 1;
+	int dx = dw.min.x;
+	int dy = dw.min.y;
+
+	Array2D<Rgba> p2 (h, w);
+	in.setFrameBuffer (&p2[-dy][-dx], 1, w);
+	in.readPixels (dw.min.y, dw.max.y);
+
+        cout << ", comparing";
+	for (int y = 0; y < h; ++y)
+	{
+	    for (int x = 0; x < w; ++x)
+	    {
+		assert (p2[y][x].r == p1[y][x].r);
+		assert (p2[y][x].g == p1[y][x].g);
+		assert (p2[y][x].b == p1[y][x].b);
+		assert (p2[y][x].a == p1[y][x].a);
+	    }
+	}
+    }
+
     {
         cout << ", reading (memory-mapped)";
 	MMIFStream ifs (fileName);
@@ -390,6 +422,46 @@ writeReadMultiPart (const char fileName[],
         }
     }
     
+    {
+        cout << ", reading (stateless)";
+        FileIStream ifs (fileName);
+        MultiPartInputFile in (ifs, 4);
+
+        assert(in.parts() == 2);
+
+        const Box2i &dw = in.header(0).dataWindow();
+        int w = dw.max.x - dw.min.x + 1;
+        int h = dw.max.y - dw.min.y + 1;
+        int dx = dw.min.x;
+        int dy = dw.min.y;
+
+        Array2D<Rgba> p2 (h, w);
+        FrameBuffer f;
+        f.insert("R",Slice(HALF,(char *) &p2[-dy][-dx].r,sizeof(Rgba),w*sizeof(Rgba)));
+        f.insert("G",Slice(HALF,(char *) &p2[-dy][-dx].g,sizeof(Rgba),w*sizeof(Rgba)));
+        f.insert("B",Slice(HALF,(char *) &p2[-dy][-dx].b,sizeof(Rgba),w*sizeof(Rgba)));
+        f.insert("A",Slice(HALF,(char *) &p2[-dy][-dx].a,sizeof(Rgba),w*sizeof(Rgba)));
+
+        for(int part=0;part<2;part++)
+        {
+            InputPart p(in,part);
+            p.setFrameBuffer(f);
+            p.readPixels (dw.min.y, dw.max.y);
+
+            cout << ", comparing pt " << part;
+            for (int y = 0; y < h; ++y)
+            {
+                for (int x = 0; x < w; ++x)
+                {
+                    assert (p2[y][x].r == p1[y][x].r);
+                    assert (p2[y][x].g == p1[y][x].g);
+                    assert (p2[y][x].b == p1[y][x].b);
+                    assert (p2[y][x].a == p1[y][x].a);
+                }
+            }
+        }
+    }
+
     {
         cout << ", reading (memory-mapped)";
         MMIFStream ifs (fileName);
@@ -498,6 +570,34 @@ writeReadTiles (const char fileName[],
 	}
     }
     
+    {
+        cout << ", reading (stateless)";
+	FileIStream ifs (fileName);
+	TiledRgbaInputFile in (ifs, 4);
+
+	const Box2i &dw = in.dataWindow();
+	int w = dw.max.x - dw.min.x + 1;
+	int h = dw.max.y - dw.min.y + 1;
+	int dx = dw.min.x;
+	int dy = dw.min.y;
+
+	Array2D<Rgba> p2 (h, w);
+	in.setFrameBuffer (&p2[-dy][-dx], 1, w);
+        in.readTiles (0, in.numXTiles() - 1, 0, in.numYTiles() - 1);
+
+        cout << ", comparing";
+	for (int y = 0; y < h; ++y)
+	{
+	    for (int x = 0; x < w; ++x)
+	    {
+		assert (p2[y][x].r == p1[y][x].r);
+		assert (p2[y][x].g == p1[y][x].g);
+		assert (p2[y][x].b == p1[y][x].b);
+		assert (p2[y][x].a == p1[y][x].a);
+	    }
+	}
+    }
+
     {
         cout << ", reading (memory-mapped)";
 	MMIFStream ifs (fileName);
@@ -532,6 +632,108 @@ writeReadTiles (const char fileName[],
 }
 
 
+void
+readMmapFile (const char fileName[],
+              Compression compression,
+              int width,
+              int height,
+              const Array2D<Rgba> &p1)
+{
+    //
+    // Save a scanline-based RGBA image with the given compression,
+    // then read it back through the library's MmapIStream, both
+    // with an explicit stream and via the memoryMapped option of
+    // InputFile and MultiPartInputFile, and compare the pixels
+    // with the original data.
+    //
+
+    cout << "compression " << compression << ":" << endl;
+
+    Header header (width, height);
+    header.compression() = compression;
+
+    {
+        cout << "writing";
+	remove (fileName);
+	RgbaOutputFile out (fileName, header, WRITE_RGBA);
+	out.setFrameBuffer (&p1[0][0], 1, width);
+	out.writePixels (height);
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        MmapIStream *ifs = 0;
+        InputFile *in = 0;
+        MultiPartInputFile *mpIn = 0;
+
+        if (i == 0)
+        {
+            cout << ", reading (MmapIStream)";
+            ifs = new MmapIStream (fileName);
+            assert (ifs->isMemoryMapped());
+            in = new InputFile (*ifs);
+        }
+        else if (i == 1)
+        {
+            cout << ", reading (InputFile, memory-mapped)";
+            in = new InputFile (fileName, globalThreadCount(), true);
+        }
+        else
+        {
+            cout << ", reading (MultiPartInputFile, memory-mapped)";
+            mpIn = new MultiPartInputFile (fileName, globalThreadCount(),
+                                           true, true);
+        }
+
+        const Header &h0 = in? in->header(): mpIn->header (0);
+	const Box2i &dw = h0.dataWindow();
+	int w = dw.max.x - dw.min.x + 1;
+	int h = dw.max.y - dw.min.y + 1;
+	int dx = dw.min.x;
+	int dy = dw.min.y;
+
+	Array2D<Rgba> p2 (h, w);
+        FrameBuffer f;
+        f.insert("R",Slice(HALF,(char *) &p2[-dy][-dx].r,sizeof(Rgba),w*sizeof(Rgba)));
+        f.insert("G",Slice(HALF,(char *) &p2[-dy][-dx].g,sizeof(Rgba),w*sizeof(Rgba)));
+        f.insert("B",Slice(HALF,(char *) &p2[-dy][-dx].b,sizeof(Rgba),w*sizeof(Rgba)));
+        f.insert("A",Slice(HALF,(char *) &p2[-dy][-dx].a,sizeof(Rgba),w*sizeof(Rgba)));
+
+        if (in)
+        {
+            in->setFrameBuffer (f);
+            in->readPixels (dw.min.y, dw.max.y);
+        }
+        else
+        {
+            InputPart p (*mpIn, 0);
+            p.setFrameBuffer (f);
+            p.readPixels (dw.min.y, dw.max.y);
+        }
+
+        cout << ", comparing";
+	for (int y = 0; y < h; ++y)
+	{
+	    for (int x = 0; x < w; ++x)
+	    {
+		assert (p2[y][x].r == p1[y][x].r);
+		assert (p2[y][x].g == p1[y][x].g);
+		assert (p2[y][x].b == p1[y][x].b);
+		assert (p2[y][x].a == p1[y][x].a);
+	    }
+	}
+
+        delete in;
+        delete mpIn;
+        delete ifs;
+    }
+
+    cout << endl;
+
+    remove (fileName);
+}
+
+
 } // namespace
 
 
@@ -556,6 +758,12 @@ testExistingStreams (const std::string &tempDir)
     fillPixels1 (p1, W, H);
     writeReadMultiPart ((tempDir +  "imf_test_streams3.exr").c_str(), W, H, p1);
 
+	fillPixels2 (p1, W, H);
+	readMmapFile ((tempDir + "imf_test_streams4.exr").c_str(),
+		      NO_COMPRESSION, W, H, p1);
+	readMmapFile ((tempDir + "imf_test_streams4.exr").c_str(),
+		      ZIP_COMPRESSION, W, H, p1);
+
 	cout << "ok\n" << endl;
     }
     catch (const std::exception &e)
@@ -0,0 +1,313 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include <ImfOutputFile.h>
+#include <ImfInputFile.h>
+#include <ImfTiledOutputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfMultiPartOutputFile.h>
+#include <ImfMultiPartInputFile.h>
+#include <ImfOutputPart.h>
+#include <ImfInputPart.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfPartType.h>
+#include <ImfArray.h>
+#include <ImfThreading.h>
+#include <IlmThreadPool.h>
+#include <IlmThreadMutex.h>
+#include <half.h>
+#include <stdio.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+using ILMTHREAD_NAMESPACE::ThreadPool;
+using ILMTHREAD_NAMESPACE::ThreadPoolProvider;
+using ILMTHREAD_NAMESPACE::Task;
+using ILMTHREAD_NAMESPACE::TaskGroup;
+using ILMTHREAD_NAMESPACE::Mutex;
+using ILMTHREAD_NAMESPACE::Lock;
+
+
+namespace {
+
+//
+// A thread pool provider that runs every task in the thread
+// that adds it, and counts the tasks.
+//
+
+class CountingProvider : public ThreadPoolProvider
+{
+  public:
+
+    CountingProvider (): _numTasks (0) {}
+
+    virtual int numThreads () const {return 2;}
+    virtual void setNumThreads (int) {}
+
+    virtual void addTask (Task *task)
+    {
+        {
+            Lock lock (_mutex);
+            ++_numTasks;
+        }
+
+        TaskGroup *group = task->group();
+        task->execute();
+        delete task;
+        group->finishOneTask();
+    }
+
+    virtual void finish () {}
+
+    int numTasks () const
+    {
+        Lock lock (_mutex);
+        return _numTasks;
+    }
+
+  private:
+
+    mutable Mutex	_mutex;
+    int			_numTasks;
+};
+
+
+const int W = 117;
+const int H = 97;
+
+
+void
+fillPixels (Array2D<half> &pixels)
+{
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+            pixels[y][x] = half ((x * 7 + y * 3) % 100 / 10.0f);
+}
+
+
+void
+comparePixels (const Array2D<half> &p1, const Array2D<half> &p2)
+{
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+            assert (p1[y][x].bits() == p2[y][x].bits());
+}
+
+
+FrameBuffer
+frameBuffer (Array2D<half> &pixels)
+{
+    FrameBuffer fb;
+    fb.insert ("Y", Slice (HALF, (char *) &pixels[0][0],
+                           sizeof (half), sizeof (half) * W));
+    return fb;
+}
+
+
+Header
+makeHeader ()
+{
+    Header header (W, H);
+    header.compression() = ZIP_COMPRESSION;
+    header.channels().insert ("Y", Channel (HALF));
+    return header;
+}
+
+
+void
+scanLineFile (const std::string &fileName,
+              ThreadPool &pool,
+              CountingProvider *counter,
+              const Array2D<half> &p1)
+{
+    cout << "scan line file" << endl;
+
+    Array2D<half> p2 (H, W);
+
+    {
+        OutputFile out (fileName.c_str(), makeHeader(), 2, pool);
+        out.setFrameBuffer (frameBuffer (const_cast<Array2D<half> &> (p1)));
+        out.writePixels (H);
+    }
+
+    int numWritten = counter->numTasks();
+    assert (numWritten > 0);
+
+    {
+        InputFile in (fileName.c_str(), 2, false, pool);
+        in.setFrameBuffer (frameBuffer (p2));
+        in.readPixels (0, H - 1);
+    }
+
+    assert (counter->numTasks() > numWritten);
+    comparePixels (p1, p2);
+
+    remove (fileName.c_str());
+}
+
+
+void
+tiledFile (const std::string &fileName,
+           ThreadPool &pool,
+           CountingProvider *counter,
+           const Array2D<half> &p1)
+{
+    cout << "tiled file" << endl;
+
+    Array2D<half> p2 (H, W);
+    Header header = makeHeader();
+    header.setTileDescription (TileDescription (16, 16, ONE_LEVEL));
+
+    int numBefore = counter->numTasks();
+
+    {
+        TiledOutputFile out (fileName.c_str(), header, 2, pool);
+        out.setFrameBuffer (frameBuffer (const_cast<Array2D<half> &> (p1)));
+        out.writeTiles (0, out.numXTiles() - 1, 0, out.numYTiles() - 1);
+    }
+
+    int numWritten = counter->numTasks();
+    assert (numWritten > numBefore);
+
+    {
+        TiledInputFile in (fileName.c_str(), 2, pool);
+        in.setFrameBuffer (frameBuffer (p2));
+        in.readTiles (0, in.numXTiles() - 1, 0, in.numYTiles() - 1);
+    }
+
+    assert (counter->numTasks() > numWritten);
+    comparePixels (p1, p2);
+
+    remove (fileName.c_str());
+}
+
+
+void
+multiPartFile (const std::string &fileName,
+               ThreadPool &pool,
+               CountingProvider *counter,
+               const Array2D<half> &p1)
+{
+    cout << "multi-part file" << endl;
+
+    Array2D<half> p2 (H, W);
+    Header headers[2] = {makeHeader(), makeHeader()};
+    headers[0].setName ("left");
+    headers[0].setType (SCANLINEIMAGE);
+    headers[1].setName ("right");
+    headers[1].setType (SCANLINEIMAGE);
+
+    int numBefore = counter->numTasks();
+
+    {
+        MultiPartOutputFile out (fileName.c_str(), headers, 2, false, 2, pool);
+
+        for (int i = 0; i < 2; ++i)
+        {
+            OutputPart part (out, i);
+            part.setFrameBuffer (frameBuffer (const_cast<Array2D<half> &> (p1)));
+            part.writePixels (H);
+        }
+    }
+
+    int numWritten = counter->numTasks();
+    assert (numWritten > numBefore);
+
+    {
+        MultiPartInputFile in (fileName.c_str(), 2, true, false, pool);
+
+        for (int i = 0; i < 2; ++i)
+        {
+            InputPart part (in, i);
+            part.setFrameBuffer (frameBuffer (p2));
+            part.readPixels (0, H - 1);
+            comparePixels (p1, p2);
+        }
+    }
+
+    assert (counter->numTasks() > numWritten);
+
+    remove (fileName.c_str());
+}
+
+} // namespace
+
+
+void
+testFileThreadPool (const std::string &tempDir)
+{
+    try
+    {
+        cout << "Testing files with their own thread pool" << endl;
+
+        //
+        // Install counting providers both in the global pool and in
+        // a private pool; the files must only use the private pool.
+        //
+
+        CountingProvider *globalCounter = new CountingProvider;
+        globalThreadPool().setThreadProvider (globalCounter);
+
+        ThreadPool pool;
+        CountingProvider *counter = new CountingProvider;
+        pool.setThreadProvider (counter);
+
+        Array2D<half> p1 (H, W);
+        fillPixels (p1);
+
+        scanLineFile (tempDir + "imf_test_file_thread_pool.exr", pool, counter, p1);
+        tiledFile (tempDir + "imf_test_file_thread_pool.exr", pool, counter, p1);
+        multiPartFile (tempDir + "imf_test_file_thread_pool.exr", pool, counter, p1);
+
+        assert (globalCounter->numTasks() == 0);
+
+        //
+        // Put a built-in provider back into the global pool.
+        //
+
+        globalThreadPool().setProviderType (ThreadPool::DEFAULT_PROVIDER);
+        setGlobalThreadCount (0);
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
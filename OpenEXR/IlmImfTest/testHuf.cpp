@@ -107,6 +107,26 @@ fill5 (unsigned short data[/*n*/], int n)
 }
 
 
+void
+fill6 (unsigned short data[/*n*/], int n, IMATH_NAMESPACE::Rand48 & rand48)
+{
+    //
+    // Geometric distribution; most symbols have very short
+    // codes, and several of them fit into one table lookup.
+    //
+
+    for (int i = 0; i < n; ++i)
+    {
+	int j = 0;
+
+	while (j < 16 && rand48.nextf() < 0.5)
+	    ++j;
+
+	data[i] = (rand48.nexti() & 1)? j: USHRT_MAX - j;
+    }
+}
+
+
 void
 compressUncompress (const unsigned short raw[], int n)
 {
@@ -242,6 +262,18 @@ testHuf (const std::string&)
 	compressUncompress (raw, N);
 	compressUncompressSubset (raw, N);
 
+	fill6 (raw, N, rand48);		// test multi-symbol table lookups
+	compressUncompress (raw, N);
+	compressUncompressSubset (raw, N);
+
+	for (int n = 4; n < 64; ++n)	// test bitstreams shorter than
+	{				// 128 bits
+	    fill6 (raw, n, rand48);
+	    compressUncompress (raw, n);
+	    fill4 (raw, n);
+	    compressUncompress (raw, n);
+	}
+
 	cout << "ok\n" << endl;
     }
     catch (const std::exception &e)
@@ -343,24 +343,12 @@ readPixels (const char pFilename[], int pNbChannels, Array2D<half>& pPixels)
     if(is_optimized)
     {
         cout << " optimization enabled\n";
-        
-        if(pNbChannels==2)
-        {
-            cerr << " error: isOptimizationEnabled returned TRUE, but "
-            "optimization not known to work for two channel images\n";
-            assert(pNbChannels!=2);
-        }
-            
     }else{
         cout << " optimization disabled\n";
 #ifdef IMF_HAVE_SSE2
-        if(pNbChannels!=2)
-        {
-            cerr << " error: isOptimizationEnabled returned FALSE, but "
-            "should work for " << pNbChannels << "channel images\n";
-            assert(pNbChannels==2);
-        }
-        
+        cerr << " error: isOptimizationEnabled returned FALSE, but "
+        "should work for " << pNbChannels << "channel images\n";
+        assert(false);
 #endif
     }
     
@@ -492,10 +480,11 @@ readValidateFile (const char pFilename[],
 }
 
 //
-// confirm the optimization flag returns false for non-RGB files
+// confirm that files with channels other than RGB(A) can be read
+// with the optimization enabled
 //
 void
-testNonOptimized (const std::string & tempDir)
+testNonRgb (const std::string & tempDir)
 {
     const int pHeight = IMAGE_2K_HEIGHT - 1;
     const int pWidth  =  IMAGE_2K_WIDTH - 1;
@@ -586,8 +575,8 @@ testOptimized (const std::string & tempDir)
                 "2048x1152 (alignment respected) UNCOMPRESSED" << endl;
 
                          
-        cout << "\tNON-OPTIMIZABLE file" << endl;
-        testNonOptimized(tempDir);
+        cout << "\tNON-RGB(A) file" << endl;
+        testNonRgb(tempDir);
                 
         cout << "\tALIGNED -- MONO -- NO COMPRESSION" << endl;
         testAllCombinations (true, false, NO_COMPRESSION, tempDir);
@@ -0,0 +1,461 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include "testOptimizedMultiChannel.h"
+
+#include <ImfInputFile.h>
+#include <ImfOutputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfArray.h>
+#include <ImfConvert.h>
+#include <ImfSimd.h>
+#include <ImathRandom.h>
+#include <half.h>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+
+
+namespace {
+
+//
+// The file has twelve half channels, c00 ... c11, like a beauty
+// render with a few AOVs, plus a float and an unsigned int channel.
+//
+
+const int NUM_HALF_CHANNELS = 12;
+
+const double HALF_FILL_VALUE = 0.5;
+const double FLOAT_FILL_VALUE = 2.25;
+
+
+string
+halfChannelName (int i)
+{
+    ostringstream s;
+    s << "c" << i / 10 << i % 10;
+    return s.str();
+}
+
+
+struct Image
+{
+    Box2i dw;
+    map<string, Array2D<half> > halfChannels;
+    Array2D<float> depth;
+    Array2D<unsigned int> id;
+};
+
+
+void
+fillImage (Image &img, Rand48 &rand)
+{
+    int w = img.dw.max.x - img.dw.min.x + 1;
+    int h = img.dw.max.y - img.dw.min.y + 1;
+
+    for (int i = 0; i < NUM_HALF_CHANNELS; ++i)
+    {
+        Array2D<half> &c = img.halfChannels[halfChannelName (i)];
+        c.resizeErase (h, w);
+
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+                c[y][x].setBits (rand.nexti() & 0xffff);
+    }
+
+    img.depth.resizeErase (h, w);
+    img.id.resizeErase (h, w);
+
+    for (int y = 0; y < h; ++y)
+    {
+        for (int x = 0; x < w; ++x)
+        {
+            img.depth[y][x] = rand.nextf (-1e6, 1e6);
+            img.id[y][x] = rand.nexti();
+        }
+    }
+}
+
+
+void
+writeImage (const string &fileName, const Image &img, Compression comp)
+{
+    Header hdr (img.dw, img.dw);
+    hdr.compression() = comp;
+
+    int w = img.dw.max.x - img.dw.min.x + 1;
+    FrameBuffer fb;
+
+    for (map<string, Array2D<half> >::const_iterator i =
+             img.halfChannels.begin();
+         i != img.halfChannels.end();
+         ++i)
+    {
+        hdr.channels().insert (i->first, Channel (HALF));
+
+        fb.insert (i->first,
+                   Slice (HALF,
+                          (char *) (&i->second[0][0] -
+                                    img.dw.min.x - img.dw.min.y * w),
+                          sizeof (half),
+                          sizeof (half) * w));
+    }
+
+    hdr.channels().insert ("depth", Channel (FLOAT));
+    hdr.channels().insert ("id", Channel (UINT));
+
+    fb.insert ("depth",
+               Slice (FLOAT,
+                      (char *) (&img.depth[0][0] -
+                                img.dw.min.x - img.dw.min.y * w),
+                      sizeof (float),
+                      sizeof (float) * w));
+
+    fb.insert ("id",
+               Slice (UINT,
+                      (char *) (&img.id[0][0] -
+                                img.dw.min.x - img.dw.min.y * w),
+                      sizeof (unsigned int),
+                      sizeof (unsigned int) * w));
+
+    OutputFile out (fileName.c_str(), hdr);
+    out.setFrameBuffer (fb);
+    out.writePixels (img.dw.max.y - img.dw.min.y + 1);
+}
+
+
+//
+// A frame buffer layout is a list of groups of channels; the channels
+// in a group are interleaved in a single buffer, all of the same type.
+// Channels that are not in the file are filled.
+//
+
+struct Group
+{
+    PixelType type;
+    vector<string> names;
+
+    Group (PixelType t, const char *n0, const char *n1 = 0,
+           const char *n2 = 0, const char *n3 = 0, const char *n4 = 0,
+           const char *n5 = 0, const char *n6 = 0): type (t)
+    {
+        const char *n[] = {n0, n1, n2, n3, n4, n5, n6};
+
+        for (int i = 0; i < 7 && n[i]; ++i)
+            names.push_back (n[i]);
+    }
+
+    Group (PixelType t, int firstHalfChannel, int lastHalfChannel): type (t)
+    {
+        for (int i = firstHalfChannel; i <= lastHalfChannel; ++i)
+            names.push_back (halfChannelName (i));
+    }
+};
+
+
+size_t
+pixelTypeSize (PixelType type)
+{
+    return type == HALF? sizeof (half): sizeof (float);
+}
+
+
+void
+readAndCompare (const string &fileName,
+                const Image &img,
+                const vector<Group> &layout,
+                bool expectOptimized)
+{
+    int w = img.dw.max.x - img.dw.min.x + 1;
+    int h = img.dw.max.y - img.dw.min.y + 1;
+
+    vector<vector<char> > buffers (layout.size());
+    FrameBuffer fb;
+
+    for (size_t g = 0; g < layout.size(); ++g)
+    {
+        const Group &group = layout[g];
+        size_t valueSize = pixelTypeSize (group.type);
+        size_t xStride = valueSize * group.names.size();
+
+        buffers[g].resize (xStride * w * h);
+
+        for (size_t c = 0; c < group.names.size(); ++c)
+        {
+            char *base = &buffers[g][0] + c * valueSize -
+                         img.dw.min.x * xStride -
+                         img.dw.min.y * xStride * w;
+
+            fb.insert (group.names[c],
+                       Slice (group.type, base, xStride, xStride * w, 1, 1,
+                              group.type == HALF? HALF_FILL_VALUE:
+                                                  FLOAT_FILL_VALUE));
+        }
+    }
+
+    InputFile in (fileName.c_str());
+    in.setFrameBuffer (fb);
+
+#ifdef IMF_HAVE_SSE2
+    assert (in.isOptimizationEnabled() == expectOptimized);
+#else
+    assert (!in.isOptimizationEnabled());
+#endif
+
+    in.readPixels (img.dw.min.y, img.dw.max.y);
+
+    for (size_t g = 0; g < layout.size(); ++g)
+    {
+        const Group &group = layout[g];
+        size_t n = group.names.size();
+
+        for (size_t c = 0; c < n; ++c)
+        {
+            const string &name = group.names[c];
+
+            map<string, Array2D<half> >::const_iterator i =
+                img.halfChannels.find (name);
+
+            for (int y = 0; y < h; ++y)
+            {
+                for (int x = 0; x < w; ++x)
+                {
+                    size_t index = (y * w + x) * n + c;
+
+                    if (group.type == HALF)
+                    {
+                        half v;
+                        memcpy (&v, &buffers[g][index * sizeof (half)],
+                                sizeof (half));
+
+                        half expected;
+
+                        if (i != img.halfChannels.end())
+                            expected = i->second[y][x];
+                        else if (name == "depth")
+                            expected = floatToHalf (img.depth[y][x]);
+                        else
+                            expected = HALF_FILL_VALUE;
+
+                        assert (v.bits() == expected.bits());
+                    }
+                    else if (group.type == FLOAT)
+                    {
+                        float v;
+                        memcpy (&v, &buffers[g][index * sizeof (float)],
+                                sizeof (float));
+
+                        float expected;
+
+                        if (i != img.halfChannels.end())
+                            expected = i->second[y][x];
+                        else if (name == "depth")
+                            expected = img.depth[y][x];
+                        else
+                            expected = FLOAT_FILL_VALUE;
+
+                        assert (memcmp (&v, &expected, sizeof (float)) == 0);
+                    }
+                    else
+                    {
+                        unsigned int v;
+                        memcpy (&v, &buffers[g][index * sizeof (unsigned int)],
+                                sizeof (unsigned int));
+
+                        assert (name == "id" && v == img.id[y][x]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+void
+testLayouts (const string &fileName, const Image &img)
+{
+    //
+    // All twelve half channels interleaved, in reverse order;
+    // the float and uint channels in planar buffers.
+    //
+
+    {
+        cout << "      interleaved" << flush;
+
+        vector<Group> layout;
+        Group all (HALF, "c11", "c10", "c09", "c08", "c07", "c06", "c05");
+
+        for (int i = 4; i >= 0; --i)
+            all.names.push_back (halfChannelName (i));
+
+        layout.push_back (all);
+        layout.push_back (Group (FLOAT, "depth"));
+        layout.push_back (Group (UINT, "id"));
+        readAndCompare (fileName, img, layout, true);
+    }
+
+    //
+    // Every channel in a buffer of its own
+    //
+
+    {
+        cout << ", planar" << flush;
+
+        vector<Group> layout;
+
+        for (int i = 0; i < NUM_HALF_CHANNELS; ++i)
+            layout.push_back (Group (HALF, i, i));
+
+        layout.push_back (Group (FLOAT, "depth"));
+        readAndCompare (fileName, img, layout, true);
+    }
+
+    //
+    // Half channels converted to interleaved and planar floats
+    //
+
+    {
+        cout << ", float" << flush;
+
+        vector<Group> layout;
+        layout.push_back (Group (FLOAT, 0, 3));
+        layout.push_back (Group (FLOAT, 4, 4));
+        layout.push_back (Group (FLOAT, 5, 11));
+        readAndCompare (fileName, img, layout, true);
+    }
+
+    //
+    // Groups whose sizes are not multiples of four, with filled
+    // channels; channel c11 is skipped.
+    //
+
+    {
+        cout << ", odd groups" << flush;
+
+        vector<Group> layout;
+        layout.push_back (Group (HALF, 0, 4));
+        layout.push_back (Group (HALF, "c05", "c06", "missing1",
+                                 "c07", "c08", "c09"));
+        layout.push_back (Group (HALF, "c10", "missing2"));
+        layout.push_back (Group (FLOAT, "missing3"));
+        readAndCompare (fileName, img, layout, true);
+    }
+
+    //
+    // RGB and RGBA groups, with and without filled alpha, and
+    // a three-channel group with a filled channel in the middle.
+    //
+
+    {
+        cout << ", rgba" << flush;
+
+        vector<Group> layout;
+        layout.push_back (Group (HALF, "c00", "missing1", "c01"));
+        layout.push_back (Group (HALF, "c02", "c03", "c04", "missing2"));
+        layout.push_back (Group (HALF, 5, 7));
+        layout.push_back (Group (HALF, 8, 11));
+        readAndCompare (fileName, img, layout, true);
+    }
+
+    //
+    // Converting float to half is not optimized
+    //
+
+    {
+        cout << ", not optimized" << endl;
+
+        vector<Group> layout;
+        layout.push_back (Group (HALF, 0, 11));
+        layout.push_back (Group (HALF, "depth"));
+        layout.push_back (Group (UINT, "id"));
+        readAndCompare (fileName, img, layout, false);
+    }
+}
+
+} // namespace
+
+
+void
+testOptimizedMultiChannel (const string &tempDir)
+{
+    try
+    {
+        cout << "Testing optimized reading of multi-channel images" << endl;
+
+        string fileName = tempDir + "imf_test_optimized_multi_channel.exr";
+
+        const int widths[] = {1, 7, 8, 9, 31, 117};
+        const int nWidths = sizeof (widths) / sizeof (widths[0]);
+
+        const Compression compressions[] = {NO_COMPRESSION,
+                                            ZIP_COMPRESSION};
+
+        Rand48 rand (0);
+
+        for (int c = 0; c < 2; ++c)
+        {
+            for (int i = 0; i < nWidths; ++i)
+            {
+                cout << "   compression " << compressions[c] <<
+                        ", width " << widths[i] << endl;
+
+                Image img;
+                img.dw = Box2i (V2i (-3, 5), V2i (widths[i] - 4, 5 + 18));
+                fillImage (img, rand);
+
+                writeImage (fileName, img, compressions[c]);
+                testLayouts (fileName, img);
+            }
+        }
+
+        remove (fileName.c_str());
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
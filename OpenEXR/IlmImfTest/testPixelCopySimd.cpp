@@ -0,0 +1,472 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include "testPixelCopySimd.h"
+
+#include <ImfPixelCopySimd.h>
+#include <ImfConvert.h>
+#include <ImfOutputFile.h>
+#include <ImfInputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfArray.h>
+#include <ImathRandom.h>
+#include <half.h>
+#include <vector>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+
+
+namespace {
+
+const char *levelNames[] = {"baseline", "AVX2", "AVX-512"};
+
+const unsigned char SENTINEL = 0xa5;
+
+
+bool
+sameBits (float a, float b)
+{
+    return memcmp (&a, &b, sizeof (float)) == 0;
+}
+
+
+//
+// Returns random half bit patterns, with plenty of
+// zeroes, denormals, infinities and NaNs mixed in.
+//
+
+unsigned short
+randomHalfBits (Rand48 &rand)
+{
+    switch (rand.nexti() % 8)
+    {
+      case 0:
+        return rand.nexti() & 0x83ff;                   // zero or denormal
+      case 1:
+        return (rand.nexti() & 0x83ff) | 0x7c00;        // infinity or NaN
+      default:
+        return rand.nexti() & 0xffff;
+    }
+}
+
+
+void
+testConvertHalfToFloat (Rand48 &rand)
+{
+    //
+    // Every half value, contiguous
+    //
+
+    {
+        vector<unsigned short> src (65536);
+        vector<float> dst (65536);
+
+        for (int i = 0; i < 65536; ++i)
+            src[i] = (unsigned short) i;
+
+        convertHalfToFloat ((const char *) &src[0],
+                            (char *) &dst[0],
+                            sizeof (float),
+                            src.size());
+
+        for (int i = 0; i < 65536; ++i)
+        {
+            half h;
+            h.setBits (src[i]);
+            assert (sameBits (dst[i], float (h)));
+        }
+    }
+
+    //
+    // Short rows, different strides, unaligned buffers
+    //
+
+    for (size_t stride = 4; stride <= 20; stride += 4)
+    {
+        for (size_t n = 0; n < 70; ++n)
+        {
+            vector<unsigned short> src (n + 1);
+            vector<char> srcBytes (2 * n + 1);
+            vector<char> dst ((n + 1) * stride + 8, SENTINEL);
+
+            for (size_t i = 0; i < n; ++i)
+                src[i] = randomHalfBits (rand);
+
+            if (n > 0)
+                memcpy (&srcBytes[1], &src[0], 2 * n);
+
+            convertHalfToFloat (&srcBytes[1], &dst[2], stride, n);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                half h;
+                h.setBits (src[i]);
+
+                float f;
+                memcpy (&f, &dst[2 + i * stride], sizeof (float));
+                assert (sameBits (f, float (h)));
+
+                for (size_t j = sizeof (float); j < stride; ++j)
+                    assert ((unsigned char) dst[2 + i * stride + j] == SENTINEL);
+            }
+
+            for (size_t j = 2 + n * stride; j < dst.size(); ++j)
+                assert ((unsigned char) dst[j] == SENTINEL);
+        }
+    }
+}
+
+
+void
+testGatherHalf (Rand48 &rand)
+{
+    for (size_t stride = 2; stride <= 16; stride += 2)
+    {
+        for (size_t n = 0; n < 70; ++n)
+        {
+            //
+            // The source buffer ends right after the last half,
+            // so that reading past it would be caught by memory
+            // checking tools.
+            //
+
+            size_t srcSize = n? (n - 1) * stride + 2: 0;
+            vector<char> src (srcSize + 1);
+            vector<unsigned short> dst (n + 4, SENTINEL * 0x101);
+
+            for (size_t i = 0; i < srcSize; ++i)
+                src[i] = char (rand.nexti());
+
+            gatherHalf (&src[0], stride, (char *) &dst[0], n);
+
+            for (size_t i = 0; i < n; ++i)
+                assert (memcmp (&dst[i], &src[i * stride], 2) == 0);
+
+            for (size_t i = n; i < dst.size(); ++i)
+                assert (dst[i] == SENTINEL * 0x101);
+        }
+    }
+}
+
+
+void
+testInterleave (Rand48 &rand, bool fillAlpha)
+{
+    for (size_t n = 0; n < 140; ++n)
+    {
+        vector<unsigned short> r (n + 1), g (n + 1), b (n + 1), a (n + 1);
+        vector<unsigned short> dst (4 * n + 8, SENTINEL * 0x101);
+        unsigned short alpha = randomHalfBits (rand);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            r[i] = randomHalfBits (rand);
+            g[i] = randomHalfBits (rand);
+            b[i] = randomHalfBits (rand);
+            a[i] = randomHalfBits (rand);
+        }
+
+        size_t copied = fillAlpha?
+            interleaveRGBAFillA (&r[0], &g[0], &b[0], alpha, &dst[0], n):
+            interleaveRGBA (&r[0], &g[0], &b[0], &a[0], &dst[0], n);
+
+        assert (copied <= n && copied % 16 == 0);
+        assert (simdLevel() != SIMD_BASELINE || copied == 0);
+        assert (simdLevel() == SIMD_BASELINE || copied == n - n % 16);
+
+        for (size_t i = 0; i < copied; ++i)
+        {
+            assert (dst[4 * i + 0] == r[i]);
+            assert (dst[4 * i + 1] == g[i]);
+            assert (dst[4 * i + 2] == b[i]);
+            assert (dst[4 * i + 3] == (fillAlpha? alpha: a[i]));
+        }
+
+        for (size_t i = 4 * copied; i < dst.size(); ++i)
+            assert (dst[i] == SENTINEL * 0x101);
+    }
+}
+
+
+//
+// Write a file from a strided half frame buffer, and read it back
+// into a float frame buffer and into a strided half frame buffer.
+// This runs the kernels through copyFromFrameBuffer() and
+// copyIntoFrameBuffer().
+//
+
+void
+testFileIo (Rand48 &rand, const string &fileName, Compression compression)
+{
+    const int W = 117;
+    const int H = 19;
+
+    struct Pixel
+    {
+        half  h;
+        float f;
+        half  pad;
+    };
+
+    Array2D<Pixel> pixels (H, W);
+
+    for (int y = 0; y < H; ++y)
+    {
+        for (int x = 0; x < W; ++x)
+        {
+            pixels[y][x].h.setBits (randomHalfBits (rand));
+            pixels[y][x].f = rand.nextf (-1e10, 1e10);
+        }
+    }
+
+    {
+        Header hdr (W, H);
+        hdr.compression() = compression;
+        hdr.channels().insert ("H", Channel (HALF));
+        hdr.channels().insert ("F", Channel (FLOAT));
+
+        FrameBuffer fb;
+
+        fb.insert ("H", Slice (HALF,
+                               (char *) &pixels[0][0].h,
+                               sizeof (Pixel),
+                               sizeof (Pixel) * W));
+
+        fb.insert ("F", Slice (FLOAT,
+                               (char *) &pixels[0][0].f,
+                               sizeof (Pixel),
+                               sizeof (Pixel) * W));
+
+        OutputFile out (fileName.c_str(), hdr);
+        out.setFrameBuffer (fb);
+        out.writePixels (H);
+    }
+
+    {
+        Array2D<float> hAsFloat (H, W);
+        Array2D<float> f (H, W);
+        Array2D<Pixel> strided (H, W);
+
+        FrameBuffer fb;
+
+        fb.insert ("H", Slice (FLOAT,
+                               (char *) &hAsFloat[0][0],
+                               sizeof (float),
+                               sizeof (float) * W));
+
+        fb.insert ("F", Slice (FLOAT,
+                               (char *) &f[0][0],
+                               sizeof (float),
+                               sizeof (float) * W));
+
+        InputFile in (fileName.c_str());
+        in.setFrameBuffer (fb);
+        in.readPixels (0, H - 1);
+
+        FrameBuffer fb2;
+
+        fb2.insert ("H", Slice (HALF,
+                                (char *) &strided[0][0].h,
+                                sizeof (Pixel),
+                                sizeof (Pixel) * W));
+
+        fb2.insert ("F", Slice (FLOAT,
+                                (char *) &strided[0][0].f,
+                                sizeof (Pixel),
+                                sizeof (Pixel) * W));
+
+        in.setFrameBuffer (fb2);
+        in.readPixels (0, H - 1);
+
+        for (int y = 0; y < H; ++y)
+        {
+            for (int x = 0; x < W; ++x)
+            {
+                assert (sameBits (hAsFloat[y][x], float (pixels[y][x].h)));
+                assert (sameBits (f[y][x], pixels[y][x].f));
+
+                assert (strided[y][x].h.bits() == pixels[y][x].h.bits());
+                assert (sameBits (strided[y][x].f, pixels[y][x].f));
+            }
+        }
+    }
+
+    remove (fileName.c_str());
+}
+
+
+//
+// Write a file with UINT, HALF and FLOAT channels, and read
+// each channel into frame buffer slices of the other types.
+// The results must match the per-pixel conversion functions
+// in ImfConvert.h.
+//
+
+void
+testTypeConversions (Rand48 &rand, const string &fileName)
+{
+    const int W = 131;
+    const int H = 7;
+
+    Array2D<unsigned int> ui (H, W);
+    Array2D<half> h (H, W);
+    Array2D<float> f (H, W);
+
+    const float specialFloats[] =
+    {
+        65504.0f, 65505.0f, 65519.0f, 65520.0f, -65510.0f, 1e30f, -1e30f,
+        6.0e-8f, 3.0e-8f, -2.9e-8f, 1e-40f, 0.0f, -0.0f
+    };
+
+    const int numSpecialFloats = sizeof (specialFloats) / sizeof (float);
+
+    for (int y = 0; y < H; ++y)
+    {
+        for (int x = 0; x < W; ++x)
+        {
+            int i = y * W + x;
+
+            ui[y][x] = (i % 3)? rand.nexti() % 70000: rand.nexti();
+            h[y][x].setBits (randomHalfBits (rand));
+
+            if (i % 4 == 0)
+            {
+                f[y][x] = specialFloats[(i / 4) % numSpecialFloats];
+            }
+            else if (i % 17 == 0)
+            {
+                unsigned int nanBits = 0x7f800001 | (rand.nexti() & 0x807fffff);
+                memcpy (&f[y][x], &nanBits, sizeof (float));
+            }
+            else
+            {
+                f[y][x] = rand.nextf (-70000, 70000);
+            }
+        }
+    }
+
+    {
+        Header hdr (W, H);
+        hdr.channels().insert ("U", Channel (UINT));
+        hdr.channels().insert ("H", Channel (HALF));
+        hdr.channels().insert ("F", Channel (FLOAT));
+
+        FrameBuffer fb;
+        fb.insert ("U", Slice (UINT, (char *) &ui[0][0], sizeof (ui[0][0]), sizeof (ui[0][0]) * W));
+        fb.insert ("H", Slice (HALF, (char *) &h[0][0], sizeof (h[0][0]), sizeof (h[0][0]) * W));
+        fb.insert ("F", Slice (FLOAT, (char *) &f[0][0], sizeof (f[0][0]), sizeof (f[0][0]) * W));
+
+        OutputFile out (fileName.c_str(), hdr);
+        out.setFrameBuffer (fb);
+        out.writePixels (H);
+    }
+
+    {
+        Array2D<half> uAsHalf (H, W);
+        Array2D<half> fAsHalf (H, W);
+        Array2D<unsigned int> hAsUint (H, W);
+
+        FrameBuffer fb;
+        fb.insert ("U", Slice (HALF, (char *) &uAsHalf[0][0], sizeof (half), sizeof (half) * W));
+        fb.insert ("F", Slice (HALF, (char *) &fAsHalf[0][0], sizeof (half), sizeof (half) * W));
+        fb.insert ("H", Slice (UINT, (char *) &hAsUint[0][0], sizeof (unsigned int), sizeof (unsigned int) * W));
+
+        InputFile in (fileName.c_str());
+        in.setFrameBuffer (fb);
+        in.readPixels (0, H - 1);
+
+        for (int y = 0; y < H; ++y)
+        {
+            for (int x = 0; x < W; ++x)
+            {
+                assert (uAsHalf[y][x].bits() == uintToHalf (ui[y][x]).bits());
+                assert (fAsHalf[y][x].bits() == floatToHalf (f[y][x]).bits());
+                assert (hAsUint[y][x] == halfToUint (h[y][x]));
+            }
+        }
+    }
+
+    remove (fileName.c_str());
+}
+
+} // namespace
+
+
+void
+testPixelCopySimd (const string &tempDir)
+{
+    cout << "Testing pixel copy kernels at all supported SIMD levels" << endl;
+
+    SimdLevel maxLevel = maxSimdLevel();
+
+    for (int l = SIMD_BASELINE; l <= maxLevel; ++l)
+    {
+        SimdLevel level = SimdLevel (l);
+        setSimdLevel (level);
+        assert (simdLevel() == level);
+
+        cout << "   " << levelNames[level] << endl;
+
+        Rand48 rand (l);
+
+        testConvertHalfToFloat (rand);
+        testGatherHalf (rand);
+        testInterleave (rand, false);
+        testInterleave (rand, true);
+
+        string fileName = tempDir + "imf_test_pixel_copy_simd.exr";
+
+        testFileIo (rand, fileName, NO_COMPRESSION);
+        testFileIo (rand, fileName, ZIP_COMPRESSION);
+        testFileIo (rand, fileName, PIZ_COMPRESSION);
+        testTypeConversions (rand, fileName);
+    }
+
+    //
+    // Levels above the supported maximum are clamped.
+    //
+
+    setSimdLevel (SIMD_AVX512);
+    assert (simdLevel() == maxLevel);
+
+    cout << "ok\n" << endl;
+}
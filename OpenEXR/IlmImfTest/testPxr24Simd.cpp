@@ -0,0 +1,279 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include "testPxr24Simd.h"
+
+#include <ImfPxr24Compressor.h>
+#include <ImfPixelCopySimd.h>
+#include <ImfHeader.h>
+#include <ImfChannelList.h>
+#include <ImfMisc.h>
+#include <ImathRandom.h>
+#include <ImathFun.h>
+#include <vector>
+#include <iostream>
+#include <string.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+
+
+namespace {
+
+const char *levelNames[] = {"baseline", "AVX2", "AVX-512"};
+
+
+//
+// The conversion from 32-bit to 24-bit floats, as it was
+// written before it was vectorized.
+//
+
+unsigned int
+referenceFloatToFloat24 (unsigned int u)
+{
+    unsigned int s = u & 0x80000000;
+    unsigned int e = u & 0x7f800000;
+    unsigned int m = u & 0x007fffff;
+    unsigned int i;
+
+    if (e == 0x7f800000)
+    {
+        if (m)
+        {
+            m >>= 8;
+            i = (e >> 8) | m | (m == 0);
+        }
+        else
+        {
+            i = e >> 8;
+        }
+    }
+    else
+    {
+        i = ((e | m) + (m & 0x00000080)) >> 8;
+
+        if (i >= 0x7f8000)
+            i = (e | m) >> 8;
+    }
+
+    return (s >> 8) | i;
+}
+
+
+unsigned int
+floatBits (Rand48 &rand)
+{
+    //
+    // Random bit patterns, with extra weight on the
+    // cases that floatToFloat24() treats specially.
+    //
+
+    unsigned int u = (unsigned int) rand.nexti() ^
+                     ((unsigned int) rand.nexti() << 16);
+
+    switch (rand.nexti() % 8)
+    {
+      case 0:	// NaN that would become an infinity if truncated
+        return (u & 0x80000000) | 0x7f800000 | (u & 0xff) | 1;
+
+      case 1:	// infinity
+        return (u & 0x80000000) | 0x7f800000;
+
+      case 2:	// close to FLT_MAX
+        return (u & 0x80000000) | 0x7f7fff00 | (u & 0xff);
+
+      case 3:	// rounds up into the next binade
+        return (u & 0xff800000) | 0x007fff80 | (u & 0x7f);
+
+      case 4:	// small differences
+        return 0x3f800000 | (u & 0xfff);
+
+      default:
+        return u;
+    }
+}
+
+
+Header
+makeHeader (int width, int height)
+{
+    Header hdr (width, height);
+
+    hdr.channels().insert ("F", Channel (FLOAT));
+    hdr.channels().insert ("H", Channel (HALF));
+    hdr.channels().insert ("S", Channel (HALF, 2, 2));
+    hdr.channels().insert ("U", Channel (UINT));
+
+    return hdr;
+}
+
+
+void
+testCompress (int width, int height)
+{
+    Header hdr = makeHeader (width, height);
+
+    //
+    // Fill the input buffer, scan line by scan line and channel
+    // by channel, and compute the pixels that uncompressing the
+    // compressed data should return.
+    //
+
+    Rand48 rand (width * 31 + height);
+    vector<char> raw;
+    vector<char> expected;
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (ChannelList::ConstIterator i = hdr.channels().begin();
+             i != hdr.channels().end();
+             ++i)
+        {
+            const Channel &c = i.channel();
+
+            if (modp (y, c.ySampling) != 0)
+                continue;
+
+            int n = numSamples (c.xSampling, 0, width - 1);
+
+            for (int x = 0; x < n; ++x)
+            {
+                if (c.type == HALF)
+                {
+                    unsigned short h = (unsigned short) rand.nexti();
+
+                    if (rand.nexti() % 2)
+                        h = 0x3c00 | (h & 0x3f);
+
+                    raw.insert (raw.end(), (char *) &h, (char *) &h + 2);
+                    expected.insert (expected.end(),
+                                     (char *) &h, (char *) &h + 2);
+                }
+                else if (c.type == FLOAT)
+                {
+                    unsigned int f = floatBits (rand);
+                    unsigned int f24 = referenceFloatToFloat24 (f) << 8;
+
+                    raw.insert (raw.end(), (char *) &f, (char *) &f + 4);
+                    expected.insert (expected.end(),
+                                     (char *) &f24, (char *) &f24 + 4);
+                }
+                else
+                {
+                    unsigned int u = (unsigned int) rand.nexti() ^
+                                     ((unsigned int) rand.nexti() << 16);
+
+                    if (rand.nexti() % 2)
+                        u = 1000 + (u & 0xff);
+
+                    raw.insert (raw.end(), (char *) &u, (char *) &u + 4);
+                    expected.insert (expected.end(),
+                                     (char *) &u, (char *) &u + 4);
+                }
+            }
+        }
+    }
+
+    size_t lineSize = raw.size() / height + 16;
+
+    //
+    // The compressed data must be identical for all instruction
+    // set levels, and uncompressing them must reproduce the input
+    // pixels, with FLOAT pixels rounded to 24 bits.
+    //
+
+    SimdLevel maxLevel = maxSimdLevel();
+    vector<char> refCompressed;
+
+    for (int l = SIMD_BASELINE; l <= maxLevel; ++l)
+    {
+        setSimdLevel (SimdLevel (l));
+
+        Pxr24Compressor comp (hdr, lineSize, 16);
+
+        const char *outPtr;
+        int outSize = comp.compress (&raw[0], raw.size(), 0, outPtr);
+        vector<char> compressed (outPtr, outPtr + outSize);
+
+        if (l == SIMD_BASELINE)
+            refCompressed = compressed;
+        else
+            assert (compressed == refCompressed);
+
+        outSize = comp.uncompress (&refCompressed[0], refCompressed.size(),
+                                   0, outPtr);
+
+        assert (outSize == int (expected.size()));
+        assert (!memcmp (outPtr, &expected[0], outSize));
+    }
+
+    setSimdLevel (maxLevel);
+}
+
+} // namespace
+
+
+void
+testPxr24Simd (const std::string &)
+{
+    try
+    {
+        cout << "Testing PXR24 pixel conversion for all instruction "
+                "set levels" << endl;
+
+        SimdLevel maxLevel = maxSimdLevel();
+
+        for (int l = SIMD_BASELINE; l <= maxLevel; ++l)
+            cout << "   " << levelNames[l] << endl;
+
+        static const int widths[] =
+            {1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 100, 257};
+
+        for (int i = 0; i < int (sizeof (widths) / sizeof (widths[0])); ++i)
+        {
+            testCompress (widths[i], 1);
+            testCompress (widths[i], 16);
+        }
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
@@ -0,0 +1,616 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include "testRawChunkDecode.h"
+
+#include <ImfInputFile.h>
+#include <ImfOutputFile.h>
+#include <ImfScanLineInputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfTiledOutputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfArray.h>
+#include <IlmThreadPool.h>
+#include <ImathRandom.h>
+#include <Iex.h>
+#include <half.h>
+#include <vector>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+using namespace ILMTHREAD_NAMESPACE;
+
+
+namespace {
+
+//
+// The images have a half, a float and a uint channel; the scan line
+// images also have a half channel that is subsampled in x and y.
+//
+
+struct Pixels
+{
+    Array2D<half>         h;
+    Array2D<float>        f;
+    Array2D<unsigned int> u;
+    Array2D<half>         s;        // subsampled
+
+    int width;
+    int height;
+
+    void
+    resize (int newWidth, int newHeight)
+    {
+        width = newWidth;
+        height = newHeight;
+        h.resizeErase (height, width);
+        f.resizeErase (height, width);
+        u.resizeErase (height, width);
+        s.resizeErase (height / 2 + 1, width / 2 + 1);
+    }
+
+    void
+    erase ()
+    {
+        memset (&h[0][0], 0, sizeof (half) * width * height);
+        memset (&f[0][0], 0, sizeof (float) * width * height);
+        memset (&u[0][0], 0, sizeof (unsigned int) * width * height);
+        memset (&s[0][0], 0, sizeof (half) * (width / 2 + 1) * (height / 2 + 1));
+    }
+
+    bool
+    operator == (const Pixels &other) const
+    {
+        return memcmp (&h[0][0], &other.h[0][0],
+                       sizeof (half) * width * height) == 0 &&
+               memcmp (&f[0][0], &other.f[0][0],
+                       sizeof (float) * width * height) == 0 &&
+               memcmp (&u[0][0], &other.u[0][0],
+                       sizeof (unsigned int) * width * height) == 0 &&
+               memcmp (&s[0][0], &other.s[0][0],
+                       sizeof (half) * (width / 2 + 1) * (height / 2 + 1)) == 0;
+    }
+};
+
+
+//
+// Frame buffer for the pixels; origin is the
+// pixel that goes into pixels[0][0].
+//
+
+FrameBuffer
+frameBuffer (Pixels &pixels, const V2i &origin, bool subsampled)
+{
+    int w = pixels.width;
+    FrameBuffer fb;
+
+    fb.insert ("H", Slice (HALF,
+                           (char *) (&pixels.h[0][0] - origin.x - origin.y * w),
+                           sizeof (half),
+                           sizeof (half) * w));
+
+    fb.insert ("F", Slice (FLOAT,
+                           (char *) (&pixels.f[0][0] - origin.x - origin.y * w),
+                           sizeof (float),
+                           sizeof (float) * w));
+
+    fb.insert ("U", Slice (UINT,
+                           (char *) (&pixels.u[0][0] - origin.x - origin.y * w),
+                           sizeof (unsigned int),
+                           sizeof (unsigned int) * w));
+
+    if (subsampled)
+    {
+        int sw = w / 2 + 1;
+
+        fb.insert ("S", Slice (HALF,
+                               (char *) (&pixels.s[0][0] -
+                                         origin.x / 2 - origin.y / 2 * sw),
+                               sizeof (half),
+                               sizeof (half) * sw,
+                               2, 2));
+    }
+
+    return fb;
+}
+
+
+void
+fillPixels (Pixels &pixels, Rand48 &rand)
+{
+    for (int y = 0; y < pixels.height; ++y)
+    {
+        for (int x = 0; x < pixels.width; ++x)
+        {
+            pixels.h[y][x] = half (float (rand.nextf (-100, 100)));
+            pixels.f[y][x] = float (rand.nextf (-1e6, 1e6));
+            pixels.u[y][x] = rand.nexti();
+        }
+    }
+
+    for (int y = 0; y < pixels.height / 2 + 1; ++y)
+        for (int x = 0; x < pixels.width / 2 + 1; ++x)
+            pixels.s[y][x] = half (float (rand.nextf (0, 1)));
+}
+
+
+//
+// A chunk of raw pixel data, as it might be shipped to another process
+//
+
+struct Chunk
+{
+    vector<char> data;
+    int y;                      // first scan line in the chunk
+    int dx, dy, lx, ly;         // tile coordinates
+};
+
+
+class DecodeScanLineTask: public Task
+{
+  public:
+
+    DecodeScanLineTask (TaskGroup *group,
+                        const Header &header,
+                        const Chunk &chunk,
+                        const FrameBuffer &fb,
+                        int y1, int y2)
+    :
+        Task (group), _header (header), _chunk (chunk), _fb (fb),
+        _y1 (y1), _y2 (y2)
+    {}
+
+    virtual void
+    execute ()
+    {
+        ScanLineInputFile::decodeRawPixelData (_header,
+                                               &_chunk.data[0],
+                                               _chunk.data.size(),
+                                               _fb, _y1, _y2);
+    }
+
+  private:
+
+    const Header &_header;
+    const Chunk &_chunk;
+    const FrameBuffer &_fb;
+    int _y1;
+    int _y2;
+};
+
+
+void
+testScanLines (const string &fileName, Compression comp, Rand48 &rand)
+{
+    cout << "   scan lines, compression " << comp << endl;
+
+    const int W = 98;
+    const int H = 84;
+
+    //
+    // The subsampled channel requires the data window's corner
+    // to be at even coordinates, and its size to be even.
+    //
+
+    const Box2i dw (V2i (-8, 10), V2i (-8 + W - 1, 10 + H - 1));
+
+    Header hdr (dw, dw);
+    hdr.compression() = comp;
+    hdr.lineOrder() = (rand.nexti() & 1)? INCREASING_Y: DECREASING_Y;
+    hdr.channels().insert ("H", Channel (HALF));
+    hdr.channels().insert ("F", Channel (FLOAT));
+    hdr.channels().insert ("U", Channel (UINT));
+    hdr.channels().insert ("S", Channel (HALF, 2, 2));
+
+    Pixels pixels;
+    pixels.resize (W, H);
+    fillPixels (pixels, rand);
+
+    {
+        OutputFile out (fileName.c_str(), hdr);
+        out.setFrameBuffer (frameBuffer (pixels, dw.min, true));
+        out.writePixels (H);
+    }
+
+    //
+    // Read the image the usual way, and fetch its raw chunks.
+    //
+
+    Pixels expected;
+    expected.resize (W, H);
+    expected.erase();
+
+    vector<Chunk> chunks;
+
+    InputFile in (fileName.c_str());
+    in.setFrameBuffer (frameBuffer (expected, dw.min, true));
+    in.readPixels (dw.min.y, dw.max.y);
+
+    for (int y = dw.min.y; y <= dw.max.y; y = in.lastScanLineInChunk (y) + 1)
+    {
+        assert (in.firstScanLineInChunk (y) == y);
+
+        const char *data;
+        int size;
+        in.rawPixelData (y, data, size);
+
+        chunks.push_back (Chunk());
+        chunks.back().data.assign (data, data + size);
+        chunks.back().y = y;
+    }
+
+    //
+    // Decode the chunks in a thread pool, using only the header.
+    //
+
+    {
+        Pixels decoded;
+        decoded.resize (W, H);
+        decoded.erase();
+
+        Header header = in.header();
+        FrameBuffer fb = frameBuffer (decoded, dw.min, true);
+        ThreadPool pool (3);
+
+        {
+            TaskGroup group;
+
+            for (size_t i = 0; i < chunks.size(); ++i)
+            {
+                pool.addTask (new DecodeScanLineTask
+                              (&group, header, chunks[i], fb,
+                               chunks[i].y,
+                               in.lastScanLineInChunk (chunks[i].y)));
+            }
+        }
+
+        assert (decoded == expected);
+    }
+
+    //
+    // Decode single scan lines through the file, in reverse order.
+    //
+
+    {
+        Pixels decoded;
+        decoded.resize (W, H);
+        decoded.erase();
+
+        FrameBuffer fb = frameBuffer (decoded, dw.min, true);
+
+        for (int i = int (chunks.size()) - 1; i >= 0; --i)
+        {
+            int y1 = chunks[i].y;
+            int y2 = in.lastScanLineInChunk (y1);
+
+            for (int y = y2; y >= y1; --y)
+            {
+                in.readPixels (&chunks[i].data[0], chunks[i].data.size(),
+                               fb, y, y);
+            }
+        }
+
+        assert (decoded == expected);
+    }
+
+    //
+    // Errors
+    //
+
+    Pixels dummy;
+    dummy.resize (W, H);
+    FrameBuffer fb = frameBuffer (dummy, dw.min, true);
+
+    if (chunks.size() > 1)
+    {
+        try
+        {
+            in.readPixels (&chunks[0].data[0], chunks[0].data.size(), fb,
+                           chunks[0].y, chunks[1].y);
+            assert (false);
+        }
+        catch (const IEX_NAMESPACE::ArgExc &)
+        {
+            // expected
+        }
+    }
+
+    try
+    {
+        in.readPixels (&chunks[0].data[0], chunks[0].data.size(), fb,
+                       dw.min.y - 1, dw.min.y);
+        assert (false);
+    }
+    catch (const IEX_NAMESPACE::ArgExc &)
+    {
+        // expected
+    }
+
+    if (comp == NO_COMPRESSION)
+    {
+        try
+        {
+            in.readPixels (&chunks[0].data[0], chunks[0].data.size() / 2, fb,
+                           chunks[0].y, chunks[0].y);
+            assert (false);
+        }
+        catch (const IEX_NAMESPACE::InputExc &)
+        {
+            // expected
+        }
+    }
+
+    remove (fileName.c_str());
+}
+
+
+class DecodeTileTask: public Task
+{
+  public:
+
+    DecodeTileTask (TaskGroup *group,
+                    const Header &header,
+                    const Chunk &chunk,
+                    const FrameBuffer &fb)
+    :
+        Task (group), _header (header), _chunk (chunk), _fb (fb)
+    {}
+
+    virtual void
+    execute ()
+    {
+        TiledInputFile::decodeRawTileData (_header,
+                                           &_chunk.data[0],
+                                           _chunk.data.size(),
+                                           _fb,
+                                           _chunk.dx, _chunk.dy,
+                                           _chunk.lx, _chunk.ly);
+    }
+
+  private:
+
+    const Header &_header;
+    const Chunk &_chunk;
+    const FrameBuffer &_fb;
+};
+
+
+void
+testTiles (const string &fileName, Compression comp, Rand48 &rand)
+{
+    cout << "   tiles, compression " << comp << endl;
+
+    const int W = 101;
+    const int H = 67;
+    const Box2i dw (V2i (3, -5), V2i (3 + W - 1, -5 + H - 1));
+
+    Header hdr (dw, dw);
+    hdr.compression() = comp;
+    hdr.setTileDescription (TileDescription (16, 12, MIPMAP_LEVELS,
+                                             ROUND_UP));
+    hdr.channels().insert ("H", Channel (HALF));
+    hdr.channels().insert ("F", Channel (FLOAT));
+    hdr.channels().insert ("U", Channel (UINT));
+
+    //
+    // Write the full-resolution level, and the same
+    // pixels, cropped, for the other levels.
+    //
+
+    Pixels pixels;
+    pixels.resize (W, H);
+    fillPixels (pixels, rand);
+
+    {
+        TiledOutputFile out (fileName.c_str(), hdr);
+        out.setFrameBuffer (frameBuffer (pixels, dw.min, false));
+
+        for (int l = 0; l < out.numLevels(); ++l)
+            out.writeTiles (0, out.numXTiles (l) - 1,
+                            0, out.numYTiles (l) - 1, l);
+    }
+
+    //
+    // Fetch all raw tiles.  For single-part files, rawTileData()
+    // returns the next tile in the file, and sets dx, dy, lx and
+    // ly accordingly; a newly opened file is positioned at the
+    // first tile.
+    //
+
+    vector<Chunk> allChunks;
+
+    {
+        TiledInputFile in (fileName.c_str());
+
+        int numTiles = 0;
+
+        for (int l = 0; l < in.numLevels(); ++l)
+            numTiles += in.numXTiles (l) * in.numYTiles (l);
+
+        for (int i = 0; i < numTiles; ++i)
+        {
+            Chunk chunk;
+            chunk.dx = chunk.dy = chunk.lx = chunk.ly = 0;
+
+            const char *data;
+            int size;
+            in.rawTileData (chunk.dx, chunk.dy, chunk.lx, chunk.ly,
+                            data, size);
+
+            chunk.data.assign (data, data + size);
+            allChunks.push_back (chunk);
+        }
+    }
+
+    TiledInputFile in (fileName.c_str());
+
+    for (int l = 0; l < in.numLevels(); ++l)
+    {
+        Box2i levelDw = in.dataWindowForLevel (l);
+
+        Pixels expected;
+        expected.resize (W, H);
+        expected.erase();
+
+        in.setFrameBuffer (frameBuffer (expected, levelDw.min, false));
+        in.readTiles (0, in.numXTiles (l) - 1, 0, in.numYTiles (l) - 1, l);
+
+        //
+        // Decode the level's raw tiles in a thread pool, using
+        // only the header, and then through the file.
+        //
+
+        vector<Chunk> chunks;
+
+        for (size_t i = 0; i < allChunks.size(); ++i)
+        {
+            if (allChunks[i].lx == l)
+                chunks.push_back (allChunks[i]);
+        }
+
+        assert (int (chunks.size()) == in.numXTiles (l) * in.numYTiles (l));
+
+        Pixels decoded;
+        decoded.resize (W, H);
+        decoded.erase();
+
+        Header header = in.header();
+        FrameBuffer fb = frameBuffer (decoded, levelDw.min, false);
+
+        {
+            ThreadPool pool (3);
+            TaskGroup group;
+
+            for (size_t i = 0; i < chunks.size(); ++i)
+                pool.addTask (new DecodeTileTask (&group, header, chunks[i], fb));
+        }
+
+        assert (decoded == expected);
+
+        decoded.erase();
+
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            in.readTile (&chunks[i].data[0], chunks[i].data.size(), fb,
+                         chunks[i].dx, chunks[i].dy,
+                         chunks[i].lx, chunks[i].ly);
+        }
+
+        assert (decoded == expected);
+    }
+
+    //
+    // Errors
+    //
+
+    Pixels dummy;
+    dummy.resize (W, H);
+    FrameBuffer fb = frameBuffer (dummy, dw.min, false);
+    vector<char> data (16);
+
+    try
+    {
+        in.readTile (&data[0], data.size(), fb, in.numXTiles (0), 0, 0, 0);
+        assert (false);
+    }
+    catch (const IEX_NAMESPACE::ArgExc &)
+    {
+        // expected
+    }
+
+    try
+    {
+        Header scanLineHeader (W, H);
+        TiledInputFile::decodeRawTileData (scanLineHeader,
+                                           &data[0], data.size(), fb,
+                                           0, 0, 0, 0);
+        assert (false);
+    }
+    catch (const IEX_NAMESPACE::ArgExc &)
+    {
+        // expected
+    }
+
+    remove (fileName.c_str());
+}
+
+} // namespace
+
+
+void
+testRawChunkDecode (const string &tempDir)
+{
+    try
+    {
+        cout << "Testing decoding of raw pixel data chunks" << endl;
+
+        string fileName = tempDir + "imf_test_raw_chunk_decode.exr";
+
+        const Compression compressions[] = {NO_COMPRESSION,
+                                            RLE_COMPRESSION,
+                                            ZIPS_COMPRESSION,
+                                            ZIP_COMPRESSION,
+                                            PIZ_COMPRESSION,
+                                            PXR24_COMPRESSION,
+                                            B44_COMPRESSION,
+                                            B44A_COMPRESSION,
+                                            DWAA_COMPRESSION,
+                                            DWAB_COMPRESSION};
+
+        const int numCompressions =
+            sizeof (compressions) / sizeof (compressions[0]);
+
+        Rand48 rand (1);
+
+        for (int i = 0; i < numCompressions; ++i)
+        {
+            testScanLines (fileName, compressions[i], rand);
+            testTiles (fileName, compressions[i], rand);
+        }
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
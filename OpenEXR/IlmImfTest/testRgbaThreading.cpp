@@ -43,12 +43,15 @@
 #include <assert.h>
 #include <ImathRandom.h>
 #include <ImfThreading.h>
+#include <ImfCompressor.h>
 #include <IlmThread.h>
+#include <IlmThreadPool.h>
 
 
 using namespace OPENEXR_IMF_NAMESPACE;
 using namespace std;
 using namespace IMATH_NAMESPACE;
+using ILMTHREAD_NAMESPACE::ThreadPool;
 
 
 namespace {
@@ -231,6 +234,9 @@ testRgbaThreading (const std::string &tempDir)
 
             for (int comp = 0; comp < NUM_COMPRESSION_METHODS; ++comp)
             {
+                if (!isSupportedCompression (Compression (comp)))
+                    continue;
+
                 for (int lorder = 0; lorder < RANDOM_Y; ++lorder)
                 {
                     writeReadRGBA ((tempDir + "imf_test_rgba.exr").c_str(),
@@ -261,6 +267,47 @@ testRgbaThreading (const std::string &tempDir)
         }
         
 	cout << "ok\n" << endl;
+
+	cout << "Testing the work-stealing thread pool provider" << endl;
+
+        ThreadPool &pool = ThreadPool::globalThreadPool();
+        pool.setProviderType (ThreadPool::WORK_STEALING_PROVIDER);
+        assert (pool.providerType() == ThreadPool::WORK_STEALING_PROVIDER);
+
+        for (int i = 0; i < 500; i++)
+        {
+            int numThreads = int (rand1.nextf() * 16 + 0.5f);
+            setGlobalThreadCount (numThreads);
+            assert (globalThreadCount() == numThreads);
+        }
+
+        for (int n = 0; n <= 8; n++)
+        {
+            int numThreads = (n * 3) % 8;
+
+            setGlobalThreadCount (numThreads);
+            cout << "number of threads: " << globalThreadCount () << endl;
+
+            for (int comp = 0; comp < NUM_COMPRESSION_METHODS; ++comp)
+            {
+                if (!isSupportedCompression (Compression (comp)))
+                    continue;
+
+                for (int lorder = 0; lorder < RANDOM_Y; ++lorder)
+                {
+                    writeReadRGBA ((tempDir + "imf_test_rgba.exr").c_str(),
+                                   W, H, p1,
+                                   WRITE_RGBA,
+                                   LineOrder (lorder),
+                                   Compression (comp));
+                }
+            }
+        }
+
+        pool.setProviderType (ThreadPool::DEFAULT_PROVIDER);
+        assert (pool.providerType() == ThreadPool::DEFAULT_PROVIDER);
+
+	cout << "ok\n" << endl;
     }
     catch (const std::exception &e)
     {
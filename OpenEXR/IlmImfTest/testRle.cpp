@@ -33,6 +33,8 @@
 
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <vector>
 #include <assert.h>
 #include <ImfRle.h>
 #include <ImathRandom.h>
@@ -98,6 +100,103 @@ testRoundTrip(int bufferLen)
 }
 
 
+
+// The encoder as it was written before run detection was
+// vectorized; the compressed data must remain identical.
+int
+referenceRleCompress(int inLength, const char in[], signed char out[])
+{
+    const int MIN_RUN_LENGTH = 3;
+    const int MAX_RUN_LENGTH = 127;
+
+    const char  *inEnd    = in + inLength;
+    const char  *runStart = in;
+    const char  *runEnd   = in + 1;
+    signed char *outWrite = out;
+
+    while (runStart < inEnd) {
+
+        while (runEnd < inEnd &&
+               *runStart == *runEnd &&
+               runEnd - runStart - 1 < MAX_RUN_LENGTH) {
+            ++runEnd;
+        }
+
+        if (runEnd - runStart >= MIN_RUN_LENGTH) {
+
+            *outWrite++ = (runEnd - runStart) - 1;
+            *outWrite++ = *(signed char *) runStart;
+            runStart = runEnd;
+
+        } else {
+
+            while (runEnd < inEnd &&
+                   ((runEnd + 1 >= inEnd ||
+                     *runEnd != *(runEnd + 1)) ||
+                    (runEnd + 2 >= inEnd ||
+                     *(runEnd + 1) != *(runEnd + 2))) &&
+                   runEnd - runStart < MAX_RUN_LENGTH) {
+                ++runEnd;
+            }
+
+            *outWrite++ = runStart - runEnd;
+
+            while (runStart < runEnd) {
+                *outWrite++ = *(signed char *) (runStart++);
+            }
+        }
+
+        ++runEnd;
+    }
+
+    return outWrite - out;
+}
+
+// Compare the compressed data with the reference encoder, for
+// data with runs and literal sequences of all lengths around the
+// 16-byte blocks that the run detection examines at a time.
+void
+testAgainstReference(Rand48 &rand48, int bufferLen)
+{
+    std::vector<char>        src (bufferLen + 1);
+    std::vector<signed char> compressed (2 * bufferLen + 2);
+    std::vector<signed char> reference (2 * bufferLen + 2);
+    std::vector<char>        test (bufferLen + 1);
+
+    int alphabet = 2 + rand48.nexti() % 8;
+    int maxRun   = 1 + rand48.nexti() % 200;
+    int i        = 0;
+
+    while (i < bufferLen) {
+
+        char value = (char) (rand48.nexti() % alphabet);
+        int  runLen = 1 + rand48.nexti() % maxRun;
+
+        for (int j=0; j<runLen && i<bufferLen; ++j)
+            src[i++] = value;
+    }
+
+    int compressedLen = rleCompress(bufferLen, &src[0], &compressed[0]);
+    int referenceLen  = referenceRleCompress(bufferLen, &src[0], &reference[0]);
+
+    assert(compressedLen == referenceLen);
+    assert(std::equal(reference.begin(), reference.begin() + referenceLen,
+                      compressed.begin()));
+
+    if (bufferLen == 0)
+        return;
+
+    assert(rleUncompress(compressedLen, bufferLen,
+                         &compressed[0], &test[0]) == bufferLen);
+
+    assert(std::equal(src.begin(), src.begin() + bufferLen, test.begin()));
+
+    // Decoding must fail rather than overrun a buffer that is too small.
+    assert(rleUncompress(compressedLen, bufferLen - 1,
+                         &compressed[0], &test[0]) == 0);
+}
+
+
 } // namespace
 
 void 
@@ -115,6 +214,16 @@ testRle(const string&)
         for (int iter=0; iter<numIter; ++iter) {
             testRoundTrip( (int)rand48.nextf(100.0, 1000000.0));
         }
+
+        cout << "   Comparing with the reference encoder " << endl; 
+
+        for (int len=0; len<300; ++len) {
+            testAgainstReference(rand48, len);
+        }
+
+        for (int iter=0; iter<200; ++iter) {
+            testAgainstReference(rand48, (int)rand48.nextf(300.0, 100000.0));
+        }
    
     } catch (const exception &e) {
         cout << "unexpected exception: " << e.what() << endl;
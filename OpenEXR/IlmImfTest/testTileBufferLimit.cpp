@@ -0,0 +1,276 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+
+#include "testTileBufferLimit.h"
+
+#include <ImfTiledOutputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfArray.h>
+#include <ImathRandom.h>
+#include <half.h>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <stdio.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+
+
+namespace {
+
+const int W = 371;
+const int H = 293;
+
+
+struct Tile
+{
+    int dx, dy, lx, ly;
+};
+
+
+FrameBuffer
+frameBuffer (Array2D<half> &pixels, const Box2i &dw)
+{
+    FrameBuffer fb;
+
+    fb.insert ("Y", Slice (HALF,
+                           (char *) (&pixels[0][0] - dw.min.x - dw.min.y * W),
+                           sizeof (half),
+                           sizeof (half) * W));
+    return fb;
+}
+
+
+vector<char>
+fileContents (const string &fileName)
+{
+    ifstream is (fileName.c_str(), ios_base::binary);
+    return vector<char> ((istreambuf_iterator<char> (is)),
+                         istreambuf_iterator<char>());
+}
+
+
+//
+// Write all tiles of a ripmapped image, in the order given by tiles,
+// and return the file's peak number of buffered bytes.  All levels
+// are written from the same pixels.
+//
+
+size_t
+writeTiles (const string &fileName,
+            LineOrder lineOrder,
+            Array2D<half> &pixels,
+            const vector<Tile> &tiles,
+            size_t limit,
+            Int64 &spilled)
+{
+    Header hdr (W, H);
+    hdr.lineOrder() = lineOrder;
+    hdr.compression() = ZIP_COMPRESSION;
+    hdr.channels().insert ("Y", Channel (HALF));
+    hdr.setTileDescription (TileDescription (32, 32, RIPMAP_LEVELS));
+
+    TiledOutputFile out (fileName.c_str(), hdr);
+    out.setTileBufferLimit (limit);
+    assert (out.tileBufferLimit() == limit);
+
+    for (size_t i = 0; i < tiles.size(); ++i)
+    {
+        const Tile &t = tiles[i];
+
+        out.setFrameBuffer
+            (frameBuffer (pixels, out.dataWindowForLevel (t.lx, t.ly)));
+
+        out.writeTile (t.dx, t.dy, t.lx, t.ly);
+
+        if (limit > 0)
+            assert (out.bufferedTileBytes() <= limit);
+    }
+
+    assert (out.bufferedTileBytes() == 0);
+
+    spilled = out.spilledTileBytes();
+    return out.peakBufferedTileBytes();
+}
+
+
+void
+checkPixels (const string &fileName, const Array2D<half> &pixels)
+{
+    TiledInputFile in (fileName.c_str());
+    Array2D<half> p (H, W);
+
+    for (int ly = 0; ly < in.numYLevels(); ++ly)
+    {
+        for (int lx = 0; lx < in.numXLevels(); ++lx)
+        {
+            Box2i dw = in.dataWindowForLevel (lx, ly);
+
+            in.setFrameBuffer (frameBuffer (p, dw));
+            in.readTiles (0, in.numXTiles (lx) - 1,
+                          0, in.numYTiles (ly) - 1, lx, ly);
+
+            for (int y = 0; y <= dw.max.y - dw.min.y; ++y)
+                for (int x = 0; x <= dw.max.x - dw.min.x; ++x)
+                    assert (p[y][x].bits() == pixels[y][x].bits());
+        }
+    }
+}
+
+
+void
+testOrder (const string &fileName,
+           LineOrder lineOrder,
+           Array2D<half> &pixels,
+           const vector<Tile> &tiles,
+           const char *description)
+{
+    cout << "   line order " << lineOrder << ", " << description << endl;
+
+    Int64 spilled;
+    size_t peak = writeTiles (fileName, lineOrder, pixels, tiles, 0, spilled);
+    vector<char> expected = fileContents (fileName);
+
+    assert (spilled == 0);
+    checkPixels (fileName, pixels);
+
+    if (lineOrder == RANDOM_Y)
+    {
+        assert (peak == 0);
+        return;
+    }
+
+    //
+    // Limit the buffer to a fraction of what was needed without
+    // a limit; the file must not change.  A limit of one byte
+    // sends every out-of-order tile to the temporary file.
+    //
+
+    const size_t limits[] = {peak / 3 + 1, 1};
+
+    for (int i = 0; i < 2; ++i)
+    {
+        Int64 limitedSpilled;
+
+        size_t limitedPeak = writeTiles (fileName, lineOrder, pixels, tiles,
+                                         limits[i], limitedSpilled);
+
+        assert (limitedPeak <= limits[i]);
+        assert (peak == 0 || limitedSpilled > 0);
+        assert (fileContents (fileName) == expected);
+    }
+}
+
+} // namespace
+
+
+void
+testTileBufferLimit (const std::string &tempDir)
+{
+    try
+    {
+        cout << "Testing the memory limit for out-of-order tiles" << endl;
+
+        string fileName = tempDir + "imf_test_tile_buffer_limit.exr";
+
+        Array2D<half> pixels (H, W);
+        Rand48 rand (7);
+
+        for (int y = 0; y < H; ++y)
+            for (int x = 0; x < W; ++x)
+                pixels[y][x] = half (float (rand.nextf (0, 1)));
+
+        //
+        // Build the list of tiles, in increasing order, and
+        // then in reverse and random order.
+        //
+
+        vector<Tile> tiles;
+
+        {
+            Header hdr (W, H);
+            hdr.channels().insert ("Y", Channel (HALF));
+            hdr.setTileDescription (TileDescription (32, 32, RIPMAP_LEVELS));
+
+            TiledOutputFile out (fileName.c_str(), hdr);
+
+            for (int ly = 0; ly < out.numYLevels(); ++ly)
+            {
+                for (int lx = 0; lx < out.numXLevels(); ++lx)
+                {
+                    for (int dy = 0; dy < out.numYTiles (ly); ++dy)
+                    {
+                        for (int dx = 0; dx < out.numXTiles (lx); ++dx)
+                        {
+                            Tile t = {dx, dy, lx, ly};
+                            tiles.push_back (t);
+                        }
+                    }
+                }
+            }
+        }
+
+        vector<Tile> reversed (tiles.rbegin(), tiles.rend());
+        vector<Tile> shuffled (tiles);
+
+        for (int i = int (shuffled.size()) - 1; i > 0; --i)
+            swap (shuffled[i], shuffled[rand.nexti() % (i + 1)]);
+
+        const LineOrder lineOrders[] = {INCREASING_Y, DECREASING_Y, RANDOM_Y};
+
+        for (int i = 0; i < 3; ++i)
+        {
+            testOrder (fileName, lineOrders[i], pixels, tiles, "in order");
+            testOrder (fileName, lineOrders[i], pixels, reversed, "reversed");
+            testOrder (fileName, lineOrders[i], pixels, shuffled, "shuffled");
+        }
+
+        remove (fileName.c_str());
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
@@ -45,6 +45,7 @@
 #include <half.h>
 #include <ImathRandom.h>
 #include <ImfTileDescriptionAttribute.h>
+#include <ImfCompressor.h>
 #include "compareFloat.h"
 
 #include <stdio.h>
@@ -480,6 +481,9 @@ writeRead (const std::string &tempDir,
 
     for (int comp = 0; comp < NUM_COMPRESSION_METHODS; ++comp)
     {
+        if (!isSupportedCompression (Compression (comp)))
+            continue;
+
         writeRead (pi, ph, pf,
                    filename.c_str(),
                    LineOrder (0),
@@ -38,6 +38,7 @@
 #include <ImfTiledInputFile.h>
 #include <ImfChannelList.h>
 #include <ImfArray.h>
+#include <ImfCompressor.h>
 #include <half.h>
 
 #include <vector>
@@ -479,6 +480,9 @@ writeCopyRead (const std::string &tempDir, int w, int h, int xs, int ys, int dx,
 
     for (int comp = 0; comp < NUM_COMPRESSION_METHODS; ++comp)
     {
+	if (!isSupportedCompression (Compression (comp)))
+	    continue;
+
 	for (int rmode = 0; rmode < NUM_ROUNDINGMODES; ++rmode)
 	{
 	    writeCopyReadONE (filename1.c_str(), filename2.c_str(), w, h, xs, ys, dx, dy,
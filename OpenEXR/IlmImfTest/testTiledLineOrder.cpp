@@ -40,6 +40,7 @@
 #include <ImfChannelList.h>
 #include <ImfArray.h>
 #include <ImfThreading.h>
+#include <ImfCompressor.h>
 #include <IlmThread.h>
 #include <half.h>
 
@@ -586,6 +587,9 @@ writeCopyRead (const std::string &tempDir, int w, int h, int xs, int ys)
 
     for (int comp = 0; comp < NUM_COMPRESSION_METHODS; ++comp)
     {
+	if (!isSupportedCompression (Compression (comp)))
+	    continue;
+
 	if (comp == B44_COMPRESSION ||
             comp == B44A_COMPRESSION)
         {
@@ -0,0 +1,430 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2004, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+
+#include "testWriteBehind.h"
+
+#include <ImfOutputFile.h>
+#include <ImfInputFile.h>
+#include <ImfTiledOutputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfWriteBehindIO.h>
+#include <ImfStdIO.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfArray.h>
+#include <IlmThreadPool.h>
+#include <Iex.h>
+#include <half.h>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <stdio.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+using ILMTHREAD_NAMESPACE::ThreadPool;
+
+
+namespace {
+
+const int W = 203;
+const int H = 157;
+
+
+//
+// An output stream that keeps the data in memory and
+// fails once more than a given number of bytes have
+// been written to it.
+//
+
+class LimitedOStream: public OStream
+{
+  public:
+
+    LimitedOStream (Int64 limit):
+        OStream ("<limited stream>"), _limit (limit), _pos (0) {}
+
+    virtual void
+    write (const char c[], int n)
+    {
+        if (_pos + n > _limit)
+            throw IEX_NAMESPACE::IoExc ("Disk full.");
+
+        if (_pos + n > Int64 (_data.size()))
+            _data.resize (_pos + n);
+
+        for (int i = 0; i < n; ++i)
+            _data[_pos + i] = c[i];
+
+        _pos += n;
+    }
+
+    virtual Int64 tellp () {return _pos;}
+    virtual void seekp (Int64 pos) {_pos = pos;}
+
+    const vector<char> & data () const {return _data;}
+
+  private:
+
+    Int64		_limit;
+    Int64		_pos;
+    vector<char>	_data;
+};
+
+
+void
+fillPixels (Array2D<half> &ph, Array2D<float> &pf)
+{
+    for (int y = 0; y < H; ++y)
+    {
+        for (int x = 0; x < W; ++x)
+        {
+            ph[y][x] = half (((x * 17 + y * 5) % 97) / 8.0f);
+            pf[y][x] = float ((x ^ y) % 1013) * 0.25f;
+        }
+    }
+}
+
+
+FrameBuffer
+frameBuffer (Array2D<half> &ph, Array2D<float> &pf)
+{
+    FrameBuffer fb;
+
+    fb.insert ("H", Slice (HALF, (char *) &ph[0][0],
+                           sizeof (half), sizeof (half) * W));
+
+    fb.insert ("F", Slice (FLOAT, (char *) &pf[0][0],
+                           sizeof (float), sizeof (float) * W));
+
+    return fb;
+}
+
+
+Header
+header (Compression comp, LineOrder lineOrder)
+{
+    Header hdr (W, H);
+    hdr.compression() = comp;
+    hdr.lineOrder() = lineOrder;
+    hdr.channels().insert ("H", Channel (HALF));
+    hdr.channels().insert ("F", Channel (FLOAT));
+    return hdr;
+}
+
+
+vector<char>
+fileContents (const string &fileName)
+{
+    ifstream is (fileName.c_str(), ios_base::binary);
+    return vector<char> ((istreambuf_iterator<char> (is)),
+                         istreambuf_iterator<char>());
+}
+
+
+void
+checkPixels (const string &fileName,
+             const Array2D<half> &ph,
+             const Array2D<float> &pf)
+{
+    Array2D<half> rh (H, W);
+    Array2D<float> rf (H, W);
+
+    InputFile in (fileName.c_str());
+    in.setFrameBuffer (frameBuffer (rh, rf));
+    in.readPixels (0, H - 1);
+
+    for (int y = 0; y < H; ++y)
+    {
+        for (int x = 0; x < W; ++x)
+        {
+            assert (rh[y][x].bits() == ph[y][x].bits());
+            assert (rf[y][x] == pf[y][x]);
+        }
+    }
+}
+
+
+void
+writeScanLines (const string &fileName,
+                const Header &hdr,
+                Array2D<half> &ph,
+                Array2D<float> &pf,
+                ThreadPool &pool,
+                size_t writeBehind,
+                int linesPerCall)
+{
+    OutputFile out (fileName.c_str(), hdr, pool.numThreads(), pool);
+    assert (out.writeBehind() == 0);
+
+    out.setWriteBehind (writeBehind);
+    assert (out.writeBehind() == writeBehind);
+    out.setFrameBuffer (frameBuffer (ph, pf));
+
+    for (int y = 0; y < H; y += linesPerCall)
+        out.writePixels (min (linesPerCall, H - y));
+}
+
+
+void
+scanLineFiles (const string &fileName,
+               Array2D<half> &ph,
+               Array2D<float> &pf)
+{
+    cout << "scan line files" << endl;
+
+    const Compression compressions[] = {NO_COMPRESSION,
+                                        ZIP_COMPRESSION,
+                                        PIZ_COMPRESSION};
+
+    const size_t budgets[] = {1, 4000, 1 << 20};
+    const int linesPerCall[] = {1, 7, H};
+
+    for (int c = 0; c < 3; ++c)
+    {
+        for (int o = 0; o < 2; ++o)
+        {
+            Header hdr = header (compressions[c],
+                                 o? DECREASING_Y: INCREASING_Y);
+
+            //
+            // With write-behind, the file must have exactly
+            // the same contents as without write-behind.
+            //
+
+            ThreadPool pool0 (0);
+            writeScanLines (fileName, hdr, ph, pf, pool0, 0, H);
+            vector<char> expected = fileContents (fileName);
+
+            for (int n = 0; n < 2; ++n)
+            {
+                ThreadPool pool (n * 3);
+
+                for (int b = 0; b < 3; ++b)
+                {
+                    for (int l = 0; l < 3; ++l)
+                    {
+                        writeScanLines (fileName, hdr, ph, pf, pool,
+                                        budgets[b], linesPerCall[l]);
+
+                        assert (fileContents (fileName) == expected);
+                    }
+                }
+            }
+
+            checkPixels (fileName, ph, pf);
+        }
+    }
+
+    remove (fileName.c_str());
+}
+
+
+void
+writeTiles (const string &fileName,
+            const Header &hdr,
+            Array2D<half> &ph,
+            Array2D<float> &pf,
+            ThreadPool &pool,
+            size_t writeBehind)
+{
+    TiledOutputFile out (fileName.c_str(), hdr, pool.numThreads(), pool);
+    out.setWriteBehind (writeBehind);
+    assert (out.writeBehind() == writeBehind);
+    out.setFrameBuffer (frameBuffer (ph, pf));
+
+    //
+    // Write the tiles in reverse order, so that the file
+    // has to buffer all of them until the first one arrives.
+    //
+
+    for (int dy = out.numYTiles() - 1; dy >= 0; --dy)
+        for (int dx = out.numXTiles() - 1; dx >= 0; --dx)
+            out.writeTile (dx, dy);
+
+    //
+    // Turning write-behind off writes the queued tiles.
+    //
+
+    out.setWriteBehind (0);
+    assert (out.writeBehind() == 0);
+}
+
+
+void
+tiledFiles (const string &fileName,
+            Array2D<half> &ph,
+            Array2D<float> &pf)
+{
+    cout << "tiled files" << endl;
+
+    const LineOrder lineOrders[] = {INCREASING_Y, RANDOM_Y};
+
+    for (int o = 0; o < 2; ++o)
+    {
+        Header hdr = header (ZIP_COMPRESSION, lineOrders[o]);
+        hdr.setTileDescription (TileDescription (32, 24, ONE_LEVEL));
+
+        ThreadPool pool0 (0);
+        writeTiles (fileName, hdr, ph, pf, pool0, 0);
+        vector<char> expected = fileContents (fileName);
+
+        for (int n = 0; n < 2; ++n)
+        {
+            ThreadPool pool (n * 3);
+            writeTiles (fileName, hdr, ph, pf, pool, 1);
+            assert (fileContents (fileName) == expected);
+            writeTiles (fileName, hdr, ph, pf, pool, 1 << 20);
+            assert (fileContents (fileName) == expected);
+        }
+
+        checkPixels (fileName, ph, pf);
+    }
+
+    remove (fileName.c_str());
+}
+
+
+void
+writeErrors (Array2D<half> &ph, Array2D<float> &pf)
+{
+    cout << "write errors" << endl;
+
+    Header hdr = header (NO_COMPRESSION, INCREASING_Y);
+
+    for (int n = 0; n < 2; ++n)
+    {
+        ThreadPool pool (n * 3);
+
+        //
+        // The header fits into the stream, but not all of the pixels.
+        // The error must be reported by writePixels(), or at the
+        // latest when write-behind is turned off.
+        //
+
+        LimitedOStream os (W * H * 3);
+        bool caught = false;
+
+        {
+            OutputFile out (os, hdr, pool.numThreads(), pool);
+            out.setWriteBehind (1 << 16);
+            out.setFrameBuffer (frameBuffer (ph, pf));
+
+            try
+            {
+                for (int y = 0; y < H; ++y)
+                    out.writePixels (1);
+
+                out.setWriteBehind (0);
+            }
+            catch (const IEX_NAMESPACE::IoExc &)
+            {
+                caught = true;
+            }
+        }
+
+        assert (caught);
+    }
+
+    {
+        //
+        // Writing through a WriteBehindOStream directly
+        //
+
+        ThreadPool pool (2);
+        LimitedOStream os (100);
+
+        WriteBehindOStream wb (os, 16, pool);
+        char c[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+        for (int i = 0; i < 10; ++i)
+            wb.write (c, 10);
+
+        assert (wb.tellp() == 100);
+        wb.seekp (50);
+        wb.write (c, 5);
+        wb.flush();
+
+        assert (os.tellp() == 55);
+        assert (os.data().size() == 100);
+        assert (os.data()[50] == 0 && os.data()[54] == 4);
+        assert (os.data()[55] == 5 && os.data()[99] == 9);
+
+        wb.seekp (100);
+        wb.write (c, 1);
+
+        try
+        {
+            wb.flush();
+            assert (false);
+        }
+        catch (const IEX_NAMESPACE::IoExc &)
+        {
+            // expected
+        }
+    }
+}
+
+} // namespace
+
+
+void
+testWriteBehind (const std::string &tempDir)
+{
+    try
+    {
+        cout << "Testing write-behind output" << endl;
+
+        string fileName = tempDir + "imf_test_write_behind.exr";
+
+        Array2D<half> ph (H, W);
+        Array2D<float> pf (H, W);
+        fillPixels (ph, pf);
+
+        scanLineFiles (fileName, ph, pf);
+        tiledFiles (fileName, ph, pf);
+        writeErrors (ph, pf);
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
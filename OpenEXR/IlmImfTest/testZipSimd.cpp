@@ -0,0 +1,338 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include "testZipSimd.h"
+
+#include <ImfZip.h>
+#include <ImfPixelCopySimd.h>
+#include <ImfStandardAttributes.h>
+#include <ImfOutputFile.h>
+#include <ImfInputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfArray.h>
+#include <ImathRandom.h>
+#include <zlib.h>
+#include <vector>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+
+
+namespace {
+
+const char *levelNames[] = {"baseline", "AVX2", "AVX-512"};
+
+const char SENTINEL = char (0xa5);
+
+
+//
+// The byte reordering and predictor, as they were written
+// before they were vectorized.  The compressed data must
+// remain byte-for-byte identical.
+//
+
+void
+referencePreprocess (const vector<char> &raw, vector<char> &tmp)
+{
+    size_t n = raw.size();
+    tmp.resize (n);
+
+    size_t half = (n + 1) / 2;
+
+    for (size_t i = 0; i < n; ++i)
+        tmp[(i % 2)? half + i / 2: i / 2] = raw[i];
+
+    int p = n? (unsigned char) tmp[0]: 0;
+
+    for (size_t i = 1; i < n; ++i)
+    {
+        int d = int ((unsigned char) tmp[i]) - p + (128 + 256);
+        p = (unsigned char) tmp[i];
+        tmp[i] = char (d);
+    }
+}
+
+
+void
+randomData (Rand48 &rand, size_t n, vector<char> &data)
+{
+    data.resize (n);
+
+    //
+    // Mostly smooth data, as from a half image, with some noise
+    //
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (rand.nexti() % 8)
+            data[i] = char ((i % 2)? 0x3c: (i / 2) & 0xff);
+        else
+            data[i] = char (rand.nexti());
+    }
+}
+
+
+void
+testSplitAndMerge (Rand48 &rand)
+{
+    for (size_t n = 0; n < 300; ++n)
+    {
+        vector<char> src;
+        randomData (rand, n, src);
+
+        vector<char> split (n + 8, SENTINEL);
+        splitBytes (n? &src[0]: 0, n, &split[1]);
+
+        size_t half = (n + 1) / 2;
+
+        for (size_t i = 0; i < n; ++i)
+            assert (split[1 + ((i % 2)? half + i / 2: i / 2)] == src[i]);
+
+        assert (split[0] == SENTINEL);
+
+        for (size_t i = n + 1; i < split.size(); ++i)
+            assert (split[i] == SENTINEL);
+
+        vector<char> merged (n + 8, SENTINEL);
+        mergeBytes (&split[1], n, &merged[3]);
+
+        assert (merged[0] == SENTINEL &&
+                merged[1] == SENTINEL &&
+                merged[2] == SENTINEL);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (merged[3 + i] == src[i]);
+
+        for (size_t i = n + 3; i < merged.size(); ++i)
+            assert (merged[i] == SENTINEL);
+    }
+}
+
+
+void
+testCompress (Rand48 &rand, int level)
+{
+    const size_t sizes[] = {1, 2, 3, 15, 16, 17, 31, 32, 33, 63, 64, 65,
+                            127, 128, 129, 1000, 4097, 65536};
+
+    const int numSizes = sizeof (sizes) / sizeof (sizes[0]);
+
+    for (int s = 0; s < numSizes; ++s)
+    {
+        size_t n = sizes[s];
+
+        vector<char> raw;
+        randomData (rand, n, raw);
+
+        Zip zip (n);
+        zip.setLevel (level);
+
+        vector<char> compressed (zip.maxCompressedSize());
+        int compressedSize = zip.compress (&raw[0], n, &compressed[0]);
+
+        //
+        // Compare with the reference preprocessing followed by zlib
+        //
+
+        vector<char> tmp;
+        referencePreprocess (raw, tmp);
+
+        vector<char> expected (zip.maxCompressedSize());
+        uLongf expectedSize = expected.size();
+
+        assert (Z_OK == compress2 ((Bytef *) &expected[0], &expectedSize,
+                                   (const Bytef *) &tmp[0], n,
+                                   zip.level()));
+
+        assert (size_t (compressedSize) == expectedSize);
+        assert (memcmp (&compressed[0], &expected[0], expectedSize) == 0);
+
+        //
+        // Round trip
+        //
+
+        vector<char> uncompressed (n + 1, SENTINEL);
+        int uncompressedSize = zip.uncompress (&compressed[0],
+                                               compressedSize,
+                                               &uncompressed[0]);
+
+        assert (size_t (uncompressedSize) == n);
+        assert (memcmp (&uncompressed[0], &raw[0], n) == 0);
+        assert (uncompressed[n] == SENTINEL);
+    }
+}
+
+
+void
+testCompressionLevel (Rand48 &rand, const string &fileName)
+{
+    const int W = 237;
+    const int H = 53;
+
+    Array2D<unsigned int> pixels (H, W);
+
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+            pixels[y][x] = (x * y) / 7 + rand.nexti() % 16;
+
+    const int levels[] = {-1, 0, 1, 6, 9, 12};
+    const int numLevels = sizeof (levels) / sizeof (levels[0]);
+
+    Compression compressions[] = {ZIP_COMPRESSION, ZIPS_COMPRESSION};
+
+    for (int c = 0; c < 2; ++c)
+    {
+        size_t uncompressedFileSize = 0;
+
+        for (int l = 0; l < numLevels; ++l)
+        {
+            {
+                Header hdr (W, H);
+                hdr.compression() = compressions[c];
+                hdr.channels().insert ("U", Channel (UINT));
+                addZipCompressionLevel (hdr, levels[l]);
+
+                FrameBuffer fb;
+
+                fb.insert ("U", Slice (UINT,
+                                       (char *) &pixels[0][0],
+                                       sizeof (pixels[0][0]),
+                                       sizeof (pixels[0][0]) * W));
+
+                OutputFile out (fileName.c_str(), hdr);
+                out.setFrameBuffer (fb);
+                out.writePixels (H);
+            }
+
+            FILE *f = fopen (fileName.c_str(), "rb");
+            assert (f != 0);
+            fseek (f, 0, SEEK_END);
+            size_t fileSize = ftell (f);
+            fclose (f);
+
+            //
+            // Level 0 stores the data without deflating them
+            //
+
+            if (levels[l] == 0)
+                uncompressedFileSize = fileSize;
+            else if (levels[l] > 0)
+                assert (fileSize < uncompressedFileSize);
+
+            {
+                Array2D<unsigned int> pixels2 (H, W);
+
+                FrameBuffer fb;
+
+                fb.insert ("U", Slice (UINT,
+                                       (char *) &pixels2[0][0],
+                                       sizeof (pixels2[0][0]),
+                                       sizeof (pixels2[0][0]) * W));
+
+                InputFile in (fileName.c_str());
+                in.setFrameBuffer (fb);
+                in.readPixels (0, H - 1);
+
+                assert (hasZipCompressionLevel (in.header()));
+                assert (zipCompressionLevel (in.header()) == levels[l]);
+
+                for (int y = 0; y < H; ++y)
+                    for (int x = 0; x < W; ++x)
+                        assert (pixels2[y][x] == pixels[y][x]);
+            }
+        }
+    }
+
+    remove (fileName.c_str());
+}
+
+} // namespace
+
+
+void
+testZipSimd (const string &tempDir)
+{
+    try
+    {
+        cout << "Testing ZIP preprocessing at all supported SIMD levels" << endl;
+
+        SimdLevel maxLevel = maxSimdLevel();
+
+        for (int l = SIMD_BASELINE; l <= maxLevel; ++l)
+        {
+            SimdLevel level = SimdLevel (l);
+            setSimdLevel (level);
+
+            cout << "   " << levelNames[level] << endl;
+
+            Rand48 rand (l);
+
+            testSplitAndMerge (rand);
+            testCompress (rand, -1);
+            testCompress (rand, 1);
+        }
+
+        setSimdLevel (maxLevel);
+
+        {
+            Zip zip (16);
+            assert (zip.level() == Z_DEFAULT_COMPRESSION);
+            zip.setLevel (17);
+            assert (zip.level() == Z_BEST_COMPRESSION);
+            zip.setLevel (-5);
+            assert (zip.level() == Z_DEFAULT_COMPRESSION);
+            zip.setLevel (0);
+            assert (zip.level() == Z_NO_COMPRESSION);
+        }
+
+        cout << "Testing the zipCompressionLevel attribute" << endl;
+
+        Rand48 rand (0);
+        testCompressionLevel (rand, tempDir + "imf_test_zip_level.exr");
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
@@ -0,0 +1,417 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2005-2012, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "testZstdCompression.h"
+
+#include <ImfOutputFile.h>
+#include <ImfInputFile.h>
+#include <ImfTiledOutputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfDeepScanLineOutputFile.h>
+#include <ImfDeepScanLineInputFile.h>
+#include <ImfDeepFrameBuffer.h>
+#include <ImfPartType.h>
+#include <ImfChannelList.h>
+#include <ImfStandardAttributes.h>
+#include <ImfCompressor.h>
+#include <ImfArray.h>
+#include <ImathRandom.h>
+#include <half.h>
+#include <Iex.h>
+#include <vector>
+#include <iostream>
+#include <stdio.h>
+#include <math.h>
+#include <assert.h>
+
+using namespace OPENEXR_IMF_NAMESPACE;
+using namespace std;
+using namespace IMATH_NAMESPACE;
+
+
+namespace {
+
+const int W = 213;
+const int H = 77;
+
+
+struct Pixels
+{
+    Array2D<unsigned int>	u;
+    Array2D<half>		h;
+    Array2D<float>		f;
+
+    Pixels (): u (H, W), h (H, W), f (H, W) {}
+
+    void
+    fill (Rand48 &rand)
+    {
+        //
+        // Smooth gradients with a little noise, so that
+        // the data are compressible, but not trivially so
+        //
+
+        for (int y = 0; y < H; ++y)
+        {
+            for (int x = 0; x < W; ++x)
+            {
+                u[y][x] = x * y + rand.nexti() % 4;
+                h[y][x] = float (x + y) / (W + H) + rand.nextf (0, 0.01);
+                f[y][x] = sin (x * 0.1) * cos (y * 0.07) + rand.nextf (0, 0.001);
+            }
+        }
+    }
+
+    FrameBuffer
+    frameBuffer ()
+    {
+        FrameBuffer fb;
+
+        fb.insert ("U", Slice (UINT,
+                               (char *) &u[0][0],
+                               sizeof (u[0][0]),
+                               sizeof (u[0][0]) * W));
+
+        fb.insert ("H", Slice (HALF,
+                               (char *) &h[0][0],
+                               sizeof (h[0][0]),
+                               sizeof (h[0][0]) * W));
+
+        fb.insert ("F", Slice (FLOAT,
+                               (char *) &f[0][0],
+                               sizeof (f[0][0]),
+                               sizeof (f[0][0]) * W));
+        return fb;
+    }
+
+    bool
+    operator == (const Pixels &other) const
+    {
+        for (int y = 0; y < H; ++y)
+        {
+            for (int x = 0; x < W; ++x)
+            {
+                if (u[y][x] != other.u[y][x] ||
+                    h[y][x].bits() != other.h[y][x].bits() ||
+                    f[y][x] != other.f[y][x])
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+};
+
+
+Header
+makeHeader (Compression compression)
+{
+    Header hdr (W, H);
+    hdr.compression() = compression;
+    hdr.channels().insert ("U", Channel (UINT));
+    hdr.channels().insert ("H", Channel (HALF));
+    hdr.channels().insert ("F", Channel (FLOAT));
+    return hdr;
+}
+
+
+size_t
+fileSize (const string &fileName)
+{
+    FILE *f = fopen (fileName.c_str(), "rb");
+    assert (f != 0);
+    fseek (f, 0, SEEK_END);
+    size_t size = ftell (f);
+    fclose (f);
+    return size;
+}
+
+
+size_t
+writeReadScanLines (Pixels &pixels,
+                    const string &fileName,
+                    Compression compression,
+                    bool setLevel,
+                    int level)
+{
+    Header hdr = makeHeader (compression);
+
+    if (setLevel)
+        addZstdCompressionLevel (hdr, level);
+
+    {
+        OutputFile out (fileName.c_str(), hdr);
+        out.setFrameBuffer (pixels.frameBuffer());
+        out.writePixels (H);
+    }
+
+    size_t size = fileSize (fileName);
+
+    {
+        Pixels pixels2;
+        InputFile in (fileName.c_str());
+        assert (in.header().compression() == compression);
+        in.setFrameBuffer (pixels2.frameBuffer());
+        in.readPixels (0, H - 1);
+        assert (pixels2 == pixels);
+    }
+
+    remove (fileName.c_str());
+    return size;
+}
+
+
+void
+writeReadTiles (Pixels &pixels, const string &fileName)
+{
+    Header hdr = makeHeader (ZSTD_COMPRESSION);
+    hdr.setTileDescription (TileDescription (35, 19, ONE_LEVEL));
+
+    {
+        TiledOutputFile out (fileName.c_str(), hdr);
+        out.setFrameBuffer (pixels.frameBuffer());
+        out.writeTiles (0, out.numXTiles() - 1, 0, out.numYTiles() - 1);
+    }
+
+    {
+        Pixels pixels2;
+        TiledInputFile in (fileName.c_str());
+        in.setFrameBuffer (pixels2.frameBuffer());
+        in.readTiles (0, in.numXTiles() - 1, 0, in.numYTiles() - 1);
+        assert (pixels2 == pixels);
+    }
+
+    remove (fileName.c_str());
+}
+
+
+void
+writeReadDeep (Rand48 &rand, const string &fileName)
+{
+    Array2D<unsigned int> sampleCount (H, W);
+    Array2D<float *> samplePointers (H, W);
+    vector<float> samples;
+
+    size_t numSamples = 0;
+
+    for (int y = 0; y < H; ++y)
+    {
+        for (int x = 0; x < W; ++x)
+        {
+            sampleCount[y][x] = rand.nexti() % 5;
+            numSamples += sampleCount[y][x];
+        }
+    }
+
+    samples.resize (numSamples + 1);
+
+    for (size_t i = 0; i < numSamples; ++i)
+        samples[i] = float (i % 1000) * 0.25f;
+
+    size_t offset = 0;
+
+    for (int y = 0; y < H; ++y)
+    {
+        for (int x = 0; x < W; ++x)
+        {
+            samplePointers[y][x] = &samples[offset];
+            offset += sampleCount[y][x];
+        }
+    }
+
+    Header hdr (W, H);
+    hdr.compression() = ZSTD_COMPRESSION;
+    hdr.channels().insert ("Z", Channel (FLOAT));
+    hdr.setType (DEEPSCANLINE);
+
+    {
+        DeepFrameBuffer fb;
+
+        fb.insertSampleCountSlice (Slice (UINT,
+                                          (char *) &sampleCount[0][0],
+                                          sizeof (unsigned int),
+                                          sizeof (unsigned int) * W));
+
+        fb.insert ("Z", DeepSlice (FLOAT,
+                                   (char *) &samplePointers[0][0],
+                                   sizeof (float *),
+                                   sizeof (float *) * W,
+                                   sizeof (float)));
+
+        DeepScanLineOutputFile out (fileName.c_str(), hdr);
+        out.setFrameBuffer (fb);
+        out.writePixels (H);
+    }
+
+    {
+        Array2D<unsigned int> sampleCount2 (H, W);
+        Array2D<float *> samplePointers2 (H, W);
+        vector<float> samples2 (numSamples + 1);
+
+        DeepFrameBuffer fb;
+
+        fb.insertSampleCountSlice (Slice (UINT,
+                                          (char *) &sampleCount2[0][0],
+                                          sizeof (unsigned int),
+                                          sizeof (unsigned int) * W));
+
+        fb.insert ("Z", DeepSlice (FLOAT,
+                                   (char *) &samplePointers2[0][0],
+                                   sizeof (float *),
+                                   sizeof (float *) * W,
+                                   sizeof (float)));
+
+        DeepScanLineInputFile in (fileName.c_str());
+        assert (in.header().compression() == ZSTD_COMPRESSION);
+
+        in.setFrameBuffer (fb);
+        in.readPixelSampleCounts (0, H - 1);
+
+        size_t offset = 0;
+
+        for (int y = 0; y < H; ++y)
+        {
+            for (int x = 0; x < W; ++x)
+            {
+                assert (sampleCount2[y][x] == sampleCount[y][x]);
+                samplePointers2[y][x] = &samples2[offset];
+                offset += sampleCount2[y][x];
+            }
+        }
+
+        in.readPixels (0, H - 1);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            assert (samples2[i] == samples[i]);
+    }
+
+    remove (fileName.c_str());
+}
+
+} // namespace
+
+
+void
+testZstdCompression (const string &tempDir)
+{
+    try
+    {
+        cout << "Testing ZSTD compression" << endl;
+
+        string fileName = tempDir + "imf_test_zstd.exr";
+
+        assert (isValidCompression (ZSTD_COMPRESSION));
+        assert (isValidDeepCompression (ZSTD_COMPRESSION));
+
+        Rand48 rand (0);
+        Pixels pixels;
+        pixels.fill (rand);
+
+        if (!isSupportedCompression (ZSTD_COMPRESSION))
+        {
+            //
+            // Without the Zstandard library, opening
+            // a ZSTD file for writing must fail.
+            //
+
+            cout << "   not supported by this build" << endl;
+
+            bool caught = false;
+
+            try
+            {
+                writeReadScanLines (pixels, fileName,
+                                    ZSTD_COMPRESSION, false, 0);
+            }
+            catch (const IEX_NAMESPACE::ArgExc &)
+            {
+                caught = true;
+            }
+
+            assert (caught);
+            remove (fileName.c_str());
+
+            cout << "ok\n" << endl;
+            return;
+        }
+
+        size_t uncompressedSize =
+            writeReadScanLines (pixels, fileName, NO_COMPRESSION, false, 0);
+
+        cout << "   scan lines" << endl;
+
+        size_t defaultSize =
+            writeReadScanLines (pixels, fileName, ZSTD_COMPRESSION, false, 0);
+
+        assert (defaultSize < uncompressedSize);
+
+        //
+        // Levels outside the supported range are clamped.
+        //
+
+        const int levels[] = {-1000, -5, 1, 9, 19, 100, 1000};
+        const int numLevels = sizeof (levels) / sizeof (levels[0]);
+        size_t sizes[numLevels];
+
+        for (int i = 0; i < numLevels; ++i)
+        {
+            sizes[i] = writeReadScanLines (pixels, fileName,
+                                           ZSTD_COMPRESSION,
+                                           true, levels[i]);
+
+            cout << "      level " << levels[i] << ": " << sizes[i] <<
+                    " bytes" << endl;
+
+            assert (sizes[i] < uncompressedSize);
+        }
+
+        assert (sizes[4] < sizes[2]);           // level 19 vs. level 1
+        assert (sizes[5] == sizes[6]);          // both are clamped
+
+        cout << "   tiles" << endl;
+        writeReadTiles (pixels, fileName);
+
+        cout << "   deep scan lines" << endl;
+        writeReadDeep (rand, fileName);
+
+        cout << "ok\n" << endl;
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "ERROR -- caught exception: " << e.what() << endl;
+        assert (false);
+    }
+}
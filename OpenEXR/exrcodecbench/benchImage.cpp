@@ -0,0 +1,330 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2014, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+
+//----------------------------------------------------------------------------
+//
+//	Source images for exrcodecbench
+//
+//----------------------------------------------------------------------------
+
+#include "benchImage.h"
+
+#include <ImfInputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <ImathBox.h>
+#include <ImathRandom.h>
+#include <ImathFun.h>
+#include <Iex.h>
+
+#include <iostream>
+#include <math.h>
+
+#include "namespaceAlias.h"
+using namespace IMF;
+using namespace IMATH;
+using namespace std;
+
+
+namespace {
+
+void
+initImage (const string &name, int width, int height, BenchImage &image)
+{
+    if (width <= 0 || height <= 0)
+	THROW (IEX::ArgExc, "Invalid image size " << width << " by " << height);
+
+    image.name = name;
+    image.width = width;
+    image.height = height;
+    image.channels.clear();
+    image.channels.push_back ("R");
+    image.channels.push_back ("G");
+    image.channels.push_back ("B");
+    image.channels.push_back ("A");
+    image.pixels.assign (size_t (4) * width * height, 0.0f);
+}
+
+
+void
+setPixel (BenchImage &image, int x, int y, float r, float g, float b, float a)
+{
+    size_t planeSize = size_t (image.width) * image.height;
+    size_t i = size_t (y) * image.width + x;
+
+    image.pixels[i] = r;
+    image.pixels[i + planeSize] = g;
+    image.pixels[i + planeSize * 2] = b;
+    image.pixels[i + planeSize * 3] = a;
+}
+
+
+void
+makeNoise (BenchImage &image)
+{
+    Rand32 rand (1);
+
+    for (size_t i = 0; i < image.pixels.size(); ++i)
+	image.pixels[i] = rand.nextf();
+}
+
+
+void
+makeGradient (BenchImage &image)
+{
+    int w = image.width;
+    int h = image.height;
+
+    for (int y = 0; y < h; ++y)
+    {
+	for (int x = 0; x < w; ++x)
+	{
+	    float u = (x + 0.5f) / w;
+	    float v = (y + 0.5f) / h;
+
+	    setPixel (image, x, y, u, v, (u + v) * 0.5f, 1.0f);
+	}
+    }
+}
+
+
+void
+makeConstant (BenchImage &image)
+{
+    for (int y = 0; y < image.height; ++y)
+	for (int x = 0; x < image.width; ++x)
+	    setPixel (image, x, y, 0.18f, 0.18f, 0.18f, 1.0f);
+}
+
+
+struct Sphere
+{
+    float	x, y, radius;	// in units of the image height
+    float	r, g, b;
+};
+
+
+void
+makeRender (BenchImage &image)
+{
+    int w = image.width;
+    int h = image.height;
+    float aspect = float (w) / h;
+
+    const Sphere spheres[] =
+    {
+	{0.30f * aspect, 0.62f, 0.20f,	0.80f, 0.20f, 0.10f},
+	{0.62f * aspect, 0.66f, 0.14f,	0.10f, 0.45f, 0.80f},
+	{0.82f * aspect, 0.52f, 0.08f,	0.90f, 0.90f, 0.85f}
+    };
+
+    const int numSpheres = sizeof (spheres) / sizeof (spheres[0]);
+
+    //
+    // Light direction, and the half-way vector between
+    // the light and a viewer looking along the z axis
+    //
+
+    const float lx = -0.45f, ly = 0.60f, lz = 0.66f;
+    const float hx = lx, hy = ly, hz = lz + 1;
+    const float hl = sqrtf (hx * hx + hy * hy + hz * hz);
+
+    const float horizon = 0.45f;
+
+    Rand32 rand (2);
+
+    for (int y = 0; y < h; ++y)
+    {
+	for (int x = 0; x < w; ++x)
+	{
+	    float sx = (x + 0.5f) / h;
+	    float sy = (y + 0.5f) / h;
+	    float r, g, b, a;
+
+	    //
+	    // Sky gradient above the horizon, perspective
+	    // checkerboard floor fading into haze below it.
+	    //
+
+	    float skyR = 0.35f + 0.30f * sy;
+	    float skyG = 0.55f + 0.25f * sy;
+	    float skyB = 1.00f + 0.10f * sy;
+
+	    if (sy < horizon)
+	    {
+		r = skyR;
+		g = skyG;
+		b = skyB;
+		a = 0;
+	    }
+	    else
+	    {
+		float depth = 0.25f / (sy - horizon + 0.01f);
+		float fx = (sx - 0.5f * aspect) * depth;
+		int check = (int (floorf (fx * 2)) + int (floorf (depth * 2))) & 1;
+		float c = check? 0.60f: 0.15f;
+		float haze = 1 - expf (-0.08f * depth);
+
+		r = lerp (c, skyR, haze);
+		g = lerp (c, skyG, haze);
+		b = lerp (c * 0.9f, skyB, haze);
+		a = 1;
+	    }
+
+	    //
+	    // Spheres with diffuse shading and bright specular
+	    // highlights; later spheres are in front of earlier ones.
+	    //
+
+	    for (int i = 0; i < numSpheres; ++i)
+	    {
+		const Sphere &s = spheres[i];
+		float dx = (sx - s.x) / s.radius;
+		float dy = (s.y - sy) / s.radius;
+		float d2 = dx * dx + dy * dy;
+
+		if (d2 >= 1)
+		    continue;
+
+		float dz = sqrtf (1 - d2);
+		float diffuse = max (0.0f, dx * lx + dy * ly + dz * lz);
+		float nh = max (0.0f, (dx * hx + dy * hy + dz * hz) / hl);
+		float specular = 12 * powf (nh, 80);
+
+		r = s.r * (0.08f + 0.92f * diffuse) + specular;
+		g = s.g * (0.08f + 0.92f * diffuse) + specular;
+		b = s.b * (0.08f + 0.92f * diffuse) + specular;
+		a = 1;
+	    }
+
+	    //
+	    // Film grain
+	    //
+
+	    r *= 1 + 0.04f * (rand.nextf() - 0.5f);
+	    g *= 1 + 0.04f * (rand.nextf() - 0.5f);
+	    b *= 1 + 0.04f * (rand.nextf() - 0.5f);
+
+	    setPixel (image, x, y, r, g, b, a);
+	}
+    }
+}
+
+} // namespace
+
+
+bool
+isSyntheticPattern (const string &pattern)
+{
+    return pattern == "noise" ||
+	   pattern == "gradient" ||
+	   pattern == "constant" ||
+	   pattern == "render";
+}
+
+
+void
+makeSyntheticImage (const string &pattern,
+		    int width,
+		    int height,
+		    BenchImage &image)
+{
+    if (!isSyntheticPattern (pattern))
+	THROW (IEX::ArgExc, "Unknown synthetic image \"" << pattern << "\".");
+
+    initImage (pattern, width, height, image);
+
+    if (pattern == "noise")
+	makeNoise (image);
+    else if (pattern == "gradient")
+	makeGradient (image);
+    else if (pattern == "constant")
+	makeConstant (image);
+    else
+	makeRender (image);
+}
+
+
+void
+loadImage (const char fileName[], BenchImage &image)
+{
+    InputFile in (fileName);
+
+    const Box2i &dw = in.header().dataWindow();
+    const ChannelList &ch = in.header().channels();
+
+    image.name = fileName;
+    image.width = dw.max.x - dw.min.x + 1;
+    image.height = dw.max.y - dw.min.y + 1;
+    image.channels.clear();
+
+    for (ChannelList::ConstIterator i = ch.begin(); i != ch.end(); ++i)
+    {
+	if (i.channel().xSampling != 1 || i.channel().ySampling != 1)
+	{
+	    cerr << "Warning: skipping subsampled channel " << i.name() <<
+		    " of " << fileName << "." << endl;
+	    continue;
+	}
+
+	image.channels.push_back (i.name());
+    }
+
+    if (image.channels.empty())
+	THROW (IEX::InputExc, "File " << fileName << " has no channels "
+			      "that are not subsampled.");
+
+    size_t planeSize = size_t (image.width) * image.height;
+    image.pixels.resize (image.channels.size() * planeSize);
+
+    FrameBuffer fb;
+
+    for (size_t c = 0; c < image.channels.size(); ++c)
+    {
+	float *base = &image.pixels[c * planeSize] -
+		      dw.min.x - dw.min.y * image.width;
+
+	fb.insert (image.channels[c],
+		   Slice (FLOAT,
+			  (char *) base,
+			  sizeof (float),
+			  sizeof (float) * image.width));
+    }
+
+    in.setFrameBuffer (fb);
+    in.readPixels (dw.min.y, dw.max.y);
+}
@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2014, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef INCLUDED_BENCH_IMAGE_H
+#define INCLUDED_BENCH_IMAGE_H
+
+//----------------------------------------------------------------------------
+//
+//	Source images for exrcodecbench: synthetic test patterns and
+//	images loaded from OpenEXR files.  The pixels are stored as
+//	floats, one plane per channel; the benchmark converts them to
+//	the pixel type that is being measured.
+//
+//----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+
+struct BenchImage
+{
+    std::string			name;
+    int				width;
+    int				height;
+    std::vector<std::string>	channels;
+    std::vector<float>		pixels;		// channels.size() planes
+						// of width * height pixels
+
+    const float *		plane (int c) const;
+};
+
+
+//
+// Generate one of the synthetic test patterns:
+//
+//	"noise"		uniformly distributed random values;
+//			the worst case for every compression method
+//
+//	"gradient"	smooth horizontal and vertical ramps
+//
+//	"constant"	every pixel has the same value
+//
+//	"render"	shaded spheres on a checkered floor under a
+//			sky gradient, with high-dynamic-range highlights
+//			and a little film grain, like a typical CG frame
+//
+// The synthetic images have R, G, B and A channels, and the
+// same pattern and size always produces the same pixels.
+//
+
+bool	isSyntheticPattern (const std::string &pattern);
+
+void	makeSyntheticImage (const std::string &pattern,
+			    int width,
+			    int height,
+			    BenchImage &image);
+
+//
+// Load the channels of an OpenEXR file that are not subsampled.
+//
+
+void	loadImage (const char fileName[], BenchImage &image);
+
+
+inline const float *
+BenchImage::plane (int c) const
+{
+    return &pixels[size_t (c) * width * height];
+}
+
+
+#endif
@@ -0,0 +1,544 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2014, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+
+//----------------------------------------------------------------------------
+//
+//	Measure the encoding and decoding speed and the compression
+//	ratio of the OpenEXR compression methods.
+//
+//----------------------------------------------------------------------------
+
+#include "codecBench.h"
+
+#include <ImfOutputFile.h>
+#include <ImfInputFile.h>
+#include <ImfTiledOutputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <ImfIO.h>
+#include <ImfThreading.h>
+#include <ImfTileDescription.h>
+#include <OpenEXRConfig.h>
+#include <Iex.h>
+#include <half.h>
+
+#include <iomanip>
+#include <sstream>
+#include <string.h>
+#include <limits.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/time.h>
+#endif
+
+using namespace IMF;
+using namespace IMATH;
+using namespace std;
+
+
+BenchConfig::BenchConfig ():
+    tileWidth (0),
+    tileHeight (0),
+    iterations (3),
+    csv (false)
+{
+    // empty
+}
+
+
+namespace {
+
+//
+// In-memory output and input streams, so that the
+// measurements do not include the cost of disk I/O
+//
+
+class MemOStream: public OStream
+{
+  public:
+
+    MemOStream (): OStream ("(memory)"), _pos (0) {}
+
+    virtual void	write (const char c[/*n*/], int n);
+    virtual Int64	tellp ()		{return _pos;}
+    virtual void	seekp (Int64 pos)	{_pos = pos;}
+
+    //
+    // Discard the contents, but keep the memory that has
+    // been allocated, so that later files that are written
+    // to the stream do not have to allocate it again.
+    //
+
+    void		rewind ()		{_data.clear(); _pos = 0;}
+
+    const char *	data () const		{return &_data[0];}
+    size_t		size () const		{return _data.size();}
+
+  private:
+
+    vector<char>	_data;
+    Int64		_pos;
+};
+
+
+void
+MemOStream::write (const char c[/*n*/], int n)
+{
+    if (_pos + n > _data.size())
+	_data.resize (_pos + n);
+
+    memcpy (&_data[_pos], c, n);
+    _pos += n;
+}
+
+
+class MemIStream: public IStream
+{
+  public:
+
+    MemIStream (const char data[], size_t size):
+	IStream ("(memory)"), _data (data), _size (size), _pos (0) {}
+
+    virtual bool	read (char c[/*n*/], int n);
+    virtual Int64	tellg ()		{return _pos;}
+    virtual void	seekg (Int64 pos)	{_pos = pos;}
+
+  private:
+
+    const char *	_data;
+    Int64		_size;
+    Int64		_pos;
+};
+
+
+bool
+MemIStream::read (char c[/*n*/], int n)
+{
+    if (_pos + n > _size)
+	throw IEX::InputExc ("Unexpected end of file.");
+
+    memcpy (c, _data + _pos, n);
+    _pos += n;
+    return _pos < _size;
+}
+
+
+double
+currentTime ()
+{
+    #ifdef _WIN32
+
+	LARGE_INTEGER count, frequency;
+	QueryPerformanceCounter (&count);
+	QueryPerformanceFrequency (&frequency);
+	return double (count.QuadPart) / double (frequency.QuadPart);
+
+    #else
+
+	timeval t;
+	gettimeofday (&t, 0);
+	return t.tv_sec + t.tv_usec * 1e-6;
+
+    #endif
+}
+
+
+size_t
+pixelSize (PixelType type)
+{
+    return (type == HALF)? sizeof (half): sizeof (float);
+}
+
+
+//
+// Convert one channel of the source image to the pixel type
+// that is being measured.  UINT values are the float values
+// scaled by 65535, so that values between 0 and 1 use the
+// low 16 bits, like integer-valued color or coverage data.
+//
+
+void
+convertPixels (const float in[], size_t n, PixelType type, char out[])
+{
+    switch (type)
+    {
+      case HALF:
+	{
+	    half *h = (half *) out;
+
+	    for (size_t i = 0; i < n; ++i)
+		h[i] = in[i];
+	}
+	break;
+
+      case FLOAT:
+
+	memcpy (out, in, n * sizeof (float));
+	break;
+
+      case UINT:
+	{
+	    unsigned int *u = (unsigned int *) out;
+
+	    for (size_t i = 0; i < n; ++i)
+	    {
+		float v = in[i] * 65535.0f + 0.5f;
+
+		if (v <= 0)
+		    u[i] = 0;
+		else if (v >= float (UINT_MAX))
+		    u[i] = UINT_MAX;
+		else
+		    u[i] = (unsigned int) v;
+	    }
+	}
+	break;
+
+      default:
+
+	throw IEX::ArgExc ("Unknown pixel type.");
+    }
+}
+
+
+void
+insertSlices (const BenchImage &image,
+	      PixelType type,
+	      char pixels[],
+	      FrameBuffer &fb)
+{
+    size_t xStride = pixelSize (type);
+    size_t yStride = xStride * image.width;
+    size_t planeSize = yStride * image.height;
+
+    for (size_t c = 0; c < image.channels.size(); ++c)
+    {
+	fb.insert (image.channels[c],
+		   Slice (type, pixels + c * planeSize, xStride, yStride));
+    }
+}
+
+
+void
+writeFile (MemOStream &os,
+	   const Header &header,
+	   const FrameBuffer &fb,
+	   int numThreads)
+{
+    if (header.hasTileDescription())
+    {
+	TiledOutputFile out (os, header, numThreads);
+	out.setFrameBuffer (fb);
+	out.writeTiles (0, out.numXTiles() - 1, 0, out.numYTiles() - 1);
+    }
+    else
+    {
+	const Box2i &dw = header.dataWindow();
+
+	OutputFile out (os, header, numThreads);
+	out.setFrameBuffer (fb);
+	out.writePixels (dw.max.y - dw.min.y + 1);
+    }
+}
+
+
+void
+readFile (MemIStream &is,
+	  bool tiled,
+	  const FrameBuffer &fb,
+	  int numThreads)
+{
+    if (tiled)
+    {
+	TiledInputFile in (is, numThreads);
+	in.setFrameBuffer (fb);
+	in.readTiles (0, in.numXTiles() - 1, 0, in.numYTiles() - 1);
+    }
+    else
+    {
+	InputFile in (is, numThreads);
+	const Box2i &dw = in.header().dataWindow();
+
+	in.setFrameBuffer (fb);
+	in.readPixels (dw.min.y, dw.max.y);
+    }
+}
+
+
+string
+tilingName (const BenchConfig &config)
+{
+    if (config.tileWidth <= 0)
+	return "scanline";
+
+    ostringstream s;
+    s << config.tileWidth << "x" << config.tileHeight;
+    return s.str();
+}
+
+
+void
+printResult (const BenchImage &image,
+	     PixelType type,
+	     Compression compression,
+	     int numThreads,
+	     const BenchConfig &config,
+	     size_t rawBytes,
+	     size_t fileBytes,
+	     double encodeTime,
+	     double decodeTime,
+	     bool exact,
+	     ostream &os)
+{
+    double ratio = double (rawBytes) / fileBytes;
+    double encodeSpeed = rawBytes / encodeTime * 1e-6;
+    double decodeSpeed = rawBytes / decodeTime * 1e-6;
+
+    if (config.csv)
+    {
+	os << OPENEXR_VERSION_STRING << "," <<
+	      simdLevelName (simdLevel()) << "," <<
+	      "\"" << image.name << "\"," <<
+	      image.width << "," <<
+	      image.height << "," <<
+	      image.channels.size() << "," <<
+	      pixelTypeName (type) << "," <<
+	      compressionName (compression) << "," <<
+	      tilingName (config) << "," <<
+	      numThreads << "," <<
+	      config.iterations << "," <<
+	      rawBytes << "," <<
+	      fileBytes << "," <<
+	      fixed << setprecision (4) << ratio << "," <<
+	      setprecision (2) << encodeSpeed << "," <<
+	      decodeSpeed << "," <<
+	      (exact? 1: 0) << endl;
+    }
+    else
+    {
+	os << left << setw (20) << image.name << " " <<
+	      setw (6) << pixelTypeName (type) << " " <<
+	      setw (6) << compressionName (compression) << " " <<
+	      right << setw (7) << numThreads << " " <<
+	      fixed << setprecision (3) << setw (9) << ratio << " " <<
+	      setprecision (1) << setw (12) << encodeSpeed << " " <<
+	      setw (12) << decodeSpeed << "  " <<
+	      (exact? "yes": "no") << endl;
+    }
+}
+
+} // namespace
+
+
+const char *
+compressionName (Compression c)
+{
+    switch (c)
+    {
+      case NO_COMPRESSION:	return "none";
+      case RLE_COMPRESSION:	return "rle";
+      case ZIPS_COMPRESSION:	return "zips";
+      case ZIP_COMPRESSION:	return "zip";
+      case PIZ_COMPRESSION:	return "piz";
+      case PXR24_COMPRESSION:	return "pxr24";
+      case B44_COMPRESSION:	return "b44";
+      case B44A_COMPRESSION:	return "b44a";
+      case DWAA_COMPRESSION:	return "dwaa";
+      case DWAB_COMPRESSION:	return "dwab";
+      case ZSTD_COMPRESSION:	return "zstd";
+      default:			return "unknown";
+    }
+}
+
+
+const char *
+pixelTypeName (PixelType type)
+{
+    switch (type)
+    {
+      case UINT:	return "uint";
+      case HALF:	return "half";
+      case FLOAT:	return "float";
+      default:		return "unknown";
+    }
+}
+
+
+const char *
+simdLevelName (SimdLevel level)
+{
+    switch (level)
+    {
+      case SIMD_BASELINE:	return "baseline";
+      case SIMD_AVX2:		return "avx2";
+      case SIMD_AVX512:		return "avx512";
+      default:			return "unknown";
+    }
+}
+
+
+void
+printHeading (const BenchConfig &config, ostream &os)
+{
+    if (config.csv)
+    {
+	os << "version,simd,image,width,height,channels,pixel_type,"
+	      "compression,tiling,threads,iterations,raw_bytes,file_bytes,"
+	      "ratio,encode_mb_per_s,decode_mb_per_s,exact" << endl;
+    }
+    else
+    {
+	os << "OpenEXR " << OPENEXR_VERSION_STRING << ", " <<
+	      simdLevelName (simdLevel()) << " instruction set, ";
+
+	if (config.tileWidth > 0)
+	    os << "tiled files with " << tilingName (config) << " tiles";
+	else
+	    os << "scan line files";
+
+	os << ", best of " <<
+	      config.iterations << (config.iterations == 1? " run": " runs") <<
+	      "\n\n" <<
+	      left << setw (20) << "image" << " " <<
+	      setw (6) << "type" << " " <<
+	      setw (6) << "codec" << " " <<
+	      right << setw (7) << "threads" << " " <<
+	      setw (9) << "ratio" << " " <<
+	      setw (12) << "encode MB/s" << " " <<
+	      setw (12) << "decode MB/s" << "  " <<
+	      "exact" << endl;
+    }
+}
+
+
+void
+benchmarkImage (const BenchImage &image,
+		const BenchConfig &config,
+		ostream &os)
+{
+    size_t planeSize = size_t (image.width) * image.height;
+    bool tiled = (config.tileWidth > 0);
+    MemOStream out;
+
+    for (size_t t = 0; t < config.pixelTypes.size(); ++t)
+    {
+	PixelType type = config.pixelTypes[t];
+	size_t rawBytes = image.channels.size() * planeSize * pixelSize (type);
+
+	//
+	// Convert the image to the pixel type that is being measured,
+	// and set up frame buffers for writing the converted pixels and
+	// for reading them back.
+	//
+
+	vector<char> src (rawBytes);
+	vector<char> dst (rawBytes);
+
+	for (size_t c = 0; c < image.channels.size(); ++c)
+	{
+	    convertPixels (image.plane (c),
+			   planeSize,
+			   type,
+			   &src[c * planeSize * pixelSize (type)]);
+	}
+
+	Header header (image.width, image.height);
+
+	for (size_t c = 0; c < image.channels.size(); ++c)
+	    header.channels().insert (image.channels[c], Channel (type));
+
+	if (tiled)
+	{
+	    header.setTileDescription
+		(TileDescription (config.tileWidth, config.tileHeight));
+	}
+
+	FrameBuffer srcFb;
+	FrameBuffer dstFb;
+	insertSlices (image, type, &src[0], srcFb);
+	insertSlices (image, type, &dst[0], dstFb);
+
+	for (size_t c = 0; c < config.compressions.size(); ++c)
+	{
+	    header.compression() = config.compressions[c];
+
+	    for (size_t n = 0; n < config.threadCounts.size(); ++n)
+	    {
+		int numThreads = config.threadCounts[n];
+		setGlobalThreadCount (numThreads);
+
+		double encodeTime = 0;
+		double decodeTime = 0;
+
+		for (int i = 0; i < config.iterations; ++i)
+		{
+		    out.rewind();
+
+		    double t0 = currentTime();
+		    writeFile (out, header, srcFb, numThreads);
+		    double t1 = currentTime();
+
+		    if (i == 0 || t1 - t0 < encodeTime)
+			encodeTime = t1 - t0;
+		}
+
+		memset (&dst[0], 0, rawBytes);
+
+		for (int i = 0; i < config.iterations; ++i)
+		{
+		    MemIStream in (out.data(), out.size());
+
+		    double t0 = currentTime();
+		    readFile (in, tiled, dstFb, numThreads);
+		    double t1 = currentTime();
+
+		    if (i == 0 || t1 - t0 < decodeTime)
+			decodeTime = t1 - t0;
+		}
+
+		bool exact = (memcmp (&src[0], &dst[0], rawBytes) == 0);
+
+		printResult (image, type, config.compressions[c], numThreads,
+			     config, rawBytes, out.size(),
+			     encodeTime, decodeTime, exact, os);
+	    }
+	}
+    }
+}
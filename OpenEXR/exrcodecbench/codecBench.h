@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2014, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef INCLUDED_CODEC_BENCH_H
+#define INCLUDED_CODEC_BENCH_H
+
+//----------------------------------------------------------------------------
+//
+//	Measure the encoding and decoding speed and the compression
+//	ratio of the OpenEXR compression methods.
+//
+//	Every measurement writes an image to an in-memory file and reads
+//	it back, through the same code paths that applications use for
+//	files on disk, but without the cost of the disk I/O.  Encoding
+//	time includes writing the header and the line offset table;
+//	decoding time includes reading them.  Speeds are reported in
+//	megabytes (10^6 bytes) of uncompressed pixel data per second,
+//	using the fastest of several runs.  The compression ratio is
+//	the size of the uncompressed pixel data divided by the size
+//	of the file.
+//
+//----------------------------------------------------------------------------
+
+#include "benchImage.h"
+
+#include <ImfCompression.h>
+#include <ImfPixelType.h>
+#include <ImfPixelCopySimd.h>
+
+#include <iostream>
+#include <vector>
+
+#include "namespaceAlias.h"
+
+
+struct BenchConfig
+{
+    std::vector<IMF::Compression>	compressions;
+    std::vector<IMF::PixelType>		pixelTypes;
+    std::vector<int>			threadCounts;
+    int					tileWidth;	// 0 for scan
+    int					tileHeight;	// line files
+    int					iterations;
+    bool				csv;
+
+    BenchConfig ();
+};
+
+
+const char *	compressionName (IMF::Compression c);
+const char *	pixelTypeName (IMF::PixelType type);
+const char *	simdLevelName (IMF::SimdLevel level);
+
+
+//
+// printHeading() prints the column headings.  benchmarkImage()
+// prints one line of results for every combination of pixel type,
+// compression method and thread count in the configuration.
+//
+
+void	printHeading (const BenchConfig &config, std::ostream &os);
+
+void	benchmarkImage (const BenchImage &image,
+			const BenchConfig &config,
+			std::ostream &os);
+
+
+#endif
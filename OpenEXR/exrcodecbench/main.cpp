@@ -0,0 +1,508 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2014, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+
+//-----------------------------------------------------------------------------
+//
+//	exrcodecbench -- program that measures the speed and
+//	the compression ratio of the OpenEXR compression methods.
+//
+//-----------------------------------------------------------------------------
+
+#include "codecBench.h"
+#include "benchImage.h"
+
+#include <OpenEXRConfig.h>
+
+#include <iostream>
+#include <exception>
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdlib.h>
+
+#include "namespaceAlias.h"
+using namespace IMF;
+using namespace std;
+
+
+
+namespace {
+
+void
+usageMessage (const char argv0[], bool verbose = false)
+{
+    cerr << "usage: " << argv0 << " [options] [infile ...]" << endl;
+
+    if (verbose)
+    {
+        cerr << "\n"
+        "Measures how fast the OpenEXR compression methods encode\n"
+        "and decode images, and how well they compress them.  For\n"
+        "every combination of image, pixel type, compression method\n"
+        "and thread count, the image is written to an in-memory file\n"
+        "and read back.  Speeds are in megabytes of uncompressed pixel\n"
+        "data per second, using the fastest of several runs.  The\n"
+        "ratio is the size of the pixel data divided by the size of\n"
+        "the file.  \"exact\" tells whether the pixels that were read\n"
+        "back are identical to the pixels that were written.\n"
+        "\n"
+        "The images are synthetic test patterns (see option -s), and\n"
+        "the images in the specified OpenEXR files.  The images are\n"
+        "converted to every pixel type that is selected with -p;\n"
+        "uint pixels are the image's values multiplied by 65535.\n"
+        "\n"
+        "Options:\n"
+        "\n"
+        "-z list   compression methods, separated by commas\n"
+        "          (none/rle/zips/zip/piz/pxr24/b44/b44a/dwaa/dwab/zstd,\n"
+        "          default is all that are supported)\n"
+        "\n"
+        "-p list   pixel types, separated by commas\n"
+        "          (half/float/uint, default is half,float)\n"
+        "\n"
+        "-n list   thread counts, separated by commas\n"
+        "          (default is 0, no worker threads)\n"
+        "\n"
+        "-s list   synthetic images, separated by commas\n"
+        "          (noise/gradient/constant/render, default is\n"
+        "          all of them if no input files are specified,\n"
+        "          otherwise none)\n"
+        "\n"
+        "-r x y    sets the size of the synthetic images to\n"
+        "          x by y pixels (default is 1920 by 1080)\n"
+        "\n"
+        "-t x y    writes tiled files with x by y pixel tiles\n"
+        "          (default is scan line files)\n"
+        "\n"
+        "-i n      measures every combination n times\n"
+        "          (default is 3)\n"
+        "\n"
+        "-l x      limits the library to instruction set x\n"
+        "          (baseline/avx2/avx512, default is the\n"
+        "          widest that the CPU supports)\n"
+        "\n"
+        "-csv      prints the results as comma-separated values,\n"
+        "          with one line of column names, for further\n"
+        "          processing by other programs\n"
+        "\n"
+        "-h        prints this message\n";
+
+        cerr << endl;
+    }
+
+    exit (1);
+}
+
+
+void
+splitList (const string &str, vector<string> &items)
+{
+    size_t start = 0;
+
+    while (true)
+    {
+        size_t end = str.find (',', start);
+        items.push_back (str.substr (start, end - start));
+
+        if (end == string::npos)
+            break;
+
+        start = end + 1;
+    }
+}
+
+
+Compression
+getCompression (const string &str)
+{
+    for (int i = 0; i < NUM_COMPRESSION_METHODS; ++i)
+    {
+        Compression c = Compression (i);
+
+        if (str == compressionName (c))
+        {
+            #ifndef OPENEXR_IMF_HAVE_ZSTD
+
+                if (c == ZSTD_COMPRESSION)
+                {
+                    cerr << "This version of the library does not "
+                            "support ZSTD compression." << endl;
+                    exit (1);
+                }
+
+            #endif
+
+            return c;
+        }
+    }
+
+    cerr << "Unknown compression method \"" << str << "\"." << endl;
+    exit (1);
+}
+
+
+PixelType
+getPixelType (const string &str)
+{
+    PixelType type;
+
+    if (str == "half")
+    {
+        type = HALF;
+    }
+    else if (str == "float")
+    {
+        type = FLOAT;
+    }
+    else if (str == "uint")
+    {
+        type = UINT;
+    }
+    else
+    {
+        cerr << "Unknown pixel type \"" << str << "\"." << endl;
+        exit (1);
+    }
+
+    return type;
+}
+
+
+int
+getThreadCount (const string &str)
+{
+    char *end;
+    long n = strtol (str.c_str(), &end, 0);
+
+    if (str.empty() || *end != 0 || n < 0)
+    {
+        cerr << "Invalid thread count \"" << str << "\"." << endl;
+        exit (1);
+    }
+
+    return int (n);
+}
+
+
+SimdLevel
+getSimdLevel (const string &str)
+{
+    for (int i = SIMD_BASELINE; i <= SIMD_AVX512; ++i)
+    {
+        if (str == simdLevelName (SimdLevel (i)))
+            return SimdLevel (i);
+    }
+
+    cerr << "Unknown instruction set \"" << str << "\"." << endl;
+    exit (1);
+}
+
+} // namespace
+
+
+int
+main(int argc, char **argv)
+{
+    BenchConfig config;
+    vector<string> patterns;
+    vector<const char *> inFiles;
+    int width = 1920;
+    int height = 1080;
+    bool setLevel = false;
+    SimdLevel level = SIMD_BASELINE;
+
+    //
+    // Parse the command line.
+    //
+
+    int i = 1;
+
+    while (i < argc)
+    {
+        if (!strcmp (argv[i], "-z"))
+        {
+            //
+            // Compression methods
+            //
+
+            if (i > argc - 2)
+                usageMessage (argv[0]);
+
+            vector<string> items;
+            splitList (argv[i + 1], items);
+
+            for (size_t j = 0; j < items.size(); ++j)
+                config.compressions.push_back (getCompression (items[j]));
+
+            i += 2;
+        }
+        else if (!strcmp (argv[i], "-p"))
+        {
+            //
+            // Pixel types
+            //
+
+            if (i > argc - 2)
+                usageMessage (argv[0]);
+
+            vector<string> items;
+            splitList (argv[i + 1], items);
+
+            for (size_t j = 0; j < items.size(); ++j)
+                config.pixelTypes.push_back (getPixelType (items[j]));
+
+            i += 2;
+        }
+        else if (!strcmp (argv[i], "-n"))
+        {
+            //
+            // Thread counts
+            //
+
+            if (i > argc - 2)
+                usageMessage (argv[0]);
+
+            vector<string> items;
+            splitList (argv[i + 1], items);
+
+            for (size_t j = 0; j < items.size(); ++j)
+                config.threadCounts.push_back (getThreadCount (items[j]));
+
+            i += 2;
+        }
+        else if (!strcmp (argv[i], "-s"))
+        {
+            //
+            // Synthetic images
+            //
+
+            if (i > argc - 2)
+                usageMessage (argv[0]);
+
+            vector<string> items;
+            splitList (argv[i + 1], items);
+
+            for (size_t j = 0; j < items.size(); ++j)
+            {
+                if (!isSyntheticPattern (items[j]))
+                {
+                    cerr << "Unknown synthetic image \"" <<
+                            items[j] << "\"." << endl;
+                    return 1;
+                }
+
+                patterns.push_back (items[j]);
+            }
+
+            i += 2;
+        }
+        else if (!strcmp (argv[i], "-r"))
+        {
+            //
+            // Size of the synthetic images
+            //
+
+            if (i > argc - 3)
+                usageMessage (argv[0]);
+
+            width = strtol (argv[i + 1], 0, 0);
+            height = strtol (argv[i + 2], 0, 0);
+
+            if (width <= 0 || height <= 0)
+            {
+                cerr << "Image size must be greater than zero." << endl;
+                return 1;
+            }
+
+            i += 3;
+        }
+        else if (!strcmp (argv[i], "-t"))
+        {
+            //
+            // Tile size
+            //
+
+            if (i > argc - 3)
+                usageMessage (argv[0]);
+
+            config.tileWidth = strtol (argv[i + 1], 0, 0);
+            config.tileHeight = strtol (argv[i + 2], 0, 0);
+
+            if (config.tileWidth <= 0 || config.tileHeight <= 0)
+            {
+                cerr << "Tile size must be greater than zero." << endl;
+                return 1;
+            }
+
+            i += 3;
+        }
+        else if (!strcmp (argv[i], "-i"))
+        {
+            //
+            // Number of runs per measurement
+            //
+
+            if (i > argc - 2)
+                usageMessage (argv[0]);
+
+            config.iterations = strtol (argv[i + 1], 0, 0);
+
+            if (config.iterations <= 0)
+            {
+                cerr << "Number of runs must be greater than zero." << endl;
+                return 1;
+            }
+
+            i += 2;
+        }
+        else if (!strcmp (argv[i], "-l"))
+        {
+            //
+            // Instruction set level
+            //
+
+            if (i > argc - 2)
+                usageMessage (argv[0]);
+
+            level = getSimdLevel (argv[i + 1]);
+            setLevel = true;
+            i += 2;
+        }
+        else if (!strcmp (argv[i], "-csv"))
+        {
+            //
+            // Comma-separated output
+            //
+
+            config.csv = true;
+            i += 1;
+        }
+        else if (!strcmp (argv[i], "-h"))
+        {
+            //
+            // Print help message
+            //
+
+            usageMessage (argv[0], true);
+        }
+        else if (argv[i][0] == '-')
+        {
+            usageMessage (argv[0]);
+        }
+        else
+        {
+            //
+            // Image file name
+            //
+
+            inFiles.push_back (argv[i]);
+            i += 1;
+        }
+    }
+
+    //
+    // Fill in the defaults for the lists that
+    // were not specified on the command line.
+    //
+
+    if (config.compressions.empty())
+    {
+        for (int c = 0; c < NUM_COMPRESSION_METHODS; ++c)
+        {
+            #ifndef OPENEXR_IMF_HAVE_ZSTD
+
+                if (c == ZSTD_COMPRESSION)
+                    continue;
+
+            #endif
+
+            config.compressions.push_back (Compression (c));
+        }
+    }
+
+    if (config.pixelTypes.empty())
+    {
+        config.pixelTypes.push_back (HALF);
+        config.pixelTypes.push_back (FLOAT);
+    }
+
+    if (config.threadCounts.empty())
+        config.threadCounts.push_back (0);
+
+    if (patterns.empty() && inFiles.empty())
+    {
+        patterns.push_back ("noise");
+        patterns.push_back ("gradient");
+        patterns.push_back ("constant");
+        patterns.push_back ("render");
+    }
+
+    //
+    // Measure.  The images are generated or
+    // loaded one at a time to limit memory use.
+    //
+
+    int exitStatus = 0;
+
+    try
+    {
+        if (setLevel)
+            setSimdLevel (level);
+
+        printHeading (config, cout);
+
+        for (size_t j = 0; j < patterns.size(); ++j)
+        {
+            BenchImage image;
+            makeSyntheticImage (patterns[j], width, height, image);
+            benchmarkImage (image, config, cout);
+        }
+
+        for (size_t j = 0; j < inFiles.size(); ++j)
+        {
+            BenchImage image;
+            loadImage (inFiles[j], image);
+            benchmarkImage (image, config, cout);
+        }
+    }
+    catch (const exception &e)
+    {
+        cerr << e.what() << endl;
+        exitStatus = 1;
+    }
+
+    return exitStatus;
+}
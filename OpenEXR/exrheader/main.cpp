@@ -115,6 +115,10 @@ printCompression (Compression c)
             cout << "dwa, medium scanline blocks";
             break;
 
+        case ZSTD_COMPRESSION:
+            cout << "zstd";
+            break;
+
         default:
             cout << int (c);
             break;
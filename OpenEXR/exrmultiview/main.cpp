@@ -81,7 +81,7 @@ usageMessage (const char argv0[], bool verbose = false)
 		"Options:\n"
 		"\n"
 		"-z x      sets the data compression method to x\n"
-		"          (none/rle/zip/piz/pxr24/b44/b44a/dwaa/dwab,\n"
+		"          (none/rle/zip/piz/pxr24/b44/b44a/dwaa/dwab/zstd,\n"
 		"          default is piz)\n"
 		"\n"
 		"-v        verbose mode\n"
@@ -136,6 +136,10 @@ getCompression (const string &str)
     {
 	c = DWAB_COMPRESSION;
     }
+    else if (str == "zstd" || str == "ZSTD")
+    {
+	c = ZSTD_COMPRESSION;
+    }
     else
     {
 	cerr << "Unknown compression method \"" << str << "\"." << endl;